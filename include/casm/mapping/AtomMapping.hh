@@ -28,6 +28,10 @@ struct AtomMapping {
 AtomMapping interpolated_mapping(AtomMapping const &atom_mapping,
                                  double interpolation_factor);
 
+/// \brief Total order of atom mappings, for reproducible ordering of
+///     results with equal cost
+bool total_order_less(AtomMapping const &lhs, AtomMapping const &rhs);
+
 struct ScoredAtomMapping : public AtomMapping {
   ScoredAtomMapping(double _atom_cost, AtomMapping _atom_mapping)
       : AtomMapping(_atom_mapping), atom_cost(_atom_cost) {}
@@ -0,0 +1,93 @@
+#ifndef CASM_mapping_AtomMappingSearchDataCache
+#define CASM_mapping_AtomMappingSearchDataCache
+
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+
+namespace CASM {
+namespace mapping {
+
+struct AtomMappingSearchData;
+struct LatticeMappingSearchData;
+
+// Note: See source file for full documentation
+
+/// \brief Counts of AtomMappingSearchDataCache lookups and evictions
+struct AtomMappingSearchDataCacheStatistics {
+  /// \brief Number of lookups that found cached data
+  Index n_hit = 0;
+
+  /// \brief Number of lookups that did not find cached data, so that
+  ///     the data had to be (re-)constructed
+  Index n_miss = 0;
+
+  /// \brief Number of entries evicted to stay within the size limit
+  Index n_evicted = 0;
+
+  /// \brief Current estimated size of the cached data, in bytes
+  Index n_bytes = 0;
+
+  /// \brief Maximum value of `n_bytes`
+  Index max_n_bytes_used = 0;
+};
+
+/// \brief A size-bounded, least recently used cache of
+///     AtomMappingSearchData
+class AtomMappingSearchDataCache {
+ public:
+  /// \brief Constructor
+  explicit AtomMappingSearchDataCache(Index _max_n_bytes);
+
+  /// \brief Maximum estimated size of the cached data, in bytes
+  Index max_n_bytes() const { return m_max_n_bytes; }
+
+  /// \brief Number of cached entries
+  Index size() const { return m_entries.size(); }
+
+  /// \brief Find cached data for a lattice mapping and trial
+  ///     translation
+  std::shared_ptr<AtomMappingSearchData const> find(
+      LatticeMappingSearchData const &lattice_mapping_data,
+      Eigen::Vector3d const &trial_translation_cart);
+
+  /// \brief Insert data, evicting least recently used entries if
+  ///     necessary
+  void insert(std::shared_ptr<AtomMappingSearchData const> const &data);
+
+  /// \brief Counts of lookups and evictions
+  AtomMappingSearchDataCacheStatistics statistics;
+
+ private:
+  typedef std::tuple<LatticeMappingSearchData const *, double, double, double>
+      Key;
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<AtomMappingSearchData const> data;
+    Index n_bytes;
+  };
+
+  static Key _make_key(LatticeMappingSearchData const &lattice_mapping_data,
+                       Eigen::Vector3d const &trial_translation_cart);
+
+  Index m_max_n_bytes;
+
+  /// \brief Entries, most recently used first
+  std::list<Entry> m_entries;
+
+  std::map<Key, std::list<Entry>::iterator> m_index;
+};
+
+/// \brief Estimate the memory used by the site displacements and cost
+///     matrix of AtomMappingSearchData, in bytes
+Index estimate_n_bytes(AtomMappingSearchData const &atom_mapping_data);
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
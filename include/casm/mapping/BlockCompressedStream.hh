@@ -0,0 +1,119 @@
+#ifndef CASM_mapping_BlockCompressedStream
+#define CASM_mapping_BlockCompressedStream
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "casm/global/definitions.hh"
+
+namespace CASM {
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Location and contents of one block of a block-compressed
+///     result stream
+struct BlockCompressedIndexEntry {
+  /// \brief File offset of the compressed block
+  std::uint64_t offset = 0;
+
+  /// \brief Size of the compressed block, in bytes
+  std::uint64_t n_compressed_bytes = 0;
+
+  /// \brief Size of the uncompressed block, in bytes
+  std::uint64_t n_bytes = 0;
+
+  /// \brief Index of the first record in the block
+  std::uint64_t first_record = 0;
+
+  /// \brief Number of records in the block
+  std::uint64_t n_record = 0;
+};
+
+/// \brief Writes records (NDJSON lines or binary) in zlib-compressed
+///     blocks, compressing blocks in parallel
+class BlockCompressedWriter {
+ public:
+  /// \brief Constructor, opens the file
+  BlockCompressedWriter(std::string const &_path,
+                        Index _block_size = 1 << 20, Index _n_threads = 0,
+                        int _level = -1);
+
+  /// \brief Destructor, closes the file if not already closed
+  ~BlockCompressedWriter();
+
+  BlockCompressedWriter(BlockCompressedWriter const &) = delete;
+  BlockCompressedWriter &operator=(BlockCompressedWriter const &) = delete;
+
+  /// \brief Append a record
+  void write(std::string const &record);
+
+  /// \brief Compress remaining records, and write the block index
+  void close();
+
+  /// \brief Number of records written
+  Index n_record() const { return m_n_record; }
+
+ private:
+  /// \brief Compress the current block on a worker thread
+  void _submit_block();
+
+  /// \brief Write the oldest compressed block to the file
+  void _write_front();
+
+  std::FILE *m_file;
+  Index m_block_size;
+  Index m_n_threads;
+  int m_level;
+
+  std::uint64_t m_n_record;
+  std::uint64_t m_offset;
+
+  std::vector<char> m_block;
+  std::uint64_t m_block_n_record;
+
+  std::deque<std::future<std::vector<char>>> m_pending;
+  std::deque<BlockCompressedIndexEntry> m_pending_entry;
+  std::vector<BlockCompressedIndexEntry> m_index;
+};
+
+/// \brief Reads records from a file written by BlockCompressedWriter,
+///     decompressing blocks in parallel
+class BlockCompressedReader {
+ public:
+  /// \brief Constructor, opens the file and reads the block index
+  explicit BlockCompressedReader(std::string const &_path,
+                                 Index _n_threads = 0);
+
+  /// \brief Destructor, closes the file
+  ~BlockCompressedReader();
+
+  BlockCompressedReader(BlockCompressedReader const &) = delete;
+  BlockCompressedReader &operator=(BlockCompressedReader const &) = delete;
+
+  /// \brief Number of records
+  Index n_record() const { return m_n_record; }
+
+  /// \brief Block index
+  std::vector<BlockCompressedIndexEntry> const &index() const {
+    return m_index;
+  }
+
+  /// \brief Read records in the range [begin, end)
+  std::vector<std::string> read(Index begin, Index end);
+
+ private:
+  std::FILE *m_file;
+  Index m_n_threads;
+  Index m_n_record;
+  std::vector<BlockCompressedIndexEntry> m_index;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef CASM_mapping_ConcurrentKBestResults
+#define CASM_mapping_ConcurrentKBestResults
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "casm/global/definitions.hh"
+#include "casm/mapping/misc.hh"
+
+namespace CASM {
+namespace mapping {
+
+/// \brief Collects k-best results, with ties, from many threads
+///
+/// This is a concurrent version of the k-best results maintained by
+/// `mapping_impl::insert` for MappingSearch, and by `map_lattices`,
+/// using `maintain_k_best_results`:
+///
+/// - Results with cost in the range (min_cost - cost_tol, max_cost +
+///   cost_tol) are kept.
+/// - If `k_best` has a value, only the k-best results are kept, plus
+///   results approximately equal in cost (within cost_tol) to the
+///   k-th best result.
+/// - Once k_best results are found, max_cost shrinks to the cost of the
+///   k-th best result.
+///
+/// Insertions go to one of several shards, chosen by the inserting
+/// thread, so threads do not contend for a single lock. Each shard
+/// maintains its own k-best results. The cost of the k-th best result of
+/// any shard is an upper bound on the cost of the k-th best result
+/// overall, so whenever a shard shrinks its max_cost, the minimum over
+/// shards is published as `max_cost()` using an atomic, which pruning
+/// code can read cheaply and without locking. Results that cannot be in
+/// the final k-best results (cost >= max_cost() + cost_tol) are rejected
+/// without locking.
+///
+/// `results()` merges the shards. The merged results are the same as
+/// those obtained by inserting the same results serially, in order of
+/// increasing key, which for serial insertion in any order differs at
+/// most by which results approximately tied with the k-th best result
+/// are kept when ties are separated by more than cost_tol in total.
+///
+/// Results with equal keys are merged in the order they are found in the
+/// shards, which depends on which thread inserted them. For results that
+/// do not depend on the number of threads or their scheduling, use
+/// `set_value_less` to set a total order of values with equal keys, such
+/// as `total_order_less` for StructureMapping. Then results are merged in
+/// order of increasing key and value, and are identical regardless of
+/// the number of threads and shards.
+///
+/// Example, for use in a parallel search:
+///
+///     ConcurrentKBestResults<StructureMappingCost, StructureMapping>
+///         collector(k_best, min_cost, max_cost, cost_tol,
+///                   [](StructureMappingCost const &key) {
+///                     return key.total_cost;
+///                   });
+///
+///     // in each worker:
+///     if (total_cost < collector.max_cost() + cost_tol) {
+///       collector.insert(key, value);
+///     }
+///
+///     // after all workers finish:
+///     auto results = collector.results();
+///
+template <typename K, typename T, typename Compare = std::less<K>>
+class ConcurrentKBestResults {
+ public:
+  typedef std::multimap<K, T, Compare> map_type;
+  typedef std::function<double(K const &)> GetCostFromKey;
+  typedef std::function<bool(T const &, T const &)> ValueLess;
+
+  /// \brief Constructor
+  ///
+  /// \param _k_best The optional number of results to keep. If there
+  ///     are approximate ties, those will also be kept.
+  /// \param _min_cost Keep results with cost >= min_cost
+  /// \param _max_cost Keep results with cost <= max_cost. This shrinks
+  ///     to the cost of the k-th best result once k_best results are
+  ///     found.
+  /// \param _cost_tol Tolerance for checking if costs are approximately
+  ///     equal
+  /// \param _get_cost_f Returns the cost of a result from its key
+  /// \param _n_shard Number of shards. The default (0) uses
+  ///     `std::thread::hardware_concurrency()`. Insertions by different
+  ///     threads only contend if they are assigned the same shard.
+  ConcurrentKBestResults(std::optional<int> _k_best, double _min_cost,
+                         double _max_cost, double _cost_tol,
+                         GetCostFromKey _get_cost_f, Index _n_shard = 0)
+      : m_k_best(_k_best),
+        m_min_cost(_min_cost),
+        m_init_max_cost(_max_cost),
+        m_cost_tol(_cost_tol),
+        m_get_cost_f(_get_cost_f),
+        m_max_cost(_max_cost) {
+    if (m_k_best.has_value() && *m_k_best < 1) {
+      throw std::runtime_error(
+          "Error in ConcurrentKBestResults: k_best < 1 is not allowed");
+    }
+    if (_n_shard <= 0) {
+      _n_shard =
+          std::max(Index(std::thread::hardware_concurrency()), Index(1));
+    }
+    for (Index i = 0; i < _n_shard; ++i) {
+      m_shards.emplace_back(std::make_unique<Shard>(_max_cost));
+    }
+  }
+
+  ConcurrentKBestResults(ConcurrentKBestResults const &) = delete;
+  ConcurrentKBestResults &operator=(ConcurrentKBestResults const &) = delete;
+
+  /// \brief The current upper bound on the cost of the k-th best result
+  ///
+  /// Results with cost >= max_cost() + cost_tol will not be kept. This
+  /// only decreases, and may be read at any time by any thread.
+  double max_cost() const {
+    return m_max_cost.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Tolerance for checking if costs are approximately equal
+  double cost_tol() const { return m_cost_tol; }
+
+  /// \brief Set a total order of values with equal keys, used to merge
+  ///     results reproducibly
+  ///
+  /// Not thread-safe: set before inserting results. If empty (default),
+  /// results with equal keys are merged in the order they are found in
+  /// the shards.
+  void set_value_less(ValueLess _value_less) { m_value_less = _value_less; }
+
+  /// \brief Insert a result, if it may be one of the k-best results
+  ///
+  /// Thread-safe.
+  ///
+  /// \returns True if the result was inserted, false if it was rejected
+  ///     because its cost is out of range. An inserted result may
+  ///     later be removed by better results.
+  bool insert(K const &key, T const &value) {
+    double cost = m_get_cost_f(key);
+    if (!(cost > (m_min_cost - m_cost_tol)) ||
+        !(cost < max_cost() + m_cost_tol)) {
+      return false;
+    }
+
+    Shard &shard = *m_shards[_shard_index()];
+    double shard_max_cost;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (!(cost < std::min(shard.max_cost, max_cost()) + m_cost_tol)) {
+        return false;
+      }
+      shard.results.emplace(key, value);
+      maintain_k_best_results(m_k_best, m_cost_tol, shard.results,
+                              shard.overflow, m_get_cost_f);
+      if (m_k_best.has_value() &&
+          static_cast<int>(shard.results.size()) == *m_k_best) {
+        shard.max_cost = m_get_cost_f(shard.results.rbegin()->first);
+      }
+      shard_max_cost = shard.max_cost;
+    }
+    _publish_max_cost(shard_max_cost);
+    return true;
+  }
+
+  /// \brief Return the merged k-best results, including approximate ties
+  ///
+  /// Thread-safe, but normally called after all insertions are done.
+  map_type results() const {
+    std::vector<std::pair<K, T>> all;
+    for (auto const &shard_ptr : m_shards) {
+      std::lock_guard<std::mutex> lock(shard_ptr->mutex);
+      all.insert(all.end(), shard_ptr->results.begin(),
+                 shard_ptr->results.end());
+      all.insert(all.end(), shard_ptr->overflow.begin(),
+                 shard_ptr->overflow.end());
+    }
+    Compare compare;
+    if (m_value_less) {
+      std::sort(all.begin(), all.end(),
+                [&](std::pair<K, T> const &lhs, std::pair<K, T> const &rhs) {
+                  if (compare(lhs.first, rhs.first)) {
+                    return true;
+                  }
+                  if (compare(rhs.first, lhs.first)) {
+                    return false;
+                  }
+                  return m_value_less(lhs.second, rhs.second);
+                });
+    } else {
+      std::stable_sort(
+          all.begin(), all.end(),
+          [&](std::pair<K, T> const &lhs, std::pair<K, T> const &rhs) {
+            return compare(lhs.first, rhs.first);
+          });
+    }
+
+    // insert serially, in order, as by mapping_impl::insert
+    double max_cost = m_init_max_cost;
+    map_type results;
+    map_type overflow;
+    for (auto const &pair : all) {
+      double cost = m_get_cost_f(pair.first);
+      if (!(cost > (m_min_cost - m_cost_tol)) ||
+          !(cost < max_cost + m_cost_tol)) {
+        continue;
+      }
+      results.insert(pair);
+      maintain_k_best_results(m_k_best, m_cost_tol, results, overflow,
+                              m_get_cost_f);
+      if (m_k_best.has_value() &&
+          static_cast<int>(results.size()) == *m_k_best) {
+        max_cost = m_get_cost_f(results.rbegin()->first);
+      }
+    }
+    while (overflow.size()) {
+      results.insert(overflow.extract(overflow.begin()));
+    }
+    return results;
+  }
+
+ private:
+  /// \brief Per-shard k-best results
+  ///
+  /// Aligned to avoid false sharing between shards.
+  struct alignas(64) Shard {
+    Shard(double _max_cost) : max_cost(_max_cost) {}
+
+    std::mutex mutex;
+    map_type results;
+    map_type overflow;
+    double max_cost;
+  };
+
+  /// \brief Shard used by the calling thread
+  ///
+  /// Threads are numbered in order of first use, so that up to
+  /// `m_shards.size()` threads each have their own shard.
+  Index _shard_index() const {
+    static std::atomic<Index> next_thread_index{0};
+    thread_local Index thread_index = next_thread_index++;
+    return thread_index % m_shards.size();
+  }
+
+  /// \brief Atomically set m_max_cost = min(m_max_cost, value)
+  void _publish_max_cost(double value) {
+    double current = m_max_cost.load(std::memory_order_relaxed);
+    while (value < current &&
+           !m_max_cost.compare_exchange_weak(current, value,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  std::optional<int> m_k_best;
+  double m_min_cost;
+  double m_init_max_cost;
+  double m_cost_tol;
+  GetCostFromKey m_get_cost_f;
+  ValueLess m_value_less;
+
+  std::atomic<double> m_max_cost;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
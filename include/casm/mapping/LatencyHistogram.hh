@@ -0,0 +1,83 @@
+#ifndef CASM_mapping_LatencyHistogram
+#define CASM_mapping_LatencyHistogram
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "casm/global/definitions.hh"
+
+namespace CASM {
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Histogram of latencies, with bounded relative error
+///
+/// Latencies are recorded as integer nanoseconds into log-linear
+/// buckets (HDR-style): values less than `2^(significant_bits+1)`
+/// have their own bucket, and larger values share buckets of width
+/// proportional to their magnitude, so that any recorded value is
+/// known to a relative precision of `2^-significant_bits`.
+class LatencyHistogram {
+ public:
+  /// \brief Constructor
+  explicit LatencyHistogram(int _significant_bits = 7);
+
+  /// \brief Number of bits of precision kept for each recorded value
+  int significant_bits() const { return m_significant_bits; }
+
+  /// \brief Record a latency, in seconds
+  void record(double seconds);
+
+  /// \brief Record a latency, in nanoseconds
+  void record_nanoseconds(std::uint64_t nanoseconds);
+
+  /// \brief Add the counts of another histogram
+  void merge(LatencyHistogram const &other);
+
+  /// \brief Number of recorded values
+  std::uint64_t count() const { return m_count; }
+
+  /// \brief Minimum recorded value, in seconds (exact)
+  double min() const;
+
+  /// \brief Maximum recorded value, in seconds (exact)
+  double max() const;
+
+  /// \brief Mean recorded value, in seconds (exact)
+  double mean() const;
+
+  /// \brief Value at a percentile, in seconds
+  double value_at_percentile(double percentile) const;
+
+  /// \brief Number of buckets
+  Index n_bucket() const { return m_counts.size(); }
+
+  /// \brief Range of values, in nanoseconds, counted by a bucket
+  std::pair<std::uint64_t, std::uint64_t> bucket_range(Index index) const;
+
+  /// \brief Number of values counted by a bucket
+  std::uint64_t bucket_count(Index index) const { return m_counts[index]; }
+
+ private:
+  /// \brief Bucket index for a value, in nanoseconds
+  Index _bucket_index(std::uint64_t nanoseconds) const;
+
+  int m_significant_bits;
+
+  std::vector<std::uint64_t> m_counts;
+
+  std::uint64_t m_count;
+
+  std::uint64_t m_min;
+
+  std::uint64_t m_max;
+
+  double m_sum;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
@@ -51,6 +51,10 @@ LatticeMapping interpolated_mapping(LatticeMapping const &lattice_mapping,
 xtal::Lattice make_mapped_lattice(xtal::Lattice const &parent_lattice,
                                   LatticeMapping const &lattice_mapping);
 
+/// \brief Total order of lattice mappings, for reproducible ordering
+///     of results with equal cost
+bool total_order_less(LatticeMapping const &lhs, LatticeMapping const &rhs);
+
 struct ScoredLatticeMapping : public LatticeMapping {
   ScoredLatticeMapping(double _lattice_cost, LatticeMapping _lattice_mapping)
       : LatticeMapping(_lattice_mapping), lattice_cost(_lattice_cost) {}
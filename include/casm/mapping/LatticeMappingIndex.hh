@@ -0,0 +1,126 @@
+#ifndef CASM_mapping_LatticeMappingIndex
+#define CASM_mapping_LatticeMappingIndex
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/SymType.hh"
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+#include "casm/mapping/LatticeMapping.hh"
+
+namespace CASM {
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Shape=(6,1) vector of lattice metric invariants
+typedef Eigen::Matrix<double, 6, 1> LatticeMetricInvariant;
+
+/// \brief Return the Niggli-reduced lattice and the unimodular matrix, U,
+///     that gives it (L_reduced = L * U)
+std::pair<xtal::Lattice, Eigen::Matrix3l> make_reduced_lattice(
+    xtal::Lattice const &lattice);
+
+/// \brief Return lattice metric invariants, used to find similar lattices
+LatticeMetricInvariant make_lattice_metric_invariant(
+    xtal::Lattice const &lattice);
+
+/// \brief A previously mapped child lattice and its lattice mappings
+struct LatticeMappingIndexEntry {
+  /// \brief The Niggli-reduced child lattice, L2
+  xtal::Lattice reduced_lattice2;
+
+  /// \brief Metric invariants of reduced_lattice2
+  LatticeMetricInvariant invariant;
+
+  /// \brief Lattice mappings, F * L1 * T * N = reduced_lattice2
+  LatticeMappingResults lattice_mappings;
+};
+
+/// \brief Index of previously mapped child lattices, used to
+///     warm-start lattice mapping searches
+///
+/// Child lattices are stored by the metric invariants of their
+/// Niggli-reduced form in a k-d tree, so that previously found
+/// lattice mappings of the most similar child lattices can be found
+/// quickly and adjusted into candidate mappings for a new child
+/// lattice. All entries map to the same parent lattice, L1.
+class LatticeMappingIndex {
+ public:
+  /// \brief Constructor
+  LatticeMappingIndex(
+      xtal::Lattice const &_lattice1,
+      std::vector<xtal::SymOp> _lattice1_point_group = {},
+      std::string _cost_method = std::string("isotropic_strain_cost"));
+
+  /// \brief The parent lattice, L1
+  xtal::Lattice const &lattice1() const { return m_lattice1; }
+
+  /// \brief Parent point group, used for "symmetry_breaking_strain_cost"
+  std::vector<xtal::SymOp> const &lattice1_point_group() const {
+    return m_lattice1_point_group;
+  }
+
+  /// \brief The lattice mapping cost method
+  std::string const &cost_method() const { return m_cost_method; }
+
+  /// \brief Number of child lattices in the index
+  Index size() const { return m_entries.size(); }
+
+  /// \brief Child lattice entries, in the order inserted
+  std::vector<LatticeMappingIndexEntry> const &entries() const {
+    return m_entries;
+  }
+
+  /// \brief Insert lattice mappings for a child lattice
+  void insert(xtal::Lattice const &lattice2,
+              LatticeMappingResults const &lattice_mappings);
+
+  /// \brief Find the entries nearest a child lattice
+  std::vector<std::pair<double, Index>> nearest(
+      xtal::Lattice const &lattice2, Index k_nearest = 1,
+      double max_distance = 1e20) const;
+
+  /// \brief Make candidate lattice mappings for a child lattice from
+  ///     the lattice mappings of the nearest entries
+  LatticeMappingResults make_candidates(xtal::Lattice const &lattice2,
+                                        Index k_nearest = 1,
+                                        double max_distance = 1e20) const;
+
+ private:
+  /// \brief Rebuild the k-d tree over all entries
+  void _rebuild();
+
+  /// \brief Build the k-d tree for m_tree[begin, end)
+  void _build(Index begin, Index end, int depth);
+
+  /// \brief Search the k-d tree for m_tree[begin, end)
+  void _search(LatticeMetricInvariant const &x, Index begin, Index end,
+               int depth, Index k_nearest, double max_distance,
+               std::vector<std::pair<double, Index>> &heap) const;
+
+  /// \brief Add a candidate to the k nearest
+  void _push(std::pair<double, Index> value, Index k_nearest,
+             std::vector<std::pair<double, Index>> &heap) const;
+
+  xtal::Lattice m_lattice1;
+
+  std::vector<xtal::SymOp> m_lattice1_point_group;
+
+  std::string m_cost_method;
+
+  std::vector<LatticeMappingIndexEntry> m_entries;
+
+  /// \brief Entry indices in k-d tree order, for entries
+  ///     [0, m_tree.size()). Entries [m_tree.size(), m_entries.size())
+  ///     are searched linearly until the tree is rebuilt.
+  std::vector<Index> m_tree;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
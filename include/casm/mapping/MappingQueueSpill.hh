@@ -0,0 +1,172 @@
+#ifndef CASM_mapping_MappingQueueSpill
+#define CASM_mapping_MappingQueueSpill
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+#include "casm/mapping/murty.hh"
+
+namespace CASM {
+namespace mapping {
+
+struct LatticeMappingSearchData;
+
+// Note: See source file for full documentation
+
+/// \brief The part of a MappingNode that is written to a
+///     MappingQueueSpill
+///
+/// The AtomMappingSearchData and AtomMapping are not stored, they are
+/// re-constructed from the lattice mapping data, trial translation, and
+/// assignment when the MappingNode is reloaded.
+struct SpilledMappingNode {
+  /// \brief The lattice mapping cost
+  double lattice_cost;
+
+  /// \brief Lattice mapping-specific data
+  std::shared_ptr<LatticeMappingSearchData const> lattice_mapping_data;
+
+  /// \brief The atom mapping cost
+  double atom_cost;
+
+  /// \brief The trial translation
+  Eigen::Vector3d trial_translation_cart;
+
+  /// \brief The constrained assignment problem solution
+  ///
+  /// Only `forced_on`, `forced_off`, `sub_assignment`, and `cost` are
+  /// stored. When reloaded, `unassigned_rows` and `unassigned_cols`
+  /// are re-constructed from `forced_on` and the number of supercell
+  /// sites, as by `murty::make_node`.
+  murty::Node assignment_node;
+
+  /// \brief The total mapping cost
+  double total_cost;
+};
+
+/// \brief Counts of MappingNode and bytes moved through a
+///     MappingQueueSpill
+struct MappingQueueSpillStatistics {
+  /// \brief Number of MappingNode written to the spill file
+  Index n_spilled_mapping_node = 0;
+
+  /// \brief Number of MappingNode read back from the spill file
+  Index n_reloaded_mapping_node = 0;
+
+  /// \brief Number of bytes written to the spill file
+  Index n_bytes_written = 0;
+
+  /// \brief Number of bytes read from the spill file
+  Index n_bytes_read = 0;
+
+  /// \brief Maximum size, in bytes, of the spill file
+  Index max_n_bytes_file = 0;
+
+  /// \brief Time spent writing and reading the spill file, in seconds
+  double io_time = 0.0;
+};
+
+/// \brief Holds the highest cost part of a MappingSearch queue in a
+///     temporary file
+class MappingQueueSpill {
+ public:
+  /// \brief Constructor
+  explicit MappingQueueSpill(std::optional<std::string> _path = std::nullopt);
+
+  ~MappingQueueSpill();
+
+  MappingQueueSpill(MappingQueueSpill const &) = delete;
+  MappingQueueSpill &operator=(MappingQueueSpill const &) = delete;
+
+  /// \brief Number of spilled MappingNode
+  Index size() const { return m_index.size(); }
+
+  /// \brief Total cost of the lowest cost spilled MappingNode
+  double front_cost() const;
+
+  /// \brief Write a MappingNode to the spill file
+  void push_back(SpilledMappingNode const &node);
+
+  /// \brief Read and remove the lowest cost spilled MappingNode
+  SpilledMappingNode pop_front();
+
+  /// \brief Read and remove the n lowest cost spilled MappingNode
+  std::vector<SpilledMappingNode> pop_front(Index n);
+
+  /// \brief Read the highest cost spilled MappingNode
+  SpilledMappingNode back();
+
+  /// \brief Remove the highest cost spilled MappingNode, without
+  ///     reading it
+  void pop_back();
+
+  /// \brief Counts of MappingNode and bytes written and read
+  MappingQueueSpillStatistics statistics;
+
+ private:
+  /// \brief In-memory index of one spilled MappingNode
+  struct Entry {
+    double total_cost;
+    std::uint64_t sequence;
+    std::int64_t offset;
+    std::int64_t n_bytes;
+    Index lattice_mapping_data_id;
+
+    /// \brief Order by total cost, then by order written
+    bool operator<(Entry const &rhs) const {
+      if (this->total_cost != rhs.total_cost) {
+        return this->total_cost < rhs.total_cost;
+      }
+      return this->sequence < rhs.sequence;
+    }
+  };
+
+  /// \brief Shared data referenced by spilled MappingNode, kept in
+  ///     memory while referenced
+  template <typename DataType>
+  struct SharedDataTable {
+    Index add(std::shared_ptr<DataType const> const &data);
+    std::shared_ptr<DataType const> const &get(Index id) const;
+    void release(Index id);
+
+    std::vector<std::shared_ptr<DataType const>> data;
+    std::vector<Index> n_ref;
+    std::vector<Index> unused_id;
+    std::unordered_map<DataType const *, Index> id;
+  };
+
+  std::int64_t _allocate(std::int64_t n_bytes);
+  void _free(std::int64_t offset, std::int64_t n_bytes);
+  void _read_bytes(std::int64_t offset, std::int64_t n_bytes);
+  SpilledMappingNode _decode(Entry const &entry, char const *ptr) const;
+  void _release(Entry const &entry);
+
+  std::optional<std::string> m_path;
+  std::FILE *m_file;
+  std::int64_t m_end;
+  std::uint64_t m_next_sequence;
+  std::set<Entry> m_index;
+  SharedDataTable<LatticeMappingSearchData> m_lattice_mapping_data;
+  std::vector<char> m_buffer;
+
+  /// \brief Unused extents of the spill file, as {offset, n_bytes},
+  ///     with adjacent extents merged
+  std::map<std::int64_t, std::int64_t> m_free_by_offset;
+
+  /// \brief Unused extents of the spill file, as {n_bytes, offset}
+  std::multimap<std::int64_t, std::int64_t> m_free_by_size;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
@@ -1,15 +1,23 @@
 #ifndef CASM_mapping_MappingSearch
 #define CASM_mapping_MappingSearch
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
+#include <string>
+#include <unordered_map>
 
 #include "casm/mapping/AtomMapping.hh"
+#include "casm/mapping/AtomMappingSearchDataCache.hh"
 #include "casm/mapping/LatticeMapping.hh"
+#include "casm/mapping/MappingQueueSpill.hh"
 #include "casm/mapping/SearchData.hh"
 #include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/assignment.hh"
+#include "casm/mapping/atom_cost.hh"
+#include "casm/mapping/misc.hh"
 #include "casm/mapping/murty.hh"
 
 namespace CASM {
@@ -37,6 +45,42 @@ struct SymmetryBreakingAtomCost {
                     AtomMapping const &atom_mapping) const;
 };
 
+/// \brief Function type for calculating the atom mapping costs of a
+///     batch of atom mappings, for the same lattice mapping and trial
+///     translation
+using BatchAtomCostFunction = std::function<Eigen::VectorXd(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    AtomMappingSearchData const &atom_mapping_data,
+    std::vector<AtomMapping> const &atom_mappings)>;
+
+/// \brief Adapts a `BatchAtomCostFunction` for use as an atom cost
+///     function
+///
+/// When used as the atom cost function of a MappingSearch, by itself
+/// or held by an `AtomCostFunction`, `partition` calculates the atom
+/// costs of all the sub-optimal assignments of a MappingNode with one
+/// call of `f`.
+struct BatchAtomCost {
+  /// \brief Constructor
+  explicit BatchAtomCost(BatchAtomCostFunction _f);
+
+  /// \brief The function used to calculate atom mapping costs
+  BatchAtomCostFunction f;
+
+  /// \brief Calculate the atom mapping cost of one atom mapping, with
+  ///     a batch of size 1
+  double operator()(LatticeMappingSearchData const &lattice_mapping_data,
+                    AtomMappingSearchData const &atom_mapping_data,
+                    AtomMapping const &atom_mapping) const;
+
+  /// \brief Calculate the atom mapping costs of a batch of atom
+  ///     mappings
+  Eigen::VectorXd operator()(
+      LatticeMappingSearchData const &lattice_mapping_data,
+      AtomMappingSearchData const &atom_mapping_data,
+      std::vector<AtomMapping> const &atom_mappings) const;
+};
+
 // --- Total cost calculation ---
 
 /// \brief Function type for calculating total mapping cost
@@ -100,6 +144,17 @@ struct MappingNode {
       murty::Node _assignment_node, AtomMapping _atom_mapping,
       double _total_cost);
 
+  /// \brief Constructor, with an explicit trial translation, for
+  ///     MappingNode that do not hold their atom mapping data
+  MappingNode(
+      double _lattice_cost,
+      std::shared_ptr<LatticeMappingSearchData const> _lattice_mapping_data,
+      double _atom_cost,
+      std::shared_ptr<AtomMappingSearchData const> _atom_mapping_data,
+      Eigen::Vector3d const &_trial_translation_cart,
+      murty::Node _assignment_node, AtomMapping _atom_mapping,
+      double _total_cost);
+
   /// \brief The lattice mapping cost
   double const lattice_cost;
 
@@ -112,8 +167,17 @@ struct MappingNode {
 
   /// \brief Data that can be used for all atom mappings with the
   ///     same lattice mapping and trial translation
+  ///
+  /// This is nullptr if the MappingNode was constructed by a
+  /// MappingSearch that uses an AtomMappingSearchDataCache, in which
+  /// case the data is obtained from the cache using
+  /// lattice_mapping_data and trial_translation_cart.
   std::shared_ptr<AtomMappingSearchData const> const atom_mapping_data;
 
+  /// \brief The trial translation that, with lattice_mapping_data,
+  ///     identifies atom_mapping_data
+  Eigen::Vector3d const trial_translation_cart;
+
   /// \brief Encodes a constrained solution to the atom-to-site
   ///     assignment problem
   ///
@@ -143,6 +207,91 @@ struct MappingNode {
   }
 };
 
+/// \brief Identifies a complete structure mapping, for detecting
+///     duplicate MappingNode
+///
+/// Two MappingNode with equal keys have the same prim, child structure,
+/// ideal supercell (T*N), permutation, and, up to a supercell lattice
+/// translation, the same atom mapping translation.
+struct MappingNodeKey {
+  /// \brief Prim search data address
+  PrimSearchData const *prim_data;
+
+  /// \brief Structure search data address
+  StructureSearchData const *structure_data;
+
+  /// \brief Ideal supercell transformation matrix, T*N
+  Eigen::Matrix3l transformation_matrix_to_super;
+
+  /// \brief AtomMapping permutation
+  std::vector<Index> permutation;
+
+  /// \brief AtomMapping translation, as fractional coordinates of the
+  ///     supercell, wrapped and discretized
+  Eigen::Vector3l translation;
+
+  bool operator==(MappingNodeKey const &rhs) const {
+    return this->prim_data == rhs.prim_data &&
+           this->structure_data == rhs.structure_data &&
+           this->transformation_matrix_to_super ==
+               rhs.transformation_matrix_to_super &&
+           this->permutation == rhs.permutation &&
+           this->translation == rhs.translation;
+  }
+};
+
+/// \brief Hash function for MappingNodeKey
+struct MappingNodeKeyHash {
+  std::size_t operator()(MappingNodeKey const &key) const;
+};
+
+/// \brief Make the key identifying the structure mapping of a MappingNode
+MappingNodeKey make_mapping_node_key(MappingNode const &mapping_node);
+
+/// \brief Make the key identifying a structure mapping
+MappingNodeKey make_mapping_node_key(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    std::vector<Index> const &permutation,
+    Eigen::Vector3d const &translation);
+
+/// \brief Counts of MappingNode handled during a MappingSearch
+struct MappingSearchStatistics {
+  /// \brief Number of MappingNode constructed
+  Index n_mapping_node = 0;
+
+  /// \brief Number of MappingNode discarded because an equivalent
+  ///     MappingNode was in the queue or results
+  Index n_duplicate_mapping_node = 0;
+
+  /// \brief Counts of MappingNode and bytes written to and read from
+  ///     the queue spill file, if queue spilling is enabled
+  MappingQueueSpillStatistics queue_spill;
+
+  /// \brief Counts of AtomMappingSearchDataCache lookups and evictions,
+  ///     if the cache is enabled
+  AtomMappingSearchDataCacheStatistics atom_mapping_data_cache;
+};
+
+namespace mapping_impl {
+
+/// \brief Construct an AtomMapping from an assignment solution
+AtomMapping make_atom_mapping_from_assignment(
+    std::vector<Index> const &assignment,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    Eigen::VectorXd trial_translation,
+    Eigen::Matrix3d const &deformation_gradient,
+    bool enable_remove_mean_displacement);
+
+/// \brief Return the mean displacement and displacement moment of an
+///     assignment solution, without constructing an AtomMapping
+std::pair<Eigen::Vector3d, Eigen::Matrix3d>
+make_displacement_moment_from_assignment(
+    std::vector<Index> const &assignment,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    bool enable_remove_mean_displacement);
+
+}  // namespace mapping_impl
+
 /// \brief Make mapping node
 MappingNode make_mapping_node(
     MappingSearch const &search, double lattice_cost,
@@ -160,13 +309,16 @@ struct MappingSearch {
       TotalCostFunction _total_cost_f = WeightedTotalCost(0.5),
       AtomToSiteCostFunction _atom_to_site_cost_f = make_atom_to_site_cost,
       bool _enable_remove_mean_displacement = true, double _infinity = 1e20,
-      double _cost_tol = 1e-5);
+      double _cost_tol = 1e-5, bool _enable_duplicate_elimination = false,
+      bool _enable_structure_symmetry_reduction = false);
 
   /// \brief A queue of structure mappings, sorted by total
   ///     cost only
   ///
   /// This stores mappings with exactly repeated total cost
-  /// in order of insertion.
+  /// in order of insertion. If queue spilling is enabled, this
+  /// holds the lowest cost part of the queue and the rest is held
+  /// in `queue_spill`.
   std::multiset<MappingNode> queue;
 
   /// \brief Results, sorted by total cost, satisifying the
@@ -212,11 +364,53 @@ struct MappingSearch {
   /// \brief Tolerance used for comparing costs
   double cost_tol;
 
+  /// \brief If true, MappingNode which are equivalent to a MappingNode
+  ///     in the queue or results are not inserted into the queue or
+  ///     results
+  bool enable_duplicate_elimination;
+
+  /// \brief If true, `make_and_insert_mapping_nodes` skips trial
+  ///     translations that are equivalent under the internal
+  ///     translations of the structure being mapped
+  bool enable_structure_symmetry_reduction;
+
+  /// \brief Keys of the MappingNode in the queue, or inserted into
+  ///     results, used if enable_duplicate_elimination is true
+  ///
+  /// The value is true if the MappingNode was inserted into results.
+  /// Keys of MappingNode removed from the queue that were not inserted
+  /// into results are erased.
+  std::unordered_map<MappingNodeKey, bool, MappingNodeKeyHash>
+      mapping_node_keys;
+
+  /// \brief Counts of MappingNode handled during the search
+  MappingSearchStatistics statistics;
+
+  /// \brief Optional, maximum number of MappingNode to hold in
+  ///     `queue` before spilling the highest cost MappingNode to
+  ///     `queue_spill`
+  std::optional<Index> max_queue_memory_size;
+
+  /// \brief Holds the highest cost part of the queue, if queue
+  ///     spilling is enabled
+  std::unique_ptr<MappingQueueSpill> queue_spill;
+
+  /// \brief Holds AtomMappingSearchData for queued MappingNode, if
+  ///     the cache is enabled
+  std::unique_ptr<AtomMappingSearchDataCache> atom_mapping_data_cache;
+
+  /// \brief Method used to solve assignment problems
+  ///
+  /// By default, hungarian::solve is used. Set
+  /// `assignment_f.solver_type` to use augmenting_path::solve. The
+  /// number of problems solved is counted in `assignment_f.n_solved`.
+  assignment::SolverMethod assignment_f;
+
   /// \brief Return lowest total cost MappingNode in the queue
   MappingNode const &front() const;
 
   /// \brief Return highest total cost MappingNode in the queue
-  MappingNode const &back() const;
+  MappingNode const &back();
 
   /// \brief Erase lowest total cost MappingNode in the queue
   void pop_front();
@@ -227,6 +421,16 @@ struct MappingSearch {
   /// \brief Return the size of the queue
   Index size() const;
 
+  /// \brief Hold the highest cost part of the queue in a temporary
+  ///     file
+  void enable_queue_spill(
+      Index _max_queue_memory_size,
+      std::optional<std::string> spill_path = std::nullopt);
+
+  /// \brief Hold AtomMappingSearchData for queued MappingNode in a
+  ///     size-bounded cache
+  void enable_atom_mapping_data_cache(Index max_n_bytes);
+
   /// \brief Make assignment and insert mapping node
   ///     into this->queue & this->results, maintaining k-best results
   std::multiset<MappingNode>::iterator make_and_insert_mapping_node(
@@ -236,46 +440,37 @@ struct MappingSearch {
       std::map<Index, Index> forced_on = {},
       std::vector<std::pair<Index, Index>> forced_off = {});
 
+  /// \brief Make trial translations, and make and insert a mapping
+  ///     node for each
+  void make_and_insert_mapping_nodes(
+      double lattice_cost,
+      std::shared_ptr<LatticeMappingSearchData const> lattice_mapping_data);
+
   /// \brief Make the next level of sub-optimal assignments and
   ///     inserts them into this->queue & this->results, maintaining
   ///     k-best results
   std::vector<std::multiset<MappingNode>::iterator> partition();
+
+ private:
+  /// \brief Return true if an assignment solution cannot be inserted
+  ///     in the queue or results, without constructing a MappingNode
+  bool _skip_assignment_node(
+      murty::Node const &assignment_node, double lattice_cost,
+      LatticeMappingSearchData const &lattice_mapping_data,
+      AtomMappingSearchData const &atom_mapping_data);
+
+  /// \brief Holds the MappingNode returned by `back()`, if it was read
+  ///     from `queue_spill`
+  std::unique_ptr<MappingNode const> m_spilled_back;
+
+  /// \brief Storage reused by `_skip_assignment_node` for the full
+  ///     assignment
+  std::vector<Index> m_assignment;
 };
 
 /// \brief Return MappingSearch results combined with overflow
 StructureMappingResults combined_results(MappingSearch const &search);
 
-/// --- Inline implementation ---
-
-/// \brief Return lowest total cost MappingNode in the queue
-///
-/// Invalid if !size()
-inline MappingNode const &MappingSearch::front() const {
-  return *queue.begin();
-}
-
-/// \brief Return highest total cost MappingNode in the queue
-///
-/// Invalid if !size()
-inline MappingNode const &MappingSearch::back() const {
-  return *queue.rbegin();
-}
-
-/// \brief Erase lowest total cost MappingNode in the queue
-///
-/// Invalid if !size()
-inline void MappingSearch::pop_front() { queue.erase(queue.begin()); }
-
-/// \brief Erase highest total cost MappingNode in the queue
-///
-/// Invalid if !size()
-inline void MappingSearch::pop_back() {
-  queue.erase(std::next(queue.rbegin()).base());
-}
-
-/// \brief Return the size of the queue
-inline Index MappingSearch::size() const { return queue.size(); }
-
 }  // namespace mapping
 }  // namespace CASM
 
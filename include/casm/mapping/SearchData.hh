@@ -1,11 +1,18 @@
 #ifndef CASM_mapping_SearchData
 #define CASM_mapping_SearchData
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <type_traits>
 
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/LinearIndexConverter.hh"
+#include "casm/crystallography/Molecule.hh"
 #include "casm/crystallography/SymType.hh"
 #include "casm/global/eigen.hh"
 #include "casm/mapping/LatticeMapping.hh"
@@ -92,6 +99,97 @@ struct StructureSearchData {
 /// StructureSearchData
 xtal::SimpleStructure make_structure(StructureSearchData const &structure_data);
 
+/// \brief An optional value that is generated on first access
+///
+/// This provides the read-only interface of `std::optional`, but if
+/// there is a value it is not generated until it is first accessed.
+/// First access is thread-safe. The generating function should not
+/// refer to the object that owns the LazyOptional, so that copies
+/// remain valid.
+///
+/// Copies and moves take the value if it has already been generated,
+/// otherwise the result generates its own value on first access.
+/// Copying or moving must not be done concurrently with first access.
+template <typename T>
+class LazyOptional {
+ public:
+  /// \brief Construct without a value
+  LazyOptional() : m_flag(std::make_unique<std::once_flag>()) {}
+
+  /// \brief Construct with a value generated by `_make` on first access
+  explicit LazyOptional(std::function<T()> _make)
+      : m_make(std::move(_make)), m_flag(std::make_unique<std::once_flag>()) {}
+
+  LazyOptional(LazyOptional const &other) : LazyOptional() { *this = other; }
+
+  LazyOptional(LazyOptional &&other) : LazyOptional() {
+    *this = std::move(other);
+  }
+
+  LazyOptional &operator=(LazyOptional const &other) {
+    if (this != &other) {
+      m_make = other.m_make;
+      m_value.reset();
+      if (other.m_is_generated.load(std::memory_order_acquire)) {
+        m_value = other.m_value;
+      }
+      _reset_flag();
+    }
+    return *this;
+  }
+
+  LazyOptional &operator=(LazyOptional &&other) {
+    if (this != &other) {
+      m_make = std::move(other.m_make);
+      m_value.reset();
+      if (other.m_is_generated.load(std::memory_order_acquire)) {
+        m_value = std::move(other.m_value);
+      }
+      _reset_flag();
+      other.m_make = nullptr;
+      other.m_value.reset();
+      other._reset_flag();
+    }
+    return *this;
+  }
+
+  /// \brief Return true if there is a value (does not generate it)
+  bool has_value() const { return static_cast<bool>(m_make); }
+
+  explicit operator bool() const { return has_value(); }
+
+  /// \brief Return the value, generating it if this is first access
+  ///
+  /// Throws std::bad_optional_access if there is no value.
+  T const &value() const {
+    if (!has_value()) {
+      throw std::bad_optional_access();
+    }
+    std::call_once(*m_flag, [&]() {
+      if (!m_value.has_value()) {
+        m_value = m_make();
+      }
+      m_is_generated.store(true, std::memory_order_release);
+    });
+    return *m_value;
+  }
+
+  T const &operator*() const { return value(); }
+
+  T const *operator->() const { return &value(); }
+
+ private:
+  void _reset_flag() {
+    m_flag = std::make_unique<std::once_flag>();
+    m_is_generated.store(false, std::memory_order_relaxed);
+  }
+
+  std::function<T()> m_make;
+  std::unique_ptr<std::once_flag> m_flag;
+  mutable std::atomic<bool> m_is_generated{false};
+  mutable std::optional<T> m_value;
+};
+
 /// \brief Holds prim-related data used for mapping searches
 struct PrimSearchData {
   /// \brief Constructor
@@ -136,12 +234,61 @@ struct PrimSearchData {
   ///         sym_invariant_displacement_modes[mode_index].col(site_index)
   ///
   /// This member may be expensive so it is optional to construct, though
-  /// it is required for calculating the symmetry_breaking_atom_cost.
+  /// it is required for calculating the symmetry_breaking_atom_cost. If
+  /// it has a value, it is generated on first access.
   ///
-  std::optional<std::vector<Eigen::MatrixXd>> const
+  LazyOptional<std::vector<Eigen::MatrixXd>> const
       prim_sym_invariant_displacement_modes;
 };
 
+/// \brief Supercell site data in a packed, site-major layout, shared
+///     by the site displacement and cost matrix kernels
+///
+/// Sites are in the order of the UnitCellCoordIndexConverter used to
+/// construct it (the order used by AtomMapping permutations). They are
+/// not reordered for spatial locality, because that would change the
+/// meaning of AtomMapping permutations. Site coordinates are not
+/// copied; the kernels read them from the column-major
+/// `LatticeMappingSearchData::supercell_site_coordinate_cart`.
+struct SupercellSiteData {
+  /// \brief Constructor
+  SupercellSiteData(
+      xtal::Lattice const &supercell_lattice,
+      xtal::UnitCellCoordIndexConverter const &unitcellcoord_index_converter,
+      Eigen::MatrixXd const &supercell_site_coordinate_cart,
+      std::vector<std::vector<std::string>> const &prim_allowed_atom_types);
+
+  /// \brief Number of supercell sites
+  Index N_site;
+
+  /// \brief Size=N_site, prim sublattice index of each supercell site
+  std::vector<Index> sublattice;
+
+  /// \brief Distinct atom type names allowed on prim sites, in order of
+  ///     first appearance. Name `k` corresponds to mask bit `1 << k`.
+  std::vector<std::string> atom_type_names;
+
+  /// \brief Size=N_site, masks of the atom types allowed on each site.
+  ///     Empty if there are more than 64 atom_type_names.
+  std::vector<std::uint64_t> allowed_atom_type_mask;
+
+  /// \brief Mask of the atom_type_names that are vacancies
+  std::uint64_t vacancy_mask;
+
+  /// \brief The supercell lattice column matrix
+  Eigen::Matrix3d lat_column_mat;
+
+  /// \brief The inverse of lat_column_mat
+  Eigen::Matrix3d inv_lat_column_mat;
+
+  /// \brief Periodic displacements shorter than this are the unique
+  ///     minimum length displacement
+  double min_image_radius;
+
+  /// \brief Return the mask of an atom type
+  std::uint64_t atom_type_mask(std::string const &atom_type) const;
+};
+
 /// \brief Holds prim and lattice mapping-specific data used
 ///     for mapping searches
 struct LatticeMappingSearchData {
@@ -196,12 +343,16 @@ struct LatticeMappingSearchData {
   /// \brief Size=N_supercell_site, with names of atoms allowed on
   ///     each supercell site
   std::vector<std::vector<std::string>> const supercell_allowed_atom_types;
+
+  /// \brief Supercell site data in a packed, site-major layout
+  SupercellSiteData const supercell_site_data;
 };
 
 /// \brief Make possible atom -> site translations to bring atoms into
 ///     registry with the sites.
 std::vector<Eigen::Vector3d> make_trial_translations(
-    LatticeMappingSearchData const &lattice_mapping_data);
+    LatticeMappingSearchData const &lattice_mapping_data,
+    bool structure_symmetry_reduction = false);
 
 /// \brief A function, such as `make_atom_to_site_cost`,
 ///     which calculates the atom-to-site mapping cost given the
@@ -217,6 +368,154 @@ double make_atom_to_site_cost(
     Eigen::Vector3d const &displacement, std::string const &atom_type,
     std::vector<std::string> const &allowed_atom_types, double infinity);
 
+/// \brief Functor equivalent to `make_atom_to_site_cost`
+///
+/// Unlike `AtomToSiteCostFunction`, this is not type-erased, so
+/// that it can be inlined. When an `AtomToSiteCostFunction` holds an
+/// `AtomToSiteCost` or `make_atom_to_site_cost`, `make_cost_matrix`
+/// calls this directly.
+struct AtomToSiteCost {
+  double operator()(Eigen::Vector3d const &displacement,
+                    std::string const &atom_type,
+                    std::vector<std::string> const &allowed_atom_types,
+                    double infinity) const;
+};
+
+/// \brief The site-to-atom displacements and atom types of all atoms
+///     and sites, used to calculate a cost matrix with one call
+struct AtomToSiteCostBatch {
+  /// \brief Number of sites
+  Index N_site;
+
+  /// \brief Number of atoms, including one implicit vacancy if there
+  ///     are fewer atoms than sites
+  Index N_atom;
+
+  /// \brief Shape=(3, N_site*N_atom), the site-to-atom displacements.
+  ///     Column `site_index * N_atom + atom_index` is the displacement
+  ///     from site `site_index` to atom `atom_index`, so the data has
+  ///     the layout of a row-major (N_site, N_atom, 3) array.
+  Eigen::MatrixXd displacement;
+
+  /// \brief Names of the atom types that are allowed on any site or
+  ///     are the type of any atom
+  std::vector<std::string> atom_type_names;
+
+  /// \brief Size=N_atom, the index into `atom_type_names` of the type
+  ///     of each atom
+  Eigen::VectorXi atom_type_index;
+
+  /// \brief Shape=(N_site, atom_type_names.size()), true if
+  ///     `atom_type_names[k]` is allowed on site `i`
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> site_allowed;
+};
+
+/// \brief A function which calculates the atom-to-site mapping cost
+///     of all atoms and sites at once, given the site-to-atom
+///     displacements and atom types, and value to use for unallowed
+///     mappings (infinity), and returns a shape=(N_site, N_atom)
+///     matrix of costs.
+using AtomToSiteCostMatrixFunction = std::function<Eigen::MatrixXd(
+    AtomToSiteCostBatch const &batch, double infinity)>;
+
+/// \brief Adapts an `AtomToSiteCostMatrixFunction` for use as an
+///     atom-to-site cost function
+///
+/// When used as the atom-to-site cost function, by itself or held by
+/// an `AtomToSiteCostFunction`, the cost matrix is calculated with one
+/// call of `f` instead of one call per atom and site.
+struct AtomToSiteCostMatrix {
+  /// \brief Constructor
+  explicit AtomToSiteCostMatrix(AtomToSiteCostMatrixFunction _f);
+
+  /// \brief The function used to calculate the cost matrix
+  AtomToSiteCostMatrixFunction f;
+
+  /// \brief Calculate the cost of one atom and site, with a batch of
+  ///     size 1
+  double operator()(Eigen::Vector3d const &displacement,
+                    std::string const &atom_type,
+                    std::vector<std::string> const &allowed_atom_types,
+                    double infinity) const;
+};
+
+namespace mapping_impl {
+
+/// \brief Make possible atom -> site translations, from atom and prim
+///     site coordinates
+std::vector<Eigen::Vector3d> make_trial_translations(
+    Eigen::MatrixXd const &atom_coordinate_cart_in_supercell,
+    std::vector<std::string> const &atom_type,
+    xtal::Lattice const &prim_lattice,
+    Eigen::MatrixXd const &prim_site_coordinate_cart,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    std::vector<xtal::SymOp> const &prim_factor_group,
+    std::vector<Eigen::Vector3d> const &structure_internal_translations_cart);
+
+/// \brief Return Cartesian coordinates of supercell sites, as columns
+Eigen::MatrixXd make_supercell_site_coordinate_cart(
+    xtal::UnitCellCoordIndexConverter const &unitcellcoord_index_converter,
+    Eigen::MatrixXd const &prim_site_coordinate_cart,
+    xtal::Lattice const &prim_lattice);
+
+/// \brief Return allowed atom types on each supercell site
+std::vector<std::vector<std::string>> make_supercell_allowed_atom_types(
+    xtal::UnitCellCoordIndexConverter const &unitcellcoord_index_converter,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types);
+
+/// \brief Make container of displacement vectors
+std::vector<std::vector<Eigen::Vector3d>> make_site_displacements(
+    xtal::Lattice const &lattice,
+    Eigen::MatrixXd const &supercell_site_coordinate_cart,
+    Eigen::MatrixXd const &atom_coordinate_cart_in_supercell,
+    Eigen::Vector3d const &trial_translation);
+
+/// \brief Make container of displacement vectors, using packed site data
+std::vector<std::vector<Eigen::Vector3d>> make_site_displacements(
+    xtal::Lattice const &lattice,
+    Eigen::MatrixXd const &supercell_site_coordinate_cart,
+    SupercellSiteData const &site_data,
+    Eigen::MatrixXd const &atom_coordinate_cart_in_supercell,
+    Eigen::Vector3d const &trial_translation);
+
+/// \brief Calculate elements of the cost matrix
+template <typename AtomToSiteCostF>
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostF const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    std::vector<std::vector<std::string>> const &allowed_atom_types,
+    double infinity);
+
+/// \brief Calculate elements of the cost matrix, using packed site data
+template <typename AtomToSiteCostF>
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostF const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    double infinity);
+
+/// \brief Make the input of an `AtomToSiteCostMatrixFunction`
+AtomToSiteCostBatch make_atom_to_site_cost_batch(
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types);
+
+/// \brief Calculate the cost matrix with one call of an
+///     `AtomToSiteCostMatrixFunction`, using packed site data
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostMatrix const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    double infinity);
+
+}  // namespace mapping_impl
+
 /// \brief Holds data shared amongst all potential atom-to-site
 ///     assignment problems making use of the same trial
 ///     translation
@@ -228,6 +527,13 @@ struct AtomMappingSearchData {
       AtomToSiteCostFunction _atom_to_site_cost_f = make_atom_to_site_cost,
       double _infinity = 1e20);
 
+  /// \brief Constructor, with a statically typed atom-to-site cost function
+  template <typename AtomToSiteCostF>
+  AtomMappingSearchData(
+      std::shared_ptr<LatticeMappingSearchData const> _lattice_mapping_data,
+      Eigen::Vector3d const &_trial_translation_cart,
+      AtomToSiteCostF const &_atom_to_site_cost_f, double _infinity);
+
   /// \brief Holds lattice mapping-specific data used
   ///     for mapping searches
   std::shared_ptr<LatticeMappingSearchData const> const lattice_mapping_data;
@@ -253,6 +559,279 @@ struct AtomMappingSearchData {
   Eigen::MatrixXd const cost_matrix;
 };
 
+/// --- Inline implementation ---
+
+/// \brief Make the atom mapping cost for a particular atom
+///     to a particular structure site
+///
+/// See `make_atom_to_site_cost` for details.
+inline double AtomToSiteCost::operator()(
+    Eigen::Vector3d const &displacement, std::string const &atom_type,
+    std::vector<std::string> const &allowed_atom_types, double infinity) const {
+  // if vacancy is allowed on site, return 0.0; else return infinity
+  if (xtal::is_vacancy(atom_type)) {
+    for (auto const &allowed_type : allowed_atom_types) {
+      if (xtal::is_vacancy(allowed_type)) {
+        return 0.0;
+      }
+    }
+    return infinity;
+  }
+
+  // if non-vacancy is not allowed on site, return infinity
+  auto begin = allowed_atom_types.begin();
+  auto end = allowed_atom_types.end();
+  if (std::find(begin, end, atom_type) == end) {
+    return infinity;
+  }
+
+  // otherwise, return distance squared
+  return displacement.dot(displacement);
+}
+
+namespace mapping_impl {
+
+/// \brief Calculate elements of the cost matrix
+///
+/// The assignment problem cost matrix is calculated from
+/// site-to-atom displacements, atom types, and the
+/// types allowed on each site.
+///
+/// The site displacements are the minimum length displacements
+/// that satisfy:
+///
+///     site_coordinate_cart[i] + site_displacements[i][j] =
+///         F^{-1}*atom_coordinate_cart[j] + trial_translation
+///
+/// under periodic boundary conditions.
+///
+/// \param f A function used to calculate the atom mapping cost
+///      to a particular site. Follows the signature of
+///     `make_atom_to_site_cost`.
+/// \param site_displacements The site-to-atom displacements,
+///     of minimum length under periodic boundary conditions.
+/// \param atom_type Vector of size=N_atom containing the
+///     types of the atoms being mapped. May include vacancies.
+///     Any vacancies included in the child atoms **must** be
+///     mapped. Other vacancies may be added if there are more
+///     sites than atoms.
+/// \param allowed_atom_types The atom types allowed on each site
+/// \param infinity The value to use for unallowed mappings
+///
+/// \returns cost_matrix, with shape=(N_site, N_site). The element
+///     `cost_matrix(i, j)` is set to the cost of mapping the
+///     j-th atom to the i-th site. If there are more sites
+///     than atoms, vacancies are added.
+template <typename AtomToSiteCostF>
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostF const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    std::vector<std::vector<std::string>> const &allowed_atom_types,
+    double infinity) {
+  if (site_displacements.size() != allowed_atom_types.size()) {
+    throw std::runtime_error(
+        "Error in make_cost_matrix: site_displacements.size() != "
+        "allowed_atom_types.size()");
+  }
+
+  for (auto const &site_displacements_i : site_displacements) {
+    if (site_displacements_i.size() != atom_type.size()) {
+      throw std::runtime_error(
+          "Error in make_cost_matrix: an element of site_displacements != "
+          "atom_type.size()");
+    }
+  }
+
+  Index N_site = allowed_atom_types.size();
+  Index N_atom = atom_type.size();
+
+  Eigen::MatrixXd cost_matrix(N_site, N_site);
+
+  // make cost matrix: use cost_matrix(site_index, atom_index)
+  // to match AtomMapping permutation convention
+  for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
+    for (Index site_index = 0; site_index < N_site; ++site_index) {
+      cost_matrix(site_index, atom_index) =
+          f(site_displacements[site_index][atom_index], atom_type[atom_index],
+            allowed_atom_types[site_index], infinity);
+    }
+  }
+  // If N_atom < N_site, treat as additional vacancies to map
+  std::string const va_name("Va");
+  for (Index atom_index = N_atom; atom_index < N_site; ++atom_index) {
+    for (Index site_index = 0; site_index < N_site; ++site_index) {
+      cost_matrix(site_index, atom_index) =
+          f(Eigen::Vector3d::Zero(), va_name, allowed_atom_types[site_index],
+            infinity);
+    }
+  }
+
+  return cost_matrix;
+}
+
+/// \brief Calculate elements of the cost matrix, using packed site data
+///
+/// Gives the same result as `make_cost_matrix` with
+/// `allowed_atom_types` equal to the supercell allowed atom types, but:
+///
+/// - `f` is passed the prim allowed atom types of each site's
+///   sublattice, so only N_prim_site distinct vectors are read,
+/// - the matrix is filled in tiles, so that both the site displacements
+///   (stored site-major) and the cost matrix (stored column-major) are
+///   accessed with good locality, and
+/// - if `f` is `AtomToSiteCost`, allowed atom types are checked with
+///   the site data masks, rather than by comparing names.
+///
+/// If N_atom < N_site, the added vacancy columns are identical, so the
+/// cost of mapping a vacancy to each site is calculated once.
+///
+/// \param f A function used to calculate the atom mapping cost
+///      to a particular site. Follows the signature of
+///     `make_atom_to_site_cost`.
+/// \param site_displacements The site-to-atom displacements,
+///     of minimum length under periodic boundary conditions.
+/// \param atom_type Vector of size=N_atom containing the
+///     types of the atoms being mapped. May include vacancies.
+/// \param site_data Packed supercell site data
+/// \param prim_allowed_atom_types The atom types allowed on each prim
+///     site, indexed by `site_data.sublattice`
+/// \param infinity The value to use for unallowed mappings
+///
+/// \returns cost_matrix, with shape=(N_site, N_site). The element
+///     `cost_matrix(i, j)` is set to the cost of mapping the
+///     j-th atom to the i-th site.
+template <typename AtomToSiteCostF>
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostF const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    double infinity) {
+  if (site_displacements.size() != site_data.N_site) {
+    throw std::runtime_error(
+        "Error in make_cost_matrix: site_displacements.size() != "
+        "site_data.N_site");
+  }
+  for (auto const &site_displacements_i : site_displacements) {
+    if (site_displacements_i.size() != atom_type.size()) {
+      throw std::runtime_error(
+          "Error in make_cost_matrix: an element of site_displacements != "
+          "atom_type.size()");
+    }
+  }
+
+  Index N_site = site_data.N_site;
+  Index N_atom = atom_type.size();
+  Index const tile = 32;
+  Eigen::MatrixXd cost_matrix(N_site, N_site);
+
+  // fill cost_matrix(site_index, atom_index) for atoms, tile by tile
+  auto fill = [&](auto const &cost) {
+    for (Index atom_begin = 0; atom_begin < N_atom; atom_begin += tile) {
+      Index atom_end = std::min(atom_begin + tile, N_atom);
+      for (Index site_begin = 0; site_begin < N_site; site_begin += tile) {
+        Index site_end = std::min(site_begin + tile, N_site);
+        for (Index atom_index = atom_begin; atom_index < atom_end;
+             ++atom_index) {
+          for (Index site_index = site_begin; site_index < site_end;
+               ++site_index) {
+            cost_matrix(site_index, atom_index) = cost(site_index, atom_index);
+          }
+        }
+      }
+    }
+  };
+
+  bool use_mask = false;
+  if constexpr (std::is_same<AtomToSiteCostF, AtomToSiteCost>::value) {
+    use_mask = !site_data.allowed_atom_type_mask.empty();
+  }
+
+  if (use_mask) {
+    std::vector<std::uint64_t> atom_mask(N_atom);
+    std::vector<char> atom_is_vacancy(N_atom);
+    for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
+      atom_mask[atom_index] = site_data.atom_type_mask(atom_type[atom_index]);
+      atom_is_vacancy[atom_index] = xtal::is_vacancy(atom_type[atom_index]);
+    }
+    std::uint64_t const *site_mask = site_data.allowed_atom_type_mask.data();
+    fill([&](Index site_index, Index atom_index) {
+      if (!(site_mask[site_index] & atom_mask[atom_index])) {
+        return infinity;
+      }
+      if (atom_is_vacancy[atom_index]) {
+        return 0.0;
+      }
+      Eigen::Vector3d const &d = site_displacements[site_index][atom_index];
+      return d.dot(d);
+    });
+  } else {
+    fill([&](Index site_index, Index atom_index) {
+      return f(site_displacements[site_index][atom_index],
+               atom_type[atom_index],
+               prim_allowed_atom_types[site_data.sublattice[site_index]],
+               infinity);
+    });
+  }
+
+  // If N_atom < N_site, treat as additional vacancies to map
+  if (N_atom < N_site) {
+    std::string const va_name("Va");
+    for (Index site_index = 0; site_index < N_site; ++site_index) {
+      cost_matrix(site_index, N_atom) =
+          f(Eigen::Vector3d::Zero(), va_name,
+            prim_allowed_atom_types[site_data.sublattice[site_index]],
+            infinity);
+    }
+    for (Index atom_index = N_atom + 1; atom_index < N_site; ++atom_index) {
+      cost_matrix.col(atom_index) = cost_matrix.col(N_atom);
+    }
+  }
+
+  return cost_matrix;
+}
+
+}  // namespace mapping_impl
+
+/// \brief Constructor, with a statically typed atom-to-site cost function
+///
+/// Equivalent to the constructor accepting an `AtomToSiteCostFunction`,
+/// but the atom-to-site cost function, which is evaluated
+/// N_supercell_site^2 times, may be inlined.
+///
+/// \param _lattice_mapping_data Lattice mapping-specific data
+/// \param _trial_translation_cart A Cartesian translation applied
+///     to atom coordinates in the ideal superstructure setting
+///     (i.e. atom_coordinate_cart_in_supercell) to bring the
+///     atoms and sites into alignment.
+/// \param _atom_to_site_cost_f A functor used to calculate
+///      the atom mapping cost to a particular site. Follows
+///     the signature of `make_atom_to_site_cost`.
+/// \param _infinity The value used in the assignment problem
+///     cost matrix when a particular assignment is not
+///     allowed.
+template <typename AtomToSiteCostF>
+AtomMappingSearchData::AtomMappingSearchData(
+    std::shared_ptr<LatticeMappingSearchData const> _lattice_mapping_data,
+    Eigen::Vector3d const &_trial_translation_cart,
+    AtomToSiteCostF const &_atom_to_site_cost_f, double _infinity)
+    : lattice_mapping_data(std::move(_lattice_mapping_data)),
+      trial_translation_cart(_trial_translation_cart),
+      site_displacements(mapping_impl::make_site_displacements(
+          lattice_mapping_data->supercell_lattice,
+          lattice_mapping_data->supercell_site_coordinate_cart,
+          lattice_mapping_data->supercell_site_data,
+          lattice_mapping_data->atom_coordinate_cart_in_supercell,
+          trial_translation_cart)),
+      cost_matrix(mapping_impl::make_cost_matrix(
+          _atom_to_site_cost_f, site_displacements,
+          lattice_mapping_data->structure_data->atom_type,
+          lattice_mapping_data->supercell_site_data,
+          lattice_mapping_data->prim_data->prim_allowed_atom_types,
+          _infinity)) {}
+
 }  // namespace mapping
 }  // namespace CASM
 
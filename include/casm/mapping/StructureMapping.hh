@@ -55,6 +55,11 @@ struct StructureMapping {
 StructureMapping interpolated_mapping(StructureMapping const &structure_mapping,
                                       double interpolation_factor);
 
+/// \brief Total order of structure mappings, for reproducible ordering
+///     of results with equal cost
+bool total_order_less(StructureMapping const &lhs,
+                      StructureMapping const &rhs);
+
 struct ScoredStructureMapping : public StructureMapping {
   ScoredStructureMapping(double _lattice_cost, double _atom_cost,
                          double _total_cost,
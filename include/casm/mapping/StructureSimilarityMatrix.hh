@@ -0,0 +1,148 @@
+#ifndef CASM_mapping_StructureSimilarityMatrix
+#define CASM_mapping_StructureSimilarityMatrix
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "casm/crystallography/SimpleStructure.hh"
+#include "casm/crystallography/SymType.hh"
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+#include "casm/mapping/ConcurrentKBestResults.hh"
+
+namespace CASM {
+
+namespace xtal {
+class BasicStructure;
+}  // namespace xtal
+
+namespace mapping {
+struct StructureMappingResults;
+
+// Note: See source file for full documentation
+
+/// \brief Parameters of a StructureSimilarityMatrix
+struct StructureSimilarityParams {
+  /// \brief Maximum parent superstructure volume, as a multiple of the
+  ///     parent structure volume
+  Index max_vol = 1;
+
+  /// \brief Similarity threshold: pairs with no mapping with total cost
+  ///     <= max_cost have infinite cost
+  double max_cost = 1e20;
+
+  /// \brief If has value, only the k_best lowest cost pairs (with
+  ///     approximate ties) have finite cost
+  std::optional<int> k_best;
+
+  double lattice_cost_weight = 0.5;
+  std::string lattice_cost_method = "isotropic_strain_cost";
+  std::string atom_cost_method = "isotropic_disp_cost";
+  double cost_tol = 1e-5;
+};
+
+/// \brief Counts of structure pairs mapped and skipped by a
+///     StructureSimilarityMatrix
+struct StructureSimilarityStatistics {
+  /// \brief Number of pairs for which a structure mapping search was done
+  Index n_mapped = 0;
+
+  /// \brief Number of pairs skipped because the number of child sites is
+  ///     not a multiple of the number of parent sites, or the volume is
+  ///     greater than `max_vol`
+  Index n_skipped_volume = 0;
+
+  /// \brief Number of pairs skipped because the compositions are not
+  ///     compatible
+  Index n_skipped_composition = 0;
+
+  /// \brief Number of pairs with cost equal to that of the reverse pair
+  Index n_mirrored = 0;
+};
+
+/// \brief One pair of a StructureSimilarityMatrix with finite cost
+struct StructureSimilarityEntry {
+  Index parent_index;
+  Index child_index;
+  double cost;
+};
+
+/// \brief Structure mapping costs between all pairs of a set of
+///     structures
+class StructureSimilarityMatrix {
+ public:
+  /// \brief Constructor, maps all pairs of structures
+  StructureSimilarityMatrix(
+      std::vector<std::shared_ptr<xtal::BasicStructure const>> _structures,
+      std::vector<std::vector<xtal::SymOp>> _factor_groups,
+      StructureSimilarityParams _params, Index n_threads = 0);
+
+  /// \brief Number of structures
+  Index size() const { return m_structures.size(); }
+
+  /// \brief Parameters
+  StructureSimilarityParams const &params() const { return m_params; }
+
+  /// \brief Minimum total mapping cost of each pair, with the parent
+  ///     structure index as row and the child structure index as column
+  Eigen::MatrixXd const &cost() const { return m_cost; }
+
+  /// \brief Pairs with finite cost
+  std::vector<StructureSimilarityEntry> sparse_cost() const;
+
+  /// \brief Find the lowest cost structure mapping for a pair
+  StructureMappingResults best_mapping(Index parent_index,
+                                       Index child_index) const;
+
+  /// \brief Counts of structure pairs mapped and skipped
+  StructureSimilarityStatistics const &statistics() const {
+    return m_statistics;
+  }
+
+ private:
+  /// \brief Volume of a pair, if the number of sites is compatible
+  std::optional<Index> _pair_vol(Index parent_index, Index child_index) const;
+
+  /// \brief Collects the lowest cost pairs, as {cost, {parent_index,
+  ///     child_index}}, from all threads
+  typedef ConcurrentKBestResults<double, std::pair<Index, Index>>
+      PairCollector;
+
+  /// \brief True if cost(i, j) is set equal to cost(j, i) instead of being
+  ///     mapped
+  bool _is_mirrored(Index i, Index j) const;
+
+  /// \brief Map all pairs with one parent, using one StrucMapper
+  void _map_row(Index parent_index, PairCollector &collector,
+                StructureSimilarityStatistics &stats);
+
+  std::vector<std::shared_ptr<xtal::BasicStructure const>> m_structures;
+  std::vector<std::vector<xtal::SymOp>> m_factor_groups;
+  StructureSimilarityParams m_params;
+
+  /// \brief Each structure as a child structure
+  std::vector<xtal::SimpleStructure> m_simple_structures;
+
+  /// \brief Number of atoms of each type of each structure, as a child
+  ///     structure
+  std::vector<std::map<std::string, Index>> m_composition;
+
+  /// \brief True if each site of the structure has one allowed occupant,
+  ///     which is not a vacancy
+  std::vector<bool> m_is_ordered;
+
+  /// \brief True if the cost methods give cost(i, j) == cost(j, i) for
+  ///     ordered structures with equal numbers of sites
+  bool m_is_symmetric;
+
+  Eigen::MatrixXd m_cost;
+  StructureSimilarityStatistics m_statistics;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CASM_mapping_assignment
+#define CASM_mapping_assignment
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+
+namespace CASM {
+namespace mapping {
+namespace assignment {
+
+/// \brief The assignment vector gives `j = assignment[i]`, where i is the
+///     "worker" (row) and j is the assigned "task" (column).
+typedef std::vector<Index> Assignment;
+
+/// \brief Assignment problem solvers
+enum class SolverType {
+  /// \brief hungarian::solve
+  hungarian,
+
+  /// \brief augmenting_path::solve
+  augmenting_path
+};
+
+/// \brief Return the name of a SolverType
+std::string to_string(SolverType solver_type);
+
+/// \brief Find the optimal solution to the assignment problem, using
+///     the specified solver
+std::pair<double, Assignment> solve(SolverType solver_type,
+                                    Eigen::MatrixXd const &cost_matrix,
+                                    double infinity = 1e20, double tol = 1e-5);
+
+/// \brief Solves the assignment problem with a chosen solver, and
+///     counts the problems solved
+///
+/// This can be used as a `murty::AssignmentMethod`. Copies share
+/// the same count.
+struct SolverMethod {
+  /// \brief Constructor
+  SolverMethod(SolverType _solver_type = SolverType::hungarian);
+
+  /// \brief The solver used
+  SolverType solver_type;
+
+  /// \brief Number of assignment problems solved
+  std::shared_ptr<std::atomic<Index>> n_solved;
+
+  /// \brief Find the optimal solution to the assignment problem
+  std::pair<double, Assignment> operator()(Eigen::MatrixXd const &cost_matrix,
+                                           double infinity = 1e20,
+                                           double tol = 1e-5) const;
+};
+
+}  // namespace assignment
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
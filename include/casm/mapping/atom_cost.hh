@@ -1,6 +1,7 @@
 #ifndef CASM_mapping_atom_cost
 #define CASM_mapping_atom_cost
 
+#include "casm/global/definitions.hh"
 #include "casm/global/eigen.hh"
 
 namespace CASM {
@@ -24,6 +25,12 @@ double make_isotropic_atom_cost(
     Eigen::Matrix3d const &prim_lattice_column_vector_matrix,
     LatticeMapping const &lattice_mapping, Eigen::MatrixXd const &displacement);
 
+/// \brief Return the "isotropic" atom cost, from the displacement moment
+double make_isotropic_atom_cost(
+    Eigen::Matrix3d const &prim_lattice_column_vector_matrix,
+    LatticeMapping const &lattice_mapping,
+    Eigen::Matrix3d const &displacement_moment, Index N_supercell_site);
+
 /// \brief Return the symmetry-preserving component of displacement
 Eigen::MatrixXd make_symmetry_preserving_displacement(
     Eigen::MatrixXd const &displacement,
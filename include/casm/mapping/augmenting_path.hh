@@ -0,0 +1,26 @@
+#ifndef CASM_mapping_augmenting_path
+#define CASM_mapping_augmenting_path
+
+#include <vector>
+
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+
+namespace CASM {
+namespace mapping {
+namespace augmenting_path {
+
+/// \brief The assignment vector gives `j = assignment[i]`, where i is the
+///     "worker" (row) and j is the assigned "task" (column).
+typedef std::vector<Index> Assignment;
+
+/// \brief Find the optimal solution to the assignment problem, using
+///     a shortest augmenting path method
+std::pair<double, Assignment> solve(Eigen::MatrixXd const &cost_matrix,
+                                    double infinity = 1e20, double tol = 1e-5);
+
+}  // namespace augmenting_path
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
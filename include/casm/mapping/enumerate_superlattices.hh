@@ -0,0 +1,82 @@
+#ifndef CASM_mapping_enumerate_superlattices
+#define CASM_mapping_enumerate_superlattices
+
+#include <map>
+#include <vector>
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+
+namespace CASM {
+namespace xtal {
+struct SymOp;
+}
+
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Return the Hermite normal form of the lattice spanned by the
+///     columns of an integer matrix
+Eigen::Matrix3l make_hermite_normal_form(
+    Eigen::Matrix<long, 3, Eigen::Dynamic> M);
+
+/// \brief Return all 3x3 integer matrices in Hermite normal form with
+///     the given determinant
+std::vector<Eigen::Matrix3l> make_hermite_normal_forms(Index vol);
+
+/// \brief Return the point group operations as integer matrices acting
+///     on the fractional coordinates of a lattice
+std::vector<Eigen::Matrix3l> make_integer_point_group(
+    xtal::Lattice const &lattice, std::vector<xtal::SymOp> const &point_group);
+
+/// \brief Enumerates symmetrically distinct superlattices for a range
+///     of volumes, sharing work between volumes
+class SuperlatticeRangeEnumerator {
+ public:
+  /// \brief Constructor
+  SuperlatticeRangeEnumerator(
+      std::vector<Eigen::Matrix3l> const &integer_point_group);
+
+  /// \brief Return the number of superlattices with the given volume,
+  ///     including symmetrically equivalent superlattices
+  Index n_superlattice(Index vol);
+
+  /// \brief Return the Hermite normal form of the transformation
+  ///     matrix of one superlattice of each orbit of superlattices
+  ///     with the given volume
+  std::vector<Eigen::Matrix3l> const &distinct_hermite_normal_forms(
+      Index vol);
+
+ private:
+  /// \brief Hermite normal forms with a prime power volume, and their
+  ///     images under the point group
+  struct PrimePowerData {
+    std::vector<Eigen::Matrix3l> hnf;
+
+    /// \brief image[g][i]: index of the Hermite normal form of
+    ///     integer_point_group[g] * hnf[i]
+    std::vector<std::vector<Index>> image;
+  };
+
+  PrimePowerData const &_prime_power_data(Index prime_power);
+
+  std::vector<Eigen::Matrix3l> m_integer_point_group;
+
+  std::map<Index, PrimePowerData> m_prime_power_data;
+
+  std::map<Index, std::vector<Eigen::Matrix3l>> m_distinct_hnf;
+};
+
+/// \brief Enumerate symmetrically distinct superlattices for a range of
+///     volumes
+std::map<Index, std::vector<xtal::Lattice>> enumerate_superlattices(
+    xtal::Lattice const &unit_lattice,
+    std::vector<xtal::SymOp> const &point_group, Index min_vol,
+    Index max_vol);
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
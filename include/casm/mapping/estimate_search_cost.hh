@@ -0,0 +1,134 @@
+#ifndef CASM_mapping_estimate_search_cost
+#define CASM_mapping_estimate_search_cost
+
+#include <vector>
+
+#include "casm/global/definitions.hh"
+#include "casm/mapping/assignment.hh"
+
+namespace CASM {
+namespace mapping {
+
+struct PrimSearchData;
+struct StructureSearchData;
+
+// Note: See source file for full documentation
+
+/// \brief Parameters of a structure mapping search, used to estimate
+///     its cost
+struct SearchCostParams {
+  /// \brief Minimum parent superstructure volume, as a multiple of the
+  ///     prim volume
+  Index min_vol = 1;
+
+  /// \brief Maximum parent superstructure volume, as a multiple of the
+  ///     prim volume
+  Index max_vol = 1;
+
+  /// \brief Range of reorientation matrix elements (1 to 4)
+  int reorientation_range = 1;
+
+  /// \brief Number of results to keep
+  int k_best = 1;
+};
+
+/// \brief Coefficients of the model used to predict search runtime
+struct SearchCostModel {
+  /// \brief Seconds per lattice mapping trial (one superlattice and
+  ///     reorientation)
+  double seconds_per_lattice_mapping_trial = 2e-7;
+
+  /// \brief Seconds per assignment problem cost matrix element
+  double seconds_per_cost_matrix_element = 2e-8;
+
+  /// \brief Seconds per assignment problem, divided by N^3
+  double seconds_per_assignment_op = 2e-9;
+};
+
+/// \brief Estimated cost of the part of a search at one superstructure
+///     volume
+struct VolumeSearchCostEstimate {
+  /// \brief Parent superstructure volume, as a multiple of the prim volume
+  Index vol = 0;
+
+  /// \brief Number of superstructure sites (equal to assignment
+  ///     problem dimension)
+  Index n_supercell_site = 0;
+
+  /// \brief True if the superstructure sites are consistent with the
+  ///     number and types of child structure atoms
+  bool is_compatible = false;
+
+  /// \brief Number of superlattices (Hermite normal form matrices)
+  Index n_superlattice = 0;
+
+  /// \brief Lower bound on the number of symmetrically distinct
+  ///     superlattices
+  Index n_canonical_superlattice = 0;
+
+  /// \brief Estimated number of lattice mapping trials (superlattice
+  ///     and reorientation combinations)
+  double n_lattice_mapping_trial = 0.0;
+
+  /// \brief Estimated number of lattice mappings used for atom mapping
+  double n_lattice_mapping = 0.0;
+
+  /// \brief Number of trial translations per lattice mapping
+  Index n_trial_translation = 0;
+
+  /// \brief Estimated number of assignment problems solved
+  double n_assignment_problem = 0.0;
+
+  /// \brief Predicted lattice mapping runtime, in seconds
+  double lattice_mapping_seconds = 0.0;
+
+  /// \brief Predicted cost matrix construction runtime, in seconds
+  double cost_matrix_seconds = 0.0;
+
+  /// \brief Predicted assignment problem runtime, in seconds
+  double assignment_seconds = 0.0;
+
+  /// \brief Predicted total runtime, in seconds
+  double total_seconds = 0.0;
+};
+
+/// \brief Estimated cost of a structure mapping search
+struct SearchCostEstimate {
+  /// \brief Number of unimodular reorientation matrices in the
+  ///     reorientation range
+  Index n_reorientation = 0;
+
+  /// \brief Estimates for each volume in [min_vol, max_vol]
+  std::vector<VolumeSearchCostEstimate> volumes;
+
+  /// \brief Estimated total number of assignment problems solved
+  double n_assignment_problem = 0.0;
+
+  /// \brief Predicted total runtime, in seconds
+  double total_seconds = 0.0;
+};
+
+/// \brief Return the number of superlattices of a 3d lattice with the
+///     given volume
+Index count_superlattices(Index vol);
+
+/// \brief Return the number of reorientation matrices with elements in
+///     the given range
+Index count_reorientations(int reorientation_range);
+
+/// \brief Estimate the cost of a structure mapping search, as an order
+///     of magnitude bound
+SearchCostEstimate estimate_search_cost(
+    PrimSearchData const &prim_data, StructureSearchData const &structure_data,
+    SearchCostParams const &params,
+    SearchCostModel const &model = SearchCostModel());
+
+/// \brief Calibrate a SearchCostModel by timing representative operations
+SearchCostModel calibrate_search_cost_model(
+    Index dim = 32, Index n_samples = 10,
+    assignment::SolverType solver_type = assignment::SolverType::hungarian);
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
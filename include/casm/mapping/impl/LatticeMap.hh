@@ -1,6 +1,9 @@
 #ifndef CASM_mapping_LatticeMap
 #define CASM_mapping_LatticeMap
 
+#include <memory>
+#include <optional>
+
 #include "casm/container/Counter.hh"
 #include "casm/crystallography/Lattice.hh"
 #include "casm/global/definitions.hh"
@@ -70,7 +73,9 @@ class LatticeMap {
              int _range, xtal::SymOpVector const &_parent_point_group,
              xtal::SymOpVector const &_child_point_group,
              double _init_better_than = 1e20,
-             bool _symmetrize_strain_cost = false, double _cost_tol = TOL);
+             bool _symmetrize_strain_cost = false, double _cost_tol = TOL,
+             std::optional<Index> _fixed_axis = std::nullopt,
+             double _vacuum_strain_weight = 0.0);
 
   /// Iterate until all possible solutions have been considered
   LatticeMap const &best_strain_mapping() const;
@@ -120,6 +125,16 @@ class LatticeMap {
   /// isotropic strain cost
   bool symmetrize_strain_cost() const { return m_symmetrize_strain_cost; }
 
+  /// \brief If has value, the index of the lattice vector that is fixed
+  /// (slab mode), and the slab strain cost is used
+  std::optional<Index> const &fixed_axis() const { return m_fixed_axis; }
+
+  /// \brief Weight of the out-of-plane strain in the slab strain cost
+  double vacuum_strain_weight() const { return m_vacuum_strain_weight; }
+
+  /// \brief Number of lattice mapping strain costs calculated
+  Index n_strain_cost() const { return m_n_strain_cost; }
+
  private:
   /// These are the original, not reduced, parent and child lattice column
   /// matrices
@@ -141,9 +156,14 @@ class LatticeMap {
   // m_range.
   int m_range;
 
-  // pointer to static list of unimodular matrices (used as N.inverse())
+  // pointer to static list of unimodular matrices (used as N.inverse()),
+  // or to m_slab_mats in slab mode
   std::vector<Eigen::Matrix3i> const *m_mvec_ptr;
 
+  // in slab mode, the unimodular matrices for which N preserves the fixed
+  // axis (shared, so that copies of LatticeMap keep m_mvec_ptr valid)
+  std::shared_ptr<std::vector<Eigen::Matrix3i> const> m_slab_mats;
+
   // parent point group matrices, in fractional coordinates
   std::vector<Eigen::Matrix3i> m_parent_fsym_mats;
 
@@ -158,9 +178,14 @@ class LatticeMap {
   bool m_symmetrize_strain_cost;
   double m_cost_tol;
 
+  // if has value, only N that preserve this lattice vector are enumerated
+  std::optional<Index> m_fixed_axis;
+  double m_vacuum_strain_weight;
+
   mutable bool m_has_current_solution;
   mutable double m_cost;
   mutable Index m_currmat;
+  mutable Index m_n_strain_cost;
   mutable DMatType m_deformation_gradient, m_N, m_dcache;
   mutable IMatType m_icache;
 
@@ -181,11 +206,32 @@ class LatticeMap {
   /// Returns true if current N matrix is the canonical equivalent
   bool _check_canonical() const;
 
+  /// Returns N for the unreduced lattices, given the current inv_mat()
+  DMatType _make_N() const;
+
   /// \brief Iterate until the next solution \f$(N, F^{N})\f$ with lattice
   /// mapping score less than `max_cost` is found.
   LatticeMap const &_next_mapping_better_than(double max_cost) const;
 };
 
+/// \brief Returns true if a transformation matrix preserves a lattice
+/// vector and the plane of the other two lattice vectors
+bool is_slab_transformation(Eigen::Matrix3d const &M, Index fixed_axis,
+                            double tol = 1e-5);
+
+/// \brief Returns the unimodular matrices used by LatticeMap as
+/// N.inverse() in slab mode
+std::vector<Eigen::Matrix3i> make_slab_unimodular_matrices(
+    Eigen::Matrix3d const &transformation_matrix_to_reduced_parent,
+    Eigen::Matrix3d const &transformation_matrix_to_reduced_child_inv,
+    int range, Index fixed_axis);
+
+/// \brief Returns the point group operations that preserve a lattice
+/// vector and the plane of the other two lattice vectors
+xtal::SymOpVector make_slab_point_group(xtal::Lattice const &lattice,
+                                        xtal::SymOpVector const &point_group,
+                                        Index fixed_axis);
+
 /// \brief Returns the volume-normalized strain cost, calculated to be
 /// invariant to which structure is the child/parent.
 double isotropic_strain_cost(Eigen::Matrix3d const &deformation_gradient);
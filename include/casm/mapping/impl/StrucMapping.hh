@@ -1,6 +1,7 @@
 #ifndef CASM_mapping_StrucMapping
 #define CASM_mapping_StrucMapping
 
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -604,6 +605,44 @@ class StrucMapper {
   bool symmetrize_lattice_cost() const { return m_symmetrize_lattice_cost; }
   bool symmetrize_atomic_cost() const { return m_symmetrize_atomic_cost; }
 
+  /// \brief Enable slab mode, in which the parent lattice vector with index
+  /// `_fixed_axis` is fixed (i.e. the non-periodic, or vacuum, direction).
+  /// Parent superlattices are only enumerated in the plane of the other two
+  /// lattice vectors, lattice reorientations must preserve the fixed axis,
+  /// and lattice mappings are scored using `slab_strain_cost`. Use
+  /// std::nullopt to disable slab mode (default).
+  void set_fixed_axis(std::optional<Index> _fixed_axis,
+                      double _vacuum_strain_weight = 0.0) {
+    m_fixed_axis = _fixed_axis;
+    m_vacuum_strain_weight = _vacuum_strain_weight;
+    m_superlat_map.clear();
+  }
+
+  /// \brief If has value, the fixed lattice vector index (slab mode)
+  std::optional<Index> const &fixed_axis() const { return m_fixed_axis; }
+
+  /// \brief Weight of the out-of-plane strain in slab mode
+  double vacuum_strain_weight() const { return m_vacuum_strain_weight; }
+
+  /// \brief If true (default), `map_deformed_struc_impose_lattice_vols`
+  /// first checks if the child lattice is an exact superlattice of the
+  /// parent lattice, and if so maps the child to that superlattice to bound
+  /// the cost of the k-best mappings before considering other lattice
+  /// mappings. The bound is only used as `max_cost` for the full search,
+  /// which still includes mappings approximately tied with the k-th best,
+  /// so the k-best mapping costs are not changed.
+  void set_ideal_lattice_bound(bool _ideal_lattice_bound) {
+    m_ideal_lattice_bound = _ideal_lattice_bound;
+  }
+
+  /// \brief If true, bound the mapping cost using the child's exact
+  /// superlattice of the parent lattice, if it exists
+  bool ideal_lattice_bound() const { return m_ideal_lattice_bound; }
+
+  /// \brief Largest number of MappingNode held in the search queue
+  /// during the most recent `map_deformed_struc_impose_lattice_vols` call
+  Index max_queue_size() const { return m_max_queue_size; }
+
   /// \brief Returns the minimum fraction of sites allowed to be vacant in the
   /// mapping relation Vacancy fraction is used to constrain the mapping
   /// supercell search, but is only used when the supercell volume cannot is not
@@ -753,6 +792,14 @@ class StrucMapper {
       xtal::SymOpVector const &child_factor_group = {
           xtal::SymOp::identity()}) const;
 
+  /// \brief construct a partial mapping node (with uninitialized
+  /// atomic_node) with zero lattice cost, if the child lattice is a
+  /// superlattice of the parent lattice with volume between min_vol and
+  /// max_vol
+  std::set<MappingNode> _seed_from_ideal_superlattice(
+      xtal::SimpleStructure const &unmapped_child, Index min_vol,
+      Index max_vol) const;
+
   ///\brief returns number of species in a SimpleStructure given the current
   /// calculator settings.
   ///       Use instead of sstruc.n_atom() for consistency
@@ -785,14 +832,23 @@ class StrucMapper {
   bool m_symmetrize_lattice_cost;
   bool m_symmetrize_atomic_cost;
 
+  std::optional<Index> m_fixed_axis;
+  double m_vacuum_strain_weight;
+
+  bool m_ideal_lattice_bound;
+
   bool m_filtered;
   LatticeFilterFunction m_filter_f;
 
+  mutable Index m_max_queue_size;
+
   /// Maps the supercell volume to a vector of Lattices with that volume
   mutable LatMapType m_superlat_map;
   mutable LatMapType m_allowed_superlat_map;
 
   std::vector<xtal::Lattice> _lattices_of_vol(Index prim_vol) const;
+
+  void _enumerate_superlattices(Index min_vol, Index max_vol) const;
 };
 
 }  // namespace mapping_impl
@@ -19,6 +19,7 @@ namespace mapping {
 struct LatticeMapping;
 struct ScoredLatticeMapping;
 struct LatticeMappingResults;
+class LatticeMappingIndex;
 struct AtomMapping;
 struct ScoredAtomMapping;
 struct AtomMappingResults;
@@ -26,6 +27,10 @@ struct StructureMapping;
 struct StructureMappingCost;
 struct ScoredStructureMapping;
 struct StructureMappingResults;
+struct PerfCounts;
+class LatencyHistogram;
+struct MapStructuresParams;
+struct MapStructuresBatchStatistics;
 }  // namespace mapping
 
 // LatticeMapping
@@ -58,6 +63,13 @@ jsonParser &to_json(mapping::LatticeMappingResults const &results,
 
 void from_json(mapping::LatticeMappingResults &results, jsonParser const &json);
 
+// LatticeMappingIndex
+
+jsonParser &to_json(mapping::LatticeMappingIndex const &index,
+                    jsonParser &json);
+
+void from_json(mapping::LatticeMappingIndex &index, jsonParser const &json);
+
 // AtomMapping
 
 jsonParser &to_json(mapping::AtomMapping const &m, jsonParser &json);
@@ -137,6 +149,27 @@ void from_json(mapping::StructureMappingResults &results,
                jsonParser const &json,
                std::shared_ptr<xtal::BasicStructure const> const &prim);
 
+// PerfCounts
+
+jsonParser &to_json(mapping::PerfCounts const &counts, jsonParser &json);
+
+// LatencyHistogram
+
+jsonParser &to_json(mapping::LatencyHistogram const &histogram,
+                    jsonParser &json);
+
+// MapStructuresParams
+
+jsonParser &to_json(mapping::MapStructuresParams const &params,
+                    jsonParser &json);
+
+void from_json(mapping::MapStructuresParams &params, jsonParser const &json);
+
+// MapStructuresBatchStatistics
+
+jsonParser &to_json(mapping::MapStructuresBatchStatistics const &statistics,
+                    jsonParser &json);
+
 }  // namespace CASM
 
 #endif
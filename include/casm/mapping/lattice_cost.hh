@@ -17,6 +17,11 @@ namespace mapping {
 /// invariant to which structure is the child/parent.
 double isotropic_strain_cost(Eigen::Matrix3d const &deformation_gradient);
 
+/// \brief Returns a lower bound on `isotropic_strain_cost`, which does
+/// not require a polar decomposition
+double isotropic_strain_cost_lower_bound(
+    Eigen::Matrix3d const &deformation_gradient);
+
 /// \brief Returns the symmetrized right stretch tensor
 Eigen::Matrix3d symmetrized_right_stretch(
     Eigen::Matrix3d const &deformation_gradient,
@@ -33,6 +38,13 @@ double symmetry_breaking_strain_cost(
     Eigen::Matrix3d const &deformation_gradient,
     std::vector<xtal::SymOp> const &lattice1_point_group);
 
+/// \brief Returns the slab strain cost, with the in-plane and out-of-plane
+/// strain components weighted separately
+double slab_strain_cost(Eigen::Matrix3d const &deformation_gradient,
+                        Eigen::Vector3d const &in_plane_vector_a,
+                        Eigen::Vector3d const &in_plane_vector_b,
+                        double vacuum_strain_weight = 0.0);
+
 }  // namespace mapping
 }  // namespace CASM
 
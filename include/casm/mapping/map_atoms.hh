@@ -1,6 +1,7 @@
 #ifndef CASM_mapping_map_atoms
 #define CASM_mapping_map_atoms
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -46,6 +47,16 @@ AtomMappingResults map_atoms(
     std::string atom_cost_method = std::string("isotropic_atom_cost"),
     int k_best = 1, double cost_tol = 1e-5);
 
+/// \brief Find atom mappings, given a shared prim
+AtomMappingResults map_atoms(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2,
+    LatticeMapping const &lattice_mapping,
+    std::vector<xtal::SymOp> prim_factor_group = std::vector<xtal::SymOp>{},
+    double min_cost = 0.0, double max_cost = 1e20,
+    std::string atom_cost_method = std::string("isotropic_atom_cost"),
+    int k_best = 1, double cost_tol = 1e-5);
+
 }  // namespace mapping
 }  // namespace CASM
 
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "casm/global/definitions.hh"
 #include "casm/global/eigen.hh"
 
 namespace CASM {
@@ -17,6 +18,7 @@ struct SymOp;
 namespace mapping {
 struct LatticeMapping;
 struct LatticeMappingResults;
+class LatticeMappingIndex;
 
 // Note: See source file for full documentation
 
@@ -29,9 +31,45 @@ LatticeMappingResults map_lattices(
     std::vector<xtal::SymOp> lattice2_point_group = std::vector<xtal::SymOp>{},
     double min_cost = 0.0, double max_cost = 1e20,
     std::string cost_method = std::string("isotropic_strain_cost"),
-    std::optional<int> k_best = std::nullopt, double cost_tol = 1e-5);
+    std::optional<int> k_best = std::nullopt, double cost_tol = 1e-5,
+    std::optional<Index> fixed_axis = std::nullopt,
+    double vacuum_strain_weight = 0.0);
+
+/// \brief Find the k-best lattice mappings, using an index of previously
+///     mapped lattices to bound the search
+LatticeMappingResults map_lattices_warm_start(
+    LatticeMappingIndex const &index, xtal::Lattice const &lattice2, int k_best,
+    std::optional<Eigen::Matrix3d> T = std::nullopt,
+    int reorientation_range = 1,
+    std::vector<xtal::SymOp> lattice2_point_group = std::vector<xtal::SymOp>{},
+    double min_cost = 0.0, double max_cost = 1e20, double cost_tol = 1e-5,
+    Index k_nearest = 1, double max_distance = 1e20);
 
 }  // namespace mapping
+
+namespace mapping_impl {
+
+/// \brief Find lattice mappings, and count the strain costs calculated
+mapping::LatticeMappingResults map_lattices(
+    xtal::Lattice const &lattice1, xtal::Lattice const &lattice2,
+    std::optional<Eigen::Matrix3d> T, int reorientation_range,
+    std::vector<xtal::SymOp> lattice1_point_group,
+    std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
+    double max_cost, std::string cost_method, std::optional<int> k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight, Index &n_strain_cost);
+
+/// \brief Find the k-best lattice mappings, using an index of previously
+///     mapped lattices to bound the search, and count the strain costs
+///     calculated
+mapping::LatticeMappingResults map_lattices_warm_start(
+    mapping::LatticeMappingIndex const &index, xtal::Lattice const &lattice2,
+    int k_best, std::optional<Eigen::Matrix3d> T, int reorientation_range,
+    std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
+    double max_cost, double cost_tol, Index k_nearest, double max_distance,
+    Index &n_strain_cost);
+
+}  // namespace mapping_impl
 }  // namespace CASM
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef CASM_mapping_map_structures
 #define CASM_mapping_map_structures
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -34,7 +35,25 @@ StructureMappingResults map_structures(
     double lattice_cost_weight = 0.5,
     std::string lattice_cost_method = std::string("isotropic_strain_cost"),
     std::string atom_cost_method = std::string("isotropic_disp_cost"),
-    int k_best = 1, double cost_tol = 1e-5);
+    int k_best = 1, double cost_tol = 1e-5,
+    std::optional<Index> fixed_axis = std::nullopt,
+    double vacuum_strain_weight = 0.0);
+
+/// \brief Find structure mappings, given a range of parent superstructure
+/// volumes, sharing the prim with the results
+StructureMappingResults map_structures(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2, Index max_vol,
+    std::vector<xtal::SymOp> prim_factor_group = std::vector<xtal::SymOp>{},
+    std::vector<xtal::SymOp> structure2_factor_group =
+        std::vector<xtal::SymOp>{},
+    Index min_vol = 1, double min_cost = 0.0, double max_cost = 1e20,
+    double lattice_cost_weight = 0.5,
+    std::string lattice_cost_method = std::string("isotropic_strain_cost"),
+    std::string atom_cost_method = std::string("isotropic_disp_cost"),
+    int k_best = 1, double cost_tol = 1e-5,
+    std::optional<Index> fixed_axis = std::nullopt,
+    double vacuum_strain_weight = 0.0);
 
 /// \brief Find structure mappings, given a range of parent superstructure
 /// volumes
@@ -0,0 +1,99 @@
+#ifndef CASM_mapping_map_structures_batch
+#define CASM_mapping_map_structures_batch
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "casm/crystallography/SymType.hh"
+#include "casm/global/definitions.hh"
+#include "casm/mapping/LatencyHistogram.hh"
+#include "casm/mapping/perf_counters.hh"
+
+namespace CASM {
+
+namespace xtal {
+class BasicStructure;
+class SimpleStructure;
+}  // namespace xtal
+
+namespace mapping {
+struct StructureMappingResults;
+
+// Note: See source file for full documentation
+
+/// \brief Parameters of `map_structures` shared by all structures in a
+///     batch (structure factor groups are not used)
+struct MapStructuresParams {
+  Index max_vol = 1;
+  std::vector<xtal::SymOp> prim_factor_group;
+  Index min_vol = 1;
+  double min_cost = 0.0;
+  double max_cost = 1e20;
+  double lattice_cost_weight = 0.5;
+  std::string lattice_cost_method = "isotropic_strain_cost";
+  std::string atom_cost_method = "isotropic_disp_cost";
+  int k_best = 1;
+  double cost_tol = 1e-5;
+  std::optional<Index> fixed_axis;
+  double vacuum_strain_weight = 0.0;
+};
+
+/// \brief Thresholds for writing slow structures to replayable JSON
+///     files
+struct SlowInputCapture {
+  /// \brief If has value, capture structures that take at least this
+  ///     many seconds to map
+  std::optional<double> min_seconds;
+
+  /// \brief If has value, capture structures for which the mapping
+  ///     search queue holds at least this many mapping nodes
+  std::optional<Index> min_queue_size;
+
+  /// \brief Directory where files are written
+  std::string dir = ".";
+
+  /// \brief Prefix of written file names
+  std::string prefix = "slow_input";
+
+  /// \brief Maximum number of structures captured
+  Index max_n_capture = 100;
+};
+
+/// \brief Per-structure latency and search statistics of batch
+///     structure mapping
+struct MapStructuresBatchStatistics {
+  /// \brief Number of structures mapped
+  Index n_structure = 0;
+
+  /// \brief Histogram of the time taken to map each structure
+  LatencyHistogram latency;
+
+  /// \brief Largest mapping search queue size, over all structures
+  Index max_queue_size = 0;
+
+  /// \brief Total hardware performance counts, over all structures
+  PerfCounts total;
+
+  /// \brief Paths of files written for captured slow structures
+  std::vector<std::string> slow_input_paths;
+};
+
+/// \brief Find structure mappings for each of a batch of structures,
+///     recording per-structure latency and capturing slow structures
+std::vector<StructureMappingResults> map_structures_batch(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    std::vector<xtal::SimpleStructure> const &structures,
+    MapStructuresParams const &params,
+    MapStructuresBatchStatistics &statistics,
+    SlowInputCapture const &capture = SlowInputCapture());
+
+/// \brief Map a structure captured by `map_structures_batch` again
+StructureMappingResults replay_slow_input(
+    std::string const &path, MapStructuresBatchStatistics &statistics);
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
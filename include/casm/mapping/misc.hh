@@ -1,9 +1,12 @@
 #ifndef CASM_mapping_misc
 #define CASM_mapping_misc
 
+#include <algorithm>
 #include <map>
 #include <optional>
 
+#include "casm/global/eigen.hh"
+
 namespace CASM {
 namespace mapping {
 
@@ -53,6 +56,26 @@ void maintain_k_best_results(std::optional<int> const &k_best, double cost_tol,
   }
 }
 
+/// \brief Compare matrices by shape, then lexicographically by
+///     element, in storage order
+///
+/// Elements are compared exactly, so that this can be used to order
+/// results reproducibly.
+template <typename Derived>
+bool matrix_lexicographical_less(Eigen::DenseBase<Derived> const &lhs,
+                                 Eigen::DenseBase<Derived> const &rhs) {
+  if (lhs.rows() != rhs.rows()) {
+    return lhs.rows() < rhs.rows();
+  }
+  if (lhs.cols() != rhs.cols()) {
+    return lhs.cols() < rhs.cols();
+  }
+  auto const &A = lhs.derived().eval();
+  auto const &B = rhs.derived().eval();
+  return std::lexicographical_compare(A.data(), A.data() + A.size(),
+                                      B.data(), B.data() + B.size());
+}
+
 }  // namespace mapping
 }  // namespace CASM
 
@@ -90,6 +90,9 @@ Node make_node(Eigen::MatrixXd const &cost_matrix,
 /// \brief Returns the full assignment
 Assignment make_assignment(Node const &node);
 
+/// \brief Write the full assignment to an existing vector
+void make_assignment(Node const &node, Assignment &assignment);
+
 /// \brief Return the cost for a particular assignment
 double make_cost(Eigen::MatrixXd const &cost_matrix,
                  Assignment const &assignment);
@@ -99,6 +102,15 @@ void partition(std::multiset<Node> &node_set, AssignmentMethod assign_f,
                Eigen::MatrixXd const &cost_matrix, Node const &node,
                double infinity, double tol);
 
+/// \brief Check if the assignment problem, given certain assignments
+///    forced on and certain assignments forced off, has a solution that
+///    only includes assignments with cost less than infinity
+bool is_feasible(Eigen::MatrixXd const &cost_matrix,
+                 std::set<Index> const &unassigned_rows,
+                 std::set<Index> const &unassigned_cols,
+                 std::vector<std::pair<Index, Index>> const &forced_off,
+                 double infinity);
+
 /// \brief Solve the assignment problem given certain assignments
 ///    forced on and certain assignments forced off
 std::pair<double, std::map<Index, Index>> make_sub_assignment(
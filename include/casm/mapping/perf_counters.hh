@@ -0,0 +1,110 @@
+#ifndef CASM_mapping_perf_counters
+#define CASM_mapping_perf_counters
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "casm/global/definitions.hh"
+
+namespace CASM {
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Hardware performance counts and elapsed time for a measured
+///     phase
+///
+/// Counts are std::nullopt if the counter is not available (for
+/// example, if `perf_event_open` is not permitted in a container).
+struct PerfCounts {
+  /// \brief Elapsed wall time, in seconds
+  double seconds = 0.0;
+
+  /// \brief CPU cycles
+  std::optional<double> cycles;
+
+  /// \brief Instructions retired
+  std::optional<double> instructions;
+
+  /// \brief L1 data cache read misses
+  std::optional<double> l1d_read_misses;
+
+  /// \brief Last level cache misses
+  std::optional<double> llc_misses;
+
+  /// \brief Branch mispredictions
+  std::optional<double> branch_misses;
+
+  /// \brief Instructions per cycle, if available
+  std::optional<double> ipc() const;
+
+  /// \brief Add counts from another measurement
+  PerfCounts &operator+=(PerfCounts const &other);
+};
+
+/// \brief Return per-element counts (i.e. per cost matrix element)
+PerfCounts per_element(PerfCounts const &counts, double n_element);
+
+/// \brief Measures hardware performance counters for the calling
+///     thread (and threads it creates) using `perf_event_open`
+class PerfCounters {
+ public:
+  /// \brief Constructor, opens the counters
+  PerfCounters();
+
+  /// \brief Destructor, closes the counters
+  ~PerfCounters();
+
+  PerfCounters(PerfCounters const &) = delete;
+  PerfCounters &operator=(PerfCounters const &) = delete;
+
+  /// \brief True if any hardware counter is available
+  bool is_available() const;
+
+  /// \brief Reset and start counting
+  void start();
+
+  /// \brief Stop counting and return the counts since `start`
+  PerfCounts stop();
+
+ private:
+  static constexpr int n_counter = 5;
+
+  std::array<int, n_counter> m_fd;
+
+  double m_begin;
+};
+
+/// \brief Accumulates PerfCounts for the lifetime of the object
+///
+/// Example, measuring a complete `map_structures` call:
+///
+///     PerfCounts counts;
+///     {
+///       ScopedPerfCounters scoped(counts);
+///       results = map_structures(prim, structure, ...);
+///     }
+///
+class ScopedPerfCounters {
+ public:
+  /// \brief Constructor, starts counting
+  ScopedPerfCounters(PerfCounts &_counts);
+
+  /// \brief Destructor, stops counting and adds to `counts`
+  ~ScopedPerfCounters();
+
+  ScopedPerfCounters(ScopedPerfCounters const &) = delete;
+  ScopedPerfCounters &operator=(ScopedPerfCounters const &) = delete;
+
+ private:
+  PerfCounts &m_counts;
+
+  PerfCounters m_counters;
+};
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef CASM_mapping_synthetic_structure
+#define CASM_mapping_synthetic_structure
+
+#include <cstdint>
+#include <memory>
+
+#include "casm/crystallography/SimpleStructure.hh"
+#include "casm/global/definitions.hh"
+#include "casm/global/eigen.hh"
+#include "casm/mapping/StructureMapping.hh"
+
+namespace CASM {
+namespace xtal {
+class BasicStructure;
+}  // namespace xtal
+
+namespace mapping {
+
+// Note: See source file for full documentation
+
+/// \brief Parameters controlling synthetic structure generation
+struct SyntheticStructureParams {
+  /// \brief Supercell of the prim, S = P * T
+  Eigen::Matrix3l transformation_matrix_to_super =
+      Eigen::Matrix3l::Identity();
+
+  /// \brief Magnitude of random symmetric strain, as the standard
+  ///     deviation of the elements of the Biot strain, U - I
+  double strain_magnitude = 0.0;
+
+  /// \brief Standard deviation of random atomic displacement components
+  double displacement_magnitude = 0.0;
+
+  /// \brief Probability that a site which allows vacancies is vacant
+  double vacancy_fraction = 0.0;
+
+  /// \brief Probability that an occupied site is occupied by an atom type
+  ///     other than its first allowed atom type
+  double antisite_fraction = 0.0;
+
+  /// \brief If true, apply a uniformly random rigid rotation
+  bool random_rotation = false;
+
+  /// \brief If true, randomly shuffle the order of atoms
+  bool shuffle_atoms = true;
+
+  /// \brief If true, apply a random rigid translation
+  bool random_translation = true;
+};
+
+/// \brief A synthetic child structure and the known structure mapping
+///     that generated it
+struct SyntheticStructure {
+  SyntheticStructure(xtal::SimpleStructure const &_structure,
+                     StructureMapping const &_structure_mapping)
+      : structure(_structure), structure_mapping(_structure_mapping) {}
+
+  /// \brief The generated child structure
+  xtal::SimpleStructure structure;
+
+  /// \brief The structure mapping, from the prim to `structure`, used to
+  ///     generate it
+  StructureMapping structure_mapping;
+};
+
+/// \brief Generate a child structure with a known mapping to the prim
+SyntheticStructure make_synthetic_structure(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    SyntheticStructureParams const &params, std::uint64_t seed);
+
+}  // namespace mapping
+}  // namespace CASM
+
+#endif
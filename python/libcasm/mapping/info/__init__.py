@@ -13,5 +13,6 @@ from ._mapping_info import (
     has_same_prim,
     isotropic_strain_cost,
     pretty_json,
+    slab_strain_cost,
     symmetry_breaking_strain_cost,
 )
@@ -10,6 +10,9 @@ from ._mapping_mapsearch import (
     StructureSearchData,
     SymmetryBreakingAtomCost,
     WeightedTotalCost,
+    calibrate_search_cost_model,
+    enumerate_superlattices,
+    estimate_search_cost,
     make_atom_to_site_cost,
     make_superstructure_data,
     make_trial_translations,
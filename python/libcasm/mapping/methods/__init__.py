@@ -1,10 +1,19 @@
 """Easy-to-use mapping methods"""
 from ._mapping_methods import (
+    BlockCompressedReader,
+    BlockCompressedWriter,
+    LatticeMappingIndex,
+    PerfCounters,
+    StructureSimilarityMatrix,
     make_mapped_lattice,
     make_mapped_structure,
+    make_synthetic_structure,
     map_atoms,
     map_lattices,
+    map_lattices_warm_start,
     map_structures,
+    map_structures_batch,
+    replay_slow_input,
 )
 from ._methods import (
     map_lattices_without_reorientation,
@@ -808,6 +808,40 @@ PYBIND11_MODULE(_mapping_info, m) {
       )pbdoc",
         py::arg("deformation_gradient"), py::arg("lattice1_point_group"));
 
+  m.def("slab_strain_cost", &slab_strain_cost, R"pbdoc(
+      Return the slab strain cost for a lattice deformation.
+
+      The slab strain cost is used for slabs and 2d materials, for which one
+      lattice vector is not periodic (i.e. spans a vacuum region) or is fixed
+      by construction. It is the sum of an area-normalized, isotropic strain
+      cost of the plane spanned by the two in-plane parent lattice vectors, and
+      `vacuum_strain_weight` times a cost for the remaining components of the
+      Biot strain, which include strain along the fixed direction.
+
+      Parameters
+      ----------
+      deformation_gradient : array_like, shape=(3,3)
+          The parent-to-child deformation gradient tensor, :math:`F`, a shape=(3,3)
+          matrix.
+      in_plane_vector_a : array_like, shape=(3,)
+          The first in-plane (i.e. periodic) parent lattice vector.
+      in_plane_vector_b : array_like, shape=(3,)
+          The second in-plane parent lattice vector. The plane normal is
+          the normalized cross product of `in_plane_vector_a` and
+          `in_plane_vector_b`, so the fixed lattice vector need not be
+          perpendicular to the plane.
+      vacuum_strain_weight : float, default=0.0
+          The weight of the out-of-plane strain cost. If 0.0, strain along
+          the fixed direction is ignored.
+
+      Returns
+      -------
+      cost: float
+          The slab strain cost for the lattice deformation given by :math:`F`.
+      )pbdoc",
+        py::arg("deformation_gradient"), py::arg("in_plane_vector_a"),
+        py::arg("in_plane_vector_b"), py::arg("vacuum_strain_weight") = 0.0);
+
 #ifdef VERSION_INFO
   m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
 #else
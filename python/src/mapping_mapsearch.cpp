@@ -1,5 +1,6 @@
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -12,6 +13,8 @@
 #include "casm/mapping/LatticeMapping.hh"
 #include "casm/mapping/MappingSearch.hh"
 #include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/enumerate_superlattices.hh"
+#include "casm/mapping/estimate_search_cost.hh"
 #include "casm/mapping/io/json_io.hh"
 #include "pybind11_json/pybind11_json.hpp"
 
@@ -26,39 +29,153 @@ namespace CASMpy {
 using namespace CASM;
 using namespace CASM::mapping;
 
+/// \brief Python array-level atom-to-site cost function, called as
+///     `f(displacement, atom_type_index, site_allowed, atom_type_names,
+///     infinity)`, with `displacement` of shape=(N_site, N_atom, 3)
+typedef std::function<Eigen::MatrixXd(
+    py::array_t<double> displacement, Eigen::VectorXi const &atom_type_index,
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> const &site_allowed,
+    std::vector<std::string> const &atom_type_names, double infinity)>
+    PyAtomToSiteCostMatrixFunction;
+
+/// \brief Make an atom-to-site cost function that calculates the cost
+///     matrix with one call of a Python function
+AtomToSiteCostFunction make_atom_to_site_cost_matrix_f(
+    PyAtomToSiteCostMatrixFunction f) {
+  return AtomToSiteCostMatrix(
+      [f](AtomToSiteCostBatch const &batch, double infinity) {
+        // the GIL is acquired once per cost matrix
+        py::gil_scoped_acquire acquire;
+        py::array_t<double> displacement(
+            {py::ssize_t(batch.N_site), py::ssize_t(batch.N_atom),
+             py::ssize_t(3)});
+        std::copy(batch.displacement.data(),
+                  batch.displacement.data() + batch.displacement.size(),
+                  displacement.mutable_data());
+        return f(displacement, batch.atom_type_index, batch.site_allowed,
+                 batch.atom_type_names, infinity);
+      });
+}
+
+/// \brief Choose the atom-to-site cost function from the
+///     per-element or array-level Python arguments
+AtomToSiteCostFunction make_atom_to_site_cost_f(
+    std::optional<AtomToSiteCostFunction> atom_to_site_cost_f,
+    std::optional<PyAtomToSiteCostMatrixFunction> atom_to_site_cost_matrix_f) {
+  if (atom_to_site_cost_f && atom_to_site_cost_matrix_f) {
+    throw std::runtime_error(
+        "Error: only one of atom_to_site_cost_f and "
+        "atom_to_site_cost_matrix_f may be provided");
+  }
+  if (atom_to_site_cost_matrix_f) {
+    return make_atom_to_site_cost_matrix_f(atom_to_site_cost_matrix_f.value());
+  }
+  if (atom_to_site_cost_f) {
+    return atom_to_site_cost_f.value();
+  }
+  return AtomToSiteCostFunction(make_atom_to_site_cost);
+}
+
 MappingSearch make_MappingSearch(
     double _min_cost, double _max_cost, int _k_best,
     std::optional<AtomCostFunction> _atom_cost_f,
     std::optional<TotalCostFunction> _total_cost_f,
     std::optional<AtomToSiteCostFunction> _atom_to_site_cost_f,
-    bool _enable_remove_mean_displacement, double _infinity, double _cost_tol) {
+    bool _enable_remove_mean_displacement, double _infinity, double _cost_tol,
+    bool _enable_duplicate_elimination,
+    std::optional<BatchAtomCostFunction> _batch_atom_cost_f,
+    std::optional<PyAtomToSiteCostMatrixFunction> _atom_to_site_cost_matrix_f,
+    bool _enable_structure_symmetry_reduction) {
+  if (_atom_cost_f && _batch_atom_cost_f) {
+    throw std::runtime_error(
+        "Error constructing MappingSearch: only one of atom_cost_f and "
+        "batch_atom_cost_f may be provided");
+  }
+  if (_batch_atom_cost_f) {
+    _atom_cost_f = BatchAtomCost(_batch_atom_cost_f.value());
+  }
   if (!_atom_cost_f) {
     _atom_cost_f = IsotropicAtomCost();
   }
   if (!_total_cost_f) {
     _total_cost_f = WeightedTotalCost(0.5);
   }
-  if (!_atom_to_site_cost_f) {
-    _atom_to_site_cost_f = AtomToSiteCostFunction(make_atom_to_site_cost);
-  }
-  return MappingSearch(_min_cost, _max_cost, _k_best, _atom_cost_f.value(),
-                       _total_cost_f.value(), _atom_to_site_cost_f.value(),
-                       _enable_remove_mean_displacement, _infinity, _cost_tol);
+  return MappingSearch(
+      _min_cost, _max_cost, _k_best, _atom_cost_f.value(),
+      _total_cost_f.value(),
+      make_atom_to_site_cost_f(_atom_to_site_cost_f,
+                               _atom_to_site_cost_matrix_f),
+      _enable_remove_mean_displacement, _infinity, _cost_tol,
+      _enable_duplicate_elimination, _enable_structure_symmetry_reduction);
 }
 
 std::shared_ptr<AtomMappingSearchData> make_AtomMappingSearchData(
     std::shared_ptr<LatticeMappingSearchData const> lattice_mapping_data,
     Eigen::Vector3d const &trial_translation_cart,
     std::optional<AtomToSiteCostFunction> atom_to_site_cost_f,
-    double infinity) {
-  if (!atom_to_site_cost_f) {
-    atom_to_site_cost_f = AtomToSiteCostFunction(make_atom_to_site_cost);
-  }
+    double infinity,
+    std::optional<PyAtomToSiteCostMatrixFunction> atom_to_site_cost_matrix_f) {
   return std::make_shared<AtomMappingSearchData>(
-      lattice_mapping_data, trial_translation_cart, atom_to_site_cost_f.value(),
+      lattice_mapping_data, trial_translation_cart,
+      make_atom_to_site_cost_f(atom_to_site_cost_f,
+                               atom_to_site_cost_matrix_f),
       infinity);
 }
 
+py::dict search_cost_model_to_dict(SearchCostModel const &model) {
+  py::dict d;
+  d["seconds_per_lattice_mapping_trial"] =
+      model.seconds_per_lattice_mapping_trial;
+  d["seconds_per_cost_matrix_element"] = model.seconds_per_cost_matrix_element;
+  d["seconds_per_assignment_op"] = model.seconds_per_assignment_op;
+  return d;
+}
+
+SearchCostModel search_cost_model_from_dict(py::dict const &d) {
+  SearchCostModel model;
+  if (d.contains("seconds_per_lattice_mapping_trial")) {
+    model.seconds_per_lattice_mapping_trial =
+        d["seconds_per_lattice_mapping_trial"].cast<double>();
+  }
+  if (d.contains("seconds_per_cost_matrix_element")) {
+    model.seconds_per_cost_matrix_element =
+        d["seconds_per_cost_matrix_element"].cast<double>();
+  }
+  if (d.contains("seconds_per_assignment_op")) {
+    model.seconds_per_assignment_op =
+        d["seconds_per_assignment_op"].cast<double>();
+  }
+  return model;
+}
+
+py::dict search_cost_estimate_to_dict(
+    SearchCostEstimate const &estimate) {
+  py::list volumes;
+  for (auto const &v : estimate.volumes) {
+    py::dict x;
+    x["vol"] = v.vol;
+    x["n_supercell_site"] = v.n_supercell_site;
+    x["is_compatible"] = v.is_compatible;
+    x["n_superlattice"] = v.n_superlattice;
+    x["n_canonical_superlattice"] = v.n_canonical_superlattice;
+    x["n_lattice_mapping_trial"] = v.n_lattice_mapping_trial;
+    x["n_lattice_mapping"] = v.n_lattice_mapping;
+    x["n_trial_translation"] = v.n_trial_translation;
+    x["n_assignment_problem"] = v.n_assignment_problem;
+    x["lattice_mapping_seconds"] = v.lattice_mapping_seconds;
+    x["cost_matrix_seconds"] = v.cost_matrix_seconds;
+    x["assignment_seconds"] = v.assignment_seconds;
+    x["total_seconds"] = v.total_seconds;
+    volumes.append(x);
+  }
+  py::dict d;
+  d["n_reorientation"] = estimate.n_reorientation;
+  d["volumes"] = volumes;
+  d["n_assignment_problem"] = estimate.n_assignment_problem;
+  d["total_seconds"] = estimate.total_seconds;
+  return d;
+}
+
 }  // namespace CASMpy
 
 PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>);
@@ -112,7 +229,11 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
               If symmetry_breaking_atom_cost is intended to be used, setting
               this to true will generate the symmetry-invariant displacement
               modes required for the calculation using this object's
-              prim_factor_group.
+              prim_factor_group, when they are first requested.
+
+          The prim factor group, crystal point group, and symmetry-invariant
+          displacement modes are generated when first requested, not by the
+          constructor.
           )pbdoc")
       .def(
           "prim", [](PrimSearchData const &m) { return m.prim; },
@@ -146,8 +267,12 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
           "symmetrically equivalent lattice mappings.")
       .def(
           "prim_sym_invariant_displacement_modes",
-          [](PrimSearchData const &m) {
-            return m.prim_sym_invariant_displacement_modes;
+          [](PrimSearchData const &m)
+              -> std::optional<std::vector<Eigen::MatrixXd>> {
+            if (!m.prim_sym_invariant_displacement_modes.has_value()) {
+              return std::nullopt;
+            }
+            return *m.prim_sym_invariant_displacement_modes;
           },
           "Returns a size=N_mode vector with shape=(3,N_prim_site) matrices, "
           "giving the symmetry invariant displacement modes. Columns of the "
@@ -400,6 +525,7 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
 
   m.def("make_trial_translations", &make_trial_translations,
         py::arg("lattice_mapping_data"),
+        py::arg("structure_symmetry_reduction") = false,
         R"pbdoc(
         Returns translations that bring atoms into registry with ideal \
         superstructure sites.
@@ -413,10 +539,30 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
         description of how the trial translation is used when finding an
         atom mapping and associated displacements.
 
+        Translations that are equivalent up to a prim internal translation
+        are skipped. If `structure_symmetry_reduction` is True, translations
+        that are equivalent up to a combination of a prim internal translation
+        and an internal translation of the structure being mapped are also
+        skipped. The structure mappings found using the skipped translations
+        are equivalent under the structure's symmetry and have the same
+        costs, so they are only needed if all structure mappings, rather
+        than one of each set of equivalents, are required.
+
+        The skipped mappings are not reconstructed; to obtain them, call
+        again with `structure_symmetry_reduction` False. The option is used
+        by
+        :func:`~libcasm.mapping.mapsearch.MappingSearch.make_and_insert_mapping_nodes`
+        if the MappingSearch was constructed with
+        `enable_structure_symmetry_reduction` True. It is not used by
+        :func:`~libcasm.mapping.methods.map_structures`.
+
         Parameters
         ----------
         lattice_mapping_data : libcasm.mapping.mapsearch.LatticeMappingSearchData
             Data describing a lattice mapping between a prim and a structure
+        structure_symmetry_reduction : bool = False
+            If True, also skip translations that are equivalent under the
+            internal translations of the structure being mapped.
 
         Returns
         -------
@@ -427,6 +573,41 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
             superstructure of the prim they are being mapped to.
         )pbdoc");
 
+  m.def("enumerate_superlattices", &enumerate_superlattices,
+        py::arg("unit_lattice"), py::arg("point_group"), py::arg("min_vol"),
+        py::arg("max_vol"),
+        R"pbdoc(
+        Enumerate symmetrically distinct superlattices for a range of volumes
+
+        Superlattices with volume n are constructed from superlattices with
+        prime power volumes, whose enumeration and symmetry analysis is
+        shared between all volumes in the range. This is faster than
+        enumerating superlattices one volume at a time, for example to
+        generate the lattice mappings for a custom
+        :class:`~libcasm.mapping.mapsearch.MappingSearch`.
+
+        Parameters
+        ----------
+        unit_lattice : libcasm.xtal.Lattice
+            The lattice, :math:`L`, whose superlattices are enumerated.
+        point_group : List[libcasm.xtal.SymOp]
+            The point group of `unit_lattice`, used to skip symmetrically
+            equivalent superlattices.
+        min_vol : int
+            The minimum superlattice volume, as a multiple of the unit
+            lattice volume. Must be >= 1.
+        max_vol : int
+            The maximum superlattice volume, as a multiple of the unit
+            lattice volume. Must be >= `min_vol`.
+
+        Returns
+        -------
+        superlattices : Dict[int, List[libcasm.xtal.Lattice]]
+            For each volume, one superlattice, :math:`L H`, of each orbit
+            of symmetrically equivalent superlattices, where :math:`H` is
+            an integer matrix in Hermite normal form.
+        )pbdoc");
+
   m.def("make_atom_to_site_cost", &make_atom_to_site_cost,
         py::arg("displacement"), py::arg("atom_type"),
         py::arg("allowed_atom_types"), py::arg("infinity"),
@@ -505,7 +686,8 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
       .def(py::init<>(&make_AtomMappingSearchData),
            py::arg("lattice_mapping_data"), py::arg("trial_translation_cart"),
            py::arg("atom_to_site_cost_f") = std::nullopt,
-           py::arg("infinity") = 1e20, R"pbdoc(
+           py::arg("infinity") = 1e20,
+           py::arg("atom_to_site_cost_matrix_f") = std::nullopt, R"pbdoc(
           .. rubric:: Constructor
 
           Parameters
@@ -526,6 +708,21 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
               is the default method.
           infinity : float, default=1e20
               The value to use for the cost of unallowed mappings.
+          atom_to_site_cost_matrix_f : Optional[Callable[[numpy.ndarray[numpy.float64[N_site, N_atom, 3]], numpy.ndarray[numpy.int32[N_atom]], numpy.ndarray[numpy.bool[N_site, N_type]], List[str], float], numpy.ndarray[numpy.float64[N_site, N_atom]]]] = None
+              An alternative to `atom_to_site_cost_f`, which calculates the
+              cost of mapping all atoms to all sites with one call, as
+              ``f(displacement, atom_type_index, site_allowed,
+              atom_type_names, infinity)``, where `displacement[i, j, :]` is
+              the displacement from site `i` to atom `j`,
+              `atom_type_names[atom_type_index[j]]` is the type of atom `j`,
+              and `site_allowed[i, k]` is True if `atom_type_names[k]` is
+              allowed on site `i`. It returns the cost matrix, with
+              `cost[i, j]` the cost of mapping atom `j` to site `i`. If there
+              are fewer atoms than sites, the last atom is an implicit
+              vacancy, named "Va", with zero displacement, and its cost is
+              used for all additional vacancies. Only one of
+              `atom_to_site_cost_f` and `atom_to_site_cost_matrix_f` may be
+              provided.
           )pbdoc")
       .def(
           "lattice_mapping_data",
@@ -846,7 +1043,15 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
           "atom_mapping_data",
           [](MappingNode const &m) { return m.atom_mapping_data; },
           "Returns the search data for a particular lattice mapping and choice "
-          "of trial translation between a prim and the structure being mapped.")
+          "of trial translation between a prim and the structure being mapped. "
+          "Returns None if the MappingNode was constructed by a MappingSearch "
+          "with the atom mapping data cache enabled.")
+      .def(
+          "trial_translation_cart",
+          [](MappingNode const &m) -> Eigen::Vector3d {
+            return m.trial_translation_cart;
+          },
+          "Returns the trial translation, as a Cartesian vector.")
       .def(
           "atom_mapping", [](MappingNode const &m) { return m.atom_mapping; },
           "Returns the atom mapping transformation.")
@@ -903,6 +1108,10 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
            py::arg("atom_to_site_cost_f") = std::nullopt,
            py::arg("enable_remove_mean_displacement") = true,
            py::arg("infinity") = 1e20, py::arg("cost_tol") = 1e-5,
+           py::arg("enable_duplicate_elimination") = false,
+           py::arg("batch_atom_cost_f") = std::nullopt,
+           py::arg("atom_to_site_cost_matrix_f") = std::nullopt,
+           py::arg("enable_structure_symmetry_reduction") = false,
            R"pbdoc(
           .. rubric:: Constructor
 
@@ -955,6 +1164,46 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
               unallowed atom-to-site mappings.
           cost_tol : float, default=1e-5
               Tolerance for checking if mapping costs are approximately equal.
+          enable_duplicate_elimination : bool, default=False
+              If true, mapping solutions that have the same supercell,
+              permutation, and translation (up to a supercell lattice
+              translation) as a mapping solution in the search queue or
+              results are not inserted into the search queue or results, so
+              their sub-optimal assignments are not searched twice. The
+              keys used to detect duplicates are only kept while a mapping
+              solution is queued or in the results. The number of
+              duplicates found is available from
+              :func:`~libcasm.mapping.mapsearch.MappingSearch.statistics`.
+          batch_atom_cost_f : Optional[Callable[[LatticeMappingSearchData, AtomMappingSearchData, List[libcasm.mapping.info.AtomMapping]], numpy.ndarray[numpy.float64[n]]]] = None
+              An alternative to `atom_cost_f`, which calculates the atom
+              mapping costs of a batch of atom mappings, with the same
+              lattice mapping and trial translation, with one call. It
+              returns an array with the atom cost of each atom mapping.
+              :func:`~libcasm.mapping.mapsearch.MappingSearch.partition`
+              calls it once for all the sub-optimal assignments it makes.
+              Only one of `atom_cost_f` and `batch_atom_cost_f` may be
+              provided.
+          atom_to_site_cost_matrix_f : Optional[Callable[[numpy.ndarray[numpy.float64[N_site, N_atom, 3]], numpy.ndarray[numpy.int32[N_atom]], numpy.ndarray[numpy.bool[N_site, N_type]], List[str], float], numpy.ndarray[numpy.float64[N_site, N_atom]]]] = None
+              An alternative to `atom_to_site_cost_f`, which calculates the
+              cost of mapping all atoms to all sites with one call, as
+              ``f(displacement, atom_type_index, site_allowed,
+              atom_type_names, infinity)``, where `displacement[i, j, :]` is
+              the displacement from site `i` to atom `j`,
+              `atom_type_names[atom_type_index[j]]` is the type of atom `j`,
+              and `site_allowed[i, k]` is True if `atom_type_names[k]` is
+              allowed on site `i`. It returns the cost matrix, with
+              `cost[i, j]` the cost of mapping atom `j` to site `i`. If there
+              are fewer atoms than sites, the last atom is an implicit
+              vacancy, named "Va", with zero displacement, and its cost is
+              used for all additional vacancies. Only one of
+              `atom_to_site_cost_f` and `atom_to_site_cost_matrix_f` may be
+              provided.
+          enable_structure_symmetry_reduction : bool, default=False
+              If true,
+              :func:`~libcasm.mapping.mapsearch.MappingSearch.make_and_insert_mapping_nodes`
+              skips trial translations that are equivalent under the
+              internal translations of the structure being mapped. See
+              :func:`~libcasm.mapping.mapsearch.make_trial_translations`.
           )pbdoc")
       .def_readonly("min_cost", &MappingSearch::min_cost,
                     "float: Keep mappings with total cost >= min_cost.")
@@ -982,6 +1231,121 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
       .def("pop_back", &MappingSearch::pop_back,
            "Erase the highest cost MappingNode in the queue.")
       .def("size", &MappingSearch::size, "Returns the current queue size.")
+      .def("enable_queue_spill", &MappingSearch::enable_queue_spill,
+           py::arg("max_queue_memory_size"),
+           py::arg("spill_path") = std::optional<std::string>(),
+           R"pbdoc(
+          Hold the highest cost part of the queue in a temporary file
+
+          When the number of MappingNode held in memory exceeds
+          `max_queue_memory_size`, at the beginning of
+          :func:`~libcasm.mapping.mapsearch.MappingSearch.make_and_insert_mapping_node`
+          or :func:`~libcasm.mapping.mapsearch.MappingSearch.partition`, the
+          highest cost MappingNode are written to a spill file in compact
+          form, and they are reloaded in order when the lowest cost
+          MappingNode have been searched. The queue order is the same as if
+          all MappingNode were held in memory, so search results are
+          identical.
+
+          Spill volume and I/O time are included in
+          :func:`~libcasm.mapping.mapsearch.MappingSearch.statistics`.
+
+          Parameters
+          ----------
+          max_queue_memory_size : int
+              The maximum number of MappingNode to hold in memory before
+              spilling. Must be >= 1.
+          spill_path : Optional[str] = None
+              If provided, the spill file is created at this path, and
+              removed when the MappingSearch is destroyed. Otherwise, an
+              anonymous temporary file is used.
+          )pbdoc")
+      .def("enable_atom_mapping_data_cache",
+           &MappingSearch::enable_atom_mapping_data_cache,
+           py::arg("max_n_bytes"),
+           R"pbdoc(
+          Hold AtomMappingSearchData for queued MappingNode in a
+          size-bounded cache
+
+          With the cache enabled, queued MappingNode do not hold their
+          AtomMappingSearchData, which scales as the square of the number
+          of supercell sites. Instead, it is held in a least recently used
+          cache, and re-constructed if it was evicted when a MappingNode is
+          partitioned. Search results are identical.
+
+          Must be called while the queue is empty. Cache hits, misses, and
+          evictions are included in
+          :func:`~libcasm.mapping.mapsearch.MappingSearch.statistics`.
+
+          Parameters
+          ----------
+          max_n_bytes : int
+              The maximum estimated size, in bytes, of the cached
+              AtomMappingSearchData.
+          )pbdoc")
+      .def(
+          "statistics",
+          [](MappingSearch const &self) {
+            py::dict d;
+            d["n_mapping_node"] = self.statistics.n_mapping_node;
+            d["n_duplicate_mapping_node"] =
+                self.statistics.n_duplicate_mapping_node;
+            d["n_assignment_problem"] = self.assignment_f.n_solved->load();
+            auto const &queue_spill = self.statistics.queue_spill;
+            d["n_spilled_mapping_node"] = queue_spill.n_spilled_mapping_node;
+            d["n_reloaded_mapping_node"] = queue_spill.n_reloaded_mapping_node;
+            d["spill_bytes_written"] = queue_spill.n_bytes_written;
+            d["spill_bytes_read"] = queue_spill.n_bytes_read;
+            d["spill_max_bytes_file"] = queue_spill.max_n_bytes_file;
+            d["spill_io_time"] = queue_spill.io_time;
+            auto const &cache = self.statistics.atom_mapping_data_cache;
+            d["n_atom_mapping_data_cache_hit"] = cache.n_hit;
+            d["n_atom_mapping_data_cache_miss"] = cache.n_miss;
+            d["n_atom_mapping_data_cache_evicted"] = cache.n_evicted;
+            d["atom_mapping_data_cache_max_n_bytes_used"] =
+                cache.max_n_bytes_used;
+            return d;
+          },
+          R"pbdoc(
+          Return counts of mapping solutions handled during the search
+
+          Returns
+          -------
+          statistics : dict
+              Includes:
+
+              - "n_mapping_node": The number of MappingNode constructed.
+              - "n_duplicate_mapping_node": The number of MappingNode not
+                inserted because `enable_duplicate_elimination` is true and
+                an equivalent MappingNode was in the queue or results.
+              - "n_assignment_problem": The number of assignment problems
+                solved.
+              - "n_spilled_mapping_node": The number of MappingNode written
+                to the queue spill file, if queue spilling is enabled.
+              - "n_reloaded_mapping_node": The number of MappingNode read
+                back from the queue spill file.
+              - "spill_bytes_written": The number of bytes written to the
+                queue spill file.
+              - "spill_bytes_read": The number of bytes read from the
+                queue spill file.
+              - "spill_max_bytes_file": The maximum size, in bytes, of the
+                queue spill file. Space of reloaded MappingNode is re-used.
+              - "spill_io_time": The time, in seconds, spent writing and
+                reading the queue spill file.
+              - "n_atom_mapping_data_cache_hit": The number of
+                AtomMappingSearchData found in the cache, if the cache is
+                enabled.
+              - "n_atom_mapping_data_cache_miss": The number of
+                AtomMappingSearchData constructed because they were not in
+                the cache.
+              - "n_atom_mapping_data_cache_evicted": The number of
+                AtomMappingSearchData evicted from the cache.
+              - "atom_mapping_data_cache_max_n_bytes_used": The maximum
+                estimated size, in bytes, of the cached data.
+
+              Assignment problems are solved using the Hungarian method
+              unless another solver has been chosen in C++.
+          )pbdoc")
       .def(
           "make_and_insert_mapping_node",
           [](MappingSearch &self, double lattice_cost,
@@ -1028,6 +1392,35 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
               A list of tuples of assignments `(site_index, atom_index)` that
               are forced off.
           )pbdoc")
+      .def("make_and_insert_mapping_nodes",
+           &MappingSearch::make_and_insert_mapping_nodes,
+           py::arg("lattice_cost"), py::arg("lattice_mapping_data"),
+           R"pbdoc(
+          Make trial translations, and make and insert a mapping solution
+          for each
+
+          This is equivalent to calling
+          :func:`~libcasm.mapping.mapsearch.MappingSearch.make_and_insert_mapping_node`
+          for each trial translation returned by
+          :func:`~libcasm.mapping.mapsearch.make_trial_translations`, with
+          `structure_symmetry_reduction` equal to the
+          `enable_structure_symmetry_reduction` constructor parameter.
+
+          With `enable_structure_symmetry_reduction` True, structure
+          mappings that are equivalent under the internal translations of
+          the structure being mapped are skipped. They have the same costs
+          as mappings that are searched, so the set of costs found is
+          unchanged, but fewer approximately tied results may be kept.
+
+          Parameters
+          ----------
+          lattice_cost : float
+              The cost of the lattice mapping that forms the context
+              in which atom mappings are solved.
+          lattice_mapping_data : ~libcasm.mapping.mapsearch.LatticeMappingSearchData
+              Holds the lattice mapping and related data that forms the context
+              in which atom mappings are solved.
+          )pbdoc")
       .def(
           "partition", [](MappingSearch &self) { auto it = self.partition(); },
           R"pbdoc(
@@ -1125,6 +1518,95 @@ PYBIND11_MODULE(_mapping_mapsearch, m) {
               Search instance to manage.
           )pbdoc");
 
+  m.def(
+      "estimate_search_cost",
+      [](std::shared_ptr<PrimSearchData const> prim_data,
+         std::shared_ptr<StructureSearchData const> structure_data,
+         Index min_vol, Index max_vol, int reorientation_range, int k_best,
+         std::optional<py::dict> model) {
+        SearchCostParams params;
+        params.min_vol = min_vol;
+        params.max_vol = max_vol;
+        params.reorientation_range = reorientation_range;
+        params.k_best = k_best;
+        SearchCostModel _model;
+        if (model.has_value()) {
+          _model = search_cost_model_from_dict(*model);
+        }
+        return search_cost_estimate_to_dict(estimate_search_cost(
+            *prim_data, *structure_data, params, _model));
+      },
+      py::arg("prim_data"), py::arg("structure_data"), py::arg("min_vol") = 1,
+      py::arg("max_vol") = 1, py::arg("reorientation_range") = 1,
+      py::arg("k_best") = 1, py::arg("model") = std::nullopt,
+      R"pbdoc(
+      Estimate the cost of a structure mapping search
+
+      This quickly estimates the work done by a structure mapping search,
+      such as :func:`~libcasm.mapping.methods.map_structures`, over a range
+      of superstructure volumes, without performing any lattice or atom
+      mappings. It can be used to choose search parameters and to reject
+      parameter choices that would result in very long searches.
+
+      The number of superlattices at each volume is counted exactly, and
+      the number of symmetrically distinct superlattices and lattice
+      mapping trials is bounded using the sizes of the prim and structure
+      crystal point groups. The predicted runtime is an order of magnitude
+      estimate.
+
+      Parameters
+      ----------
+      prim_data : ~libcasm.mapping.mapsearch.PrimSearchData
+          The prim search data.
+      structure_data : ~libcasm.mapping.mapsearch.StructureSearchData
+          The child structure search data.
+      min_vol : int, default=1
+          Minimum parent superstructure volume, as a multiple of the prim
+          volume.
+      max_vol : int, default=1
+          Maximum parent superstructure volume, as a multiple of the prim
+          volume.
+      reorientation_range : int, default=1
+          Range of reorientation matrix elements, 1 to 4.
+      k_best : int, default=1
+          Number of results to keep.
+      model : Optional[dict] = None
+          Runtime model coefficients, as returned by
+          :func:`~libcasm.mapping.mapsearch.calibrate_search_cost_model`.
+          If None, default coefficients are used.
+
+      Returns
+      -------
+      estimate : dict
+          The estimated search cost, with "n_reorientation",
+          "n_assignment_problem", "total_seconds", and "volumes", a list
+          with the work breakdown and predicted runtime at each volume.
+      )pbdoc");
+
+  m.def(
+      "calibrate_search_cost_model",
+      [](Index dim, Index n_samples) {
+        return search_cost_model_to_dict(
+            calibrate_search_cost_model(dim, n_samples));
+      },
+      py::arg("dim") = 32, py::arg("n_samples") = 10,
+      R"pbdoc(
+      Calibrate the search cost model by timing representative operations
+
+      Parameters
+      ----------
+      dim : int, default=32
+          Assignment problem dimension used for timing.
+      n_samples : int, default=10
+          Number of repetitions timed.
+
+      Returns
+      -------
+      model : dict
+          Runtime model coefficients for this machine, which may be passed
+          to :func:`~libcasm.mapping.mapsearch.estimate_search_cost`.
+      )pbdoc");
+
 #ifdef VERSION_INFO
   m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
 #else
@@ -2,16 +2,28 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+// nlohmann::json binding
+#define JSON_USE_IMPLICIT_CONVERSIONS 0
+#include "casm/casm_io/container/json_io.hh"
+#include "casm/casm_io/json/jsonParser.hh"
 #include "casm/crystallography/BasicStructure.hh"
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/SimpleStructure.hh"
 #include "casm/crystallography/SymType.hh"
 #include "casm/mapping/AtomMapping.hh"
+#include "casm/mapping/BlockCompressedStream.hh"
 #include "casm/mapping/LatticeMapping.hh"
+#include "casm/mapping/LatticeMappingIndex.hh"
 #include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/StructureSimilarityMatrix.hh"
+#include "casm/mapping/io/json_io.hh"
 #include "casm/mapping/map_atoms.hh"
 #include "casm/mapping/map_lattices.hh"
 #include "casm/mapping/map_structures.hh"
+#include "casm/mapping/map_structures_batch.hh"
+#include "casm/mapping/perf_counters.hh"
+#include "casm/mapping/synthetic_structure.hh"
+#include "pybind11_json/pybind11_json.hpp"
 
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
@@ -24,6 +36,76 @@ namespace CASMpy {
 using namespace CASM;
 using namespace CASM::mapping;
 
+std::pair<xtal::SimpleStructure, StructureMapping>
+make_synthetic_structure_and_mapping(
+    std::shared_ptr<xtal::BasicStructure const> const &prim,
+    Eigen::Matrix3l const &transformation_matrix_to_super,
+    double strain_magnitude, double displacement_magnitude,
+    double vacancy_fraction, double antisite_fraction, bool random_rotation,
+    bool shuffle_atoms, bool random_translation, std::uint64_t seed) {
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super = transformation_matrix_to_super;
+  params.strain_magnitude = strain_magnitude;
+  params.displacement_magnitude = displacement_magnitude;
+  params.vacancy_fraction = vacancy_fraction;
+  params.antisite_fraction = antisite_fraction;
+  params.random_rotation = random_rotation;
+  params.shuffle_atoms = shuffle_atoms;
+  params.random_translation = random_translation;
+  SyntheticStructure synthetic =
+      mapping::make_synthetic_structure(prim, params, seed);
+  return std::make_pair(synthetic.structure, synthetic.structure_mapping);
+}
+
+std::pair<std::vector<StructureMappingResults>, nlohmann::json>
+map_structures_batch_and_statistics(
+    std::shared_ptr<xtal::BasicStructure const> const &prim,
+    std::vector<xtal::SimpleStructure> const &structures, Index max_vol,
+    std::vector<xtal::SymOp> prim_factor_group, Index min_vol,
+    double min_cost, double max_cost, double lattice_cost_weight,
+    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight, std::optional<double> capture_min_seconds,
+    std::optional<Index> capture_min_queue_size, std::string capture_dir,
+    std::string capture_prefix, Index max_n_capture) {
+  MapStructuresParams params;
+  params.max_vol = max_vol;
+  params.prim_factor_group = std::move(prim_factor_group);
+  params.min_vol = min_vol;
+  params.min_cost = min_cost;
+  params.max_cost = max_cost;
+  params.lattice_cost_weight = lattice_cost_weight;
+  params.lattice_cost_method = std::move(lattice_cost_method);
+  params.atom_cost_method = std::move(atom_cost_method);
+  params.k_best = k_best;
+  params.cost_tol = cost_tol;
+  params.fixed_axis = fixed_axis;
+  params.vacuum_strain_weight = vacuum_strain_weight;
+
+  SlowInputCapture capture;
+  capture.min_seconds = capture_min_seconds;
+  capture.min_queue_size = capture_min_queue_size;
+  capture.dir = std::move(capture_dir);
+  capture.prefix = std::move(capture_prefix);
+  capture.max_n_capture = max_n_capture;
+
+  MapStructuresBatchStatistics statistics;
+  std::vector<StructureMappingResults> results =
+      map_structures_batch(prim, structures, params, statistics, capture);
+  jsonParser json;
+  to_json(statistics, json);
+  return std::make_pair(results, static_cast<nlohmann::json>(json));
+}
+
+std::pair<StructureMappingResults, nlohmann::json>
+replay_slow_input_and_statistics(std::string const &path) {
+  MapStructuresBatchStatistics statistics;
+  StructureMappingResults results = replay_slow_input(path, statistics);
+  jsonParser json;
+  to_json(statistics, json);
+  return std::make_pair(results, static_cast<nlohmann::json>(json));
+}
+
 }  // namespace CASMpy
 
 PYBIND11_MODULE(_mapping_methods, m) {
@@ -165,6 +247,19 @@ PYBIND11_MODULE(_mapping_methods, m) {
       cost_tol : float, default=1e-5
           Tolerance for checking if lattice mapping costs are approximately
           equal.
+      fixed_axis : Optional[int] = None
+          If not None, use slab mode: the index (0, 1, or 2) of the lattice
+          vector of :math:`L_1 T` and :math:`L_2` that is fixed (i.e. the
+          non-periodic, or vacuum, direction). Only reorientations that
+          preserve the fixed lattice vector and the plane of the other two
+          are considered, and lattice mappings are scored using
+          :func:`~libcasm.mapping.info.slab_strain_cost` instead of
+          `cost_method`. The transformation matrix, :math:`T`, must also
+          preserve the fixed lattice vector and plane.
+      vacuum_strain_weight : float, default=0.0
+          In slab mode, the weight of the out-of-plane strain in
+          :func:`~libcasm.mapping.info.slab_strain_cost`. If 0.0, strain of
+          the fixed lattice vector is ignored.
 
       Returns
       -------
@@ -179,9 +274,210 @@ PYBIND11_MODULE(_mapping_methods, m) {
         py::arg("lattice2_point_group") = std::vector<xtal::SymOp>{},
         py::arg("min_cost") = 0.0, py::arg("max_cost") = 1e20,
         py::arg("cost_method") = std::string("isotropic_strain_cost"),
-        py::arg("k_best") = std::nullopt, py::arg("cost_tol") = 1e-5);
+        py::arg("k_best") = std::nullopt, py::arg("cost_tol") = 1e-5,
+        py::arg("fixed_axis") = std::nullopt,
+        py::arg("vacuum_strain_weight") = 0.0);
+
+  py::class_<LatticeMappingIndex>(m, "LatticeMappingIndex", R"pbdoc(
+      Index of previously mapped child lattices, used to warm-start lattice
+      mapping searches
+
+      Child lattices are stored by the metric invariants of their
+      Niggli-reduced form in a k-d tree, so that the lattice mappings of
+      the most similar previously mapped child lattices can be found
+      quickly and adjusted into candidate lattice mappings for a new child
+      lattice. Candidates can be used to bound a lattice mapping search
+      (see :func:`~libcasm.mapping.methods.map_lattices_warm_start`), or as
+      the lattice mappings tried first by a custom search.
+
+      The metric invariants are the independent elements of the
+      Niggli-reduced lattice metric tensor, :math:`G = L^{\mathsf{T}} L`,
+      normalized by :math:`\det(L)^{2/3}`. All entries map to the same
+      parent lattice.
+
+      The index can be saved and restored using
+      :func:`~libcasm.mapping.methods.LatticeMappingIndex.to_dict` and
+      :func:`~libcasm.mapping.methods.LatticeMappingIndex.insert_from_dict`.
+      )pbdoc")
+      .def(py::init<xtal::Lattice const &, std::vector<xtal::SymOp>,
+                    std::string>(),
+           py::arg("lattice1"),
+           py::arg("lattice1_point_group") = std::vector<xtal::SymOp>{},
+           py::arg("cost_method") = std::string("isotropic_strain_cost"),
+           R"pbdoc(
+          .. rubric:: Constructor
+
+          Parameters
+          ----------
+          lattice1 : libcasm.xtal.Lattice
+              The reference "parent" lattice, :math:`L_1`.
+          lattice1_point_group : List[libcasm.xtal.SymOp], optional
+              Parent point group, used if `cost_method` is
+              "symmetry_breaking_strain_cost".
+          cost_method : str, default="isotropic_strain_cost"
+              Method used to calculate candidate lattice mapping costs.
+              One of "isotropic_strain_cost" or
+              "symmetry_breaking_strain_cost".
+          )pbdoc")
+      .def("lattice1", &LatticeMappingIndex::lattice1,
+           "Returns the parent lattice.")
+      .def("cost_method", &LatticeMappingIndex::cost_method,
+           "Returns the lattice mapping cost method.")
+      .def("size", &LatticeMappingIndex::size,
+           "Returns the number of child lattices in the index.")
+      .def("__len__", &LatticeMappingIndex::size)
+      .def("insert", &LatticeMappingIndex::insert, py::arg("lattice2"),
+           py::arg("lattice_mappings"),
+           R"pbdoc(
+          Insert lattice mappings for a child lattice
+
+          Parameters
+          ----------
+          lattice2 : libcasm.xtal.Lattice
+              The "child" lattice, :math:`L_2`.
+          lattice_mappings : ~libcasm.mapping.info.LatticeMappingResults
+              Lattice mappings, :math:`F L_1 T N = L_2`, such as the
+              results of :func:`~libcasm.mapping.methods.map_lattices`.
+          )pbdoc")
+      .def("nearest", &LatticeMappingIndex::nearest, py::arg("lattice2"),
+           py::arg("k_nearest") = 1, py::arg("max_distance") = 1e20,
+           R"pbdoc(
+          Find the entries nearest a child lattice
+
+          Parameters
+          ----------
+          lattice2 : libcasm.xtal.Lattice
+              The "child" lattice, :math:`L_2`.
+          k_nearest : int, default=1
+              Maximum number of entries to return.
+          max_distance : float, default=1e20
+              Maximum distance between lattice metric invariants.
+
+          Returns
+          -------
+          nearest : List[Tuple[float, int]]
+              List of (distance, entry_index), sorted by distance.
+          )pbdoc")
+      .def("make_candidates", &LatticeMappingIndex::make_candidates,
+           py::arg("lattice2"), py::arg("k_nearest") = 1,
+           py::arg("max_distance") = 1e20,
+           R"pbdoc(
+          Make candidate lattice mappings for a child lattice
+
+          The transformation matrix, :math:`T`, of each lattice mapping of
+          the nearest entries is kept and the reorientation matrix,
+          :math:`N`, is adjusted for the lattice vectors of `lattice2`. The
+          deformation gradient and cost are then calculated exactly.
+
+          Parameters
+          ----------
+          lattice2 : libcasm.xtal.Lattice
+              The "child" lattice, :math:`L_2`.
+          k_nearest : int, default=1
+              Number of nearest entries to use.
+          max_distance : float, default=1e20
+              Maximum distance between lattice metric invariants of the
+              entries used.
+
+          Returns
+          -------
+          candidates : ~libcasm.mapping.info.LatticeMappingResults
+              Candidate lattice mappings, :math:`F L_1 T N = L_2`, sorted
+              by lattice mapping cost.
+          )pbdoc")
+      .def(
+          "insert_from_dict",
+          [](LatticeMappingIndex &index, const nlohmann::json &data) {
+            jsonParser json{data};
+            from_json(index, json);
+          },
+          "Insert entries from a Python dict, as written by `to_dict`. "
+          "Raises if the parent lattice or cost method do not match.",
+          py::arg("data"))
+      .def(
+          "to_dict",
+          [](LatticeMappingIndex const &index) -> nlohmann::json {
+            jsonParser json;
+            to_json(index, json);
+            return static_cast<nlohmann::json>(json);
+          },
+          "Represent the LatticeMappingIndex entries as a Python dict.");
+
+  m.def("map_lattices_warm_start", &map_lattices_warm_start, R"pbdoc(
+      Find the k-best lattice mappings, using an index of previously mapped
+      lattices to bound the search
+
+      This finds the same lattice mappings as
+      :func:`~libcasm.mapping.methods.map_lattices`, with `lattice1`,
+      `lattice1_point_group`, and `cost_method` from `index`, but first
+      uses candidate lattice mappings from the index to set a tight
+      initial `max_cost`. Every reorientation is still enumerated; for
+      the "isotropic_strain_cost" method, the bound skips the strain cost
+      calculation of reorientations whose cost lower bound exceeds it.
+      For other cost methods the index is not used. If the bounded search
+      finds fewer than `k_best` results, it is repeated without the
+      bound, which costs more than a single call to
+      :func:`~libcasm.mapping.methods.map_lattices`.
+
+      This is a standalone method:
+      :func:`~libcasm.mapping.methods.map_structures` and
+      :class:`~libcasm.mapping.methods.StrucMapper` do not use a
+      :class:`~libcasm.mapping.methods.LatticeMappingIndex`.
+
+      Parameters
+      ----------
+      index : ~libcasm.mapping.methods.LatticeMappingIndex
+          Previously mapped child lattices.
+      lattice2 : libcasm.xtal.Lattice
+          The "child" lattice, :math:`L_2`.
+      k_best : int
+          Number of results to keep. If there are approximate ties, those
+          will also be kept.
+      transformation_matrix_to_super : Optional[array_like, shape=(3,3)], optional
+          An approximately integer transformation matrix that generates a
+          superlattice of :math:`L_1`. The default value is the identity
+          matrix.
+      reorientation_range : int, default=1
+          The absolute value of the maximum element in the lattice mapping
+          reorientation matrix, :math:`N`.
+      lattice2_point_group : List[libcasm.xtal.SymOp], optional
+          Used to skip reorientation matrices that result in symmetrically
+          equivalent mappings.
+      min_cost : float, default=0.
+          Keep lattice mappings with cost >= min_cost
+      max_cost : float, default=1e20
+          Keep results with cost <= max_cost
+      cost_tol : float, default=1e-5
+          Tolerance for checking if lattice mapping costs are approximately
+          equal.
+      k_nearest : int, default=1
+          Number of nearest previously mapped child lattices used to make
+          candidates.
+      max_distance : float, default=1e20
+          Maximum lattice metric invariant distance of the previously
+          mapped child lattices used to make candidates.
 
-  m.def("map_structures", &map_structures, R"pbdoc(
+      Returns
+      -------
+      lattice_mappings : ~libcasm.mapping.info.LatticeMappingResults
+          Lattice mappings, sorted by lattice mapping cost.
+      )pbdoc",
+        py::arg("index"), py::arg("lattice2"), py::arg("k_best"),
+        py::arg("transformation_matrix_to_super") = std::nullopt,
+        py::arg("reorientation_range") = 1,
+        py::arg("lattice2_point_group") = std::vector<xtal::SymOp>{},
+        py::arg("min_cost") = 0.0, py::arg("max_cost") = 1e20,
+        py::arg("cost_tol") = 1e-5, py::arg("k_nearest") = 1,
+        py::arg("max_distance") = 1e20);
+
+  m.def("map_structures",
+        py::overload_cast<std::shared_ptr<xtal::BasicStructure const> const &,
+                          xtal::SimpleStructure const &, Index,
+                          std::vector<xtal::SymOp>, std::vector<xtal::SymOp>,
+                          Index, double, double, double, std::string,
+                          std::string, int, double, std::optional<Index>,
+                          double>(&map_structures),
+        R"pbdoc(
       Find mappings between two structures
 
       This method finds mappings from a superstructure of a reference "parent"
@@ -201,6 +497,9 @@ PYBIND11_MODULE(_mapping_methods, m) {
 
       where lattice_cost_weight is an input parameter.
 
+      If the child structure is a supercell of a smaller periodic
+      structure, mapping the smaller structure is faster.
+
       For more details, see :cite:t:`THOMAS2021a`.
 
       Parameters
@@ -244,12 +543,26 @@ PYBIND11_MODULE(_mapping_methods, m) {
       cost_tol : float, default=1e-5
           Tolerance for checking if structure mappings costs are approximately
           equal.
+      fixed_axis : Optional[int] = None
+          If not None, use slab mode: the index (0, 1, or 2) of the prim and
+          structure lattice vector that is fixed (i.e. the non-periodic, or
+          vacuum, direction). Parent superlattices are only enumerated in the
+          plane of the other two lattice vectors, only lattice reorientations
+          that preserve the fixed lattice vector are considered, and lattice
+          mappings are scored using
+          :func:`~libcasm.mapping.info.slab_strain_cost` instead of
+          `lattice_cost_method`.
+      vacuum_strain_weight : float, default=0.0
+          In slab mode, the weight of the out-of-plane strain in
+          :func:`~libcasm.mapping.info.slab_strain_cost`. If 0.0, strain of
+          the fixed lattice vector is ignored.
 
       Returns
       -------
       structure_mappings : ~libcasm.mapping.info.StructureMappingResults
           A :class:`~libcasm.mapping.info.StructureMappingResults` object,
-          giving possible structure mappings, sorted by total cost.
+          giving possible structure mappings, sorted by total cost. The
+          structure mappings share `prim`; it is not copied.
       )pbdoc",
         py::arg("prim"), py::arg("structure"), py::arg("max_vol"),
         py::arg("prim_factor_group") = std::vector<xtal::SymOp>{},
@@ -258,9 +571,141 @@ PYBIND11_MODULE(_mapping_methods, m) {
         py::arg("max_cost") = 1e20, py::arg("lattice_cost_weight") = 0.5,
         py::arg("lattice_cost_method") = std::string("isotropic_strain_cost"),
         py::arg("atom_cost_method") = std::string("isotropic_disp_cost"),
-        py::arg("k_best") = 1, py::arg("cost_tol") = 1e-5);
+        py::arg("k_best") = 1, py::arg("cost_tol") = 1e-5,
+        py::arg("fixed_axis") = std::nullopt,
+        py::arg("vacuum_strain_weight") = 0.0);
+
+  m.def("map_structures_batch", &map_structures_batch_and_statistics,
+        R"pbdoc(
+      Find mappings for a batch of structures, recording per-structure
+      latency and capturing slow structures
+
+      Each structure is mapped as by
+      :func:`~libcasm.mapping.methods.map_structures`, with
+      `structure_factor_group` equal to the identity operation only, so
+      mappings that are equivalent under a structure's symmetry are not
+      skipped. The time
+      taken to map each structure is recorded in a histogram with < 1%
+      relative error, and the largest mapping search queue size is tracked.
+
+      Structures that take at least `capture_min_seconds` to map, or for
+      which the mapping search queue holds at least
+      `capture_min_queue_size` mapping nodes, are written to
+      ``<capture_dir>/<capture_prefix>.<index>.json``, where `index` is the
+      index of the structure in `structures`. Each file includes the name
+      of the file where the prim is written
+      (``<capture_prefix>.prim.0.json``, in the same directory), the
+      structure, the mapping parameters, the largest mapping search queue
+      size, and the time taken and hardware performance counts. Captured
+      structures can be mapped again with
+      :func:`~libcasm.mapping.methods.replay_slow_input`.
 
-  m.def("map_atoms", &map_atoms, R"pbdoc(
+      Parameters
+      ----------
+      prim : libcasm.xtal.Prim
+          The reference "parent" structure.
+      structures : List[libcasm.xtal.Structure]
+          The "child" structures.
+      max_vol : int
+          The maximum parent superstructure volume to consider, as a
+          multiple of the parent structure volume.
+      prim_factor_group : List[libcasm.xtal.SymOp], optional
+          Used to skip symmetrically equivalent mappings. The default
+          (empty), is equivalent to only including the identity operation.
+      min_vol : int, default=1
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      min_cost : float, default=0.
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      max_cost : float, default=1e20
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      lattice_cost_weight : float, default=0.5
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      lattice_cost_method : str, default="isotropic_strain_cost"
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      atom_cost_method : str, default="isotropic_disp_cost"
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      k_best : int, default=1
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      cost_tol : float, default=1e-5
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      fixed_axis : Optional[int] = None
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      vacuum_strain_weight : float, default=0.0
+          See :func:`~libcasm.mapping.methods.map_structures`.
+      capture_min_seconds : Optional[float] = None
+          If not None, capture structures that take at least this many
+          seconds to map.
+      capture_min_queue_size : Optional[int] = None
+          If not None, capture structures for which the mapping search
+          queue holds at least this many mapping nodes.
+      capture_dir : str, default="."
+          Directory where captured structures are written.
+      capture_prefix : str, default="slow_input"
+          Prefix of the names of the files written for captured structures.
+      max_n_capture : int, default=100
+          Maximum number of structures captured.
+
+      Returns
+      -------
+      results : List[~libcasm.mapping.info.StructureMappingResults]
+          The structure mappings for each structure, in the same order as
+          `structures`.
+      statistics : dict
+          Includes:
+
+          - "n_structure": The number of structures mapped.
+          - "latency": The per-structure latency histogram, with
+            "count", "min", "mean", "p50", "p90", "p99", "p999", and
+            "max", in seconds, and the non-empty "buckets", as
+            ``[lowest_ns, highest_ns, count]``.
+          - "max_queue_size": The largest mapping search queue size.
+          - "total": The total time taken and hardware performance
+            counts, as returned by
+            :func:`~libcasm.mapping.methods.PerfCounters.stop`.
+          - "slow_input_paths": The paths of the files written for
+            captured structures.
+      )pbdoc",
+        py::arg("prim"), py::arg("structures"), py::arg("max_vol"),
+        py::arg("prim_factor_group") = std::vector<xtal::SymOp>{},
+        py::arg("min_vol") = 1, py::arg("min_cost") = 0.0,
+        py::arg("max_cost") = 1e20, py::arg("lattice_cost_weight") = 0.5,
+        py::arg("lattice_cost_method") = std::string("isotropic_strain_cost"),
+        py::arg("atom_cost_method") = std::string("isotropic_disp_cost"),
+        py::arg("k_best") = 1, py::arg("cost_tol") = 1e-5,
+        py::arg("fixed_axis") = std::nullopt,
+        py::arg("vacuum_strain_weight") = 0.0,
+        py::arg("capture_min_seconds") = std::nullopt,
+        py::arg("capture_min_queue_size") = std::nullopt,
+        py::arg("capture_dir") = std::string("."),
+        py::arg("capture_prefix") = std::string("slow_input"),
+        py::arg("max_n_capture") = 100);
+
+  m.def("replay_slow_input", &replay_slow_input_and_statistics, R"pbdoc(
+      Map a structure captured by
+      :func:`~libcasm.mapping.methods.map_structures_batch` again
+
+      Parameters
+      ----------
+      path : str
+          Path of a file written by
+          :func:`~libcasm.mapping.methods.map_structures_batch`.
+
+      Returns
+      -------
+      results : ~libcasm.mapping.info.StructureMappingResults
+          The structure mappings.
+      statistics : dict
+          Latency and search statistics, as returned by
+          :func:`~libcasm.mapping.methods.map_structures_batch`.
+      )pbdoc",
+        py::arg("path"));
+
+  m.def("map_atoms",
+        py::overload_cast<std::shared_ptr<xtal::BasicStructure const> const &,
+                          xtal::SimpleStructure const &, LatticeMapping const &,
+                          std::vector<xtal::SymOp>, double, double,
+                          std::string, int, double>(&map_atoms),
+        R"pbdoc(
       Find atom mappings between two structures, given a particular lattice mapping
 
       This method finds atom mappings from a superstructure of a reference
@@ -427,6 +872,395 @@ PYBIND11_MODULE(_mapping_methods, m) {
       )pbdoc",
         py::arg("structure_mapping"), py::arg("unmapped_structure"));
 
+  m.def("make_synthetic_structure", &make_synthetic_structure_and_mapping,
+        R"pbdoc(
+      Generate a child structure with a known mapping to the prim
+
+      Generates structures for testing and for scaling studies of structure
+      mapping methods, where the best mapping is known. Starting from a
+      superstructure of the prim, site occupants are chosen (with random
+      vacancies and antisites), occupied sites are randomly displaced
+      (with the mean displacement removed), the superstructure is deformed
+      by a random symmetric strain and optional random rotation, and then
+      rigidly translated and atoms shuffled. The same seed gives the same
+      structure on every platform.
+
+      The returned structure mapping satisfies:
+
+      .. code-block:: Python
+
+          F @ (r1[:, i] + d[:, i]) = r2[:, perm[i]] + t
+
+      modulo lattice translations, where `r1` are the parent superstructure
+      site coordinates and `r2` are the child atom coordinates. Vacant sites
+      have `perm[i] >= n_atom` and zero displacement.
+
+      Parameters
+      ----------
+      prim : libcasm.xtal.Prim
+          The reference "parent" structure. Site occupants must be atomic.
+      transformation_matrix_to_super : array_like, shape=(3,3), dtype=int
+          The parent superstructure, :math:`S = P T`.
+      strain_magnitude : float, default=0.0
+          Standard deviation of the elements of the random symmetric Biot
+          strain, :math:`U - I`.
+      displacement_magnitude : float, default=0.0
+          Standard deviation of random atomic displacement components.
+      vacancy_fraction : float, default=0.0
+          Probability that a site which allows vacancies is vacant.
+      antisite_fraction : float, default=0.0
+          Probability that an occupied site is occupied by an atom type
+          other than its first allowed atom type.
+      random_rotation : bool, default=False
+          If True, apply a uniformly random rigid rotation.
+      shuffle_atoms : bool, default=True
+          If True, randomly shuffle the order of atoms.
+      random_translation : bool, default=True
+          If True, apply a random rigid translation.
+      seed : int, default=0
+          Random number generator seed.
+
+      Returns
+      -------
+      structure : libcasm.xtal.Structure
+          The generated "child" structure.
+      structure_mapping : ~libcasm.mapping.info.StructureMapping
+          The structure mapping used to generate `structure`.
+      )pbdoc",
+        py::arg("prim"), py::arg("transformation_matrix_to_super"),
+        py::arg("strain_magnitude") = 0.0,
+        py::arg("displacement_magnitude") = 0.0,
+        py::arg("vacancy_fraction") = 0.0, py::arg("antisite_fraction") = 0.0,
+        py::arg("random_rotation") = false, py::arg("shuffle_atoms") = true,
+        py::arg("random_translation") = true, py::arg("seed") = 0);
+
+  py::class_<PerfCounters>(m, "PerfCounters", R"pbdoc(
+      Measures hardware performance counters using `perf_event_open`
+
+      Counts user-space cycles, instructions, L1 data cache read misses,
+      last level cache misses, and branch mispredictions for the calling
+      thread and threads it creates, and the elapsed time. If
+      `perf_event_open` is not available (non-Linux platforms, or
+      restricted in a container), only the elapsed time is measured.
+
+      Example, measuring a complete structure mapping:
+
+      .. code-block:: Python
+
+          counters = PerfCounters()
+          counters.start()
+          results = map_structures(prim, structure, max_vol=4)
+          counts = counters.stop()
+          print(counts["seconds"], counts["ipc"])
+
+      )pbdoc")
+      .def(py::init<>(), R"pbdoc(
+          .. rubric:: Constructor
+
+          Opens the counters.
+          )pbdoc")
+      .def("is_available", &PerfCounters::is_available,
+           "Returns True if any hardware counter is available.")
+      .def("start", &PerfCounters::start, "Reset and start counting.")
+      .def(
+          "stop",
+          [](PerfCounters &self) -> nlohmann::json {
+            jsonParser json;
+            to_json(self.stop(), json);
+            return static_cast<nlohmann::json>(json);
+          },
+          R"pbdoc(
+          Stop counting and return the counts since `start`
+
+          Returns
+          -------
+          counts : dict
+              Includes "seconds", "cycles", "instructions",
+              "l1d_read_misses", "llc_misses", "branch_misses", and the
+              derived value "ipc" (instructions per cycle). Counters that
+              are not available have value None.
+          )pbdoc");
+
+  py::class_<StructureSimilarityMatrix>(m, "StructureSimilarityMatrix",
+                                        R"pbdoc(
+      Structure mapping costs between all pairs of a set of structures
+
+      For each pair of structures `(i, j)`, `cost()[i, j]` is the minimum
+      total cost of mapping structure `j` (as "child") to a superstructure
+      of structure `i` (as "parent"), as would be found by
+      :func:`~libcasm.mapping.methods.map_structures` with
+      `min_vol = max_vol = vol`, where `vol` is the number of sites of
+      structure `j` divided by the number of sites of structure `i`. The
+      cost is infinity if the number of sites is not a multiple, if
+      `vol > max_vol`, or if there is no mapping with total cost
+      <= `max_cost`. The diagonal is 0.
+
+      Compared to independent
+      :func:`~libcasm.mapping.methods.map_structures` calls, each structure
+      is prepared once, all children of one parent are mapped using the
+      same parent symmetry and superlattice data, parent rows are mapped
+      in parallel, pairs with incompatible numbers of sites or
+      compositions are skipped without a search, `max_cost` bounds each
+      search, and, when using the isotropic cost methods, only one
+      direction of pairs of ordered structures with equal numbers of sites
+      is mapped.
+
+      Structures are expected to be ordered (one occupant per site, with no
+      vacancies).
+      )pbdoc")
+      .def(py::init([](std::vector<std::shared_ptr<xtal::BasicStructure const>>
+                           structures,
+                       std::vector<std::vector<xtal::SymOp>> factor_groups,
+                       Index max_vol, double max_cost,
+                       double lattice_cost_weight,
+                       std::string lattice_cost_method,
+                       std::string atom_cost_method, double cost_tol,
+                       Index n_threads, std::optional<int> k_best) {
+             StructureSimilarityParams params;
+             params.max_vol = max_vol;
+             params.max_cost = max_cost;
+             params.k_best = k_best;
+             params.lattice_cost_weight = lattice_cost_weight;
+             params.lattice_cost_method = lattice_cost_method;
+             params.atom_cost_method = atom_cost_method;
+             params.cost_tol = cost_tol;
+             py::gil_scoped_release release;
+             return std::make_unique<StructureSimilarityMatrix>(
+                 structures, factor_groups, params, n_threads);
+           }),
+           R"pbdoc(
+          .. rubric:: Constructor
+
+          Maps all pairs of structures.
+
+          Parameters
+          ----------
+          structures : List[libcasm.xtal.Prim]
+              The structures, represented as Prim, which are used as both
+              "parent" and "child" structures.
+          factor_groups : List[List[libcasm.xtal.SymOp]], optional
+              The factor group of each structure, used to skip
+              symmetrically equivalent mappings. The default (empty), is
+              equivalent to only including the identity operation.
+          max_vol : int, default=1
+              The maximum parent superstructure volume to consider, as a
+              multiple of the parent structure volume.
+          max_cost : float, default=1e20
+              Similarity threshold. Pairs with no mapping with total cost
+              <= max_cost have infinite cost.
+          lattice_cost_weight : float, default=0.5
+              See :func:`~libcasm.mapping.methods.map_structures`.
+          lattice_cost_method : str, default="isotropic_strain_cost"
+              See :func:`~libcasm.mapping.methods.map_structures`.
+          atom_cost_method : str, default="isotropic_disp_cost"
+              See :func:`~libcasm.mapping.methods.map_structures`.
+          cost_tol : float, default=1e-5
+              See :func:`~libcasm.mapping.methods.map_structures`.
+          n_threads : int, default=0
+              Number of threads used to map pairs. If 0, use the number of
+              hardware threads.
+          k_best : Optional[int] = None
+              If not None, only the `k_best` lowest cost pairs, plus pairs
+              approximately tied with the k-th, have finite cost, and
+              the search for other pairs is bounded by the k-th lowest cost
+              found so far. The diagonal and pairs mirrored from the reverse
+              pair are not counted. The result does not depend on
+              `n_threads`.
+          )pbdoc",
+           py::arg("structures"),
+           py::arg("factor_groups") = std::vector<std::vector<xtal::SymOp>>{},
+           py::arg("max_vol") = 1, py::arg("max_cost") = 1e20,
+           py::arg("lattice_cost_weight") = 0.5,
+           py::arg("lattice_cost_method") =
+               std::string("isotropic_strain_cost"),
+           py::arg("atom_cost_method") = std::string("isotropic_disp_cost"),
+           py::arg("cost_tol") = 1e-5, py::arg("n_threads") = 0,
+           py::arg("k_best") = std::nullopt)
+      .def("size", &StructureSimilarityMatrix::size,
+           "Returns the number of structures.")
+      .def("cost", &StructureSimilarityMatrix::cost, R"pbdoc(
+          Returns the minimum total mapping cost of each pair
+
+          Returns
+          -------
+          cost : numpy.ndarray[numpy.float64[n_structures, n_structures]]
+              The minimum total mapping cost, with the "parent" structure
+              index as row and the "child" structure index as column.
+          )pbdoc")
+      .def(
+          "sparse_cost",
+          [](StructureSimilarityMatrix const &self) {
+            std::vector<std::tuple<Index, Index, double>> entries;
+            for (auto const &entry : self.sparse_cost()) {
+              entries.emplace_back(entry.parent_index, entry.child_index,
+                                   entry.cost);
+            }
+            return entries;
+          },
+          R"pbdoc(
+          Returns the pairs with finite cost
+
+          Returns
+          -------
+          entries : List[Tuple[int, int, float]]
+              The pairs `(parent_index, child_index, cost)`, not including
+              the diagonal, with finite cost, in row-major order.
+          )pbdoc")
+      .def("best_mapping", &StructureSimilarityMatrix::best_mapping,
+           R"pbdoc(
+          Find the lowest cost structure mapping for a pair
+
+          The search is bounded by the known cost of the pair. If there are
+          approximate ties, those are also included.
+
+          Parameters
+          ----------
+          parent_index : int
+              Index of the "parent" structure.
+          child_index : int
+              Index of the "child" structure.
+
+          Returns
+          -------
+          structure_mappings : ~libcasm.mapping.info.StructureMappingResults
+              The lowest cost structure mappings. Empty if the pair has
+              infinite cost.
+          )pbdoc",
+           py::arg("parent_index"), py::arg("child_index"))
+      .def(
+          "statistics",
+          [](StructureSimilarityMatrix const &self) {
+            py::dict d;
+            auto const &stats = self.statistics();
+            d["n_mapped"] = stats.n_mapped;
+            d["n_skipped_volume"] = stats.n_skipped_volume;
+            d["n_skipped_composition"] = stats.n_skipped_composition;
+            d["n_mirrored"] = stats.n_mirrored;
+            return d;
+          },
+          R"pbdoc(
+          Returns counts of structure pairs mapped and skipped
+
+          Returns
+          -------
+          statistics : dict
+              Includes:
+
+              - "n_mapped": The number of pairs for which a structure
+                mapping search was done.
+              - "n_skipped_volume": The number of pairs skipped because the
+                number of child sites is not a multiple of the number of
+                parent sites, or the volume is greater than `max_vol`.
+              - "n_skipped_composition": The number of pairs skipped
+                because the compositions are not compatible.
+              - "n_mirrored": The number of pairs with cost equal to that
+                of the reverse pair, which was mapped instead.
+          )pbdoc");
+
+  py::class_<BlockCompressedWriter>(m, "BlockCompressedWriter", R"pbdoc(
+      Writes records in zlib-compressed blocks, compressing blocks in
+      parallel
+
+      Records (for example, one JSON-formatted mapping result per record,
+      as NDJSON, or binary data) are collected into blocks of
+      approximately `block_size` bytes. Full blocks are compressed on
+      worker threads while more records are collected, and written in
+      order. Closing the writer writes a block index, which
+      :class:`~libcasm.mapping.methods.BlockCompressedReader` uses to
+      read any range of records without decompressing the whole file.
+
+      Example, writing structure mapping results:
+
+      .. code-block:: Python
+
+          writer = BlockCompressedWriter("results.blk")
+          for structure in structures:
+              results = map_structures(prim, structure, max_vol=4)
+              writer.write_json(results.to_dict())
+          writer.close()
+
+      )pbdoc")
+      .def(py::init<std::string const &, Index, Index, int>(), R"pbdoc(
+          .. rubric:: Constructor
+
+          Parameters
+          ----------
+          path : str
+              Path of the file to write. An existing file is overwritten.
+          block_size : int, default=1048576
+              Uncompressed size, in bytes, at which a block is compressed.
+          n_threads : int, default=0
+              Number of blocks compressed at the same time. If 0, use the
+              number of hardware threads.
+          level : int, default=-1
+              zlib compression level, in the range [0, 9], or -1 for the
+              zlib default level.
+          )pbdoc",
+           py::arg("path"), py::arg("block_size") = 1 << 20,
+           py::arg("n_threads") = 0, py::arg("level") = -1)
+      .def(
+          "write",
+          [](BlockCompressedWriter &self, py::bytes record) {
+            self.write(std::string(record));
+          },
+          "Append a record.", py::arg("record"))
+      .def(
+          "write_json",
+          [](BlockCompressedWriter &self, nlohmann::json const &data) {
+            self.write(data.dump());
+          },
+          "Append a record, formatted as single-line JSON.", py::arg("data"))
+      .def("close", &BlockCompressedWriter::close,
+           "Compress remaining records, and write the block index.")
+      .def("n_record", &BlockCompressedWriter::n_record,
+           "Returns the number of records written.");
+
+  py::class_<BlockCompressedReader>(m, "BlockCompressedReader", R"pbdoc(
+      Reads records from a file written by
+      :class:`~libcasm.mapping.methods.BlockCompressedWriter`
+
+      Only the blocks holding the requested range of records are read, and
+      they are decompressed in parallel.
+      )pbdoc")
+      .def(py::init<std::string const &, Index>(), R"pbdoc(
+          .. rubric:: Constructor
+
+          Parameters
+          ----------
+          path : str
+              Path of a file written by
+              :class:`~libcasm.mapping.methods.BlockCompressedWriter`.
+          n_threads : int, default=0
+              Number of blocks decompressed at the same time. If 0, use the
+              number of hardware threads.
+          )pbdoc",
+           py::arg("path"), py::arg("n_threads") = 0)
+      .def("n_record", &BlockCompressedReader::n_record,
+           "Returns the number of records.")
+      .def(
+          "read",
+          [](BlockCompressedReader &self, Index begin, Index end) {
+            std::vector<std::string> records = self.read(begin, end);
+            py::list list;
+            for (std::string const &record : records) {
+              list.append(py::bytes(record));
+            }
+            return list;
+          },
+          "Returns the records in the range [begin, end), as bytes.",
+          py::arg("begin"), py::arg("end"))
+      .def(
+          "read_json",
+          [](BlockCompressedReader &self, Index begin, Index end) {
+            std::vector<nlohmann::json> data;
+            for (std::string const &record : self.read(begin, end)) {
+              data.push_back(nlohmann::json::parse(record));
+            }
+            return data;
+          },
+          "Returns the records in the range [begin, end), parsed as JSON.",
+          py::arg("begin"), py::arg("end"));
+
 #ifdef VERSION_INFO
   m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
 #else
@@ -184,3 +184,133 @@ def test_MappingSearch_1():
         0.31829851687000077,
     ]
     assert np.allclose(expected_atom_cost, [x.atom_cost() for x in results])
+
+
+def test_MappingSearch_batch_cost_functions():
+    """Array-level cost functions give the same search as test_MappingSearch_1"""
+    disp_dof = xtal.DoFSetBasis("disp")
+    Hstrain_dof = xtal.DoFSetBasis("Hstrain")
+    parent_xtal_prim = xtal_prims.HCP(
+        a=1.0,
+        occ_dof=["A"],
+        local_dof=[disp_dof],
+        global_dof=[Hstrain_dof],
+    )
+    transformation_matrix_to_super = np.array(
+        [
+            [1, 0, 0],
+            [1, 2, 0],
+            [0, 0, 1],
+        ],
+        dtype="int",
+    )
+    cost_tol = 1e-5
+
+    # equivalent to make_atom_to_site_cost, for all atoms and sites
+    n_cost_matrix_call = [0]
+
+    def atom_to_site_cost_matrix_f(
+        displacement, atom_type_index, site_allowed, atom_type_names, infinity
+    ):
+        n_cost_matrix_call[0] += 1
+        is_vacancy = np.array([x in ["Va", "VA", "va"] for x in atom_type_names])
+        atom_is_vacancy = is_vacancy[atom_type_index]
+        vacancy_allowed = site_allowed[:, is_vacancy].any(axis=1)
+        cost = np.where(
+            site_allowed[:, atom_type_index],
+            np.sum(displacement**2, axis=2),
+            infinity,
+        )
+        vacancy_cost = np.where(vacancy_allowed, 0.0, infinity)
+        return np.where(
+            atom_is_vacancy[np.newaxis, :], vacancy_cost[:, np.newaxis], cost
+        )
+
+    batch_sizes = []
+    isotropic_atom_cost_f = mapsearch.IsotropicAtomCost()
+
+    def batch_atom_cost_f(lattice_mapping_data, atom_mapping_data, atom_mappings):
+        batch_sizes.append(len(atom_mappings))
+        return np.array(
+            [
+                isotropic_atom_cost_f(lattice_mapping_data, atom_mapping_data, x)
+                for x in atom_mappings
+            ]
+        )
+
+    parent_search_data = mapsearch.PrimSearchData(
+        prim=parent_xtal_prim,
+        enable_symmetry_breaking_atom_cost=False,
+    )
+    prim_structure_data = mapsearch.StructureSearchData(
+        lattice=parent_xtal_prim.lattice(),
+        atom_coordinate_cart=parent_xtal_prim.coordinate_cart(),
+        atom_type=[occ[0] for occ in parent_xtal_prim.occ_dof()],
+        override_structure_factor_group=None,
+    )
+    child_search_data = mapsearch.make_superstructure_data(
+        prim_structure_data=prim_structure_data,
+        transformation_matrix_to_super=transformation_matrix_to_super,
+    )
+    lattice_mappings = mapmethods.map_lattices(
+        lattice1=parent_search_data.prim_lattice(),
+        lattice2=child_search_data.lattice(),
+        transformation_matrix_to_super=child_search_data.transformation_matrix_to_super(),
+        lattice1_point_group=parent_search_data.prim_crystal_point_group(),
+        lattice2_point_group=child_search_data.structure_crystal_point_group(),
+        min_cost=0.0,
+        max_cost=1e20,
+        cost_method="isotropic_strain_cost",
+        k_best=100,
+        reorientation_range=3,
+        cost_tol=cost_tol,
+    )
+
+    searches = [
+        mapsearch.MappingSearch(
+            k_best=10,
+            enable_remove_mean_displacement=False,
+            cost_tol=cost_tol,
+        ),
+        mapsearch.MappingSearch(
+            k_best=10,
+            enable_remove_mean_displacement=False,
+            cost_tol=cost_tol,
+            batch_atom_cost_f=batch_atom_cost_f,
+            atom_to_site_cost_matrix_f=atom_to_site_cost_matrix_f,
+        ),
+    ]
+    n_atom_mapping_data = 0
+    for scored_lattice_mapping in lattice_mappings:
+        lattice_mapping_data = mapsearch.LatticeMappingSearchData(
+            prim_data=parent_search_data,
+            structure_data=child_search_data,
+            lattice_mapping=scored_lattice_mapping,
+        )
+        for trial_translation in mapsearch.make_trial_translations(
+            lattice_mapping_data=lattice_mapping_data,
+        ):
+            n_atom_mapping_data += 1
+            for search in searches:
+                search.make_and_insert_mapping_node(
+                    lattice_cost=scored_lattice_mapping.lattice_cost(),
+                    lattice_mapping_data=lattice_mapping_data,
+                    trial_translation_cart=trial_translation,
+                )
+
+    # one call per cost matrix
+    assert n_cost_matrix_call[0] == n_atom_mapping_data
+
+    for search in searches:
+        while search.size():
+            search.partition()
+    assert max(batch_sizes) > 1
+
+    results = searches[0].results()
+    batch_results = searches[1].results()
+    assert len(results) == 10
+    assert len(batch_results) == len(results)
+    assert np.allclose(
+        [x.total_cost() for x in results],
+        [x.total_cost() for x in batch_results],
+    )
@@ -128,3 +128,33 @@ def test_map_lattices_3():
     _I = np.eye(3)
     assert np.allclose(F @ L1 @ T, L2)
     assert np.allclose(N, _I)
+
+
+def test_map_lattices_slab():
+    """Map to Ezz, with fixed c: slab strain cost ignores Ezz"""
+    L1 = np.eye(3)
+    lattice1 = xtal.Lattice(L1)
+    L2 = np.array(
+        [
+            [1.0, 0.0, 0.0],
+            [0.0, 1.0, 0.0],
+            [0.0, 0.0, 1.2],
+        ]
+    ).transpose()
+    lattice2 = xtal.Lattice(L2)
+
+    lattice_mappings = mapmethods.map_lattices(
+        lattice1, lattice2, max_cost=1e-10, fixed_axis=2
+    )
+    for lattice_mapping in lattice_mappings:
+        Q = lattice_mapping.isometry()
+        U = lattice_mapping.right_stretch()
+        T = lattice_mapping.transformation_matrix_to_super()
+        N = lattice_mapping.reorientation()
+        assert np.allclose(Q @ U @ L1 @ T @ N, L2)
+        assert np.allclose(N[2, 0:2], 0.0)
+        assert np.allclose(N[0:2, 2], 0.0)
+        assert math.isclose(abs(N[2, 2]), 1.0)
+        assert math.isclose(lattice_mapping.lattice_cost(), 0.0, abs_tol=1e-10)
+    # in-plane N: the 8 signed permutation matrices
+    assert len(lattice_mappings) == 8
@@ -477,3 +477,167 @@ def test_make_mapped_structure_0(shared_datadir):
     )
 
     assert isinstance(mapped_structure, xtal.Structure)
+
+
+def test_map_structures_batch(tmp_path):
+    """Batch mapping records latency and captures replayable slow inputs"""
+    prim = xtal_prims.cubic(a=1.0, occ_dof=["A"])
+    prim_factor_group = xtal.make_factor_group(prim)
+
+    unit_structure = xtal.Structure(
+        lattice=prim.lattice(),
+        atom_coordinate_frac=prim.coordinate_frac(),
+        atom_type=["A"],
+    )
+    T = np.array([[1, 0, 0], [0, 1, 0], [0, 0, 2]], dtype=int)
+    structures = [unit_structure, xtal.make_superstructure(T, unit_structure)]
+
+    results, statistics = mapmethods.map_structures_batch(
+        prim,
+        structures,
+        max_vol=2,
+        prim_factor_group=prim_factor_group,
+        capture_min_queue_size=0,
+        capture_dir=str(tmp_path),
+    )
+    assert len(results) == 2
+    for structure, structure_mappings in zip(structures, results):
+        expected = mapmethods.map_structures(
+            prim, structure, max_vol=2, prim_factor_group=prim_factor_group
+        )
+        assert len(structure_mappings) == len(expected)
+        for smap in structure_mappings:
+            check_mapping(prim, structure, smap)
+
+    assert statistics["n_structure"] == 2
+    latency = statistics["latency"]
+    assert latency["count"] == 2
+    assert latency["min"] <= latency["p50"] <= latency["max"]
+    assert sum(bucket[2] for bucket in latency["buckets"]) == 2
+    assert statistics["max_queue_size"] > 0
+    assert len(statistics["slow_input_paths"]) == 2
+    assert (tmp_path / "slow_input.prim.0.json").exists()
+
+    replay_results, replay_statistics = mapmethods.replay_slow_input(
+        statistics["slow_input_paths"][1]
+    )
+    assert replay_statistics["n_structure"] == 1
+    assert len(replay_results) == len(results[1])
+    for a, b in zip(replay_results, results[1]):
+        assert math.isclose(a.total_cost(), b.total_cost(), abs_tol=1e-10)
+
+
+def test_block_compressed_results(tmp_path):
+    """Write structure mapping results in compressed blocks, read a range"""
+    prim = xtal_prims.cubic(a=1.0, occ_dof=["A"])
+    structure = xtal.Structure(
+        lattice=prim.lattice(),
+        atom_coordinate_frac=prim.coordinate_frac(),
+        atom_type=["A"],
+    )
+    structure_mappings = mapmethods.map_structures(
+        prim, structure, max_vol=1, max_cost=0.0, min_cost=0.0
+    )
+    data = structure_mappings.to_dict()
+
+    path = str(tmp_path / "results.blk")
+    writer = mapmethods.BlockCompressedWriter(path, block_size=4096, n_threads=2)
+    for i in range(200):
+        writer.write_json(data)
+        writer.write(b"\x00\x01" + bytes([i]))
+    writer.close()
+    assert writer.n_record() == 400
+
+    reader = mapmethods.BlockCompressedReader(path)
+    assert reader.n_record() == 400
+    for record in reader.read_json(100, 106)[::2]:
+        results = mapinfo.StructureMappingResults.from_dict(record, prim)
+        assert len(results) == len(structure_mappings)
+    assert reader.read(399, 400) == [b"\x00\x01" + bytes([199])]
+
+
+def test_structure_similarity_matrix():
+    """All-pairs mapping costs match independent map_structures calls"""
+    prims = [
+        xtal_prims.BCC(r=1.0, occ_dof=["A"]),
+        xtal_prims.FCC(r=1.0, occ_dof=["A"]),
+        xtal_prims.BCC(r=1.0, occ_dof=["B"]),
+        xtal_prims.HCP(r=1.0, occ_dof=["A"]),
+    ]
+    factor_groups = [xtal.make_factor_group(prim) for prim in prims]
+
+    similarity = mapmethods.StructureSimilarityMatrix(
+        prims,
+        factor_groups=factor_groups,
+        max_vol=2,
+        n_threads=2,
+    )
+    assert similarity.size() == 4
+    cost = similarity.cost()
+    assert cost.shape == (4, 4)
+    assert np.allclose(np.diag(cost), 0.0)
+
+    for i, parent in enumerate(prims):
+        for j, child in enumerate(prims):
+            if i == j:
+                continue
+            n_parent = len(parent.occ_dof())
+            n_child = len(child.occ_dof())
+            same_type = parent.occ_dof()[0] == child.occ_dof()[0]
+            if n_child % n_parent != 0 or not same_type:
+                assert math.isinf(cost[i, j])
+                continue
+            vol = n_child // n_parent
+            structure = xtal.Structure(
+                lattice=child.lattice(),
+                atom_coordinate_frac=child.coordinate_frac(),
+                atom_type=[occ[0] for occ in child.occ_dof()],
+            )
+            expected = mapmethods.map_structures(
+                parent,
+                structure,
+                max_vol=vol,
+                min_vol=vol,
+                prim_factor_group=factor_groups[i],
+                structure_factor_group=factor_groups[j],
+                k_best=1,
+            )
+            assert len(expected)
+            assert math.isclose(
+                cost[i, j], expected[0].total_cost(), abs_tol=1e-10
+            )
+
+            best = similarity.best_mapping(i, j)
+            assert len(best)
+            assert math.isclose(best[0].total_cost(), cost[i, j], abs_tol=1e-10)
+
+    # BCC <-> FCC are mapped in one direction only
+    assert math.isclose(cost[0, 1], cost[1, 0])
+    assert math.isinf(cost[3, 0])
+    assert len(similarity.best_mapping(0, 2)) == 0
+
+    entries = similarity.sparse_cost()
+    assert len(entries) == np.count_nonzero(np.isfinite(cost)) - 4
+    for i, j, value in entries:
+        assert math.isclose(value, cost[i, j])
+
+    statistics = similarity.statistics()
+    assert statistics["n_mirrored"] >= 1
+    assert statistics["n_skipped_composition"] >= 1
+    assert statistics["n_skipped_volume"] >= 1
+
+    # k_best keeps only the lowest cost pairs, independent of n_threads
+    finite = sorted(value for _, _, value in entries)
+    for n_threads in [1, 2]:
+        nearest = mapmethods.StructureSimilarityMatrix(
+            prims,
+            factor_groups=factor_groups,
+            max_vol=2,
+            n_threads=n_threads,
+            k_best=1,
+        )
+        nearest_entries = nearest.sparse_cost()
+        assert len(nearest_entries) >= 1
+        for i, j, value in nearest_entries:
+            assert math.isclose(value, cost[i, j])
+            assert math.isclose(value, finite[0], abs_tol=1e-5)
@@ -1,6 +1,7 @@
 #include "casm/mapping/AtomMapping.hh"
 
 #include "casm/global/eigen.hh"
+#include "casm/mapping/misc.hh"
 
 namespace CASM {
 namespace mapping {
@@ -88,5 +89,20 @@ AtomMapping interpolated_mapping(AtomMapping const &atom_mapping,
                      atom_mapping.translation);
 }
 
+/// \brief Total order of atom mappings, for reproducible ordering of
+///     results with equal cost
+///
+/// Compares, exactly and in order, the translation, the permutation, and
+/// the displacements.
+bool total_order_less(AtomMapping const &lhs, AtomMapping const &rhs) {
+  if (lhs.translation != rhs.translation) {
+    return matrix_lexicographical_less(lhs.translation, rhs.translation);
+  }
+  if (lhs.permutation != rhs.permutation) {
+    return lhs.permutation < rhs.permutation;
+  }
+  return matrix_lexicographical_less(lhs.displacement, rhs.displacement);
+}
+
 }  // namespace mapping
 }  // namespace CASM
@@ -0,0 +1,117 @@
+#include "casm/mapping/AtomMappingSearchDataCache.hh"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "casm/mapping/SearchData.hh"
+
+namespace CASM {
+namespace mapping {
+
+/// \class AtomMappingSearchDataCache
+/// \brief A size-bounded, least recently used cache of
+///     AtomMappingSearchData
+///
+/// The site displacements and cost matrix of AtomMappingSearchData
+/// scale as N_site^2, and a MappingSearch may construct many of them.
+/// When MappingSearch uses an AtomMappingSearchDataCache, queued
+/// MappingNode only keep the lattice mapping data and trial
+/// translation that identify their AtomMappingSearchData, and the
+/// AtomMappingSearchData is looked up in the cache when needed. If it
+/// was evicted, it is re-constructed from the lattice mapping data,
+/// trial translation, and atom-to-site cost function, which gives an
+/// identical result.
+///
+/// Entries are identified by the address of the
+/// LatticeMappingSearchData and the exact value of the trial
+/// translation. Each entry keeps its LatticeMappingSearchData alive,
+/// so the address is not re-used while the entry exists.
+///
+/// Evicting an entry releases the cache's reference to the data. The
+/// data itself is freed once no MappingNode being partitioned or
+/// constructed uses it, so memory use is bounded by the cache size
+/// plus the data in use.
+
+/// \brief Constructor
+///
+/// \param _max_n_bytes Maximum estimated size of the cached data, in
+///     bytes. The most recently inserted entry is always kept, even if
+///     it is larger.
+AtomMappingSearchDataCache::AtomMappingSearchDataCache(Index _max_n_bytes)
+    : m_max_n_bytes(_max_n_bytes) {
+  if (m_max_n_bytes < 0) {
+    throw std::runtime_error(
+        "Error in AtomMappingSearchDataCache: max_n_bytes < 0");
+  }
+}
+
+/// \brief Find cached data for a lattice mapping and trial translation
+///
+/// \returns The cached data, which becomes the most recently used
+///     entry, or nullptr if not found.
+std::shared_ptr<AtomMappingSearchData const> AtomMappingSearchDataCache::find(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    Eigen::Vector3d const &trial_translation_cart) {
+  auto it =
+      m_index.find(_make_key(lattice_mapping_data, trial_translation_cart));
+  if (it == m_index.end()) {
+    statistics.n_miss += 1;
+    return nullptr;
+  }
+  statistics.n_hit += 1;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->data;
+}
+
+/// \brief Insert data, evicting least recently used entries if necessary
+///
+/// If data for the same lattice mapping and trial translation is
+/// already cached, it is replaced.
+void AtomMappingSearchDataCache::insert(
+    std::shared_ptr<AtomMappingSearchData const> const &data) {
+  Key key =
+      _make_key(*data->lattice_mapping_data, data->trial_translation_cart);
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    statistics.n_bytes -= it->second->n_bytes;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+
+  Entry entry{key, data, estimate_n_bytes(*data)};
+  statistics.n_bytes += entry.n_bytes;
+  m_entries.push_front(entry);
+  m_index.emplace(key, m_entries.begin());
+
+  while (statistics.n_bytes > m_max_n_bytes && m_entries.size() > 1) {
+    Entry const &back = m_entries.back();
+    statistics.n_bytes -= back.n_bytes;
+    statistics.n_evicted += 1;
+    m_index.erase(back.key);
+    m_entries.pop_back();
+  }
+  statistics.max_n_bytes_used =
+      std::max(statistics.max_n_bytes_used, statistics.n_bytes);
+}
+
+AtomMappingSearchDataCache::Key AtomMappingSearchDataCache::_make_key(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    Eigen::Vector3d const &trial_translation_cart) {
+  return Key(&lattice_mapping_data, trial_translation_cart(0),
+             trial_translation_cart(1), trial_translation_cart(2));
+}
+
+/// \brief Estimate the memory used by the site displacements and cost
+///     matrix of AtomMappingSearchData, in bytes
+Index estimate_n_bytes(AtomMappingSearchData const &atom_mapping_data) {
+  Index n_bytes = sizeof(AtomMappingSearchData);
+  for (auto const &site_displacements_i :
+       atom_mapping_data.site_displacements) {
+    n_bytes += site_displacements_i.size() * sizeof(Eigen::Vector3d);
+  }
+  n_bytes += atom_mapping_data.cost_matrix.size() * sizeof(double);
+  return n_bytes;
+}
+
+}  // namespace mapping
+}  // namespace CASM
@@ -0,0 +1,460 @@
+#include "casm/mapping/BlockCompressedStream.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+/// \brief Identifies block-compressed result stream files, written at the
+///     beginning and end of the file
+char const magic[8] = {'C', 'A', 'S', 'M', 'B', 'L', 'K', '1'};
+
+/// \brief Size of the footer: index offset, number of blocks, number of
+///     records, and magic
+std::int64_t const footer_size = 3 * sizeof(std::uint64_t) + sizeof(magic);
+
+/// \brief Size of one block index entry
+std::int64_t const index_entry_size = 5 * sizeof(std::uint64_t);
+
+Index default_n_threads(Index n_threads) {
+  if (n_threads > 0) {
+    return n_threads;
+  }
+  return std::max(Index(std::thread::hardware_concurrency()), Index(1));
+}
+
+template <typename T>
+void write_value(std::vector<char> &buffer, T const &value) {
+  char const *begin = reinterpret_cast<char const *>(&value);
+  buffer.insert(buffer.end(), begin, begin + sizeof(T));
+}
+
+template <typename T>
+T read_value(char const *&ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  ptr += sizeof(T);
+  return value;
+}
+
+std::vector<char> compress_block(std::vector<char> const &block, int level) {
+  uLongf n_compressed_bytes = compressBound(block.size());
+  std::vector<char> compressed(n_compressed_bytes);
+  int status = compress2(reinterpret_cast<Bytef *>(compressed.data()),
+                         &n_compressed_bytes,
+                         reinterpret_cast<Bytef const *>(block.data()),
+                         block.size(), level);
+  if (status != Z_OK) {
+    throw std::runtime_error(
+        "Error in BlockCompressedWriter: block compression failed");
+  }
+  compressed.resize(n_compressed_bytes);
+  return compressed;
+}
+
+std::vector<char> decompress_block(std::vector<char> const &compressed,
+                                   BlockCompressedIndexEntry const &entry) {
+  std::vector<char> block(entry.n_bytes);
+  uLongf n_bytes = entry.n_bytes;
+  int status = uncompress(reinterpret_cast<Bytef *>(block.data()), &n_bytes,
+                          reinterpret_cast<Bytef const *>(compressed.data()),
+                          compressed.size());
+  if (status != Z_OK || n_bytes != entry.n_bytes) {
+    throw std::runtime_error(
+        "Error in BlockCompressedReader: block decompression failed");
+  }
+  return block;
+}
+
+}  // namespace
+
+/// \class BlockCompressedWriter
+/// \brief Writes records (NDJSON lines or binary) in zlib-compressed
+///     blocks, compressing blocks in parallel
+///
+/// Records are arbitrary byte strings, for example one JSON-formatted
+/// StructureMappingResults per record for NDJSON output, or a binary
+/// serialization. Records are collected into blocks of approximately
+/// `block_size` uncompressed bytes. Each full block is compressed
+/// independently on a worker thread while more records are collected,
+/// and compressed blocks are written to the file in order. Closing the
+/// writer writes a block index, which lets BlockCompressedReader
+/// decompress only the blocks holding a range of records.
+///
+/// File layout (integers are 64-bit unsigned, native byte order):
+///
+/// - magic: "CASMBLK1"
+/// - compressed blocks: each a zlib stream of records, with each record
+///   written as its size followed by its bytes
+/// - block index: for each block, the file offset, compressed size,
+///   uncompressed size, first record index, and number of records
+/// - footer: index offset, number of blocks, number of records, and
+///   magic
+///
+/// Example, writing structure mapping results as NDJSON:
+///
+///     BlockCompressedWriter writer("results.blk");
+///     for (auto const &results : all_results) {
+///       jsonParser json;
+///       to_json(results, json);
+///       std::stringstream ss;
+///       json.print(ss, 0);
+///       writer.write(ss.str());
+///     }
+///     writer.close();
+///
+
+/// \brief Constructor, opens the file
+///
+/// \param _path Path of the file to write. An existing file is
+///     overwritten.
+/// \param _block_size Uncompressed size, in bytes, at which a block is
+///     compressed. Larger blocks compress better, smaller blocks make
+///     reading a small range of records faster. Default=1 MiB.
+/// \param _n_threads Number of blocks compressed at the same time. If
+///     0 (default), use `std::thread::hardware_concurrency()`.
+/// \param _level zlib compression level, in the range [0, 9], or -1
+///     (default) for the zlib default level.
+BlockCompressedWriter::BlockCompressedWriter(std::string const &_path,
+                                             Index _block_size,
+                                             Index _n_threads, int _level)
+    : m_file(nullptr),
+      m_block_size(_block_size),
+      m_n_threads(default_n_threads(_n_threads)),
+      m_level(_level),
+      m_n_record(0),
+      m_offset(0),
+      m_block_n_record(0) {
+  if (m_block_size < 1) {
+    throw std::runtime_error(
+        "Error in BlockCompressedWriter: block_size must be >= 1");
+  }
+  if (m_level < -1 || m_level > 9) {
+    throw std::runtime_error(
+        "Error in BlockCompressedWriter: level must be in the range [-1, 9]");
+  }
+  m_file = std::fopen(_path.c_str(), "wb");
+  if (!m_file) {
+    throw std::runtime_error(
+        "Error in BlockCompressedWriter: could not open file: " + _path);
+  }
+  if (std::fwrite(magic, 1, sizeof(magic), m_file) != sizeof(magic)) {
+    std::fclose(m_file);
+    m_file = nullptr;
+    throw std::runtime_error("Error in BlockCompressedWriter: write failed");
+  }
+  m_offset = sizeof(magic);
+}
+
+/// \brief Destructor, closes the file if not already closed
+///
+/// Errors are ignored; call `close` to check for errors.
+BlockCompressedWriter::~BlockCompressedWriter() {
+  if (m_file) {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+}
+
+/// \brief Append a record
+void BlockCompressedWriter::write(std::string const &record) {
+  if (!m_file) {
+    throw std::runtime_error("Error in BlockCompressedWriter: file is closed");
+  }
+  write_value(m_block, std::uint64_t(record.size()));
+  m_block.insert(m_block.end(), record.begin(), record.end());
+  ++m_block_n_record;
+  ++m_n_record;
+  if (Index(m_block.size()) >= m_block_size) {
+    _submit_block();
+  }
+}
+
+/// \brief Compress remaining records, and write the block index
+///
+/// Does nothing if already closed.
+void BlockCompressedWriter::close() {
+  if (!m_file) {
+    return;
+  }
+  try {
+    _submit_block();
+    while (!m_pending.empty()) {
+      _write_front();
+    }
+
+    std::vector<char> buffer;
+    for (BlockCompressedIndexEntry const &entry : m_index) {
+      write_value(buffer, entry.offset);
+      write_value(buffer, entry.n_compressed_bytes);
+      write_value(buffer, entry.n_bytes);
+      write_value(buffer, entry.first_record);
+      write_value(buffer, entry.n_record);
+    }
+    write_value(buffer, m_offset);
+    write_value(buffer, std::uint64_t(m_index.size()));
+    write_value(buffer, m_n_record);
+    buffer.insert(buffer.end(), magic, magic + sizeof(magic));
+    if (std::fwrite(buffer.data(), 1, buffer.size(), m_file) !=
+        buffer.size()) {
+      throw std::runtime_error("Error in BlockCompressedWriter: write failed");
+    }
+  } catch (...) {
+    std::fclose(m_file);
+    m_file = nullptr;
+    throw;
+  }
+  int status = std::fclose(m_file);
+  m_file = nullptr;
+  if (status != 0) {
+    throw std::runtime_error("Error in BlockCompressedWriter: close failed");
+  }
+}
+
+/// \brief Compress the current block on a worker thread
+///
+/// At most `2 * n_threads` blocks are held waiting to be written; if
+/// there are more, this waits for the oldest to be written.
+void BlockCompressedWriter::_submit_block() {
+  if (m_block_n_record == 0) {
+    return;
+  }
+  while (Index(m_pending.size()) >= 2 * m_n_threads) {
+    _write_front();
+  }
+
+  BlockCompressedIndexEntry entry;
+  entry.n_bytes = m_block.size();
+  entry.first_record = m_n_record - m_block_n_record;
+  entry.n_record = m_block_n_record;
+  m_pending_entry.push_back(entry);
+  m_pending.push_back(
+      std::async(std::launch::async, [block = std::move(m_block),
+                                      level = m_level]() {
+        return compress_block(block, level);
+      }));
+
+  m_block = std::vector<char>();
+  m_block_n_record = 0;
+}
+
+/// \brief Write the oldest compressed block to the file
+void BlockCompressedWriter::_write_front() {
+  std::vector<char> compressed = m_pending.front().get();
+  BlockCompressedIndexEntry entry = m_pending_entry.front();
+  m_pending.pop_front();
+  m_pending_entry.pop_front();
+
+  if (std::fwrite(compressed.data(), 1, compressed.size(), m_file) !=
+      compressed.size()) {
+    throw std::runtime_error("Error in BlockCompressedWriter: write failed");
+  }
+  entry.offset = m_offset;
+  entry.n_compressed_bytes = compressed.size();
+  m_offset += compressed.size();
+  m_index.push_back(entry);
+}
+
+/// \class BlockCompressedReader
+/// \brief Reads records from a file written by BlockCompressedWriter,
+///     decompressing blocks in parallel
+///
+/// Only the blocks holding the requested range of records are read and
+/// decompressed, so any range of records can be read without inflating
+/// the whole file.
+
+/// \brief Constructor, opens the file and reads the block index
+///
+/// \param _path Path of a file written by BlockCompressedWriter
+/// \param _n_threads Number of blocks decompressed at the same time. If
+///     0 (default), use `std::thread::hardware_concurrency()`.
+BlockCompressedReader::BlockCompressedReader(std::string const &_path,
+                                             Index _n_threads)
+    : m_file(nullptr),
+      m_n_threads(default_n_threads(_n_threads)),
+      m_n_record(0) {
+  m_file = std::fopen(_path.c_str(), "rb");
+  if (!m_file) {
+    throw std::runtime_error(
+        "Error in BlockCompressedReader: could not open file: " + _path);
+  }
+  try {
+    auto invalid = [&]() {
+      return std::runtime_error(
+          "Error in BlockCompressedReader: not a block-compressed result "
+          "stream: " +
+          _path);
+    };
+
+    char begin_magic[sizeof(magic)];
+    if (std::fread(begin_magic, 1, sizeof(magic), m_file) != sizeof(magic) ||
+        std::memcmp(begin_magic, magic, sizeof(magic)) != 0) {
+      throw invalid();
+    }
+
+    std::vector<char> buffer(footer_size);
+    if (std::fseek(m_file, -footer_size, SEEK_END) != 0 ||
+        std::fread(buffer.data(), 1, buffer.size(), m_file) !=
+            buffer.size() ||
+        std::memcmp(buffer.data() + footer_size - sizeof(magic), magic,
+                    sizeof(magic)) != 0) {
+      throw invalid();
+    }
+    std::int64_t file_size = std::ftell(m_file);
+    char const *ptr = buffer.data();
+    std::uint64_t index_offset = read_value<std::uint64_t>(ptr);
+    std::uint64_t n_block = read_value<std::uint64_t>(ptr);
+    std::uint64_t n_record = read_value<std::uint64_t>(ptr);
+    if (index_offset < sizeof(magic) ||
+        index_offset + n_block * index_entry_size + footer_size !=
+            std::uint64_t(file_size)) {
+      throw invalid();
+    }
+
+    buffer.resize(n_block * index_entry_size);
+    if (std::fseek(m_file, index_offset, SEEK_SET) != 0 ||
+        std::fread(buffer.data(), 1, buffer.size(), m_file) !=
+            buffer.size()) {
+      throw invalid();
+    }
+    ptr = buffer.data();
+    std::uint64_t expected_first_record = 0;
+    for (std::uint64_t i = 0; i < n_block; ++i) {
+      BlockCompressedIndexEntry entry;
+      entry.offset = read_value<std::uint64_t>(ptr);
+      entry.n_compressed_bytes = read_value<std::uint64_t>(ptr);
+      entry.n_bytes = read_value<std::uint64_t>(ptr);
+      entry.first_record = read_value<std::uint64_t>(ptr);
+      entry.n_record = read_value<std::uint64_t>(ptr);
+      if (entry.first_record != expected_first_record ||
+          entry.offset + entry.n_compressed_bytes > index_offset) {
+        throw invalid();
+      }
+      expected_first_record += entry.n_record;
+      m_index.push_back(entry);
+    }
+    if (expected_first_record != n_record) {
+      throw invalid();
+    }
+    m_n_record = n_record;
+  } catch (...) {
+    std::fclose(m_file);
+    m_file = nullptr;
+    throw;
+  }
+}
+
+/// \brief Destructor, closes the file
+BlockCompressedReader::~BlockCompressedReader() { std::fclose(m_file); }
+
+/// \brief Read records in the range [begin, end)
+///
+/// The compressed blocks holding the records are read, then
+/// decompressed on up to `n_threads` threads.
+///
+/// \param begin Index of the first record to read
+/// \param end One past the index of the last record to read
+///
+/// \returns records The records in the range [begin, end)
+std::vector<std::string> BlockCompressedReader::read(Index begin, Index end) {
+  if (begin < 0 || end < begin || end > m_n_record) {
+    throw std::runtime_error(
+        "Error in BlockCompressedReader::read: invalid record range");
+  }
+  std::vector<std::string> records(end - begin);
+  if (begin == end) {
+    return records;
+  }
+
+  // find blocks holding records in [begin, end)
+  auto first = std::upper_bound(
+      m_index.begin(), m_index.end(), std::uint64_t(begin),
+      [](std::uint64_t value, BlockCompressedIndexEntry const &entry) {
+        return value < entry.first_record;
+      });
+  --first;
+  std::vector<BlockCompressedIndexEntry> entries;
+  std::vector<std::vector<char>> compressed;
+  for (auto it = first;
+       it != m_index.end() && it->first_record < std::uint64_t(end); ++it) {
+    std::vector<char> buffer(it->n_compressed_bytes);
+    if (std::fseek(m_file, it->offset, SEEK_SET) != 0 ||
+        std::fread(buffer.data(), 1, buffer.size(), m_file) !=
+            buffer.size()) {
+      throw std::runtime_error(
+          "Error in BlockCompressedReader::read: read failed");
+    }
+    entries.push_back(*it);
+    compressed.push_back(std::move(buffer));
+  }
+
+  // decompress blocks in parallel; each task writes a distinct range of
+  // `records`
+  auto decompress_and_parse = [&](Index i_block) {
+    BlockCompressedIndexEntry const &entry = entries[i_block];
+    std::vector<char> block = decompress_block(compressed[i_block], entry);
+    char const *ptr = block.data();
+    char const *block_end = block.data() + block.size();
+    for (std::uint64_t r = 0; r < entry.n_record; ++r) {
+      if (block_end - ptr < std::int64_t(sizeof(std::uint64_t))) {
+        throw std::runtime_error(
+            "Error in BlockCompressedReader::read: invalid block");
+      }
+      std::uint64_t size = read_value<std::uint64_t>(ptr);
+      if (std::uint64_t(block_end - ptr) < size) {
+        throw std::runtime_error(
+            "Error in BlockCompressedReader::read: invalid block");
+      }
+      Index record_index = entry.first_record + r;
+      if (record_index >= begin && record_index < end) {
+        records[record_index - begin].assign(ptr, size);
+      }
+      ptr += size;
+    }
+  };
+
+  Index n_block = entries.size();
+  Index n_task = std::min(m_n_threads, n_block);
+  std::vector<std::future<void>> tasks;
+  for (Index t = 1; t < n_task; ++t) {
+    tasks.push_back(std::async(std::launch::async, [&, t]() {
+      for (Index i = t; i < n_block; i += n_task) {
+        decompress_and_parse(i);
+      }
+    }));
+  }
+  std::exception_ptr error;
+  try {
+    for (Index i = 0; i < n_block; i += n_task) {
+      decompress_and_parse(i);
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto &task : tasks) {
+    try {
+      task.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return records;
+}
+
+}  // namespace mapping
+}  // namespace CASM
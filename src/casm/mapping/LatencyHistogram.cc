@@ -0,0 +1,201 @@
+#include "casm/mapping/LatencyHistogram.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+/// \brief Index of the most significant set bit of a non-zero value
+int most_significant_bit(std::uint64_t value) {
+  int msb = 0;
+  while (value >>= 1) {
+    ++msb;
+  }
+  return msb;
+}
+
+}  // namespace
+
+/// \class LatencyHistogram
+/// \brief Histogram of latencies, with bounded relative error
+///
+/// Latencies are recorded as integer nanoseconds. With
+/// `S = 2^significant_bits`, values `v < 2*S` are counted in bucket `v`.
+/// Larger values are shifted right by `e = msb(v) - significant_bits`
+/// bits, keeping the `significant_bits+1` leading bits `m = v >> e`
+/// (so `S <= m < 2*S`), and are counted in bucket `e*S + m`. Each
+/// bucket therefore spans `2^e` nanoseconds, which is less than
+/// `v / S`, and buckets are only allocated up to the largest recorded
+/// value.
+///
+/// The count, minimum, maximum, and mean are exact; percentiles are
+/// reported as the upper end of the bucket containing the percentile.
+///
+/// Example, recording the latency of each `map_structures` call:
+///
+///     LatencyHistogram latency;
+///     for (auto const &structure : structures) {
+///       PerfCounts counts;
+///       {
+///         ScopedPerfCounters scoped(counts);
+///         results = map_structures(prim, structure, ...);
+///       }
+///       latency.record(counts.seconds);
+///     }
+///     double p99 = latency.value_at_percentile(99.0);
+///
+
+/// \brief Constructor
+///
+/// \param _significant_bits Number of bits of precision kept for each
+///     recorded value, in the range [1, 16]. The relative error of
+///     reported percentiles is less than `2^-significant_bits`.
+///     Default=7 (< 1% error).
+LatencyHistogram::LatencyHistogram(int _significant_bits)
+    : m_significant_bits(_significant_bits),
+      m_count(0),
+      m_min(std::numeric_limits<std::uint64_t>::max()),
+      m_max(0),
+      m_sum(0.0) {
+  if (m_significant_bits < 1 || m_significant_bits > 16) {
+    throw std::runtime_error(
+        "Error in LatencyHistogram: significant_bits must be in the range "
+        "[1, 16]");
+  }
+}
+
+/// \brief Record a latency, in seconds
+///
+/// Negative values are recorded as 0.
+void LatencyHistogram::record(double seconds) {
+  double nanoseconds = std::round(std::max(seconds, 0.0) * 1e9);
+  if (nanoseconds >= 1.8e19) {
+    nanoseconds = 1.8e19;
+  }
+  record_nanoseconds(static_cast<std::uint64_t>(nanoseconds));
+}
+
+/// \brief Record a latency, in nanoseconds
+void LatencyHistogram::record_nanoseconds(std::uint64_t nanoseconds) {
+  Index index = _bucket_index(nanoseconds);
+  if (index >= Index(m_counts.size())) {
+    m_counts.resize(index + 1, 0);
+  }
+  ++m_counts[index];
+  ++m_count;
+  m_min = std::min(m_min, nanoseconds);
+  m_max = std::max(m_max, nanoseconds);
+  m_sum += static_cast<double>(nanoseconds);
+}
+
+/// \brief Add the counts of another histogram
+///
+/// Both histograms must have the same `significant_bits`.
+void LatencyHistogram::merge(LatencyHistogram const &other) {
+  if (other.m_significant_bits != m_significant_bits) {
+    throw std::runtime_error(
+        "Error in LatencyHistogram::merge: significant_bits do not match");
+  }
+  if (other.m_counts.size() > m_counts.size()) {
+    m_counts.resize(other.m_counts.size(), 0);
+  }
+  for (Index i = 0; i < Index(other.m_counts.size()); ++i) {
+    m_counts[i] += other.m_counts[i];
+  }
+  m_count += other.m_count;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+  m_sum += other.m_sum;
+}
+
+/// \brief Minimum recorded value, in seconds (exact)
+///
+/// Returns 0.0 if no values have been recorded.
+double LatencyHistogram::min() const {
+  if (m_count == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(m_min) * 1e-9;
+}
+
+/// \brief Maximum recorded value, in seconds (exact)
+///
+/// Returns 0.0 if no values have been recorded.
+double LatencyHistogram::max() const {
+  return static_cast<double>(m_max) * 1e-9;
+}
+
+/// \brief Mean recorded value, in seconds (exact)
+///
+/// Returns 0.0 if no values have been recorded.
+double LatencyHistogram::mean() const {
+  if (m_count == 0) {
+    return 0.0;
+  }
+  return m_sum / static_cast<double>(m_count) * 1e-9;
+}
+
+/// \brief Value at a percentile, in seconds
+///
+/// \param percentile Percentile, in the range [0.0, 100.0]
+///
+/// \returns The upper end of the range of the bucket containing the
+///     value at `percentile`, limited to the range [min(), max()].
+///     Returns 0.0 if no values have been recorded.
+double LatencyHistogram::value_at_percentile(double percentile) const {
+  if (percentile < 0.0 || percentile > 100.0) {
+    throw std::runtime_error(
+        "Error in LatencyHistogram::value_at_percentile: percentile must be "
+        "in the range [0, 100]");
+  }
+  if (m_count == 0) {
+    return 0.0;
+  }
+  double target =
+      std::max(1.0, std::ceil(percentile / 100.0 * double(m_count)));
+  std::uint64_t running = 0;
+  for (Index i = 0; i < Index(m_counts.size()); ++i) {
+    running += m_counts[i];
+    if (double(running) >= target) {
+      std::uint64_t value =
+          std::clamp(bucket_range(i).second, m_min, m_max);
+      return static_cast<double>(value) * 1e-9;
+    }
+  }
+  return max();
+}
+
+/// \brief Range of values, in nanoseconds, counted by a bucket
+///
+/// \returns Pair of (lowest, highest) value counted by the bucket,
+///     inclusive
+std::pair<std::uint64_t, std::uint64_t> LatencyHistogram::bucket_range(
+    Index index) const {
+  std::uint64_t S = std::uint64_t(1) << m_significant_bits;
+  std::uint64_t i = index;
+  if (i < 2 * S) {
+    return std::make_pair(i, i);
+  }
+  std::uint64_t e = i / S - 1;
+  std::uint64_t m = i - e * S;
+  return std::make_pair(m << e, ((m + 1) << e) - 1);
+}
+
+/// \brief Bucket index for a value, in nanoseconds
+Index LatencyHistogram::_bucket_index(std::uint64_t nanoseconds) const {
+  std::uint64_t S = std::uint64_t(1) << m_significant_bits;
+  if (nanoseconds < 2 * S) {
+    return nanoseconds;
+  }
+  std::uint64_t e = most_significant_bit(nanoseconds) - m_significant_bits;
+  std::uint64_t m = nanoseconds >> e;
+  return e * S + m;
+}
+
+}  // namespace mapping
+}  // namespace CASM
@@ -1,6 +1,7 @@
 #include "casm/mapping/LatticeMapping.hh"
 
 #include "casm/crystallography/Lattice.hh"
+#include "casm/mapping/misc.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 
 namespace CASM {
@@ -124,5 +125,23 @@ xtal::Lattice make_mapped_lattice(xtal::Lattice const &parent_lattice,
   return xtal::Lattice(U * L1 * T * N);
 }
 
+/// \brief Total order of lattice mappings, for reproducible ordering
+///     of results with equal cost
+///
+/// Compares, exactly and in order, the transformation matrix to the
+/// superlattice, the reorientation matrix, and the deformation gradient.
+bool total_order_less(LatticeMapping const &lhs, LatticeMapping const &rhs) {
+  if (lhs.transformation_matrix_to_super !=
+      rhs.transformation_matrix_to_super) {
+    return matrix_lexicographical_less(lhs.transformation_matrix_to_super,
+                                       rhs.transformation_matrix_to_super);
+  }
+  if (lhs.reorientation != rhs.reorientation) {
+    return matrix_lexicographical_less(lhs.reorientation, rhs.reorientation);
+  }
+  return matrix_lexicographical_less(lhs.deformation_gradient,
+                                     rhs.deformation_gradient);
+}
+
 }  // namespace mapping
 }  // namespace CASM
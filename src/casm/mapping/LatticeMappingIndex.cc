@@ -0,0 +1,286 @@
+#include "casm/mapping/LatticeMappingIndex.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "casm/crystallography/Niggli.hh"
+#include "casm/mapping/lattice_cost.hh"
+#include "casm/misc/CASM_Eigen_math.hh"
+
+namespace CASM {
+namespace mapping {
+
+/// \brief Return the Niggli-reduced lattice and the unimodular matrix, U,
+///     that gives it (L_reduced = L * U)
+///
+/// Handedness is kept, so det(U) == 1.
+///
+/// \param lattice The lattice to reduce
+///
+/// \returns {reduced_lattice, U}
+std::pair<xtal::Lattice, Eigen::Matrix3l> make_reduced_lattice(
+    xtal::Lattice const &lattice) {
+  bool keep_handedness = true;
+  xtal::Lattice reduced = xtal::niggli(lattice, lattice.tol(), keep_handedness);
+  Eigen::Matrix3l U = lround(lattice.lat_column_mat().inverse() *
+                             reduced.lat_column_mat());
+  return std::make_pair(reduced, U);
+}
+
+/// \brief Return lattice metric invariants, used to find similar lattices
+///
+/// The invariants are the independent elements of the metric tensor,
+/// G = L^T * L, of the Niggli-reduced lattice, normalized by
+/// det(L)^(2/3) so that they do not depend on volume:
+///
+///     (G00, G11, G22, sqrt(2)*G12, sqrt(2)*G02, sqrt(2)*G01) / det(L)^(2/3)
+///
+/// The Euclidean distance between invariants is the Frobenius norm
+/// of the difference of the normalized metric tensors.
+///
+/// \param lattice A lattice. It is Niggli-reduced before the invariants
+///     are calculated.
+///
+/// \returns The metric invariants
+LatticeMetricInvariant make_lattice_metric_invariant(
+    xtal::Lattice const &lattice) {
+  Eigen::Matrix3d L = make_reduced_lattice(lattice).first.lat_column_mat();
+  Eigen::Matrix3d G = L.transpose() * L;
+  G /= std::pow(std::abs(L.determinant()), 2.0 / 3.0);
+  LatticeMetricInvariant x;
+  x << G(0, 0), G(1, 1), G(2, 2), std::sqrt(2.0) * G(1, 2),
+      std::sqrt(2.0) * G(0, 2), std::sqrt(2.0) * G(0, 1);
+  return x;
+}
+
+/// \brief Constructor
+///
+/// \param _lattice1 The reference "parent" lattice, L1, of all lattice
+///     mappings stored in the index
+/// \param _lattice1_point_group Parent point group, used if `_cost_method`
+///     is "symmetry_breaking_strain_cost"
+/// \param _cost_method One of "isotropic_strain_cost" or
+///     "symmetry_breaking_strain_cost", used to calculate the cost of
+///     candidate lattice mappings
+LatticeMappingIndex::LatticeMappingIndex(
+    xtal::Lattice const &_lattice1,
+    std::vector<xtal::SymOp> _lattice1_point_group, std::string _cost_method)
+    : m_lattice1(_lattice1),
+      m_lattice1_point_group(std::move(_lattice1_point_group)),
+      m_cost_method(std::move(_cost_method)) {
+  if (m_cost_method != "isotropic_strain_cost" &&
+      m_cost_method != "symmetry_breaking_strain_cost") {
+    throw std::runtime_error(
+        "Error in LatticeMappingIndex: cost_method not recognized");
+  }
+  if (m_lattice1_point_group.empty()) {
+    m_lattice1_point_group.push_back(xtal::SymOp::identity());
+  }
+}
+
+/// \brief Insert lattice mappings for a child lattice
+///
+/// The lattice mappings are stored relative to the Niggli-reduced
+/// child lattice, so that they can be adjusted to any similar child
+/// lattice, independent of its choice of lattice vectors.
+///
+/// Inserted entries are searched linearly until there are enough of
+/// them to make rebuilding the k-d tree worthwhile.
+///
+/// \param lattice2 The child lattice, L2
+/// \param lattice_mappings Lattice mappings, F * L1 * T * N = L2, such
+///     as the results of `map_lattices` or the lattice mappings of the
+///     best structure mappings
+void LatticeMappingIndex::insert(
+    xtal::Lattice const &lattice2,
+    LatticeMappingResults const &lattice_mappings) {
+  auto reduced = make_reduced_lattice(lattice2);
+  Eigen::Matrix3d U = reduced.second.cast<double>();
+
+  LatticeMappingIndexEntry entry{reduced.first,
+                                 make_lattice_metric_invariant(reduced.first),
+                                 LatticeMappingResults()};
+  for (auto const &m : lattice_mappings) {
+    entry.lattice_mappings.data.emplace_back(
+        m.lattice_cost,
+        LatticeMapping(m.deformation_gradient, m.transformation_matrix_to_super,
+                       m.reorientation * U));
+  }
+  m_entries.push_back(std::move(entry));
+
+  Index n_pending = m_entries.size() - m_tree.size();
+  if (n_pending * n_pending > m_entries.size() || n_pending > 64) {
+    _rebuild();
+  }
+}
+
+/// \brief Find the entries nearest a child lattice
+///
+/// \param lattice2 The child lattice, L2
+/// \param k_nearest Maximum number of entries to return
+/// \param max_distance Maximum distance between lattice metric
+///     invariants (see `make_lattice_metric_invariant`) of entries
+///     to return
+///
+/// \returns A vector of {distance, entry_index}, sorted by distance
+std::vector<std::pair<double, Index>> LatticeMappingIndex::nearest(
+    xtal::Lattice const &lattice2, Index k_nearest,
+    double max_distance) const {
+  std::vector<std::pair<double, Index>> heap;
+  if (k_nearest < 1) {
+    return heap;
+  }
+  LatticeMetricInvariant x = make_lattice_metric_invariant(lattice2);
+  _search(x, 0, m_tree.size(), 0, k_nearest, max_distance, heap);
+  for (Index i = m_tree.size(); i < m_entries.size(); ++i) {
+    _push({(m_entries[i].invariant - x).norm(), i}, k_nearest, heap);
+  }
+  std::sort_heap(heap.begin(), heap.end());
+  heap.erase(std::remove_if(heap.begin(), heap.end(),
+                            [&](std::pair<double, Index> const &value) {
+                              return value.first > max_distance;
+                            }),
+             heap.end());
+  return heap;
+}
+
+/// \brief Make candidate lattice mappings for a child lattice from
+///     the lattice mappings of the nearest entries
+///
+/// For each lattice mapping, F' * L1 * T * N' = L2', of the nearest
+/// entries, this keeps T and adjusts the reorientation matrix to the
+/// new child lattice, N = N' * U^-1, where L2' = L2 * U is the
+/// Niggli-reduced new child lattice. The deformation gradient and cost
+/// are then calculated exactly for the new child lattice, so the
+/// candidates are valid lattice mappings. If the child lattices are
+/// similar, the candidates are expected to be low cost and may be used
+/// to bound a lattice mapping search, as in `map_lattices_warm_start`.
+///
+/// \param lattice2 The child lattice, L2
+/// \param k_nearest Number of nearest entries to use
+/// \param max_distance Maximum distance between lattice metric
+///     invariants of the entries used
+///
+/// \returns Candidate lattice mappings, F * L1 * T * N = L2, without
+///     duplicates, sorted by lattice mapping cost.
+LatticeMappingResults LatticeMappingIndex::make_candidates(
+    xtal::Lattice const &lattice2, Index k_nearest,
+    double max_distance) const {
+  Eigen::Matrix3d L1 = m_lattice1.lat_column_mat();
+  Eigen::Matrix3d L2 = lattice2.lat_column_mat();
+  Eigen::Matrix3d U_inv =
+      make_reduced_lattice(lattice2).second.cast<double>().inverse();
+
+  LatticeMappingResults candidates;
+  std::vector<Eigen::Matrix3l> superlattice_matrices;
+  for (auto const &neighbor : nearest(lattice2, k_nearest, max_distance)) {
+    for (auto const &m : m_entries[neighbor.second].lattice_mappings) {
+      Eigen::Matrix3d T = m.transformation_matrix_to_super;
+      Eigen::Matrix3d N = lround(m.reorientation * U_inv).cast<double>();
+      Eigen::Matrix3l TN = lround(T * N);
+      if (std::find(superlattice_matrices.begin(),
+                    superlattice_matrices.end(),
+                    TN) != superlattice_matrices.end()) {
+        continue;
+      }
+      superlattice_matrices.push_back(TN);
+
+      Eigen::Matrix3d F = L2 * (L1 * T * N).inverse();
+      double cost = (m_cost_method == "isotropic_strain_cost")
+                        ? isotropic_strain_cost(F)
+                        : symmetry_breaking_strain_cost(
+                              F, m_lattice1_point_group);
+      candidates.data.emplace_back(cost, LatticeMapping(F, T, N));
+    }
+  }
+  std::stable_sort(
+      candidates.data.begin(), candidates.data.end(),
+      [](ScoredLatticeMapping const &lhs, ScoredLatticeMapping const &rhs) {
+        return lhs.lattice_cost < rhs.lattice_cost;
+      });
+  return candidates;
+}
+
+/// \brief Rebuild the k-d tree over all entries
+void LatticeMappingIndex::_rebuild() {
+  m_tree.resize(m_entries.size());
+  for (Index i = 0; i < m_tree.size(); ++i) {
+    m_tree[i] = i;
+  }
+  _build(0, m_tree.size(), 0);
+}
+
+/// \brief Build the k-d tree for m_tree[begin, end)
+///
+/// The median element along the axis for this depth is placed at
+/// mid = (begin + end) / 2, with lesser elements before it and
+/// greater elements after it.
+void LatticeMappingIndex::_build(Index begin, Index end, int depth) {
+  if (end - begin < 2) {
+    return;
+  }
+  int axis = depth % 6;
+  Index mid = (begin + end) / 2;
+  std::nth_element(m_tree.begin() + begin, m_tree.begin() + mid,
+                   m_tree.begin() + end, [&](Index lhs, Index rhs) {
+                     return m_entries[lhs].invariant(axis) <
+                            m_entries[rhs].invariant(axis);
+                   });
+  _build(begin, mid, depth + 1);
+  _build(mid + 1, end, depth + 1);
+}
+
+/// \brief Search the k-d tree for m_tree[begin, end)
+void LatticeMappingIndex::_search(
+    LatticeMetricInvariant const &x, Index begin, Index end, int depth,
+    Index k_nearest, double max_distance,
+    std::vector<std::pair<double, Index>> &heap) const {
+  if (end <= begin) {
+    return;
+  }
+  int axis = depth % 6;
+  Index mid = (begin + end) / 2;
+  Index i = m_tree[mid];
+  _push({(m_entries[i].invariant - x).norm(), i}, k_nearest, heap);
+
+  double diff = x(axis) - m_entries[i].invariant(axis);
+  bool lower_first = (diff < 0.0);
+  if (lower_first) {
+    _search(x, begin, mid, depth + 1, k_nearest, max_distance, heap);
+  } else {
+    _search(x, mid + 1, end, depth + 1, k_nearest, max_distance, heap);
+  }
+
+  // only search the other side if it may contain a nearer entry
+  double bound = max_distance;
+  if (heap.size() == k_nearest) {
+    bound = std::min(bound, heap.front().first);
+  }
+  if (std::abs(diff) <= bound) {
+    if (lower_first) {
+      _search(x, mid + 1, end, depth + 1, k_nearest, max_distance, heap);
+    } else {
+      _search(x, begin, mid, depth + 1, k_nearest, max_distance, heap);
+    }
+  }
+}
+
+/// \brief Add a candidate to the k nearest
+///
+/// The `heap` is a max-heap by distance with at most k_nearest elements.
+void LatticeMappingIndex::_push(
+    std::pair<double, Index> value, Index k_nearest,
+    std::vector<std::pair<double, Index>> &heap) const {
+  if (heap.size() < k_nearest) {
+    heap.push_back(value);
+    std::push_heap(heap.begin(), heap.end());
+  } else if (value < heap.front()) {
+    std::pop_heap(heap.begin(), heap.end());
+    heap.back() = value;
+    std::push_heap(heap.begin(), heap.end());
+  }
+}
+
+}  // namespace mapping
+}  // namespace CASM
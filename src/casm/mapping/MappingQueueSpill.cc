@@ -0,0 +1,406 @@
+#include "casm/mapping/MappingQueueSpill.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+
+#include "casm/mapping/SearchData.hh"
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+double now_seconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+template <typename T>
+void write_value(std::vector<char> &buffer, T const &value) {
+  char const *begin = reinterpret_cast<char const *>(&value);
+  buffer.insert(buffer.end(), begin, begin + sizeof(T));
+}
+
+template <typename Container>
+void write_pairs(std::vector<char> &buffer, Container const &pairs) {
+  write_value(buffer, std::int64_t(pairs.size()));
+  for (auto const &pair : pairs) {
+    write_value(buffer, std::int64_t(pair.first));
+    write_value(buffer, std::int64_t(pair.second));
+  }
+}
+
+template <typename T>
+T read_value(char const *&ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  ptr += sizeof(T);
+  return value;
+}
+
+std::map<Index, Index> read_map(char const *&ptr) {
+  std::map<Index, Index> result;
+  std::int64_t size = read_value<std::int64_t>(ptr);
+  for (std::int64_t i = 0; i < size; ++i) {
+    Index first = read_value<std::int64_t>(ptr);
+    Index second = read_value<std::int64_t>(ptr);
+    result.emplace_hint(result.end(), first, second);
+  }
+  return result;
+}
+
+std::vector<std::pair<Index, Index>> read_vector(char const *&ptr) {
+  std::vector<std::pair<Index, Index>> result;
+  std::int64_t size = read_value<std::int64_t>(ptr);
+  result.reserve(size);
+  for (std::int64_t i = 0; i < size; ++i) {
+    Index first = read_value<std::int64_t>(ptr);
+    Index second = read_value<std::int64_t>(ptr);
+    result.emplace_back(first, second);
+  }
+  return result;
+}
+
+}  // namespace
+
+/// \class MappingQueueSpill
+/// \brief Holds the highest cost part of a MappingSearch queue in a
+///     temporary file
+///
+/// Each spilled MappingNode is written in a compact form: the costs,
+/// the trial translation, the id of the shared LatticeMappingSearchData
+/// it references, and the `forced_on`, `forced_off`, and
+/// `sub_assignment` of its murty::Node. The shared lattice mapping data
+/// is kept in memory, as long as it is referenced by a spilled
+/// MappingNode. The AtomMappingSearchData, which holds supercell-sized
+/// site displacements and cost matrix, is released when a MappingNode is
+/// spilled, and it is re-constructed (or found in the
+/// AtomMappingSearchDataCache, if enabled) with the AtomMapping when the
+/// MappingNode is reloaded.
+///
+/// An in-memory index orders spilled MappingNode by total cost, and
+/// then by the order they were written, so MappingNode with exactly
+/// equal total cost are reloaded in the order they were spilled.
+/// `pop_front(n)` reads n MappingNode in order of their position in the
+/// file, with one read for each run of adjacent records, so reloading a
+/// group of MappingNode that were spilled together mostly reads the file
+/// sequentially.
+///
+/// The space of removed MappingNode is re-used: freed extents are
+/// merged with adjacent free extents, and new records are written in
+/// the smallest free extent that fits, or at the end of the file. The
+/// file is removed when the MappingQueueSpill is destroyed.
+
+/// \brief Constructor
+///
+/// \param _path If provided, the spill file is created at this path
+///     (overwriting any existing file) and removed on destruction.
+///     Otherwise, an anonymous temporary file is created with
+///     `std::tmpfile`.
+MappingQueueSpill::MappingQueueSpill(std::optional<std::string> _path)
+    : m_path(_path), m_file(nullptr), m_end(0), m_next_sequence(0) {
+  if (m_path.has_value()) {
+    m_file = std::fopen(m_path->c_str(), "w+b");
+  } else {
+    m_file = std::tmpfile();
+  }
+  if (m_file == nullptr) {
+    throw std::runtime_error(
+        "Error in MappingQueueSpill: could not open spill file");
+  }
+}
+
+MappingQueueSpill::~MappingQueueSpill() {
+  std::fclose(m_file);
+  if (m_path.has_value()) {
+    std::remove(m_path->c_str());
+  }
+}
+
+/// \brief Total cost of the lowest cost spilled MappingNode
+///
+/// Invalid if !size()
+double MappingQueueSpill::front_cost() const {
+  return m_index.begin()->total_cost;
+}
+
+/// \brief Write a MappingNode to the spill file
+///
+/// MappingNode with exactly equal total cost are reloaded in the
+/// order they are written.
+void MappingQueueSpill::push_back(SpilledMappingNode const &node) {
+  murty::Node const &assignment_node = node.assignment_node;
+  m_buffer.clear();
+  write_value(m_buffer, node.lattice_cost);
+  write_value(m_buffer, node.atom_cost);
+  write_value(m_buffer, node.total_cost);
+  write_value(m_buffer, assignment_node.cost);
+  for (Index i = 0; i < 3; ++i) {
+    write_value(m_buffer, node.trial_translation_cart(i));
+  }
+  write_pairs(m_buffer, assignment_node.forced_on);
+  write_pairs(m_buffer, assignment_node.forced_off);
+  write_pairs(m_buffer, assignment_node.sub_assignment);
+
+  Entry entry;
+  entry.total_cost = node.total_cost;
+  entry.sequence = m_next_sequence++;
+  entry.n_bytes = m_buffer.size();
+  entry.offset = _allocate(entry.n_bytes);
+
+  double start = now_seconds();
+  if (std::fseek(m_file, entry.offset, SEEK_SET) != 0 ||
+      std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) !=
+          m_buffer.size()) {
+    throw std::runtime_error(
+        "Error in MappingQueueSpill: failed to write spill file");
+  }
+  statistics.io_time += now_seconds() - start;
+
+  entry.lattice_mapping_data_id =
+      m_lattice_mapping_data.add(node.lattice_mapping_data);
+  m_index.insert(entry);
+
+  statistics.n_spilled_mapping_node += 1;
+  statistics.n_bytes_written += entry.n_bytes;
+  statistics.max_n_bytes_file =
+      std::max(statistics.max_n_bytes_file, Index(m_end));
+}
+
+/// \brief Read and remove the lowest cost spilled MappingNode
+///
+/// Invalid if !size()
+SpilledMappingNode MappingQueueSpill::pop_front() {
+  return std::move(pop_front(1).front());
+}
+
+/// \brief Read and remove the n lowest cost spilled MappingNode
+///
+/// The records are read in order of their position in the file, with one
+/// read for each run of adjacent records.
+///
+/// \param n Number of MappingNode to read and remove. If greater than
+///     `size()`, all spilled MappingNode are read and removed.
+///
+/// \returns The spilled MappingNode, in order of increasing total cost,
+///     as by repeated calls to `pop_front()`
+std::vector<SpilledMappingNode> MappingQueueSpill::pop_front(Index n) {
+  std::vector<Entry> entries;
+  auto it = m_index.begin();
+  while (Index(entries.size()) < n && it != m_index.end()) {
+    entries.push_back(*it);
+    it = m_index.erase(it);
+  }
+
+  std::vector<Index> order(entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](Index lhs, Index rhs) {
+    return entries[lhs].offset < entries[rhs].offset;
+  });
+
+  std::vector<SpilledMappingNode> result(entries.size());
+  Index begin = 0;
+  while (begin < Index(order.size())) {
+    Entry const &first = entries[order[begin]];
+    Index end = begin + 1;
+    std::int64_t run_end = first.offset + first.n_bytes;
+    while (end < Index(order.size()) &&
+           entries[order[end]].offset == run_end) {
+      run_end += entries[order[end]].n_bytes;
+      ++end;
+    }
+    _read_bytes(first.offset, run_end - first.offset);
+    for (Index k = begin; k < end; ++k) {
+      Entry const &entry = entries[order[k]];
+      result[order[k]] =
+          _decode(entry, m_buffer.data() + (entry.offset - first.offset));
+    }
+    begin = end;
+  }
+
+  for (Entry const &entry : entries) {
+    _release(entry);
+  }
+  statistics.n_reloaded_mapping_node += entries.size();
+  return result;
+}
+
+/// \brief Read the highest cost spilled MappingNode
+///
+/// Invalid if !size()
+SpilledMappingNode MappingQueueSpill::back() {
+  Entry const &entry = *m_index.rbegin();
+  _read_bytes(entry.offset, entry.n_bytes);
+  return _decode(entry, m_buffer.data());
+}
+
+/// \brief Remove the highest cost spilled MappingNode, without reading it
+///
+/// Invalid if !size()
+void MappingQueueSpill::pop_back() {
+  auto it = std::prev(m_index.end());
+  _release(*it);
+  m_index.erase(it);
+}
+
+/// \brief Return the offset of a record of n_bytes, using the smallest
+///     free extent that fits, else the end of the file
+std::int64_t MappingQueueSpill::_allocate(std::int64_t n_bytes) {
+  auto it = m_free_by_size.lower_bound(n_bytes);
+  if (it == m_free_by_size.end()) {
+    std::int64_t offset = m_end;
+    m_end += n_bytes;
+    return offset;
+  }
+  std::int64_t offset = it->second;
+  std::int64_t extent_n_bytes = it->first;
+  m_free_by_size.erase(it);
+  m_free_by_offset.erase(offset);
+  if (extent_n_bytes > n_bytes) {
+    m_free_by_offset.emplace(offset + n_bytes, extent_n_bytes - n_bytes);
+    m_free_by_size.emplace(extent_n_bytes - n_bytes, offset + n_bytes);
+  }
+  return offset;
+}
+
+/// \brief Mark an extent of the file as free, merging it with adjacent
+///     free extents, or shrinking the file if it is at the end
+void MappingQueueSpill::_free(std::int64_t offset, std::int64_t n_bytes) {
+  auto erase_by_size = [&](std::int64_t _offset, std::int64_t _n_bytes) {
+    auto range = m_free_by_size.equal_range(_n_bytes);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == _offset) {
+        m_free_by_size.erase(it);
+        return;
+      }
+    }
+  };
+
+  // merge with the following free extent
+  auto next = m_free_by_offset.find(offset + n_bytes);
+  if (next != m_free_by_offset.end()) {
+    erase_by_size(next->first, next->second);
+    n_bytes += next->second;
+    m_free_by_offset.erase(next);
+  }
+
+  // merge with the preceding free extent
+  auto prev = m_free_by_offset.lower_bound(offset);
+  if (prev != m_free_by_offset.begin()) {
+    --prev;
+    if (prev->first + prev->second == offset) {
+      erase_by_size(prev->first, prev->second);
+      offset = prev->first;
+      n_bytes += prev->second;
+      m_free_by_offset.erase(prev);
+    }
+  }
+
+  if (offset + n_bytes == m_end) {
+    m_end = offset;
+    return;
+  }
+  m_free_by_offset.emplace(offset, n_bytes);
+  m_free_by_size.emplace(n_bytes, offset);
+}
+
+/// \brief Read n_bytes at offset into m_buffer
+void MappingQueueSpill::_read_bytes(std::int64_t offset,
+                                    std::int64_t n_bytes) {
+  m_buffer.resize(n_bytes);
+  double start = now_seconds();
+  if (std::fseek(m_file, offset, SEEK_SET) != 0 ||
+      std::fread(m_buffer.data(), 1, m_buffer.size(), m_file) !=
+          m_buffer.size()) {
+    throw std::runtime_error(
+        "Error in MappingQueueSpill: failed to read spill file");
+  }
+  statistics.io_time += now_seconds() - start;
+  statistics.n_bytes_read += n_bytes;
+}
+
+/// \brief Decode the record of `entry`, beginning at `ptr`
+SpilledMappingNode MappingQueueSpill::_decode(Entry const &entry,
+                                              char const *ptr) const {
+  SpilledMappingNode node;
+  node.lattice_mapping_data =
+      m_lattice_mapping_data.get(entry.lattice_mapping_data_id);
+
+  node.lattice_cost = read_value<double>(ptr);
+  node.atom_cost = read_value<double>(ptr);
+  node.total_cost = read_value<double>(ptr);
+  double assignment_cost = read_value<double>(ptr);
+  for (Index i = 0; i < 3; ++i) {
+    node.trial_translation_cart(i) = read_value<double>(ptr);
+  }
+  std::map<Index, Index> forced_on = read_map(ptr);
+  std::vector<std::pair<Index, Index>> forced_off = read_vector(ptr);
+
+  // the cost matrix is N_supercell_site x N_supercell_site
+  Index N_site = node.lattice_mapping_data->N_supercell_site;
+  node.assignment_node.forced_on = std::move(forced_on);
+  node.assignment_node.forced_off = std::move(forced_off);
+  for (Index i = 0; i < N_site; ++i) {
+    node.assignment_node.unassigned_rows.insert(i);
+    node.assignment_node.unassigned_cols.insert(i);
+  }
+  for (auto const &pair : node.assignment_node.forced_on) {
+    node.assignment_node.unassigned_rows.erase(pair.first);
+    node.assignment_node.unassigned_cols.erase(pair.second);
+  }
+  node.assignment_node.sub_assignment = read_map(ptr);
+  node.assignment_node.cost = assignment_cost;
+  return node;
+}
+
+void MappingQueueSpill::_release(Entry const &entry) {
+  m_lattice_mapping_data.release(entry.lattice_mapping_data_id);
+  _free(entry.offset, entry.n_bytes);
+}
+
+template <typename DataType>
+Index MappingQueueSpill::SharedDataTable<DataType>::add(
+    std::shared_ptr<DataType const> const &_data) {
+  auto it = id.find(_data.get());
+  if (it != id.end()) {
+    n_ref[it->second] += 1;
+    return it->second;
+  }
+  Index i;
+  if (unused_id.size()) {
+    i = unused_id.back();
+    unused_id.pop_back();
+    data[i] = _data;
+    n_ref[i] = 1;
+  } else {
+    i = data.size();
+    data.push_back(_data);
+    n_ref.push_back(1);
+  }
+  id.emplace(_data.get(), i);
+  return i;
+}
+
+template <typename DataType>
+std::shared_ptr<DataType const> const &
+MappingQueueSpill::SharedDataTable<DataType>::get(Index i) const {
+  return data[i];
+}
+
+template <typename DataType>
+void MappingQueueSpill::SharedDataTable<DataType>::release(Index i) {
+  n_ref[i] -= 1;
+  if (n_ref[i] == 0) {
+    id.erase(data[i].get());
+    data[i].reset();
+    unused_id.push_back(i);
+  }
+}
+
+}  // namespace mapping
+}  // namespace CASM
@@ -1,9 +1,10 @@
 #include "casm/mapping/MappingSearch.hh"
 
+#include <cmath>
+#include <tuple>
+
 #include "casm/mapping/atom_cost.hh"
-#include "casm/mapping/hungarian.hh"
 #include "casm/mapping/impl/LatticeMap.hh"
-#include "casm/mapping/misc.hh"
 
 namespace CASM {
 namespace mapping {
@@ -97,6 +98,160 @@ AtomMapping make_atom_mapping_from_assignment(
   return AtomMapping(disp, perm, deformation_gradient * trial_translation);
 }
 
+/// \brief Return the mean displacement and displacement moment of an
+///     assignment solution, without constructing an AtomMapping
+///
+/// This gives the same mean displacement that is removed by
+/// `make_atom_mapping_from_assignment`, and the displacement moment,
+///
+///     D = sum_i d[i] * d[i]^T,
+///
+/// of the resulting AtomMapping displacements, d, in O(N) time without
+/// allocating storage proportional to N. The isotropic atom cost can be
+/// calculated from D using `make_isotropic_atom_cost`.
+///
+/// \param assignment Assignment solution, with the convention
+///     `atom_index = assignment[site_index]`.
+/// \param site_displacements The site-to-atom displacements,
+///     of minimum length under periodic boundary conditions
+///     as used in the assignment problem.
+/// \param enable_remove_mean_displacement If true, the mean
+///     displacement is calculated and removed. Otherwise, the mean
+///     displacement returned is zero.
+///
+/// \returns {mean_displacement, displacement_moment}
+std::pair<Eigen::Vector3d, Eigen::Matrix3d>
+make_displacement_moment_from_assignment(
+    std::vector<Index> const &assignment,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    bool enable_remove_mean_displacement) {
+  Index N_site = assignment.size();
+  auto const &perm = assignment;
+
+  Eigen::Vector3d mean_disp = Eigen::Vector3d::Zero();
+  if (enable_remove_mean_displacement) {
+    double n = 0.0;
+    for (Index site_index = 0; site_index < N_site; ++site_index) {
+      Index atom_index = perm[site_index];
+      if (atom_index >= site_displacements[site_index].size()) {
+        continue;
+      }
+      mean_disp += site_displacements[site_index][atom_index];
+      n += 1.0;
+    }
+    mean_disp /= n;
+  }
+
+  Eigen::Matrix3d moment = Eigen::Matrix3d::Zero();
+  for (Index site_index = 0; site_index < N_site; ++site_index) {
+    Index atom_index = perm[site_index];
+    if (atom_index >= site_displacements[site_index].size()) {
+      continue;
+    }
+    Eigen::Vector3d d = site_displacements[site_index][atom_index] - mean_disp;
+    moment.noalias() += d * d.transpose();
+  }
+  return std::make_pair(mean_disp, moment);
+}
+
+/// \brief Return a pointer to the functor held by `f` if it is of
+///     type F, else nullptr
+template <typename F, typename R, typename... Args>
+F const *functor_target(std::function<R(Args...)> const &f) {
+  return f.template target<F>();
+}
+
+/// \brief Return the AtomMappingSearchData for a lattice mapping and
+///     trial translation
+///
+/// If `search.atom_mapping_data_cache` is enabled, the data is looked
+/// up in the cache, and constructed and inserted if not found.
+/// Otherwise, the data is constructed.
+std::shared_ptr<AtomMappingSearchData const> make_atom_mapping_data(
+    MappingSearch const &search,
+    std::shared_ptr<LatticeMappingSearchData const> const
+        &lattice_mapping_data,
+    Eigen::Vector3d const &trial_translation_cart) {
+  std::shared_ptr<AtomMappingSearchData const> atom_mapping_data;
+  if (search.atom_mapping_data_cache) {
+    atom_mapping_data = search.atom_mapping_data_cache->find(
+        *lattice_mapping_data, trial_translation_cart);
+    if (atom_mapping_data) {
+      return atom_mapping_data;
+    }
+  }
+  atom_mapping_data = std::make_shared<AtomMappingSearchData const>(
+      lattice_mapping_data, trial_translation_cart, search.atom_to_site_cost_f,
+      search.infinity);
+  if (search.atom_mapping_data_cache) {
+    search.atom_mapping_data_cache->insert(atom_mapping_data);
+  }
+  return atom_mapping_data;
+}
+
+/// \brief Solve the (constrained) assignment problem for a lattice
+///     mapping and trial translation
+///
+/// \returns The assignment problem node, with the optimal
+///     sub_assignment and its cost
+murty::Node make_optimal_assignment_node(
+    MappingSearch const &search, AtomMappingSearchData const &atom_mapping_data,
+    std::map<Index, Index> forced_on,
+    std::vector<std::pair<Index, Index>> forced_off) {
+  murty::Node assignment_node =
+      murty::make_node(atom_mapping_data.cost_matrix, std::move(forced_on),
+                       std::move(forced_off));
+  std::tie(assignment_node.cost, assignment_node.sub_assignment) =
+      murty::make_sub_assignment(
+          search.assignment_f, atom_mapping_data.cost_matrix,
+          assignment_node.unassigned_rows, assignment_node.unassigned_cols,
+          assignment_node.forced_off, search.infinity, search.cost_tol);
+  return assignment_node;
+}
+
+/// \brief Return the AtomMappingSearchData of a MappingNode, from the
+///     MappingNode if it holds it, else from the cache
+std::shared_ptr<AtomMappingSearchData const> get_atom_mapping_data(
+    MappingSearch const &search, MappingNode const &mapping_node) {
+  if (mapping_node.atom_mapping_data) {
+    return mapping_node.atom_mapping_data;
+  }
+  return make_atom_mapping_data(search, mapping_node.lattice_mapping_data,
+                                mapping_node.trial_translation_cart);
+}
+
+/// \brief Make a new MappingNode from an assignment problem node, its
+///     AtomMapping, and atom cost
+///
+/// This calculates the total_cost using the parameters specified at
+/// MappingSearch construction time.
+MappingNode make_mapping_node_from_atom_mapping(
+    MappingSearch const &search, murty::Node assignment_node,
+    double lattice_cost,
+    std::shared_ptr<LatticeMappingSearchData const> lattice_mapping_data,
+    std::shared_ptr<AtomMappingSearchData const> atom_mapping_data,
+    AtomMapping atom_mapping, double atom_cost) {
+  double total_cost;
+  if (auto const *f = functor_target<WeightedTotalCost>(search.total_cost_f)) {
+    total_cost = (*f)(lattice_cost, *lattice_mapping_data, atom_cost,
+                      *atom_mapping_data, atom_mapping);
+  } else {
+    total_cost = search.total_cost_f(lattice_cost, *lattice_mapping_data,
+                                     atom_cost, *atom_mapping_data,
+                                     atom_mapping);
+  }
+  Eigen::Vector3d trial_translation_cart =
+      atom_mapping_data->trial_translation_cart;
+  if (search.atom_mapping_data_cache) {
+    // only the cache holds the data, so that it may be evicted
+    atom_mapping_data.reset();
+  }
+  return MappingNode(lattice_cost, std::move(lattice_mapping_data), atom_cost,
+                     std::move(atom_mapping_data), trial_translation_cart,
+                     std::move(assignment_node), std::move(atom_mapping),
+                     total_cost);
+}
+
 /// \brief Make a new MappingNode from an assignment problem node
 ///     with a solved sub_assignment
 ///
@@ -116,14 +271,62 @@ MappingNode make_mapping_node_from_assignment_node(
       atom_mapping_data->trial_translation_cart,
       lattice_mapping_data->lattice_mapping.deformation_gradient,
       search.enable_remove_mean_displacement);
-  double atom_cost = search.atom_cost_f(*lattice_mapping_data,
-                                        *atom_mapping_data, atom_mapping);
-  double total_cost =
-      search.total_cost_f(lattice_cost, *lattice_mapping_data, atom_cost,
-                          *atom_mapping_data, atom_mapping);
-  return MappingNode(lattice_cost, std::move(lattice_mapping_data), atom_cost,
-                     std::move(atom_mapping_data), std::move(assignment_node),
-                     std::move(atom_mapping), total_cost);
+  double atom_cost;
+  if (auto const *f = functor_target<IsotropicAtomCost>(search.atom_cost_f)) {
+    atom_cost = (*f)(*lattice_mapping_data, *atom_mapping_data, atom_mapping);
+  } else {
+    atom_cost = search.atom_cost_f(*lattice_mapping_data, *atom_mapping_data,
+                                   atom_mapping);
+  }
+  return make_mapping_node_from_atom_mapping(
+      search, std::move(assignment_node), lattice_cost,
+      std::move(lattice_mapping_data), std::move(atom_mapping_data),
+      std::move(atom_mapping), atom_cost);
+}
+
+/// \brief Write a MappingNode to the MappingSearch queue spill file
+///
+/// This does not erase `mapping_node` from the in-memory queue. The
+/// spill file does not hold the AtomMappingSearchData, so it is released
+/// when `mapping_node` is erased, unless it is referenced elsewhere.
+void spill(MappingSearch &search, MappingNode const &mapping_node) {
+  search.queue_spill->push_back(SpilledMappingNode{
+      mapping_node.lattice_cost, mapping_node.lattice_mapping_data,
+      mapping_node.atom_cost, mapping_node.trial_translation_cart,
+      mapping_node.assignment_node, mapping_node.total_cost});
+  search.statistics.queue_spill = search.queue_spill->statistics;
+}
+
+/// \brief Re-construct a MappingNode read from a MappingSearch queue
+///     spill file
+///
+/// The AtomMapping is re-constructed from the assignment exactly as
+/// when the MappingNode was first constructed, and the stored costs
+/// are used as is.
+///
+/// \param search The MappingSearch
+/// \param node The MappingNode read from the spill file
+/// \param atom_mapping_data The AtomMappingSearchData for the lattice
+///     mapping and trial translation of `node`, re-constructed because
+///     the spill file does not hold it. The MappingNode holds it unless
+///     the AtomMappingSearchDataCache is enabled.
+MappingNode make_mapping_node_from_spilled(
+    MappingSearch const &search, SpilledMappingNode node,
+    std::shared_ptr<AtomMappingSearchData const> atom_mapping_data) {
+  AtomMapping atom_mapping = make_atom_mapping_from_assignment(
+      murty::make_assignment(node.assignment_node),
+      atom_mapping_data->site_displacements, node.trial_translation_cart,
+      node.lattice_mapping_data->lattice_mapping.deformation_gradient,
+      search.enable_remove_mean_displacement);
+  if (search.atom_mapping_data_cache) {
+    // only the cache holds the data, so that it may be evicted
+    atom_mapping_data.reset();
+  }
+  return MappingNode(node.lattice_cost, std::move(node.lattice_mapping_data),
+                     node.atom_cost, std::move(atom_mapping_data),
+                     node.trial_translation_cart,
+                     std::move(node.assignment_node), std::move(atom_mapping),
+                     node.total_cost);
 }
 
 /// \brief Insert mapping node into MappingSearch queue & results,
@@ -134,14 +337,32 @@ MappingNode make_mapping_node_from_assignment_node(
 /// and k-best criteria. Approximate ties with the k-best cost
 /// are kept in overflow.
 ///
+/// If `search.enable_duplicate_elimination` is true, a MappingNode
+/// with the same MappingNodeKey as a MappingNode that is in the queue,
+/// or was inserted into results, is not inserted into queue or results.
+/// The key of a MappingNode is only added to `search.mapping_node_keys`
+/// if the MappingNode is inserted into the queue or results.
+///
 /// \param search MappingSearch structure where node is inserted
 /// \param mapping_node MappingNode to insert
 ///
-/// \returns Iterator to MappingNode in queue
+/// \returns Iterator to MappingNode in queue, or queue.end() if
+///     not inserted
 ///
 std::multiset<MappingNode>::iterator insert(MappingSearch &search,
                                             MappingNode mapping_node) {
   MappingNode const &n = mapping_node;
+  search.statistics.n_mapping_node += 1;
+  std::optional<MappingNodeKey> key;
+  if (search.enable_duplicate_elimination) {
+    key = make_mapping_node_key(n);
+    if (search.mapping_node_keys.count(*key)) {
+      search.statistics.n_duplicate_mapping_node += 1;
+      return search.queue.end();
+    }
+  }
+  bool in_results = false;
+
   // --- maintain k_best results, keeping ties in overflow ---
   // note: max_cost is modified to shrink
   // to the current k_best-th cost once k_best results are found
@@ -152,6 +373,7 @@ std::multiset<MappingNode>::iterator insert(MappingSearch &search,
           StructureMapping(n.lattice_mapping_data->prim_data->prim,
                            n.lattice_mapping_data->lattice_mapping,
                            n.atom_mapping));
+      in_results = true;
       mapping::maintain_k_best_results(
           search.k_best, search.cost_tol, search.results, search.overflow,
           [](StructureMappingCost const &key) { return key.total_cost; });
@@ -161,13 +383,124 @@ std::multiset<MappingNode>::iterator insert(MappingSearch &search,
     }
   }
 
+  auto it = search.queue.end();
+  bool in_queue = false;
   if (n.total_cost < search.max_cost + search.cost_tol) {
-    return search.queue.insert(std::move(mapping_node));
-  } else {
-    return search.queue.end();
+    // if queue spilling is enabled, keep every MappingNode with
+    // total_cost >= the lowest spilled cost in the spill file
+    in_queue = true;
+    if (search.queue_spill && search.queue_spill->size() &&
+        !(n.total_cost < search.queue_spill->front_cost())) {
+      spill(search, n);
+    } else {
+      it = search.queue.insert(std::move(mapping_node));
+    }
+  }
+  if (key.has_value() && (in_queue || in_results)) {
+    search.mapping_node_keys.emplace(std::move(*key), in_results);
+  }
+  return it;
+}
+
+/// \brief Erase the key of a MappingNode that is removed from the
+///     queue, unless it was inserted into results
+///
+/// This keeps `search.mapping_node_keys` proportional to the size of
+/// the queue and results, rather than the number of MappingNode
+/// constructed.
+void erase_mapping_node_key(MappingSearch &search, MappingNode const &node) {
+  if (!search.enable_duplicate_elimination) {
+    return;
+  }
+  auto it = search.mapping_node_keys.find(make_mapping_node_key(node));
+  if (it != search.mapping_node_keys.end() && !it->second) {
+    search.mapping_node_keys.erase(it);
   }
 }
 
+/// \brief Spill the highest cost MappingNode in the in-memory queue if
+///     it is larger than `search.max_queue_memory_size`
+///
+/// The in-memory queue is reduced to about half of
+/// `max_queue_memory_size`. MappingNode with exactly equal total cost
+/// are always spilled together, so that every MappingNode in memory
+/// has lower total cost than every spilled MappingNode, and the
+/// MappingNode with the lowest total cost are never spilled.
+///
+/// This erases elements from `search.queue`, so it must not be called
+/// while iterators to `search.queue` are in use.
+void spill_queue_back(MappingSearch &search) {
+  if (!search.queue_spill || !search.max_queue_memory_size.has_value() ||
+      Index(search.queue.size()) <= *search.max_queue_memory_size) {
+    return;
+  }
+  Index n_keep = std::max(*search.max_queue_memory_size / 2, Index(1));
+  auto &queue = search.queue;
+  auto begin = std::next(queue.begin(), n_keep);
+  while (begin != queue.begin() &&
+         std::prev(begin)->total_cost == begin->total_cost) {
+    --begin;
+  }
+  if (begin == queue.begin()) {
+    begin = queue.upper_bound(*queue.begin());
+  }
+  for (auto it = begin; it != queue.end(); ++it) {
+    spill(search, *it);
+  }
+  queue.erase(begin, queue.end());
+}
+
+/// \brief Reload the lowest cost spilled MappingNode if the in-memory
+///     queue is empty
+///
+/// About half of `search.max_queue_memory_size` MappingNode are
+/// reloaded, plus any with total cost exactly equal to the last one
+/// reloaded, in the order they were inserted. They are read from the
+/// spill file together, and each AtomMappingSearchData they reference is
+/// re-constructed once.
+void reload_queue_front(MappingSearch &search) {
+  if (!search.queue_spill || search.queue.size() ||
+      !search.queue_spill->size()) {
+    return;
+  }
+  Index n_reload =
+      std::max(search.max_queue_memory_size.value_or(2) / 2, Index(1));
+  auto &queue = search.queue;
+  auto &queue_spill = *search.queue_spill;
+
+  // AtomMappingSearchData re-constructed for this reload, by lattice
+  // mapping data and trial translation
+  typedef std::tuple<LatticeMappingSearchData const *, double, double,
+                     double>
+      Key;
+  std::map<Key, std::shared_ptr<AtomMappingSearchData const>>
+      atom_mapping_data;
+
+  while (queue_spill.size()) {
+    Index n = n_reload - Index(queue.size());
+    if (n <= 0) {
+      if (queue_spill.front_cost() != queue.rbegin()->total_cost) {
+        break;
+      }
+      n = 1;
+    }
+    for (SpilledMappingNode &node : queue_spill.pop_front(n)) {
+      Eigen::Vector3d const &t = node.trial_translation_cart;
+      Key key(node.lattice_mapping_data.get(), t(0), t(1), t(2));
+      auto it = atom_mapping_data.find(key);
+      if (it == atom_mapping_data.end()) {
+        it = atom_mapping_data
+                 .emplace(key, make_atom_mapping_data(
+                                   search, node.lattice_mapping_data, t))
+                 .first;
+      }
+      queue.insert(queue.end(), make_mapping_node_from_spilled(
+                                    search, std::move(node), it->second));
+    }
+  }
+  search.statistics.queue_spill = queue_spill.statistics;
+}
+
 }  // namespace mapping_impl
 
 double IsotropicAtomCost::operator()(
@@ -186,7 +519,9 @@ double SymmetryBreakingAtomCost::operator()(
     AtomMappingSearchData const &atom_mapping_data,
     AtomMapping const &atom_mapping) const {
   auto const &prim_data = *(lattice_mapping_data.prim_data);
-  if (!prim_data.prim_sym_invariant_displacement_modes.has_value()) {
+  auto const &prim_sym_invariant_displacement_modes =
+      prim_data.prim_sym_invariant_displacement_modes;
+  if (!prim_sym_invariant_displacement_modes.has_value()) {
     throw std::runtime_error(
         "Error in SymmetryBreakingAtomCost: prim symmetry-invariant "
         "displacement modes are not available. Use "
@@ -194,14 +529,40 @@ double SymmetryBreakingAtomCost::operator()(
   }
   auto const &L1 = prim_data.prim_lattice.lat_column_mat();
   auto const &lattice_mapping = lattice_mapping_data.lattice_mapping;
-  if (prim_data.prim_sym_invariant_displacement_modes->size() == 0) {
+  if (prim_sym_invariant_displacement_modes->size() == 0) {
     return make_isotropic_atom_cost(L1, lattice_mapping,
                                     atom_mapping.displacement);
   }
   return make_symmetry_breaking_atom_cost(
       L1, lattice_mapping, atom_mapping.displacement,
       lattice_mapping_data.unitcellcoord_index_converter,
-      *prim_data.prim_sym_invariant_displacement_modes);
+      *prim_sym_invariant_displacement_modes);
+}
+
+BatchAtomCost::BatchAtomCost(BatchAtomCostFunction _f) : f(std::move(_f)) {}
+
+double BatchAtomCost::operator()(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    AtomMappingSearchData const &atom_mapping_data,
+    AtomMapping const &atom_mapping) const {
+  return (*this)(lattice_mapping_data, atom_mapping_data,
+                 std::vector<AtomMapping>({atom_mapping}))(0);
+}
+
+Eigen::VectorXd BatchAtomCost::operator()(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    AtomMappingSearchData const &atom_mapping_data,
+    std::vector<AtomMapping> const &atom_mappings) const {
+  if (!f) {
+    throw std::runtime_error("Error in BatchAtomCost: function is empty");
+  }
+  Eigen::VectorXd atom_cost =
+      f(lattice_mapping_data, atom_mapping_data, atom_mappings);
+  if (atom_cost.size() != atom_mappings.size()) {
+    throw std::runtime_error(
+        "Error in BatchAtomCost: result size != atom_mappings.size()");
+  }
+  return atom_cost;
 }
 
 WeightedTotalCost::WeightedTotalCost(double _lattice_cost_weight)
@@ -251,6 +612,79 @@ void QueueConstraints::operator()(MappingSearch &search) const {
   }
 }
 
+namespace {
+
+void hash_combine(std::size_t &seed, std::size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+}  // namespace
+
+/// \brief Hash function for MappingNodeKey
+std::size_t MappingNodeKeyHash::operator()(MappingNodeKey const &key) const {
+  std::size_t seed = 0;
+  hash_combine(seed, std::hash<PrimSearchData const *>()(key.prim_data));
+  hash_combine(seed,
+               std::hash<StructureSearchData const *>()(key.structure_data));
+  for (Index i = 0; i < 3; ++i) {
+    for (Index j = 0; j < 3; ++j) {
+      hash_combine(seed,
+                   std::hash<long>()(key.transformation_matrix_to_super(i, j)));
+    }
+  }
+  for (Index x : key.permutation) {
+    hash_combine(seed, std::hash<Index>()(x));
+  }
+  for (Index i = 0; i < 3; ++i) {
+    hash_combine(seed, std::hash<long>()(key.translation(i)));
+  }
+  return seed;
+}
+
+/// \brief Make the key identifying the structure mapping of a MappingNode
+///
+/// The AtomMapping translation is converted to fractional coordinates
+/// of the deformed supercell, F * L1 * T * N, and each component is
+/// discretized with a resolution equal to the supercell lattice tolerance
+/// divided by the lattice vector length, and wrapped into the supercell.
+/// Translations that differ by less than the resolution may, rarely, be
+/// discretized differently, in which case they are treated as distinct.
+MappingNodeKey make_mapping_node_key(MappingNode const &mapping_node) {
+  return make_mapping_node_key(*mapping_node.lattice_mapping_data,
+                               mapping_node.atom_mapping.permutation,
+                               mapping_node.atom_mapping.translation);
+}
+
+/// \brief Make the key identifying a structure mapping
+///
+/// See `make_mapping_node_key(MappingNode const &)`.
+///
+/// \param lattice_mapping_data The lattice mapping data
+/// \param permutation The AtomMapping permutation
+/// \param translation The AtomMapping translation
+MappingNodeKey make_mapping_node_key(
+    LatticeMappingSearchData const &lattice_mapping_data,
+    std::vector<Index> const &permutation,
+    Eigen::Vector3d const &translation) {
+  auto const &F = lattice_mapping_data.lattice_mapping.deformation_gradient;
+  auto const &supercell_lattice = lattice_mapping_data.supercell_lattice;
+  Eigen::Matrix3d S = F * supercell_lattice.lat_column_mat();
+  Eigen::Vector3d frac = S.inverse() * translation;
+
+  Eigen::Vector3l translation_key;
+  for (Index i = 0; i < 3; ++i) {
+    double resolution = supercell_lattice.tol() / S.col(i).norm();
+    long n = std::max(std::lround(1.0 / resolution), 1L);
+    long k = std::lround(frac(i) / resolution) % n;
+    translation_key(i) = (k < 0) ? k + n : k;
+  }
+
+  return MappingNodeKey{lattice_mapping_data.prim_data.get(),
+                        lattice_mapping_data.structure_data.get(),
+                        lattice_mapping_data.transformation_matrix_to_super,
+                        permutation, translation_key};
+}
+
 /// \brief Constructor
 MappingNode::MappingNode(
     double _lattice_cost,
@@ -262,6 +696,34 @@ MappingNode::MappingNode(
       lattice_mapping_data(std::move(_lattice_mapping_data)),
       atom_cost(_atom_cost),
       atom_mapping_data(std::move(_atom_mapping_data)),
+      trial_translation_cart(atom_mapping_data->trial_translation_cart),
+      assignment_node(std::move(_assignment_node)),
+      atom_mapping(std::move(_atom_mapping)),
+      total_cost(_total_cost) {}
+
+/// \brief Constructor, with an explicit trial translation, for
+///     MappingNode that do not hold their atom mapping data
+///
+/// \param _atom_mapping_data Data that can be used for all atom
+///     mappings with the same lattice mapping and trial translation.
+///     May be nullptr, in which case a MappingSearch obtains it
+///     from its AtomMappingSearchDataCache using
+///     `_lattice_mapping_data` and `_trial_translation_cart`.
+/// \param _trial_translation_cart The trial translation
+///
+/// Other parameters are as for the other constructor.
+MappingNode::MappingNode(
+    double _lattice_cost,
+    std::shared_ptr<LatticeMappingSearchData const> _lattice_mapping_data,
+    double _atom_cost,
+    std::shared_ptr<AtomMappingSearchData const> _atom_mapping_data,
+    Eigen::Vector3d const &_trial_translation_cart,
+    murty::Node _assignment_node, AtomMapping _atom_mapping, double _total_cost)
+    : lattice_cost(_lattice_cost),
+      lattice_mapping_data(std::move(_lattice_mapping_data)),
+      atom_cost(_atom_cost),
+      atom_mapping_data(std::move(_atom_mapping_data)),
+      trial_translation_cart(_trial_translation_cart),
       assignment_node(std::move(_assignment_node)),
       atom_mapping(std::move(_atom_mapping)),
       total_cost(_total_cost) {}
@@ -299,19 +761,12 @@ MappingNode make_mapping_node(
     Eigen::Vector3d const &trial_translation_cart,
     std::map<Index, Index> forced_on,
     std::vector<std::pair<Index, Index>> forced_off) {
-  auto atom_mapping_data = std::make_shared<AtomMappingSearchData const>(
-      lattice_mapping_data, trial_translation_cart, search.atom_to_site_cost_f,
-      search.infinity);
+  auto atom_mapping_data = mapping_impl::make_atom_mapping_data(
+      search, lattice_mapping_data, trial_translation_cart);
 
   // --- Find optimal assignment ---
-  murty::Node assignment_node =
-      murty::make_node(atom_mapping_data->cost_matrix, std::move(forced_on),
-                       std::move(forced_off));
-  std::tie(assignment_node.cost, assignment_node.sub_assignment) =
-      murty::make_sub_assignment(
-          hungarian::solve, atom_mapping_data->cost_matrix,
-          assignment_node.unassigned_rows, assignment_node.unassigned_cols,
-          assignment_node.forced_off, search.infinity, search.cost_tol);
+  murty::Node assignment_node = mapping_impl::make_optimal_assignment_node(
+      search, *atom_mapping_data, std::move(forced_on), std::move(forced_off));
 
   // --- Make mapping node from assignment solution ---
   return mapping_impl::make_mapping_node_from_assignment_node(
@@ -376,16 +831,16 @@ MappingNode make_mapping_node(
 /// \param _max_cost Keep mappings with total cost <= max_cost. Note that this
 ///     parameter does not control the queue of MappingNode, it only controls
 ///     which solutions are stored in `results`.
-/// \param _lattice_cost_weight The fraction of the total cost due to
-///     the lattice strain cost. The remaining fraction
-///     (1.-lattice_cost_weight) is due to the atom cost. Default=0.5.
+/// \param _k_best Keep the k_best results satisfying the min_cost and
+///     max_cost constraints. If there are approximate ties, those
+///     will also be kept.
 /// \param _atom_cost_f A function that implements the atom mapping
 ///     cost calculation.
 /// \param _total_cost_f A function that implements the total mapping
 ///     cost calculation.
-/// \param _k_best Keep the k_best results satisfying the min_cost and
-///     max_cost constraints. If there are approximate ties, those
-///     will also be kept.
+/// \param _atom_to_site_cost_f A function that implements the
+///     atom-to-site cost calculation used to construct the assignment
+///     problem cost matrix.
 /// \param enable_remove_mean_displacement If true, the
 ///     AtomMapping translation and displacements are adjusted
 ///     consistently so that the mean displacment is zero.
@@ -393,12 +848,23 @@ MappingNode make_mapping_node(
 ///     matrix for unallowed assignments
 /// \param _cost_tol Tolerance for checking if mapping costs are
 ///     approximately equal
+/// \param _enable_duplicate_elimination If true, MappingNode that
+///     have the same permutation, supercell, and translation (up to a
+///     supercell lattice translation) as a MappingNode in the queue, or
+///     in results, are not inserted into the queue or results, so their
+///     sub-assignments are not searched twice. Default is false.
+/// \param _enable_structure_symmetry_reduction If true,
+///     `make_and_insert_mapping_nodes` skips trial translations that are
+///     equivalent under the internal translations of the structure being
+///     mapped. Default is false. See `make_trial_translations`.
 MappingSearch::MappingSearch(double _min_cost, double _max_cost, int _k_best,
                              AtomCostFunction _atom_cost_f,
                              TotalCostFunction _total_cost_f,
                              AtomToSiteCostFunction _atom_to_site_cost_f,
                              bool _enable_remove_mean_displacement,
-                             double _infinity, double _cost_tol)
+                             double _infinity, double _cost_tol,
+                             bool _enable_duplicate_elimination,
+                             bool _enable_structure_symmetry_reduction)
     : min_cost(_min_cost),
       max_cost(_max_cost),
       k_best(_k_best),
@@ -407,7 +873,140 @@ MappingSearch::MappingSearch(double _min_cost, double _max_cost, int _k_best,
       atom_to_site_cost_f(_atom_to_site_cost_f),
       enable_remove_mean_displacement(_enable_remove_mean_displacement),
       infinity(_infinity),
-      cost_tol(_cost_tol) {}
+      cost_tol(_cost_tol),
+      enable_duplicate_elimination(_enable_duplicate_elimination),
+      enable_structure_symmetry_reduction(
+          _enable_structure_symmetry_reduction) {}
+
+/// \brief Return lowest total cost MappingNode in the queue
+///
+/// Invalid if !size()
+MappingNode const &MappingSearch::front() const {
+  return *queue.begin();
+}
+
+/// \brief Return highest total cost MappingNode in the queue
+///
+/// Invalid if !size(). If the highest total cost MappingNode is held in
+/// `queue_spill`, it is read from the spill file, and the returned
+/// reference is only valid until the next call to `back()`. This is not
+/// const because reading the spill file changes its position, buffer,
+/// and statistics.
+MappingNode const &MappingSearch::back() {
+  if (queue_spill && queue_spill->size()) {
+    SpilledMappingNode node = queue_spill->back();
+    auto atom_mapping_data = mapping_impl::make_atom_mapping_data(
+        *this, node.lattice_mapping_data, node.trial_translation_cart);
+    m_spilled_back = std::make_unique<MappingNode const>(
+        mapping_impl::make_mapping_node_from_spilled(
+            *this, std::move(node), std::move(atom_mapping_data)));
+    return *m_spilled_back;
+  }
+  return *queue.rbegin();
+}
+
+/// \brief Erase lowest total cost MappingNode in the queue
+///
+/// Invalid if !size()
+void MappingSearch::pop_front() {
+  mapping_impl::erase_mapping_node_key(*this, *queue.begin());
+  queue.erase(queue.begin());
+  mapping_impl::reload_queue_front(*this);
+}
+
+/// \brief Erase highest total cost MappingNode in the queue
+///
+/// Invalid if !size()
+void MappingSearch::pop_back() {
+  if (queue_spill && queue_spill->size()) {
+    if (enable_duplicate_elimination) {
+      mapping_impl::erase_mapping_node_key(*this, back());
+    }
+    queue_spill->pop_back();
+    return;
+  }
+  mapping_impl::erase_mapping_node_key(*this, *queue.rbegin());
+  queue.erase(std::next(queue.rbegin()).base());
+}
+
+/// \brief Return the size of the queue
+///
+/// This includes MappingNode held in `queue_spill`.
+Index MappingSearch::size() const {
+  Index n_spilled = queue_spill ? queue_spill->size() : 0;
+  return queue.size() + n_spilled;
+}
+
+/// \brief Hold the highest cost part of the queue in a temporary file
+///
+/// When the number of MappingNode in the in-memory `queue` exceeds
+/// `_max_queue_memory_size`, at the beginning of
+/// `make_and_insert_mapping_node` or `partition`, the highest cost
+/// MappingNode are written to a spill file in compact form. Newly
+/// constructed MappingNode with total cost greater than or equal to the
+/// lowest spilled cost are written directly to the spill file. When the
+/// in-memory queue is emptied, the lowest cost spilled MappingNode are
+/// reloaded in order.
+///
+/// The queue order, including the order of MappingNode with exactly
+/// equal total cost, is the same as if all MappingNode were held in
+/// memory, so search results are identical. Iterators returned by
+/// `make_and_insert_mapping_node` and `partition` are only valid until
+/// the next call of either. Spill volume and I/O time are counted in
+/// `statistics.queue_spill`.
+///
+/// \param _max_queue_memory_size Maximum number of MappingNode to hold
+///     in `queue` before spilling. Must be >= 1.
+/// \param spill_path If provided, the spill file is created at this
+///     path, and removed when the search is destroyed. Otherwise an
+///     anonymous temporary file is used.
+void MappingSearch::enable_queue_spill(Index _max_queue_memory_size,
+                                       std::optional<std::string> spill_path) {
+  if (_max_queue_memory_size < 1) {
+    throw std::runtime_error(
+        "Error in MappingSearch::enable_queue_spill: "
+        "max_queue_memory_size must be >= 1");
+  }
+  if (queue_spill && queue_spill->size()) {
+    throw std::runtime_error(
+        "Error in MappingSearch::enable_queue_spill: "
+        "queue spilling is already enabled and in use");
+  }
+  max_queue_memory_size = _max_queue_memory_size;
+  queue_spill = std::make_unique<MappingQueueSpill>(spill_path);
+  statistics.queue_spill = queue_spill->statistics;
+}
+
+/// \brief Hold AtomMappingSearchData for queued MappingNode in a
+///     size-bounded cache
+///
+/// Each queued MappingNode otherwise keeps its AtomMappingSearchData,
+/// with its N_site^2 site displacements and cost matrix, alive for as
+/// long as it is queued. With the cache enabled, MappingNode
+/// constructed by this search do not hold their AtomMappingSearchData
+/// (`MappingNode::atom_mapping_data` is nullptr). Instead, it is held
+/// by an AtomMappingSearchDataCache, which evicts the least recently
+/// used data once its estimated size exceeds `max_n_bytes`. Evicted
+/// data is re-constructed from the lattice mapping data, trial
+/// translation, and atom-to-site cost function when a MappingNode is
+/// partitioned, giving identical search results.
+///
+/// Lookups and evictions are counted in
+/// `statistics.atom_mapping_data_cache`, which is updated by
+/// `partition`.
+///
+/// \param max_n_bytes Maximum estimated size of the cached data, in
+///     bytes.
+void MappingSearch::enable_atom_mapping_data_cache(Index max_n_bytes) {
+  if (size()) {
+    throw std::runtime_error(
+        "Error in MappingSearch::enable_atom_mapping_data_cache: "
+        "the queue must be empty");
+  }
+  atom_mapping_data_cache =
+      std::make_unique<AtomMappingSearchDataCache>(max_n_bytes);
+  statistics.atom_mapping_data_cache = atom_mapping_data_cache->statistics;
+}
 
 /// \brief Make assignment and insert mapping node
 ///     into this->queue & this->results, maintaining k-best results
@@ -443,12 +1042,61 @@ MappingSearch::make_and_insert_mapping_node(
     Eigen::Vector3d const &trial_translation_cart,
     std::map<Index, Index> forced_on,
     std::vector<std::pair<Index, Index>> forced_off) {
+  mapping_impl::spill_queue_back(*this);
+
+  // --- Find optimal assignment ---
+  auto atom_mapping_data = mapping_impl::make_atom_mapping_data(
+      *this, lattice_mapping_data, trial_translation_cart);
+  murty::Node assignment_node = mapping_impl::make_optimal_assignment_node(
+      *this, *atom_mapping_data, std::move(forced_on), std::move(forced_off));
+
   // --- Insert mapping node in queue and results, return queue iterator ---
-  return mapping_impl::insert(
-      *this,
-      make_mapping_node(*this, lattice_cost, std::move(lattice_mapping_data),
-                        trial_translation_cart, std::move(forced_on),
-                        std::move(forced_off)));
+  auto it = this->queue.end();
+  if (!this->_skip_assignment_node(assignment_node, lattice_cost,
+                                   *lattice_mapping_data,
+                                   *atom_mapping_data)) {
+    it = mapping_impl::insert(
+        *this, mapping_impl::make_mapping_node_from_assignment_node(
+                   *this, std::move(assignment_node), lattice_cost,
+                   std::move(lattice_mapping_data),
+                   std::move(atom_mapping_data)));
+  }
+  if (this->atom_mapping_data_cache) {
+    this->statistics.atom_mapping_data_cache =
+        this->atom_mapping_data_cache->statistics;
+  }
+  return it;
+}
+
+/// \brief Make trial translations, and make and insert a mapping
+///     node for each
+///
+/// This is equivalent to calling `make_and_insert_mapping_node` for
+/// each trial translation returned by `make_trial_translations`, with
+/// `structure_symmetry_reduction` equal to
+/// `this->enable_structure_symmetry_reduction`.
+///
+/// If `enable_structure_symmetry_reduction` is true, fewer assignment
+/// problems are solved when the structure being mapped has internal
+/// translations. The skipped structure mappings are equivalent under the
+/// structure's symmetry to mappings that are searched, and have the same
+/// costs, so the set of costs found is unchanged, but equivalent
+/// structure mappings are not all found. For example, with `k_best` equal
+/// to 1, the best result cost is unchanged, but fewer approximately tied
+/// results may be kept.
+///
+/// \param lattice_cost The lattice mapping cost
+/// \param lattice_mapping_data Data associated with the lattice
+///     mapping that is the context in which the atom mapping is done
+void MappingSearch::make_and_insert_mapping_nodes(
+    double lattice_cost,
+    std::shared_ptr<LatticeMappingSearchData const> lattice_mapping_data) {
+  std::vector<Eigen::Vector3d> trial_translations = make_trial_translations(
+      *lattice_mapping_data, this->enable_structure_symmetry_reduction);
+  for (Eigen::Vector3d const &trial_translation_cart : trial_translations) {
+    this->make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                       trial_translation_cart);
+  }
 }
 
 /// \brief Make the next level of sub-optimal assignments and
@@ -463,9 +1111,8 @@ MappingSearch::make_and_insert_mapping_node(
 ///
 /// Notes:
 /// - Invalid if !size()
-///
-/// \param node A MappingNode to find sub-optimal assignments from
-///     using the Murty algorithm
+/// - If the atom cost function is a `BatchAtomCost`, the atom costs of
+///   all sub-nodes are calculated with one call
 ///
 /// \returns A vector of iterators to the generated sub-nodes in queue,
 ///     or queue.end() if not inserted. Empty vector if queue is empty
@@ -479,29 +1126,36 @@ std::vector<std::multiset<MappingNode>::iterator> MappingSearch::partition() {
   if (!this->size()) {
     return result;
   }
+  mapping_impl::spill_queue_back(*this);
 
   auto node_it = this->queue.begin();
+  std::shared_ptr<AtomMappingSearchData const> atom_mapping_data_ptr =
+      mapping_impl::get_atom_mapping_data(*this, *node_it);
+
   // -- Make the next level of sub-optimal assignment solutions ---
   std::multiset<murty::Node> s;
-  murty::partition(s, hungarian::solve, node_it->atom_mapping_data->cost_matrix,
+  murty::partition(s, this->assignment_f, atom_mapping_data_ptr->cost_matrix,
                    node_it->assignment_node, this->infinity, this->cost_tol);
 
+  // With a BatchAtomCost, the AtomMapping of all sub-optimal
+  // assignments are constructed first, and their atom costs are
+  // calculated with one call.
+  auto const *batch_atom_cost_f =
+      mapping_impl::functor_target<BatchAtomCost>(this->atom_cost_f);
+  std::vector<murty::Node> batch_assignment_nodes;
+  std::vector<AtomMapping> batch_atom_mappings;
+
   // The sub-optimal assignment solutions are in 's',
   // and we want them to all end up in MappingNode.
   // This loop extracts the values from 's', uses them to
   // construct MappingNode, and continues until they are
   // all extracted.
   while (s.size()) {
-    // --- Make mapping node from sub-optimal assignment ---
-    MappingNode mapping_node =
-        mapping_impl::make_mapping_node_from_assignment_node(
-            *this, std::move(s.extract(s.begin()).value()),
-            node_it->lattice_cost, node_it->lattice_mapping_data,
-            node_it->atom_mapping_data);
+    murty::Node assignment_node = std::move(s.extract(s.begin()).value());
 
     // check assignment:
-    for (auto const &forced_on : mapping_node.assignment_node.forced_on) {
-      auto const &sub_assignment = mapping_node.assignment_node.sub_assignment;
+    for (auto const &forced_on : assignment_node.forced_on) {
+      auto const &sub_assignment = assignment_node.sub_assignment;
       auto assignment_it = sub_assignment.find(forced_on.first);
       if (assignment_it == sub_assignment.end()) {
         continue;
@@ -512,8 +1166,8 @@ std::vector<std::multiset<MappingNode>::iterator> MappingSearch::partition() {
             "be included in sub_assignment");
       }
     }
-    for (auto const &forced_off : mapping_node.assignment_node.forced_off) {
-      auto const &sub_assignment = mapping_node.assignment_node.sub_assignment;
+    for (auto const &forced_off : assignment_node.forced_off) {
+      auto const &sub_assignment = assignment_node.sub_assignment;
       auto assignment_it = sub_assignment.find(forced_off.first);
       if (assignment_it == sub_assignment.end()) {
         continue;
@@ -525,13 +1179,111 @@ std::vector<std::multiset<MappingNode>::iterator> MappingSearch::partition() {
       }
     }
 
+    // --- Skip mapping nodes that cannot be kept ---
+    if (this->_skip_assignment_node(assignment_node, node_it->lattice_cost,
+                                    *node_it->lattice_mapping_data,
+                                    *atom_mapping_data_ptr)) {
+      result.emplace_back(this->queue.end());
+      continue;
+    }
+
+    if (batch_atom_cost_f) {
+      batch_atom_mappings.push_back(
+          mapping_impl::make_atom_mapping_from_assignment(
+              murty::make_assignment(assignment_node),
+              atom_mapping_data_ptr->site_displacements,
+              atom_mapping_data_ptr->trial_translation_cart,
+              node_it->lattice_mapping_data->lattice_mapping
+                  .deformation_gradient,
+              this->enable_remove_mean_displacement));
+      batch_assignment_nodes.push_back(std::move(assignment_node));
+      continue;
+    }
+
+    // --- Make mapping node from sub-optimal assignment ---
+    MappingNode mapping_node =
+        mapping_impl::make_mapping_node_from_assignment_node(
+            *this, std::move(assignment_node), node_it->lattice_cost,
+            node_it->lattice_mapping_data, atom_mapping_data_ptr);
+
     // --- Insert mapping node in queue and results, return queue iterator ---
     result.emplace_back(mapping_impl::insert(*this, std::move(mapping_node)));
   }
+
+  // --- Make and insert mapping nodes, with batched atom costs ---
+  if (batch_atom_mappings.size()) {
+    Eigen::VectorXd atom_cost =
+        (*batch_atom_cost_f)(*node_it->lattice_mapping_data,
+                             *atom_mapping_data_ptr, batch_atom_mappings);
+    for (Index i = 0; i < batch_atom_mappings.size(); ++i) {
+      MappingNode mapping_node =
+          mapping_impl::make_mapping_node_from_atom_mapping(
+              *this, std::move(batch_assignment_nodes[i]),
+              node_it->lattice_cost, node_it->lattice_mapping_data,
+              atom_mapping_data_ptr, std::move(batch_atom_mappings[i]),
+              atom_cost(i));
+      result.emplace_back(
+          mapping_impl::insert(*this, std::move(mapping_node)));
+    }
+  }
+  mapping_impl::erase_mapping_node_key(*this, *node_it);
   this->queue.erase(node_it);
+  mapping_impl::reload_queue_front(*this);
+  if (this->atom_mapping_data_cache) {
+    this->statistics.atom_mapping_data_cache =
+        this->atom_mapping_data_cache->statistics;
+  }
   return result;
 }
 
+/// \brief Return true if an assignment solution cannot be inserted
+///     in the queue or results, without constructing a MappingNode
+///
+/// With the built-in isotropic atom cost and weighted total cost, the
+/// total cost of an assignment solution is calculated in O(N) from
+/// the site displacements, without constructing an AtomMapping, so
+/// that MappingNode which would not be inserted in the queue or
+/// results are never constructed. The full assignment is written to
+/// storage that is reused between calls.
+///
+/// If true is returned, `statistics.n_mapping_node` is updated as by
+/// `insert`. The MappingNode is rejected, so its key is not added to
+/// `mapping_node_keys`. A margin of cost_tol is kept so that rounding
+/// differences between the moment-based and displacement-based atom
+/// cost never change which nodes are kept. With other cost functions,
+/// false is always returned.
+bool MappingSearch::_skip_assignment_node(
+    murty::Node const &assignment_node, double lattice_cost,
+    LatticeMappingSearchData const &lattice_mapping_data,
+    AtomMappingSearchData const &atom_mapping_data) {
+  if (!mapping_impl::functor_target<IsotropicAtomCost>(this->atom_cost_f)) {
+    return false;
+  }
+  auto const *weighted_total_cost_f =
+      mapping_impl::functor_target<WeightedTotalCost>(this->total_cost_f);
+  if (!weighted_total_cost_f) {
+    return false;
+  }
+
+  murty::make_assignment(assignment_node, m_assignment);
+  auto moment = mapping_impl::make_displacement_moment_from_assignment(
+      m_assignment, atom_mapping_data.site_displacements,
+      this->enable_remove_mean_displacement);
+  double atom_cost = make_isotropic_atom_cost(
+      lattice_mapping_data.prim_data->prim_lattice.lat_column_mat(),
+      lattice_mapping_data.lattice_mapping, moment.second,
+      lattice_mapping_data.N_supercell_site);
+  double w = weighted_total_cost_f->lattice_cost_weight;
+  double total_cost = w * lattice_cost + (1. - w) * atom_cost;
+  if (total_cost < this->max_cost + 2.0 * this->cost_tol) {
+    return false;
+  }
+
+  // same statistics as `insert`
+  this->statistics.n_mapping_node += 1;
+  return true;
+}
+
 /// \brief Return MappingSearch results combined with overflow
 StructureMappingResults combined_results(MappingSearch const &search) {
   StructureMappingResults results;
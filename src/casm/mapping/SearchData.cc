@@ -1,5 +1,8 @@
 #include "casm/mapping/SearchData.hh"
 
+#include <cmath>
+#include <limits>
+
 #include "casm/crystallography/BasicStructure.hh"
 #include "casm/crystallography/BasicStructureTools.hh"
 #include "casm/crystallography/SimpleStructure.hh"
@@ -213,6 +216,12 @@ bool is_new_unique_translation(
 ///     matrix of Cartesian coordinates of the sites in the prim.
 /// \param prim_allowed_atom_types The atom types allowed on each
 ///     site in the prim.
+/// \param prim_factor_group The prim's factor group, used to skip
+///     translations equivalent under prim internal translations.
+/// \param structure_internal_translations_cart Internal translations
+///     of the structure being mapped, in the state after the inverse
+///     lattice mapping deformation is applied. If not empty, they are
+///     also used to skip equivalent translations.
 ///
 /// \returns Vector of possible trial_translation
 ///
@@ -222,12 +231,28 @@ std::vector<Eigen::Vector3d> make_trial_translations(
     xtal::Lattice const &prim_lattice,
     Eigen::MatrixXd const &prim_site_coordinate_cart,
     std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
-    std::vector<xtal::SymOp> const &prim_factor_group) {
+    std::vector<xtal::SymOp> const &prim_factor_group,
+    std::vector<Eigen::Vector3d> const &structure_internal_translations_cart) {
   std::vector<Eigen::Vector3d> trial_translations;
 
   std::vector<Eigen::Vector3d> internal_translations =
       xtal::make_internal_translations(prim_factor_group, prim_lattice.tol());
 
+  // combine prim and structure internal translations: test_translation
+  // + prim internal translation + structure internal translation gives
+  // a cost matrix with permuted rows and columns
+  if (structure_internal_translations_cart.size() > 1) {
+    std::vector<Eigen::Vector3d> combined_translations;
+    for (auto const &prim_translation : internal_translations) {
+      for (auto const &structure_translation :
+           structure_internal_translations_cart) {
+        combined_translations.push_back(prim_translation +
+                                        structure_translation);
+      }
+    }
+    internal_translations = std::move(combined_translations);
+  }
+
   // choose atom (best_atom_index) with fewest allowed sites in prim
   // if any atom is not allowed on any site?:
   // -> no allowed translations / assignments so return
@@ -331,49 +356,89 @@ std::vector<std::vector<Eigen::Vector3d>> make_site_displacements(
     v.resize(N_atom);
   }
 
-  for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
-    for (Index site_index = 0; site_index < N_site; ++site_index) {
-      site_displacements[site_index][atom_index] = robust_pbc_displacement_cart(
+  Eigen::MatrixXd atom_coordinate_cart =
+      atom_coordinate_cart_in_supercell.colwise() + trial_translation;
+  for (Index site_index = 0; site_index < N_site; ++site_index) {
+    auto &displacements_i = site_displacements[site_index];
+    for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
+      displacements_i[atom_index] = robust_pbc_displacement_cart(
           lattice, supercell_site_coordinate_cart.col(site_index),
-          atom_coordinate_cart_in_supercell.col(atom_index) +
-              trial_translation);
+          atom_coordinate_cart.col(atom_index));
     }
   }
   return site_displacements;
 }
 
-/// \brief Calculate elements of the cost matrix
-///
-/// The assignment problem cost matrix is calculated from
-/// site-to-atom displacements, atom types, and the
-/// types allowed on each site.
+/// \brief Make container of displacement vectors, using packed site data
 ///
-/// The site displacements are the minimum length displacements
-/// that satisfy:
+/// Gives the same displacements as `make_site_displacements` using
+/// Cartesian coordinate matrices. Displacements are calculated
+/// site-major, in fractional coordinates of the supercell lattice.
+/// If the displacement to the nearest periodic image found by rounding
+/// fractional coordinates is shorter than `site_data.min_image_radius`
+/// it is the unique minimum length displacement and is used directly;
+/// otherwise, `robust_pbc_displacement_cart` is used.
 ///
-///     site_coordinate_cart[i] + site_displacements[i][j] =
-///         F^{-1}*atom_coordinate_cart[j] + trial_translation
-///
-/// under periodic boundary conditions.
-///
-/// \param cost_matrix Cost matrix to construct. Is resized to
-///     shape=(N_site, N_site) if necessary. The element
-///     `cost_matrix(i, j)` is set to the cost of mapping the
-///     j-th atom to the i-th site. If there are more sites
-///     than atoms, vacancies are added.
-/// \param f A function used to calculate the atom mapping cost
-///      to a particular site. Follows the signature of
-///     `make_atom_mapping_cost`.
-/// \param site_displacements The site-to-atom displacements,
-///     of minimum length under periodic boundary conditions.
-/// \param atom_type Vector of size=N_atom containing the
-///     types of the atoms being mapped. May include vacancies.
-///     Any vacancies included in the child atoms **must** be
-///     mapped. Other vacancies may be added if there are more
-///     sites than atoms.
-/// \param allowed_atom_types The atom types allowed on each site
-/// \param infinity The value to use for unallowed mappings
+/// \param lattice The supercell lattice
+/// \param supercell_site_coordinate_cart Shape=(3,N_site), Cartesian
+///     coordinates of the supercell sites
+/// \param site_data Packed supercell site data
+/// \param atom_coordinate_cart_in_supercell Shape=(3,N_atom), the
+///     atom coordinates, after the inverse lattice mapping deformation
+/// \param trial_translation A Cartesian translation applied to atom
+///     coordinates to bring the atoms and sites into alignment
+std::vector<std::vector<Eigen::Vector3d>> make_site_displacements(
+    xtal::Lattice const &lattice,
+    Eigen::MatrixXd const &supercell_site_coordinate_cart,
+    SupercellSiteData const &site_data,
+    Eigen::MatrixXd const &atom_coordinate_cart_in_supercell,
+    Eigen::Vector3d const &trial_translation) {
+  Index N_atom = atom_coordinate_cart_in_supercell.cols();
+  Index N_site = site_data.N_site;
+  if (supercell_site_coordinate_cart.cols() != N_site) {
+    throw std::runtime_error(
+        "Error in make_site_displacements: "
+        "supercell_site_coordinate_cart.cols() != site_data.N_site");
+  }
+  if (N_atom > N_site) {
+    throw std::runtime_error(
+        "Error in make_site_displacements: "
+        "atom_coordinate_cart_in_supercell.cols() > site_data.N_site");
+  }
+
+  Eigen::Matrix3d const &L = site_data.lat_column_mat;
+  Eigen::Matrix3d const &L_inv = site_data.inv_lat_column_mat;
+  Eigen::MatrixXd atom_coordinate_cart =
+      atom_coordinate_cart_in_supercell.colwise() + trial_translation;
+  Eigen::MatrixXd atom_coordinate_frac = L_inv * atom_coordinate_cart;
+  double max_fast_squared_norm = std::pow(site_data.min_image_radius, 2);
+
+  std::vector<std::vector<Eigen::Vector3d>> site_displacements(N_site);
+  for (Index site_index = 0; site_index < N_site; ++site_index) {
+    Eigen::Vector3d site_cart = supercell_site_coordinate_cart.col(site_index);
+    Eigen::Vector3d site_frac = L_inv * site_cart;
+    auto &displacements_i = site_displacements[site_index];
+    displacements_i.resize(N_atom);
+    for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
+      Eigen::Vector3d frac = atom_coordinate_frac.col(atom_index) - site_frac;
+      frac -= frac.array().round().matrix();
+      Eigen::Vector3d d = L * frac;
+      if (d.squaredNorm() < max_fast_squared_norm) {
+        displacements_i[atom_index] = d;
+      } else {
+        displacements_i[atom_index] = robust_pbc_displacement_cart(
+            lattice, site_cart, atom_coordinate_cart.col(atom_index));
+      }
+    }
+  }
+  return site_displacements;
+}
+
+/// \brief Calculate elements of the cost matrix, using a type-erased
+///     atom-to-site cost function
 ///
+/// This checks that `f` is not empty and then calls the statically
+/// typed `make_cost_matrix`. See its documentation for details.
 Eigen::MatrixXd make_cost_matrix(
     AtomToSiteCostFunction f,
     std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
@@ -384,43 +449,166 @@ Eigen::MatrixXd make_cost_matrix(
     throw std::runtime_error(
         "Error in make_cost_matrix: atom mapping cost function is empty");
   }
-  if (site_displacements.size() != allowed_atom_types.size()) {
+  return make_cost_matrix<AtomToSiteCostFunction>(
+      f, site_displacements, atom_type, allowed_atom_types, infinity);
+}
+
+/// \brief Calculate elements of the cost matrix, using a type-erased
+///     atom-to-site cost function and packed site data
+///
+/// This checks that `f` is not empty and then calls the statically
+/// typed `make_cost_matrix`. See its documentation for details. If `f`
+/// holds an `AtomToSiteCostMatrix`, the cost matrix is calculated with
+/// one call of its `AtomToSiteCostMatrixFunction`. If `f` holds an
+/// `AtomToSiteCost` or `make_atom_to_site_cost`, the statically typed
+/// `make_cost_matrix` is called with an `AtomToSiteCost`, so the
+/// N_site^2 atom-to-site costs are calculated without type-erased
+/// calls.
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostFunction f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    double infinity) {
+  if (!f) {
     throw std::runtime_error(
-        "Error in make_cost_matrix: site_displacements.size() != "
-        "allowed_atom_types.size()");
+        "Error in make_cost_matrix: atom mapping cost function is empty");
+  }
+  if (auto const *matrix_f = f.target<AtomToSiteCostMatrix>()) {
+    return make_cost_matrix(*matrix_f, site_displacements, atom_type,
+                            site_data, prim_allowed_atom_types, infinity);
+  }
+  typedef double (*AtomToSiteCostPtr)(Eigen::Vector3d const &,
+                                      std::string const &,
+                                      std::vector<std::string> const &, double);
+  auto const *ptr_f = f.target<AtomToSiteCostPtr>();
+  if (f.target<AtomToSiteCost>() != nullptr ||
+      (ptr_f != nullptr && *ptr_f == &make_atom_to_site_cost)) {
+    return make_cost_matrix(AtomToSiteCost(), site_displacements, atom_type,
+                            site_data, prim_allowed_atom_types, infinity);
   }
+  return make_cost_matrix<AtomToSiteCostFunction>(
+      f, site_displacements, atom_type, site_data, prim_allowed_atom_types,
+      infinity);
+}
 
-  for (auto const &site_displacements_i : site_displacements) {
-    if (site_displacements_i.size() != atom_type.size()) {
-      throw std::runtime_error(
-          "Error in make_cost_matrix: an element of site_displacements != "
-          "atom_type.size()");
-    }
+/// \brief Make the input of an `AtomToSiteCostMatrixFunction`
+///
+/// If there are fewer atoms than sites, one implicit vacancy, named
+/// "Va" and with zero displacement to every site, is included as the
+/// last atom.
+///
+/// \param site_displacements Shape=(N_site, N_atom), the site-to-atom
+///     displacements
+/// \param atom_type Size=N_atom, the types of the atoms being mapped
+/// \param site_data Packed supercell site data
+/// \param prim_allowed_atom_types The atom types allowed on each prim
+///     site, indexed by `site_data.sublattice`
+AtomToSiteCostBatch make_atom_to_site_cost_batch(
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types) {
+  if (site_displacements.size() != site_data.N_site) {
+    throw std::runtime_error(
+        "Error in make_atom_to_site_cost_batch: site_displacements.size() "
+        "!= site_data.N_site");
   }
+  Index N_site = site_data.N_site;
+  Index N_real_atom = atom_type.size();
+  bool add_vacancy = N_real_atom < N_site;
 
-  Index N_site = allowed_atom_types.size();
-  Index N_atom = atom_type.size();
+  AtomToSiteCostBatch batch;
+  batch.N_site = N_site;
+  batch.N_atom = N_real_atom + (add_vacancy ? 1 : 0);
 
-  Eigen::MatrixXd cost_matrix(N_site, N_site);
+  auto type_index = [&](std::string const &name) {
+    auto &names = batch.atom_type_names;
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+      names.push_back(name);
+      return int(names.size() - 1);
+    }
+    return int(std::distance(names.begin(), it));
+  };
+  batch.atom_type_names = site_data.atom_type_names;
+  batch.atom_type_index.resize(batch.N_atom);
+  for (Index atom_index = 0; atom_index < N_real_atom; ++atom_index) {
+    batch.atom_type_index(atom_index) = type_index(atom_type[atom_index]);
+  }
+  if (add_vacancy) {
+    batch.atom_type_index(N_real_atom) = type_index("Va");
+  }
 
-  // make cost matrix: use cost_matrix(site_index, atom_index)
-  // to match AtomMapping permutation convention
-  for (Index atom_index = 0; atom_index < N_atom; ++atom_index) {
-    for (Index site_index = 0; site_index < N_site; ++site_index) {
-      cost_matrix(site_index, atom_index) =
-          f(site_displacements[site_index][atom_index], atom_type[atom_index],
-            allowed_atom_types[site_index], infinity);
+  Index N_type = batch.atom_type_names.size();
+  batch.site_allowed.setConstant(N_site, N_type, false);
+  for (Index site_index = 0; site_index < N_site; ++site_index) {
+    auto const &allowed =
+        prim_allowed_atom_types[site_data.sublattice[site_index]];
+    for (Index k = 0; k < N_type; ++k) {
+      batch.site_allowed(site_index, k) =
+          std::find(allowed.begin(), allowed.end(),
+                    batch.atom_type_names[k]) != allowed.end();
     }
   }
-  // If N_atom < N_site, treat as additional vacancies to map
-  for (Index atom_index = N_atom; atom_index < N_site; ++atom_index) {
-    for (Index site_index = 0; site_index < N_site; ++site_index) {
-      cost_matrix(site_index, atom_index) =
-          f(Eigen::Vector3d::Zero(), "Va", allowed_atom_types[site_index],
-            infinity);
+
+  batch.displacement.setZero(3, N_site * batch.N_atom);
+  for (Index site_index = 0; site_index < N_site; ++site_index) {
+    auto const &site_displacements_i = site_displacements[site_index];
+    if (site_displacements_i.size() != N_real_atom) {
+      throw std::runtime_error(
+          "Error in make_atom_to_site_cost_batch: an element of "
+          "site_displacements != atom_type.size()");
+    }
+    for (Index atom_index = 0; atom_index < N_real_atom; ++atom_index) {
+      batch.displacement.col(site_index * batch.N_atom + atom_index) =
+          site_displacements_i[atom_index];
     }
   }
+  return batch;
+}
 
+/// \brief Calculate the cost matrix with one call of an
+///     `AtomToSiteCostMatrixFunction`, using packed site data
+///
+/// The input to `f.f` is made by `make_atom_to_site_cost_batch`. If
+/// there are fewer atoms than sites, the cost of the implicit vacancy,
+/// the last column of the result of `f.f`, is used for all the
+/// additional vacancies, as by the other `make_cost_matrix` methods.
+///
+/// \returns cost_matrix, with shape=(N_site, N_site). The element
+///     `cost_matrix(i, j)` is set to the cost of mapping the
+///     j-th atom to the i-th site.
+Eigen::MatrixXd make_cost_matrix(
+    AtomToSiteCostMatrix const &f,
+    std::vector<std::vector<Eigen::Vector3d>> const &site_displacements,
+    std::vector<std::string> const &atom_type,
+    SupercellSiteData const &site_data,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types,
+    double infinity) {
+  if (!f.f) {
+    throw std::runtime_error(
+        "Error in make_cost_matrix: cost matrix function is empty");
+  }
+  AtomToSiteCostBatch batch = make_atom_to_site_cost_batch(
+      site_displacements, atom_type, site_data, prim_allowed_atom_types);
+  Eigen::MatrixXd batch_cost = f.f(batch, infinity);
+  if (batch_cost.rows() != batch.N_site || batch_cost.cols() != batch.N_atom) {
+    throw std::runtime_error(
+        "Error in make_cost_matrix: cost matrix function result has the "
+        "wrong shape");
+  }
+
+  Index N_site = batch.N_site;
+  if (batch.N_atom == N_site) {
+    return batch_cost;
+  }
+  Eigen::MatrixXd cost_matrix(N_site, N_site);
+  cost_matrix.leftCols(batch.N_atom) = batch_cost;
+  for (Index atom_index = batch.N_atom; atom_index < N_site; ++atom_index) {
+    cost_matrix.col(atom_index) = batch_cost.col(batch.N_atom - 1);
+  }
   return cost_matrix;
 }
 
@@ -543,6 +731,12 @@ xtal::SimpleStructure make_structure(
 ///     setting this to true will generate the symmetry-invariant
 ///     displacement modes required for the calculation using
 ///     this->prim_factor_group.
+///
+/// The symmetry-invariant displacement modes are expensive for large
+/// prims and only needed by the symmetry-breaking atom cost, so they are
+/// generated on first access rather than by the constructor. The
+/// generating function holds its own copies of the prim and factor
+/// group, so copies of PrimSearchData remain valid.
 PrimSearchData::PrimSearchData(
     std::shared_ptr<xtal::BasicStructure const> _prim,
     std::optional<std::vector<xtal::SymOp>> override_prim_factor_group,
@@ -559,12 +753,13 @@ PrimSearchData::PrimSearchData(
           prim_factor_group, prim_lattice.tol())),
       prim_sym_invariant_displacement_modes(
           enable_symmetry_breaking_atom_cost
-              ? std::optional<std::vector<Eigen::MatrixXd>>(
-                    xtal::generate_invariant_shuffle_modes(
-                        prim_factor_group,
-                        xtal::make_permutation_representation(
-                            *prim, prim_factor_group)))
-              : std::optional<std::vector<Eigen::MatrixXd>>()) {
+              ? LazyOptional<std::vector<Eigen::MatrixXd>>(
+                    [prim = prim, factor_group = prim_factor_group]() {
+                      return xtal::generate_invariant_shuffle_modes(
+                          factor_group, xtal::make_permutation_representation(
+                                            *prim, factor_group));
+                    })
+              : LazyOptional<std::vector<Eigen::MatrixXd>>()) {
   // Validation
   for (xtal::Site const &site : prim->basis()) {
     for (xtal::Molecule const &mol : site.occupant_dof()) {
@@ -581,6 +776,90 @@ PrimSearchData::PrimSearchData(
   }
 }
 
+/// \brief Constructor
+///
+/// \param supercell_lattice The supercell lattice
+/// \param unitcellcoord_index_converter Gives the supercell site order
+/// \param supercell_site_coordinate_cart Shape=(3,N_site), Cartesian
+///     coordinates of the supercell sites
+/// \param prim_allowed_atom_types The atom types allowed on each prim
+///     site
+SupercellSiteData::SupercellSiteData(
+    xtal::Lattice const &supercell_lattice,
+    xtal::UnitCellCoordIndexConverter const &unitcellcoord_index_converter,
+    Eigen::MatrixXd const &supercell_site_coordinate_cart,
+    std::vector<std::vector<std::string>> const &prim_allowed_atom_types)
+    : N_site(supercell_site_coordinate_cart.cols()),
+      sublattice(N_site),
+      vacancy_mask(0),
+      lat_column_mat(supercell_lattice.lat_column_mat()),
+      inv_lat_column_mat(supercell_lattice.inv_lat_column_mat()) {
+  for (Index l = 0; l < N_site; ++l) {
+    sublattice[l] = unitcellcoord_index_converter(l).sublattice();
+  }
+
+  for (auto const &allowed : prim_allowed_atom_types) {
+    for (auto const &name : allowed) {
+      if (std::find(atom_type_names.begin(), atom_type_names.end(), name) ==
+          atom_type_names.end()) {
+        atom_type_names.push_back(name);
+      }
+    }
+  }
+  if (atom_type_names.size() <= 64) {
+    for (Index k = 0; k < atom_type_names.size(); ++k) {
+      if (xtal::is_vacancy(atom_type_names[k])) {
+        vacancy_mask |= (std::uint64_t(1) << k);
+      }
+    }
+    std::vector<std::uint64_t> prim_mask;
+    for (auto const &allowed : prim_allowed_atom_types) {
+      std::uint64_t mask = 0;
+      for (auto const &name : allowed) {
+        mask |= atom_type_mask(name);
+      }
+      prim_mask.push_back(mask);
+    }
+    allowed_atom_type_mask.resize(N_site);
+    for (Index l = 0; l < N_site; ++l) {
+      allowed_atom_type_mask[l] = prim_mask[sublattice[l]];
+    }
+  }
+
+  // Any non-zero lattice vector, n_0*a_0 + n_1*a_1 + n_2*a_2, has length
+  // >= 1/|row k of L^-1| for some k with n_k != 0, so a displacement
+  // shorter than half the minimum of these is the unique minimum length
+  // periodic image. The lattice tolerance is subtracted so that every
+  // other image is longer by at least twice the tolerance.
+  double min_spacing = std::numeric_limits<double>::max();
+  for (Index k = 0; k < 3; ++k) {
+    min_spacing =
+        std::min(min_spacing, 1.0 / inv_lat_column_mat.row(k).norm());
+  }
+  min_image_radius =
+      std::max(0.5 * min_spacing - supercell_lattice.tol(), 0.0);
+}
+
+/// \brief Return the mask of an atom type
+///
+/// Returns the mask bit of `atom_type`, or `vacancy_mask` if
+/// `atom_type` is a vacancy, so that `(allowed_atom_type_mask[i] &
+/// atom_type_mask(atom_type)) != 0` if and only if `atom_type` is
+/// allowed on site `i` according to `make_atom_to_site_cost`. Returns 0
+/// if `atom_type` is not allowed on any site.
+std::uint64_t SupercellSiteData::atom_type_mask(
+    std::string const &atom_type) const {
+  if (xtal::is_vacancy(atom_type)) {
+    return vacancy_mask;
+  }
+  auto it =
+      std::find(atom_type_names.begin(), atom_type_names.end(), atom_type);
+  if (it == atom_type_names.end() || atom_type_names.size() > 64) {
+    return 0;
+  }
+  return std::uint64_t(1) << std::distance(atom_type_names.begin(), it);
+}
+
 /// \brief Constructor
 ///
 /// \param _prim_data Data for the prim a structure
@@ -615,7 +894,10 @@ LatticeMappingSearchData::LatticeMappingSearchData(
       supercell_allowed_atom_types(
           mapping_impl::make_supercell_allowed_atom_types(
               unitcellcoord_index_converter,
-              prim_data->prim_allowed_atom_types)) {}
+              prim_data->prim_allowed_atom_types)),
+      supercell_site_data(supercell_lattice, unitcellcoord_index_converter,
+                          supercell_site_coordinate_cart,
+                          prim_data->prim_allowed_atom_types) {}
 
 /// \brief Make possible atom -> site translations to bring atoms into
 ///     registry with the sites.
@@ -631,20 +913,56 @@ LatticeMappingSearchData::LatticeMappingSearchData(
 /// Trial translations are found by choosing the fewest valid
 /// atom type -> allowed site translations.
 ///
+/// By default, translations that are equivalent up to a prim internal
+/// translation are skipped. If `structure_symmetry_reduction` is true,
+/// translations that are equivalent up to a combination of a prim
+/// internal translation and an internal translation of the structure
+/// being mapped are also skipped.
+///
+/// A structure internal translation, \f$\vec{\tau}\f$, maps the
+/// structure onto itself, so the trial translations
+/// \f$\vec{t}\f$ and \f$\vec{t} + F^{-1}\vec{\tau}\f$ result in
+/// cost matrices that differ only by a permutation of atoms. The
+/// resulting structure mappings are equivalent under the structure's
+/// symmetry, and have the same costs. If all structure mappings are
+/// required, rather than one of each set of equivalents, do not use
+/// `structure_symmetry_reduction`.
+///
+/// The skipped mappings are not reconstructed. The option is used by
+/// `MappingSearch::make_and_insert_mapping_nodes` if
+/// `MappingSearch::enable_structure_symmetry_reduction` is true. It is
+/// not used by `map_structures`.
+///
 /// \param lattice_mapping_data Data describing a
 ///     lattice mapping between a prim and a structure
+/// \param structure_symmetry_reduction If true, also skip
+///     translations that are equivalent under the structure's internal
+///     translations. Default is false.
 ///
 /// \returns Vector of possible trial_translation
 ///
 std::vector<Eigen::Vector3d> make_trial_translations(
-    LatticeMappingSearchData const &lattice_mapping_data) {
+    LatticeMappingSearchData const &lattice_mapping_data,
+    bool structure_symmetry_reduction) {
+  std::vector<Eigen::Vector3d> structure_internal_translations_cart;
+  if (structure_symmetry_reduction) {
+    auto const &structure_data = *lattice_mapping_data.structure_data;
+    Eigen::Matrix3d F_inv =
+        lattice_mapping_data.lattice_mapping.deformation_gradient.inverse();
+    for (auto const &translation : xtal::make_internal_translations(
+             structure_data.structure_factor_group,
+             structure_data.lattice.tol())) {
+      structure_internal_translations_cart.push_back(F_inv * translation);
+    }
+  }
   return mapping_impl::make_trial_translations(
       lattice_mapping_data.atom_coordinate_cart_in_supercell,
       lattice_mapping_data.structure_data->atom_type,
       lattice_mapping_data.prim_data->prim_lattice,
       lattice_mapping_data.prim_data->prim_site_coordinate_cart,
       lattice_mapping_data.prim_data->prim_allowed_atom_types,
-      lattice_mapping_data.prim_data->prim_factor_group);
+      lattice_mapping_data.prim_data->prim_factor_group,
+      structure_internal_translations_cart);
 }
 
 /// \brief Make the atom mapping cost for a particular atom
@@ -664,25 +982,46 @@ std::vector<Eigen::Vector3d> make_trial_translations(
 double make_atom_to_site_cost(
     Eigen::Vector3d const &displacement, std::string const &atom_type,
     std::vector<std::string> const &allowed_atom_types, double infinity) {
-  // if vacancy is allowed on site, return 0.0; else return infinity
-  if (xtal::is_vacancy(atom_type)) {
-    for (auto const &allowed_type : allowed_atom_types) {
-      if (xtal::is_vacancy(allowed_type)) {
-        return 0.0;
-      }
-    }
-    return infinity;
-  }
+  return AtomToSiteCost()(displacement, atom_type, allowed_atom_types,
+                          infinity);
+}
 
-  // if non-vacancy is not allowed on site, return infinity
-  auto begin = allowed_atom_types.begin();
-  auto end = allowed_atom_types.end();
-  if (std::find(begin, end, atom_type) == end) {
-    return infinity;
-  }
+/// \brief Constructor
+AtomToSiteCostMatrix::AtomToSiteCostMatrix(AtomToSiteCostMatrixFunction _f)
+    : f(std::move(_f)) {}
 
-  // otherwise, return distance squared
-  return displacement.dot(displacement);
+/// \brief Calculate the cost of one atom and site, with a batch of
+///     size 1
+///
+/// This is only used if the cost of a single atom and site is
+/// required. The cost matrix is calculated with one call of `f` for
+/// all atoms and sites.
+double AtomToSiteCostMatrix::operator()(
+    Eigen::Vector3d const &displacement, std::string const &atom_type,
+    std::vector<std::string> const &allowed_atom_types,
+    double infinity) const {
+  AtomToSiteCostBatch batch;
+  batch.N_site = 1;
+  batch.N_atom = 1;
+  batch.displacement = displacement;
+  batch.atom_type_names = allowed_atom_types;
+  batch.site_allowed.setConstant(1, allowed_atom_types.size(), true);
+  auto it = std::find(allowed_atom_types.begin(), allowed_atom_types.end(),
+                      atom_type);
+  batch.atom_type_index.resize(1);
+  batch.atom_type_index(0) = std::distance(allowed_atom_types.begin(), it);
+  if (it == allowed_atom_types.end()) {
+    batch.atom_type_names.push_back(atom_type);
+    batch.site_allowed.conservativeResize(1, batch.atom_type_names.size());
+    batch.site_allowed(0, batch.atom_type_names.size() - 1) = false;
+  }
+  Eigen::MatrixXd cost = f(batch, infinity);
+  if (cost.rows() != 1 || cost.cols() != 1) {
+    throw std::runtime_error(
+        "Error in AtomToSiteCostMatrix: cost matrix function result has "
+        "the wrong shape");
+  }
+  return cost(0, 0);
 }
 
 /// \brief Constructor
@@ -708,12 +1047,15 @@ AtomMappingSearchData::AtomMappingSearchData(
       site_displacements(mapping_impl::make_site_displacements(
           lattice_mapping_data->supercell_lattice,
           lattice_mapping_data->supercell_site_coordinate_cart,
+          lattice_mapping_data->supercell_site_data,
           lattice_mapping_data->atom_coordinate_cart_in_supercell,
           trial_translation_cart)),
       cost_matrix(mapping_impl::make_cost_matrix(
           _atom_to_site_cost_f, site_displacements,
           lattice_mapping_data->structure_data->atom_type,
-          lattice_mapping_data->supercell_allowed_atom_types, _infinity)) {}
+          lattice_mapping_data->supercell_site_data,
+          lattice_mapping_data->prim_data->prim_allowed_atom_types,
+          _infinity)) {}
 
 }  // namespace mapping
 }  // namespace CASM
@@ -37,6 +37,22 @@ StructureMapping interpolated_mapping(StructureMapping const &structure_mapping,
       interpolated_mapping(structure_mapping.atom_mapping, f));
 }
 
+/// \brief Total order of structure mappings, for reproducible ordering
+///     of results with equal cost
+///
+/// Compares the lattice mappings, and then the atom mappings, using
+/// `total_order_less`. The prim is not compared.
+bool total_order_less(StructureMapping const &lhs,
+                      StructureMapping const &rhs) {
+  if (total_order_less(lhs.lattice_mapping, rhs.lattice_mapping)) {
+    return true;
+  }
+  if (total_order_less(rhs.lattice_mapping, lhs.lattice_mapping)) {
+    return false;
+  }
+  return total_order_less(lhs.atom_mapping, rhs.atom_mapping);
+}
+
 /// \brief Return the mapped structure, with implied vacancies,
 ///     strain, and atomic displacement
 ///
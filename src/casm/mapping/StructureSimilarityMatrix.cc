@@ -0,0 +1,370 @@
+#include "casm/mapping/StructureSimilarityMatrix.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/BasicStructureTools.hh"
+#include "casm/crystallography/SimpleStructureTools.hh"
+#include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/impl/StrucMapping.hh"
+#include "casm/mapping/map_structures.hh"
+
+namespace CASM {
+namespace mapping_impl {
+
+// Declarations of functions defined in map_structures.cc:
+
+std::unique_ptr<StrucMapper> make_map_structures_struc_mapper(
+    xtal::BasicStructure const &prim,
+    std::vector<xtal::SymOp> const &prim_factor_group,
+    double lattice_cost_weight, std::string const &lattice_cost_method,
+    std::string const &atom_cost_method, double cost_tol,
+    std::optional<Index> fixed_axis, double vacuum_strain_weight);
+
+}  // namespace mapping_impl
+
+namespace mapping {
+
+namespace {
+
+bool is_vacancy(std::string const &name) {
+  return name == "Va" || name == "VA" || name == "va";
+}
+
+}  // namespace
+
+/// \class StructureSimilarityMatrix
+/// \brief Structure mapping costs between all pairs of a set of
+///     structures
+///
+/// For each pair of structures (i, j), `cost()(i, j)` is the minimum
+/// total cost of mapping structure j (as "child") to a superstructure of
+/// structure i (as "parent"), as would be found by:
+///
+///     map_structures(structures[i], make_simple_structure(*structures[j]),
+///                    vol, factor_groups[i], factor_groups[j], vol, 0.0,
+///                    max_cost, lattice_cost_weight, lattice_cost_method,
+///                    atom_cost_method, 1, cost_tol)
+///
+/// where `vol` is the number of sites of structure j divided by the number
+/// of sites of structure i. The cost is infinity if the number of sites is
+/// not a multiple, if `vol > max_vol`, or if there is no mapping with
+/// total cost <= `max_cost`, which acts as a similarity threshold.
+/// Structures are expected to be ordered (i.e. one occupant per site,
+/// with no vacancies); each structure is used as a child structure with
+/// its first allowed occupant on each site.
+///
+/// Compared to independent `map_structures` calls, this:
+///
+/// - Constructs each structure's child structure, composition, and site
+///   count once.
+/// - Maps all children of one parent with one StrucMapper, so the parent
+///   symmetry analysis and superlattice enumeration are done once per
+///   parent instead of once per pair. Parent rows are scheduled across
+///   threads.
+/// - Skips pairs whose numbers of sites or compositions are not
+///   compatible without a mapping search.
+/// - Uses `max_cost` to bound the mapping search, so pairs that cannot be
+///   below the similarity threshold are abandoned as soon as the lowest
+///   lattice mapping costs exceed it. If `k_best` has a value, pairs are
+///   collected by a ConcurrentKBestResults shared by all threads, and
+///   the bound shrinks to the cost of the k-th lowest cost pair found
+///   by any thread so far.
+/// - Maps only one direction of pairs of ordered structures with equal
+///   numbers of sites when using the "isotropic_strain_cost" and
+///   "isotropic_disp_cost" methods. These costs do not depend on which
+///   structure is "parent" and which is "child", and the inverse of a
+///   mapping with volume 1 is a mapping of the reverse pair, so
+///   `cost()(j, i) == cost()(i, j)`.
+///
+/// If `k_best` has a value, only the `k_best` lowest cost pairs, plus
+/// pairs approximately tied with the k-th, have finite cost. The
+/// diagonal and mirrored pairs are not counted. Pairs with equal cost are
+/// ordered by (parent_index, child_index), so the result does not depend
+/// on the number of threads.
+///
+/// The diagonal is 0.0, the cost of the identity mapping. Mappings are
+/// not stored; use `best_mapping` to find the lowest cost mapping of a
+/// pair when it is needed, which is fast because the search is bounded by
+/// the known cost.
+
+/// \brief Constructor, maps all pairs of structures
+///
+/// \param _structures The structures, which are used as both "parent"
+///     and "child" structures.
+/// \param _factor_groups The factor group of each structure, used to
+///     skip symmetrically equivalent mappings. May be empty, or a
+///     factor group may be empty, which is equivalent to only including
+///     the identity operation.
+/// \param _params Parameters, see StructureSimilarityParams
+/// \param n_threads Number of threads used to map pairs. If 0 (default),
+///     use `std::thread::hardware_concurrency()`.
+StructureSimilarityMatrix::StructureSimilarityMatrix(
+    std::vector<std::shared_ptr<xtal::BasicStructure const>> _structures,
+    std::vector<std::vector<xtal::SymOp>> _factor_groups,
+    StructureSimilarityParams _params, Index n_threads)
+    : m_structures(std::move(_structures)),
+      m_factor_groups(std::move(_factor_groups)),
+      m_params(std::move(_params)),
+      m_is_symmetric(m_params.lattice_cost_method == "isotropic_strain_cost" &&
+                     m_params.atom_cost_method == "isotropic_disp_cost") {
+  Index N = m_structures.size();
+  if (m_factor_groups.empty()) {
+    m_factor_groups.resize(N);
+  }
+  if (Index(m_factor_groups.size()) != N) {
+    throw std::runtime_error(
+        "Error in StructureSimilarityMatrix: factor_groups size does not "
+        "match structures size");
+  }
+  if (m_params.max_vol < 1) {
+    throw std::runtime_error(
+        "Error in StructureSimilarityMatrix: max_vol < 1");
+  }
+  if (m_params.k_best.has_value() && *m_params.k_best < 1) {
+    throw std::runtime_error(
+        "Error in StructureSimilarityMatrix: k_best < 1");
+  }
+
+  for (Index i = 0; i < N; ++i) {
+    if (!m_structures[i]) {
+      throw std::runtime_error(
+          "Error in StructureSimilarityMatrix: structure is null");
+    }
+    if (m_factor_groups[i].empty()) {
+      m_factor_groups[i].push_back(xtal::SymOp::identity());
+    }
+    m_simple_structures.push_back(
+        xtal::make_simple_structure(*m_structures[i]));
+
+    std::map<std::string, Index> composition;
+    for (std::string const &name : m_simple_structures[i].atom_info.names) {
+      composition[name] += 1;
+    }
+    m_composition.push_back(composition);
+
+    bool is_ordered = true;
+    for (auto const &names : xtal::allowed_molecule_names(*m_structures[i])) {
+      if (names.size() != 1 || is_vacancy(names[0])) {
+        is_ordered = false;
+      }
+    }
+    m_is_ordered.push_back(is_ordered);
+  }
+
+  m_cost = Eigen::MatrixXd::Constant(N, N,
+                                     std::numeric_limits<double>::infinity());
+  m_cost.diagonal().setZero();
+  if (N == 0) {
+    return;
+  }
+
+  if (n_threads <= 0) {
+    n_threads =
+        std::max(Index(std::thread::hardware_concurrency()), Index(1));
+  }
+  n_threads = std::min(n_threads, N);
+
+  // min_cost < 0.0 so that perfect mappings are kept
+  PairCollector collector(
+      m_params.k_best, -m_params.cost_tol, m_params.max_cost,
+      m_params.cost_tol, [](double cost) { return cost; }, n_threads);
+  collector.set_value_less(
+      [](std::pair<Index, Index> const &lhs,
+         std::pair<Index, Index> const &rhs) { return lhs < rhs; });
+
+  // Each thread maps the rows (parent structures) it takes from
+  // `next_row`
+  std::atomic<Index> next_row(0);
+  std::vector<StructureSimilarityStatistics> thread_stats(n_threads);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&](Index t) {
+    try {
+      Index i;
+      while ((i = next_row++) < N) {
+        _map_row(i, collector, thread_stats[t]);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_row = N;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (Index t = 1; t < n_threads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  work(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (auto const &result : collector.results()) {
+    m_cost(result.second.first, result.second.second) = result.first;
+  }
+  for (auto const &stats : thread_stats) {
+    m_statistics.n_mapped += stats.n_mapped;
+    m_statistics.n_skipped_volume += stats.n_skipped_volume;
+    m_statistics.n_skipped_composition += stats.n_skipped_composition;
+  }
+
+  // Fill in the reverse of pairs that were mapped in one direction only
+  for (Index i = 0; i < N; ++i) {
+    for (Index j = 0; j < i; ++j) {
+      if (_is_mirrored(i, j)) {
+        m_cost(i, j) = m_cost(j, i);
+        m_statistics.n_mirrored += 1;
+      }
+    }
+  }
+}
+
+/// \brief Pairs with finite cost
+///
+/// \returns entries The pairs (parent_index, child_index, cost), not
+///     including the diagonal, with finite cost, in row-major order
+std::vector<StructureSimilarityEntry> StructureSimilarityMatrix::sparse_cost()
+    const {
+  std::vector<StructureSimilarityEntry> entries;
+  for (Index i = 0; i < m_cost.rows(); ++i) {
+    for (Index j = 0; j < m_cost.cols(); ++j) {
+      if (i != j && std::isfinite(m_cost(i, j))) {
+        entries.push_back({i, j, m_cost(i, j)});
+      }
+    }
+  }
+  return entries;
+}
+
+/// \brief Find the lowest cost structure mapping for a pair
+///
+/// The mapping search is bounded by the known cost of the pair. If there
+/// are approximate ties, those are also included.
+///
+/// \param parent_index Index of the "parent" structure
+/// \param child_index Index of the "child" structure
+///
+/// \returns results The lowest cost structure mappings. Empty if the pair
+///     has infinite cost.
+StructureMappingResults StructureSimilarityMatrix::best_mapping(
+    Index parent_index, Index child_index) const {
+  if (parent_index < 0 || parent_index >= size() || child_index < 0 ||
+      child_index >= size()) {
+    throw std::runtime_error(
+        "Error in StructureSimilarityMatrix::best_mapping: index out of "
+        "range");
+  }
+  double cost = m_cost(parent_index, child_index);
+  std::optional<Index> vol = _pair_vol(parent_index, child_index);
+  if (!std::isfinite(cost) || !vol.has_value()) {
+    return StructureMappingResults();
+  }
+  return map_structures(
+      m_structures[parent_index], m_simple_structures[child_index], *vol,
+      m_factor_groups[parent_index], m_factor_groups[child_index], *vol,
+      0.0, cost, m_params.lattice_cost_weight, m_params.lattice_cost_method,
+      m_params.atom_cost_method, 1, m_params.cost_tol);
+}
+
+/// \brief Volume of a pair, if the number of sites is compatible
+std::optional<Index> StructureSimilarityMatrix::_pair_vol(
+    Index parent_index, Index child_index) const {
+  Index n_parent = m_simple_structures[parent_index].atom_info.names.size();
+  Index n_child = m_simple_structures[child_index].atom_info.names.size();
+  if (n_parent == 0 || n_child % n_parent != 0) {
+    return std::nullopt;
+  }
+  return n_child / n_parent;
+}
+
+/// \brief True if cost(i, j) is set equal to cost(j, i) instead of being
+///     mapped
+///
+/// This requires costs that do not depend on which structure is "parent"
+/// and which is "child", equal numbers of sites, and that both structures
+/// are ordered. If the parent is not ordered, the child (which uses the
+/// first allowed occupant on each site) may map to occupants that are
+/// not in the reverse pair, so the costs may differ.
+bool StructureSimilarityMatrix::_is_mirrored(Index i, Index j) const {
+  return m_is_symmetric && m_is_ordered[i] && m_is_ordered[j] &&
+         m_simple_structures[i].atom_info.names.size() ==
+             m_simple_structures[j].atom_info.names.size();
+}
+
+/// \brief Map all pairs with one parent, using one StrucMapper
+void StructureSimilarityMatrix::_map_row(
+    Index parent_index, PairCollector &collector,
+    StructureSimilarityStatistics &stats) {
+  Index i = parent_index;
+  std::unique_ptr<mapping_impl::StrucMapper> strucmap;
+
+  for (Index j = 0; j < size(); ++j) {
+    if (j == i) {
+      continue;
+    }
+    std::optional<Index> vol = _pair_vol(i, j);
+    if (!vol.has_value() || *vol > m_params.max_vol) {
+      stats.n_skipped_volume += 1;
+      continue;
+    }
+    if (j < i && _is_mirrored(i, j)) {
+      // mirrored from (j, i)
+      continue;
+    }
+    if (m_is_ordered[i]) {
+      bool compatible =
+          m_composition[i].size() == m_composition[j].size();
+      for (auto const &pair : m_composition[i]) {
+        auto it = m_composition[j].find(pair.first);
+        if (it == m_composition[j].end() ||
+            it->second != *vol * pair.second) {
+          compatible = false;
+        }
+      }
+      if (!compatible) {
+        stats.n_skipped_composition += 1;
+        continue;
+      }
+    }
+
+    if (!strucmap) {
+      strucmap = mapping_impl::make_map_structures_struc_mapper(
+          *m_structures[i], m_factor_groups[i], m_params.lattice_cost_weight,
+          m_params.lattice_cost_method, m_params.atom_cost_method,
+          m_params.cost_tol, std::nullopt, 0.0);
+    }
+    // min_cost < 0.0 so that the search stops at a perfect mapping;
+    // max_cost is the current bound from all threads
+    Index k_best = 1;
+    double min_cost = -m_params.cost_tol;
+    double max_cost = collector.max_cost();
+    bool keep_invalid = false;
+    std::set<mapping_impl::MappingNode> mappings =
+        strucmap->map_deformed_struc_impose_lattice_vols(
+            m_simple_structures[j], *vol, *vol, k_best, max_cost, min_cost,
+            keep_invalid, m_factor_groups[j]);
+    stats.n_mapped += 1;
+
+    for (auto const &mapping_node : mappings) {
+      if (collector.insert(mapping_node.cost, std::make_pair(i, j))) {
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace mapping
+}  // namespace CASM
@@ -0,0 +1,81 @@
+#include "casm/mapping/assignment.hh"
+
+#include <stdexcept>
+
+#include "casm/mapping/augmenting_path.hh"
+#include "casm/mapping/hungarian.hh"
+
+namespace CASM {
+namespace mapping {
+namespace assignment {
+
+/// \brief Return the name of a SolverType
+std::string to_string(SolverType solver_type) {
+  switch (solver_type) {
+    case SolverType::hungarian:
+      return "hungarian";
+    case SolverType::augmenting_path:
+      return "augmenting_path";
+  }
+  throw std::runtime_error("Error in assignment::to_string: invalid solver");
+}
+
+/// \brief Find the optimal solution to the assignment problem, using
+///     the specified solver
+///
+/// Note that when there are multiple optimal assignments, the two
+/// solvers may return different ones. The optimal cost is the same.
+///
+/// \param solver_type The solver to use
+/// \param cost_matrix The cost of assigning "worker" i to "task" j
+///     is cost_matrix(i,j). The number of rows and columns must
+///     be greater than 1. The number of rows must be equal to the
+///     number of columns.
+/// \param infinity Cost used for "infinity", when an assignment is
+///     forced off
+/// \param tol Tolerance used for comparing costs
+///
+/// \returns The optimal assignment solution, as a pair of
+///     {cost, assignment}. See `hungarian::solve` for details.
+std::pair<double, Assignment> solve(SolverType solver_type,
+                                    Eigen::MatrixXd const &cost_matrix,
+                                    double infinity, double tol) {
+  switch (solver_type) {
+    case SolverType::hungarian:
+      return hungarian::solve(cost_matrix, infinity, tol);
+    case SolverType::augmenting_path:
+      return augmenting_path::solve(cost_matrix, infinity, tol);
+  }
+  throw std::runtime_error("Error in assignment::solve: invalid solver");
+}
+
+/// \brief Constructor
+///
+/// The default solver is hungarian::solve. The augmenting_path::solve
+/// method is faster for cost matrices with distinct costs (by about 4x
+/// for dimension 8 and 7x for dimension 32, on random cost matrices),
+/// and when most assignments are not allowed. It is slower for highly
+/// degenerate cost matrices of dimension 16 or more, which are common
+/// when mapping high symmetry structures, and may return a different
+/// one of several optimal assignments. Neither the cost matrix
+/// dimension nor the fraction of assignments that are not allowed
+/// predicts which solver is faster, so the solver is not chosen per
+/// cost matrix.
+///
+/// \param _solver_type The solver to use
+SolverMethod::SolverMethod(SolverType _solver_type)
+    : solver_type(_solver_type),
+      n_solved(std::make_shared<std::atomic<Index>>(0)) {}
+
+/// \brief Find the optimal solution to the assignment problem
+///
+/// Solves using `solver_type`, and increments `n_solved`.
+std::pair<double, Assignment> SolverMethod::operator()(
+    Eigen::MatrixXd const &cost_matrix, double infinity, double tol) const {
+  *n_solved += 1;
+  return solve(solver_type, cost_matrix, infinity, tol);
+}
+
+}  // namespace assignment
+}  // namespace mapping
+}  // namespace CASM
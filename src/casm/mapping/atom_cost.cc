@@ -79,18 +79,56 @@ double make_isotropic_atom_cost(
     Eigen::Matrix3d const &prim_lattice_column_vector_matrix,
     LatticeMapping const &lattice_mapping,
     Eigen::MatrixXd const &displacement) {
+  Eigen::Matrix3d displacement_moment;
+  displacement_moment.noalias() = displacement * displacement.transpose();
+  return make_isotropic_atom_cost(prim_lattice_column_vector_matrix,
+                                  lattice_mapping, displacement_moment,
+                                  displacement.cols());
+}
+
+/// \brief Return the "isotropic" atom cost, from the displacement moment
+///
+/// This is equivalent to `make_isotropic_atom_cost` with displacements,
+/// but uses only the displacement moment matrix,
+///
+///     D = sum_i d[i] * d[i]^T,
+///
+/// so it requires no storage proportional to the number of sites. Since
+///
+///     sum_i |d[i]|^2 = trace(D), and
+///     sum_i |d_reverse[i]|^2 = sum_i |U * d[i]|^2 = trace(U^T * U * D),
+///
+/// the result is the same, up to floating point rounding.
+///
+/// \param prim_lattice_column_vector_matrix A shape=(3,3) matrix
+///     containing the prim lattice vectors as columns.
+/// \param lattice_mapping A LatticeMappng solution
+/// \param displacement_moment Sum of outer products of the site-to-atom
+///     displacements, as defined in an AtomMapping, with themselves
+/// \param N_supercell_site The number of supercell sites
+///
+/// \return The isotropic atom cost
+///
+double make_isotropic_atom_cost(
+    Eigen::Matrix3d const &prim_lattice_column_vector_matrix,
+    LatticeMapping const &lattice_mapping,
+    Eigen::Matrix3d const &displacement_moment, Index N_supercell_site) {
   Eigen::Matrix3d const &L1 = prim_lattice_column_vector_matrix;
   Eigen::Matrix3d const &T = lattice_mapping.transformation_matrix_to_super;
   Eigen::Matrix3d const &N = lattice_mapping.reorientation;
   Eigen::Matrix3d const &U = lattice_mapping.right_stretch;
 
-  Eigen::Matrix3d S1 = L1 * T * N;
-  Eigen::Matrix3d L2 = U * S1;
-  Eigen::MatrixXd const &d = displacement;
-  Eigen::MatrixXd d_reverse = -U * d;
+  double N_site = N_supercell_site;
+  double S1_volume_per_site = std::abs((L1 * T * N).determinant()) / N_site;
+  double L2_volume_per_site = std::abs(U.determinant()) * S1_volume_per_site;
+  auto scale = [&](double volume_per_site) {
+    return std::pow(3. * volume_per_site / (4. * M_PI), -2. / 3.) / N_site;
+  };
 
-  double isotropic_atom_cost = (make_geometric_atom_cost(S1, d) +
-                                make_geometric_atom_cost(L2, d_reverse)) /
+  double forward = displacement_moment.trace();
+  double reverse = (U.transpose() * U * displacement_moment).trace();
+  double isotropic_atom_cost = (scale(S1_volume_per_site) * forward +
+                                scale(L2_volume_per_site) * reverse) /
                                2.;
   return isotropic_atom_cost;
 }
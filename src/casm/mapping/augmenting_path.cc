@@ -0,0 +1,147 @@
+#include "casm/mapping/augmenting_path.hh"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace CASM {
+namespace mapping {
+namespace augmenting_path {
+
+/// \brief Find the optimal solution to the assignment problem, using
+///     a shortest augmenting path method
+///
+/// The assignment problem is: minimize the cost of assigning m
+/// "workers" to n "tasks", where the cost of assigning "worker" i
+/// to "task" j is cost_matrix(i,j).
+///
+/// This is the Hungarian method in its shortest augmenting path form,
+/// with row and column potentials (Dijkstra-like searches in the
+/// reduced costs), which has O(N^3) complexity. Rows are added one at a
+/// time and the assignment is augmented along the shortest path in the
+/// reduced costs, so, unlike `hungarian::solve` (the Munkres
+/// formulation), no matrix copies or zero scanning passes are needed.
+/// It does not use the column reduction or augmenting row reduction
+/// initialization of the Jonker-Volgenant algorithm. Entries with cost
+/// >= infinity are not allowed assignments and are skipped.
+///
+/// \param cost_matrix The cost of assigning "worker" i to "task" j
+///     is cost_matrix(i,j). The number of rows and columns must
+///     be greater than 1. The number of rows must be equal to the
+///     number of columns.
+/// \param infinity Cost used for "infinity", when an assignment is
+///     forced off
+/// \param tol Tolerance used for comparing costs (not used by this
+///     method, but included for consistency with hungarian::solve)
+///
+/// \returns The optimal assignment solution, as a pair of
+///     {cost, assignment}. The assignment vector gives
+///     `j = assignment[i]`, where i is the worker (row) and j is
+///     the task (column). If no solution is found (every solution
+///     includes an infinity cost assignment), then the return
+///     values is {infinity, {}}.
+///
+std::pair<double, Assignment> solve(Eigen::MatrixXd const &cost_matrix,
+                                    double infinity, double tol) {
+  // --- Input validation ---
+  if (cost_matrix.rows() < 1) {
+    throw std::runtime_error(
+        "Error in augmenting_path::solve: cost_matrix.rows() < 1");
+  }
+  if (cost_matrix.cols() < 1) {
+    throw std::runtime_error(
+        "Error in augmenting_path::solve: cost_matrix.cols() < 1");
+  }
+  if (cost_matrix.rows() != cost_matrix.cols()) {
+    throw std::runtime_error(
+        "Error in augmenting_path::solve: "
+        "cost_matrix.rows() != cost_matrix.cols()");
+  }
+
+  double const inf = std::numeric_limits<double>::infinity();
+  Index dim = cost_matrix.rows();
+
+  // Index 0 is used as a sentinel "virtual" column, so rows and
+  // columns are indexed 1..dim below.
+  // - u: row potentials
+  // - v: column potentials
+  // - row_of_col[j]: row assigned to column j (0 if none)
+  // - prev_col[j]: previous column along the current augmenting path
+  std::vector<double> u(dim + 1, 0.0);
+  std::vector<double> v(dim + 1, 0.0);
+  std::vector<Index> row_of_col(dim + 1, 0);
+  std::vector<Index> prev_col(dim + 1, 0);
+  std::vector<double> min_slack(dim + 1);
+  std::vector<bool> used(dim + 1);
+
+  for (Index i = 1; i <= dim; ++i) {
+    // Find the shortest augmenting path from row i to a free column
+    row_of_col[0] = i;
+    Index j0 = 0;
+    std::fill(min_slack.begin(), min_slack.end(), inf);
+    std::fill(used.begin(), used.end(), false);
+    do {
+      used[j0] = true;
+      Index i0 = row_of_col[j0];
+      double delta = inf;
+      Index j1 = -1;
+      for (Index j = 1; j <= dim; ++j) {
+        if (used[j]) {
+          continue;
+        }
+        double c = cost_matrix(i0 - 1, j - 1);
+        if (c < infinity) {
+          double reduced_cost = c - u[i0] - v[j];
+          if (reduced_cost < min_slack[j]) {
+            min_slack[j] = reduced_cost;
+            prev_col[j] = j0;
+          }
+        }
+        if (min_slack[j] < delta) {
+          delta = min_slack[j];
+          j1 = j;
+        }
+      }
+
+      // Failure: no allowed assignment can complete the matching
+      if (j1 == -1) {
+        return std::make_pair(infinity, Assignment());
+      }
+
+      // Update potentials
+      for (Index j = 0; j <= dim; ++j) {
+        if (used[j]) {
+          u[row_of_col[j]] += delta;
+          v[j] -= delta;
+        } else {
+          min_slack[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (row_of_col[j0] != 0);
+
+    // Augment along the path
+    do {
+      Index j1 = prev_col[j0];
+      row_of_col[j0] = row_of_col[j1];
+      j0 = j1;
+    } while (j0);
+  }
+
+  Assignment assignment(dim, -1);
+  for (Index j = 1; j <= dim; ++j) {
+    assignment[row_of_col[j] - 1] = j - 1;
+  }
+
+  double cost = 0.0;
+  // Find the costs associated with the optimal assignments
+  for (Index i = 0; i < dim; ++i) {
+    cost += cost_matrix(i, assignment[i]);
+  }
+
+  return std::make_pair(cost, assignment);
+}
+
+}  // namespace augmenting_path
+}  // namespace mapping
+}  // namespace CASM
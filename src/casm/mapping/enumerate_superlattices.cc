@@ -0,0 +1,397 @@
+#include "casm/mapping/enumerate_superlattices.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "casm/crystallography/SymType.hh"
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+long floor_div(long a, long b) {
+  long q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0))) {
+    q -= 1;
+  }
+  return q;
+}
+
+/// \brief Upper triangular elements, used to identify a Hermite normal
+///     form matrix
+typedef std::array<long, 6> HermiteNormalFormKey;
+
+HermiteNormalFormKey make_key(Eigen::Matrix3l const &H) {
+  return HermiteNormalFormKey{H(0, 0), H(1, 1), H(2, 2),
+                              H(0, 1), H(0, 2), H(1, 2)};
+}
+
+/// \brief Return the prime power factors of vol, in increasing order
+///     of the prime
+std::vector<Index> make_prime_power_factors(Index vol) {
+  std::vector<Index> factors;
+  for (Index p = 2; p * p <= vol; ++p) {
+    Index q = 1;
+    while (vol % p == 0) {
+      vol /= p;
+      q *= p;
+    }
+    if (q > 1) {
+      factors.push_back(q);
+    }
+  }
+  if (vol > 1) {
+    factors.push_back(vol);
+  }
+  return factors;
+}
+
+}  // namespace
+
+/// \brief Return the Hermite normal form of the lattice spanned by the
+///     columns of an integer matrix
+///
+/// The Hermite normal form is the upper triangular matrix
+///
+///     H = [[a, b, d],
+///          [0, c, e],
+///          [0, 0, f]],
+///
+/// with a, c, f > 0, 0 <= b < a, 0 <= d < a, and 0 <= e < c, whose
+/// columns span the same lattice as the columns of M. It is obtained
+/// by integer column operations.
+///
+/// \param M A 3xN integer matrix, with N >= 3 and rank 3
+///
+/// \returns H, the Hermite normal form
+Eigen::Matrix3l make_hermite_normal_form(
+    Eigen::Matrix<long, 3, Eigen::Dynamic> M) {
+  Eigen::Matrix3l H;
+  std::vector<Index> remaining;
+  for (Index j = 0; j < M.cols(); ++j) {
+    remaining.push_back(j);
+  }
+
+  // Euclid's algorithm on each row, from the last row to the first,
+  // using the columns not already chosen as pivots
+  for (Index r = 2; r >= 0; --r) {
+    Index pivot = -1;
+    while (true) {
+      pivot = -1;
+      for (Index j : remaining) {
+        if (M(r, j) != 0 &&
+            (pivot == -1 || std::abs(M(r, j)) < std::abs(M(r, pivot)))) {
+          pivot = j;
+        }
+      }
+      if (pivot == -1) {
+        throw std::runtime_error(
+            "Error in make_hermite_normal_form: matrix rank < 3");
+      }
+      bool done = true;
+      for (Index j : remaining) {
+        if (j != pivot && M(r, j) != 0) {
+          M.col(j) -= (M(r, j) / M(r, pivot)) * M.col(pivot);
+          if (M(r, j) != 0) {
+            done = false;
+          }
+        }
+      }
+      if (done) {
+        break;
+      }
+    }
+    if (M(r, pivot) < 0) {
+      M.col(pivot) *= -1;
+    }
+    H.col(r) = M.col(pivot);
+    remaining.erase(std::find(remaining.begin(), remaining.end(), pivot));
+  }
+
+  // Reduce the off-diagonal elements
+  H.col(1) -= floor_div(H(0, 1), H(0, 0)) * H.col(0);
+  H.col(2) -= floor_div(H(1, 2), H(1, 1)) * H.col(1);
+  H.col(2) -= floor_div(H(0, 2), H(0, 0)) * H.col(0);
+  return H;
+}
+
+/// \brief Return all 3x3 integer matrices in Hermite normal form with
+///     the given determinant
+///
+/// See `make_hermite_normal_form` for the form. The number of matrices
+/// is `count_superlattices(vol)`.
+///
+/// \param vol The determinant, >= 1
+///
+/// \returns Matrices, ordered by the diagonal elements (a, c, f), and
+///     then by (b, d, e).
+std::vector<Eigen::Matrix3l> make_hermite_normal_forms(Index vol) {
+  if (vol < 1) {
+    throw std::runtime_error("Error in make_hermite_normal_forms: vol < 1");
+  }
+  std::vector<Eigen::Matrix3l> result;
+  for (long a = 1; a <= vol; ++a) {
+    if (vol % a) {
+      continue;
+    }
+    for (long c = 1; c <= vol / a; ++c) {
+      if ((vol / a) % c) {
+        continue;
+      }
+      long f = vol / a / c;
+      for (long b = 0; b < a; ++b) {
+        for (long d = 0; d < a; ++d) {
+          for (long e = 0; e < c; ++e) {
+            Eigen::Matrix3l H;
+            H << a, b, d, 0, c, e, 0, 0, f;
+            result.push_back(H);
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/// \brief Return the point group operations as integer matrices acting
+///     on the fractional coordinates of a lattice
+///
+/// \param lattice The lattice, L
+/// \param point_group Point group operations, R, of the lattice
+///
+/// \returns The integer matrices L^-1 * R * L
+std::vector<Eigen::Matrix3l> make_integer_point_group(
+    xtal::Lattice const &lattice,
+    std::vector<xtal::SymOp> const &point_group) {
+  std::vector<Eigen::Matrix3l> result;
+  for (xtal::SymOp const &op : point_group) {
+    Eigen::Matrix3d R_frac =
+        lattice.inv_lat_column_mat() * op.matrix * lattice.lat_column_mat();
+    Eigen::Matrix3l R;
+    for (Index i = 0; i < 3; ++i) {
+      for (Index j = 0; j < 3; ++j) {
+        R(i, j) = std::lround(R_frac(i, j));
+        if (std::abs(R_frac(i, j) - R(i, j)) > 1e-3) {
+          throw std::runtime_error(
+              "Error in make_integer_point_group: not a point group "
+              "operation of the lattice");
+        }
+      }
+    }
+    result.push_back(R);
+  }
+  return result;
+}
+
+/// \class SuperlatticeRangeEnumerator
+/// \brief Enumerates symmetrically distinct superlattices for a range
+///     of volumes, sharing work between volumes
+///
+/// Superlattices of a lattice L are L * H, where H is a 3x3 integer
+/// matrix in Hermite normal form, and superlattices are symmetrically
+/// equivalent if their Hermite normal forms are related by
+/// H' = HNF(R * H), for R in the point group of L (as integer
+/// matrices).
+///
+/// A superlattice with volume n = q_1 * q_2 * ... * q_k, where the q_i
+/// are powers of distinct primes, is the intersection of unique
+/// superlattices with volumes q_1, q_2, ..., q_k. Since the point group
+/// acts on each factor independently, superlattices of volume n and
+/// their images are represented by tuples of indices into the lists of
+/// superlattices with prime power volume. This enumerator therefore:
+///
+/// - Constructs the Hermite normal forms with prime power volume, and
+///   their images under the point group, once, and shares them between
+///   all volumes with that prime power factor,
+/// - Finds one representative of each orbit of superlattices with
+///   volume n by comparing index tuples to their images, without
+///   constructing or canonicalizing the Hermite normal forms of
+///   non-representative superlattices, and
+/// - Constructs the Hermite normal form of each representative from its
+///   prime power factors, H = HNF([q_2 * H_1, q_1 * H_2]), etc.
+///
+/// Results are cached, so a range of volumes can be queried one at a
+/// time.
+
+/// \brief Constructor
+///
+/// \param integer_point_group The point group of the unit lattice, as
+///     integer matrices acting on fractional coordinates (see
+///     `make_integer_point_group`). If empty, only the identity
+///     operation is used.
+SuperlatticeRangeEnumerator::SuperlatticeRangeEnumerator(
+    std::vector<Eigen::Matrix3l> const &integer_point_group)
+    : m_integer_point_group(integer_point_group) {
+  if (m_integer_point_group.empty()) {
+    m_integer_point_group.push_back(Eigen::Matrix3l::Identity());
+  }
+  for (Eigen::Matrix3l const &R : m_integer_point_group) {
+    if (std::abs(std::lround(R.cast<double>().determinant())) != 1) {
+      throw std::runtime_error(
+          "Error in SuperlatticeRangeEnumerator: point group operation "
+          "is not unimodular");
+    }
+  }
+}
+
+/// \brief Return the number of superlattices with the given volume,
+///     including symmetrically equivalent superlattices
+Index SuperlatticeRangeEnumerator::n_superlattice(Index vol) {
+  if (vol < 1) {
+    return 0;
+  }
+  Index n = 1;
+  for (Index q : make_prime_power_factors(vol)) {
+    n *= _prime_power_data(q).hnf.size();
+  }
+  return n;
+}
+
+/// \brief Return the Hermite normal form of the transformation matrix
+///     of one superlattice of each orbit of superlattices with the
+///     given volume
+///
+/// \param vol Superlattice volume, as a multiple of the unit lattice
+///     volume, >= 1
+///
+/// \returns The Hermite normal forms, ordered by the indices of their
+///     prime power factors. The representative of each orbit is the
+///     superlattice whose tuple of prime power factor indices is
+///     lexicographically smallest.
+std::vector<Eigen::Matrix3l> const &
+SuperlatticeRangeEnumerator::distinct_hermite_normal_forms(Index vol) {
+  if (vol < 1) {
+    throw std::runtime_error(
+        "Error in SuperlatticeRangeEnumerator: vol < 1");
+  }
+  auto it = m_distinct_hnf.find(vol);
+  if (it != m_distinct_hnf.end()) {
+    return it->second;
+  }
+  std::vector<Eigen::Matrix3l> &result = m_distinct_hnf[vol];
+  if (vol == 1) {
+    result.push_back(Eigen::Matrix3l::Identity());
+    return result;
+  }
+
+  std::vector<Index> q = make_prime_power_factors(vol);
+  std::vector<PrimePowerData const *> data;
+  for (Index q_i : q) {
+    data.push_back(&_prime_power_data(q_i));
+  }
+  Index k = q.size();
+  Index n_g = m_integer_point_group.size();
+
+  // iterate over index tuples, t, in lexicographic order
+  std::vector<Index> t(k, 0);
+  std::vector<Index> image(k);
+  while (true) {
+    // t is the orbit representative if no image is lexicographically
+    // smaller
+    bool is_representative = true;
+    for (Index g = 0; g < n_g && is_representative; ++g) {
+      for (Index i = 0; i < k; ++i) {
+        image[i] = data[i]->image[g][t[i]];
+        if (image[i] != t[i]) {
+          is_representative = (image[i] > t[i]);
+          break;
+        }
+      }
+    }
+
+    if (is_representative) {
+      Eigen::Matrix3l H = data[0]->hnf[t[0]];
+      Index vol_H = q[0];
+      for (Index i = 1; i < k; ++i) {
+        Eigen::Matrix<long, 3, Eigen::Dynamic> M(3, 6);
+        M << q[i] * H, vol_H * data[i]->hnf[t[i]];
+        H = make_hermite_normal_form(M);
+        vol_H *= q[i];
+      }
+      result.push_back(H);
+    }
+
+    // next tuple
+    Index i = k - 1;
+    while (i >= 0 && ++t[i] == Index(data[i]->hnf.size())) {
+      t[i] = 0;
+      --i;
+    }
+    if (i < 0) {
+      break;
+    }
+  }
+  return result;
+}
+
+SuperlatticeRangeEnumerator::PrimePowerData const &
+SuperlatticeRangeEnumerator::_prime_power_data(Index prime_power) {
+  auto it = m_prime_power_data.find(prime_power);
+  if (it != m_prime_power_data.end()) {
+    return it->second;
+  }
+  PrimePowerData &data = m_prime_power_data[prime_power];
+  data.hnf = make_hermite_normal_forms(prime_power);
+
+  std::map<HermiteNormalFormKey, Index> index;
+  for (Index i = 0; i < Index(data.hnf.size()); ++i) {
+    index.emplace(make_key(data.hnf[i]), i);
+  }
+  for (Eigen::Matrix3l const &R : m_integer_point_group) {
+    std::vector<Index> image;
+    image.reserve(data.hnf.size());
+    for (Eigen::Matrix3l const &H : data.hnf) {
+      Eigen::Matrix3l RH = R * H;
+      image.push_back(index.at(make_key(make_hermite_normal_form(RH))));
+    }
+    data.image.push_back(std::move(image));
+  }
+  return data;
+}
+
+/// \brief Enumerate symmetrically distinct superlattices for a range of
+///     volumes
+///
+/// Uses SuperlatticeRangeEnumerator, which shares the enumeration and
+/// symmetry analysis of superlattices with prime power volume between
+/// all volumes in the range.
+///
+/// \param unit_lattice The lattice, L, whose superlattices are
+///     enumerated
+/// \param point_group The point group of `unit_lattice`, used to skip
+///     symmetrically equivalent superlattices
+/// \param min_vol,max_vol The range of superlattice volumes, as
+///     multiples of the unit lattice volume, 1 <= min_vol <= max_vol
+///
+/// \returns For each volume, one superlattice, L * H, of each orbit,
+///     where H is in Hermite normal form.
+std::map<Index, std::vector<xtal::Lattice>> enumerate_superlattices(
+    xtal::Lattice const &unit_lattice,
+    std::vector<xtal::SymOp> const &point_group, Index min_vol,
+    Index max_vol) {
+  if (min_vol < 1) {
+    throw std::runtime_error("Error in enumerate_superlattices: min_vol < 1");
+  }
+  if (max_vol < min_vol) {
+    throw std::runtime_error(
+        "Error in enumerate_superlattices: max_vol < min_vol");
+  }
+  SuperlatticeRangeEnumerator enumerator(
+      make_integer_point_group(unit_lattice, point_group));
+  std::map<Index, std::vector<xtal::Lattice>> result;
+  for (Index vol = min_vol; vol <= max_vol; ++vol) {
+    std::vector<xtal::Lattice> &superlattices = result[vol];
+    for (Eigen::Matrix3l const &H :
+         enumerator.distinct_hermite_normal_forms(vol)) {
+      superlattices.push_back(xtal::make_superlattice(unit_lattice, H));
+    }
+  }
+  return result;
+}
+
+}  // namespace mapping
+}  // namespace CASM
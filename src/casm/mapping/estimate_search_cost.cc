@@ -0,0 +1,290 @@
+#include "casm/mapping/estimate_search_cost.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/Molecule.hh"
+#include "casm/mapping/SearchData.hh"
+#include "casm/mapping/lattice_cost.hh"
+
+namespace CASM {
+namespace mapping {
+
+/// \brief Return the number of superlattices of a 3d lattice with the
+///     given volume
+///
+/// This is the number of 3x3 integer matrices in Hermite normal form
+/// with determinant `vol`:
+///
+///     sum_{a*b*c = vol} b * c^2,
+///
+/// where a, b, c are the diagonal elements. This counts all
+/// superlattices, including symmetrically equivalent ones.
+///
+/// \param vol Superlattice volume, as a multiple of the lattice volume
+///
+/// \returns Number of superlattices. Returns 0 if vol < 1.
+Index count_superlattices(Index vol) {
+  Index count = 0;
+  for (Index a = 1; a <= vol; ++a) {
+    if (vol % a) {
+      continue;
+    }
+    for (Index b = 1; b <= vol / a; ++b) {
+      if ((vol / a) % b) {
+        continue;
+      }
+      Index c = vol / a / b;
+      count += b * c * c;
+    }
+  }
+  return count;
+}
+
+/// \brief Return the number of reorientation matrices with elements in
+///     the given range
+///
+/// Lattice mapping reorientation matrices, N, are integer matrices
+/// with determinant equal to 1 and elements in the range
+/// [-reorientation_range, reorientation_range]. The counts are
+/// precomputed, by enumerating the first two rows, a and b, and
+/// counting the third rows, x, in range that satisfy (a x b).x = 1.
+/// Enumerating them on each call takes O((2r+1)^8) operations, which
+/// is too slow for reorientation_range 4.
+///
+/// \param reorientation_range Range of matrix elements, 1 to 4.
+///
+/// \returns Number of reorientation matrices
+Index count_reorientations(int reorientation_range) {
+  if (reorientation_range < 1 || reorientation_range > 4) {
+    throw std::runtime_error(
+        "Error in count_reorientations: reorientation_range must be 1 to 4");
+  }
+  static Index const n_reorientation[4] = {3480, 67704, 640824, 2597208};
+  return n_reorientation[reorientation_range - 1];
+}
+
+/// \brief Estimate the cost of a structure mapping search
+///
+/// This quickly estimates the work done by a structure mapping search
+/// (such as `map_structures`) over a range of superstructure volumes,
+/// without performing any lattice or atom mappings. For each volume:
+///
+/// - The number of superlattices is counted exactly, using
+///   `count_superlattices`. The number of symmetrically distinct
+///   superlattices is bounded below by dividing by the size of the prim
+///   crystal point group; it is not enumerated.
+/// - The number of lattice mapping trials is estimated as the number
+///   of distinct superlattices multiplied by the number of reorientation
+///   matrices (counted exactly, using `count_reorientations`), divided by
+///   the sizes of the prim and structure crystal point groups (which are
+///   used to skip equivalent reorientations). This assumes reorientation
+///   orbits of full size, so it underestimates the trials for high
+///   symmetry lattices.
+/// - The number of lattice mappings used for atom mapping is estimated
+///   as the number of distinct superlattices times `k_best`.
+/// - The number of trial translations per lattice mapping is exact: it
+///   does not depend on the lattice mapping, so it is obtained by
+///   calling `make_trial_translations` once, with the prim factor group,
+///   for the undeformed structure. Explicit vacancies in the structure
+///   are handled as in the search.
+/// - The number of assignment problems per trial translation is
+///   estimated as `1 + (k_best - 1) * N`, where N is the assignment
+///   problem dimension, since each Murty partition solves up to N
+///   sub-problems.
+///
+/// Because of the symmetry approximations, the estimate is an order of
+/// magnitude bound, not an exact count of the work done.
+///
+/// Volumes where there are fewer superstructure sites than child atoms,
+/// where there are more superstructure sites than child atoms and too few
+/// sites that allow vacancies, or where some child atom type is not
+/// allowed on any prim site, are incompatible and contribute no work.
+///
+/// The predicted runtime uses the SearchCostModel coefficients, which
+/// can be obtained for a particular machine using
+/// `calibrate_search_cost_model`. The prediction is an order of
+/// magnitude estimate intended for choosing search parameters and
+/// rejecting pathological choices, not a precise timing.
+///
+/// \param prim_data The prim search data
+/// \param structure_data The child structure search data
+/// \param params The search parameters
+/// \param model The runtime model coefficients
+///
+/// \returns The estimated search cost, broken down by volume
+SearchCostEstimate estimate_search_cost(
+    PrimSearchData const &prim_data, StructureSearchData const &structure_data,
+    SearchCostParams const &params, SearchCostModel const &model) {
+  if (params.min_vol < 1) {
+    throw std::runtime_error("Error in estimate_search_cost: min_vol < 1");
+  }
+  if (params.max_vol < params.min_vol) {
+    throw std::runtime_error(
+        "Error in estimate_search_cost: max_vol < min_vol");
+  }
+  if (params.k_best < 1) {
+    throw std::runtime_error("Error in estimate_search_cost: k_best < 1");
+  }
+
+  SearchCostEstimate estimate;
+  estimate.n_reorientation = count_reorientations(params.reorientation_range);
+
+  double prim_point_group_size =
+      std::max(prim_data.prim_crystal_point_group.size(), std::size_t(1));
+  double structure_point_group_size = std::max(
+      structure_data.structure_crystal_point_group.size(), std::size_t(1));
+  double n_reorientation_per_superlattice =
+      std::max(estimate.n_reorientation /
+                   (prim_point_group_size * structure_point_group_size),
+               1.0);
+
+  // trial translations are shifted by the lattice mapping, but their
+  // number is the same for every lattice mapping
+  Index n_trial_translation =
+      mapping_impl::make_trial_translations(
+          structure_data.atom_coordinate_cart, structure_data.atom_type,
+          prim_data.prim_lattice, prim_data.prim_site_coordinate_cart,
+          prim_data.prim_allowed_atom_types, prim_data.prim_factor_group,
+          {})
+          .size();
+
+  // prim sites allowing vacancies
+  Index n_vacancy_prim_site = 0;
+  for (auto const &allowed : prim_data.prim_allowed_atom_types) {
+    if (std::any_of(allowed.begin(), allowed.end(),
+                    [](std::string const &name) {
+                      return xtal::is_vacancy(name);
+                    })) {
+      ++n_vacancy_prim_site;
+    }
+  }
+
+  for (Index vol = params.min_vol; vol <= params.max_vol; ++vol) {
+    VolumeSearchCostEstimate v;
+    v.vol = vol;
+    v.n_supercell_site = vol * prim_data.N_prim_site;
+    Index n_vacancy = v.n_supercell_site - structure_data.N_atom;
+    v.is_compatible = (n_vacancy >= 0) &&
+                      (n_vacancy <= vol * n_vacancy_prim_site) &&
+                      (n_trial_translation > 0);
+    v.n_superlattice = count_superlattices(vol);
+    v.n_canonical_superlattice = static_cast<Index>(
+        std::ceil(v.n_superlattice / prim_point_group_size));
+
+    if (v.is_compatible) {
+      double N = v.n_supercell_site;
+      v.n_lattice_mapping_trial =
+          v.n_canonical_superlattice * n_reorientation_per_superlattice;
+      v.n_lattice_mapping =
+          static_cast<double>(v.n_canonical_superlattice) * params.k_best;
+      v.n_trial_translation = n_trial_translation;
+      double n_root = v.n_lattice_mapping * v.n_trial_translation;
+      v.n_assignment_problem = n_root * (1.0 + (params.k_best - 1) * N);
+
+      v.lattice_mapping_seconds =
+          v.n_lattice_mapping_trial * model.seconds_per_lattice_mapping_trial;
+      v.cost_matrix_seconds =
+          n_root * N * N * model.seconds_per_cost_matrix_element;
+      v.assignment_seconds =
+          v.n_assignment_problem * N * N * N * model.seconds_per_assignment_op;
+    }
+    v.total_seconds = v.lattice_mapping_seconds + v.cost_matrix_seconds +
+                      v.assignment_seconds;
+
+    estimate.n_assignment_problem += v.n_assignment_problem;
+    estimate.total_seconds += v.total_seconds;
+    estimate.volumes.push_back(v);
+  }
+  return estimate;
+}
+
+/// \brief Calibrate a SearchCostModel by timing representative operations
+///
+/// This times:
+///
+/// - `isotropic_strain_cost`, as the per lattice mapping trial cost,
+/// - squared displacement lengths of a `dim` x `dim` set of vectors, as
+///   the per cost matrix element cost, and
+/// - `assignment::solve`, with `solver_type`, for random `dim` x `dim`
+///   cost matrices, as the per assignment problem cost, divided by
+///   `dim`^3. This should be the solver used by the search
+///   (`MappingSearch::assignment_f.solver_type`).
+///
+/// \param dim Assignment problem dimension used for timing
+/// \param n_samples Number of repetitions timed
+/// \param solver_type The assignment problem solver timed
+///
+/// \returns A SearchCostModel with coefficients for this machine
+SearchCostModel calibrate_search_cost_model(
+    Index dim, Index n_samples,
+    assignment::SolverType solver_type) {
+  typedef std::chrono::steady_clock clock;
+  auto seconds_since = [](clock::time_point begin) {
+    return std::chrono::duration<double>(clock::now() - begin).count();
+  };
+  std::mt19937_64 engine(0);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  SearchCostModel model;
+  double sum = 0.0;
+
+  // lattice mapping trials
+  {
+    Index n_trial = 1000 * n_samples;
+    Eigen::Matrix3d F =
+        Eigen::Matrix3d::Identity() +
+        0.05 * Eigen::Matrix3d::NullaryExpr([&]() { return dist(engine); });
+    auto begin = clock::now();
+    for (Index i = 0; i < n_trial; ++i) {
+      sum += isotropic_strain_cost(F);
+    }
+    model.seconds_per_lattice_mapping_trial = seconds_since(begin) / n_trial;
+  }
+
+  // cost matrix elements
+  {
+    Eigen::MatrixXd displacements =
+        Eigen::MatrixXd::NullaryExpr(3, dim, [&]() { return dist(engine); });
+    Eigen::MatrixXd cost_matrix(dim, dim);
+    auto begin = clock::now();
+    for (Index n = 0; n < n_samples; ++n) {
+      for (Index i = 0; i < dim; ++i) {
+        for (Index j = 0; j < dim; ++j) {
+          Eigen::Vector3d d = displacements.col(j) - displacements.col(i);
+          cost_matrix(i, j) = d.dot(d);
+        }
+      }
+      sum += cost_matrix.sum();
+    }
+    model.seconds_per_cost_matrix_element =
+        seconds_since(begin) / (n_samples * dim * dim);
+  }
+
+  // assignment problems
+  {
+    std::vector<Eigen::MatrixXd> samples;
+    for (Index n = 0; n < n_samples; ++n) {
+      samples.emplace_back(Eigen::MatrixXd::NullaryExpr(
+          dim, dim, [&]() { return dist(engine); }));
+    }
+    auto begin = clock::now();
+    for (auto const &cost_matrix : samples) {
+      sum += assignment::solve(solver_type, cost_matrix).first;
+    }
+    model.seconds_per_assignment_op =
+        seconds_since(begin) / (n_samples * double(dim) * dim * dim);
+  }
+
+  // prevent the timed operations from being optimized away
+  if (std::isnan(sum)) {
+    throw std::runtime_error("Error in calibrate_search_cost_model: nan");
+  }
+  return model;
+}
+
+}  // namespace mapping
+}  // namespace CASM
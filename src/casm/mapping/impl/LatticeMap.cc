@@ -7,6 +7,7 @@
 #include "casm/crystallography/Strain.hh"
 #include "casm/crystallography/SymType.hh"
 #include "casm/external/Eigen/src/Core/Matrix.h"
+#include "casm/mapping/lattice_cost.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 
 namespace CASM {
@@ -388,20 +389,40 @@ double StrainCostCalculator::strain_cost(
 ///     indicates that the `symmetry_breaking_strain_cost` should be used to
 ///     score lattice mappings.
 /// \param _cost_tol Tolerance used for cost comparisons
+/// \param _fixed_axis If has value, use slab mode: the index (0, 1, or 2)
+///     of the parent and child lattice vector that is fixed (i.e. the
+///     non-periodic, or vacuum, direction). Only \f$N\f$ that map the
+///     fixed lattice vector to itself (up to sign), and the plane of the
+///     other two lattice vectors to itself, are considered, only point
+///     group operations that do the same are used, and mappings are
+///     scored with `slab_strain_cost`.
+/// \param _vacuum_strain_weight In slab mode, the weight of the
+///     out-of-plane strain in `slab_strain_cost`. If 0.0, strain of the
+///     fixed lattice vector is ignored.
 LatticeMap::LatticeMap(const xtal::Lattice &_parent,
                        const xtal::Lattice &_child, int _range,
                        xtal::SymOpVector const &_parent_point_group,
                        xtal::SymOpVector const &_child_point_group,
                        double _init_better_than /* = 1e20 */,
-                       bool _symmetrize_strain_cost, double _cost_tol)
+                       bool _symmetrize_strain_cost, double _cost_tol,
+                       std::optional<Index> _fixed_axis,
+                       double _vacuum_strain_weight)
     : m_parent(_parent.lat_column_mat()),
       m_child(_child.lat_column_mat()),
       m_range(_range),
       m_symmetrize_strain_cost(_symmetrize_strain_cost),
       m_cost_tol(_cost_tol),
+      m_fixed_axis(_fixed_axis),
+      m_vacuum_strain_weight(_vacuum_strain_weight),
       m_has_current_solution(false),
       m_cost(1e20),
-      m_currmat(0) {
+      m_currmat(0),
+      m_n_strain_cost(0) {
+  if (m_fixed_axis.has_value() && (*m_fixed_axis < 0 || *m_fixed_axis > 2)) {
+    throw std::runtime_error(
+        "Error in LatticeMap: fixed_axis must be 0, 1, or 2");
+  }
+
   xtal::Lattice reduced_parent = _parent.reduced_cell();
   m_reduced_parent = reduced_parent.lat_column_mat();
 
@@ -427,11 +448,31 @@ LatticeMap::LatticeMap(const xtal::Lattice &_parent,
     throw std::runtime_error(
         "LatticeMap cannot currently be invoked for range>4");
 
+  // In slab mode, only enumerate N that preserve the fixed axis
+  if (m_fixed_axis.has_value()) {
+    m_slab_mats = std::make_shared<std::vector<Eigen::Matrix3i> const>(
+        make_slab_unimodular_matrices(
+            m_transformation_matrix_to_reduced_parent,
+            m_transformation_matrix_to_reduced_child_inv, m_range,
+            *m_fixed_axis));
+    m_mvec_ptr = m_slab_mats.get();
+  }
+
+  // In slab mode, only use operations that preserve the fixed axis
+  xtal::SymOpVector parent_point_group = _parent_point_group;
+  xtal::SymOpVector child_point_group = _child_point_group;
+  if (m_fixed_axis.has_value()) {
+    parent_point_group =
+        make_slab_point_group(_parent, _parent_point_group, *m_fixed_axis);
+    child_point_group =
+        make_slab_point_group(_child, _child_point_group, *m_fixed_axis);
+  }
+
   // Construct inverse fractional symops for parent
   {
     xtal::IsPointGroupOp symcheck(reduced_parent);
-    m_parent_fsym_mats.reserve(_parent_point_group.size());
-    for (auto const &op : _parent_point_group) {
+    m_parent_fsym_mats.reserve(parent_point_group.size());
+    for (auto const &op : parent_point_group) {
       if (!symcheck(op)) continue;
       m_parent_fsym_mats.push_back(
           iround(reduced_parent.inv_lat_column_mat() * op.matrix.transpose() *
@@ -446,13 +487,13 @@ LatticeMap::LatticeMap(const xtal::Lattice &_parent,
   }
 
   // Store the parent symmetry operations
-  m_parent_point_group = _parent_point_group;
+  m_parent_point_group = parent_point_group;
 
   // Construct fractional symops for child
   {
     xtal::IsPointGroupOp symcheck(reduced_child);
-    m_child_fsym_mats.reserve(_child_point_group.size());
-    for (auto const &op : _child_point_group) {
+    m_child_fsym_mats.reserve(child_point_group.size());
+    for (auto const &op : child_point_group) {
       if (!symcheck(op)) continue;
       m_child_fsym_mats.push_back(
           iround(reduced_child.inv_lat_column_mat() * op.matrix *
@@ -471,6 +512,11 @@ LatticeMap::LatticeMap(const xtal::Lattice &_parent,
 
 void LatticeMap::_reset(double _better_than) {
   m_currmat = 0;
+  if (!n_mat()) {
+    m_has_current_solution = false;
+    m_cost = 1e20;
+    return;
+  }
 
   // From relation F * parent * inv_mat.inverse() = child
   m_deformation_gradient =
@@ -484,9 +530,7 @@ void LatticeMap::_reset(double _better_than) {
     m_has_current_solution = true;
     m_cost = tcost;
     // reconstruct correct N for unreduced lattice
-    m_N = m_transformation_matrix_to_reduced_parent *
-          inv_mat().cast<double>().inverse() *
-          m_transformation_matrix_to_reduced_child_inv;
+    m_N = _make_N();
   } else
     next_mapping_better_than(_better_than);
 }
@@ -522,7 +566,12 @@ const LatticeMap &LatticeMap::best_strain_mapping() const {
 ///
 double LatticeMap::_calc_strain_cost(
     const Eigen::Matrix3d &deformation_gradient) const {
-  if (symmetrize_strain_cost())
+  ++m_n_strain_cost;
+  if (m_fixed_axis.has_value())
+    return mapping::slab_strain_cost(
+        deformation_gradient, m_parent.col((*m_fixed_axis + 1) % 3),
+        m_parent.col((*m_fixed_axis + 2) % 3), m_vacuum_strain_weight);
+  else if (symmetrize_strain_cost())
     return symmetry_breaking_strain_cost(deformation_gradient,
                                          m_parent_point_group);
   else
@@ -531,11 +580,13 @@ double LatticeMap::_calc_strain_cost(
 
 /// The name of the method used to calculate the lattice deformation cost
 ///
-/// \returns "isotropic_strain_cost", "anisotropic_strain_cost", or
-///   "symmetry_breaking_strain_cost", as determined by constructor arguments
+/// \returns "isotropic_strain_cost", "symmetry_breaking_strain_cost", or
+///   "slab_strain_cost", as determined by constructor arguments
 ///
 std::string LatticeMap::cost_method() const {
-  if (symmetrize_strain_cost()) {
+  if (m_fixed_axis.has_value()) {
+    return "slab_strain_cost";
+  } else if (symmetrize_strain_cost()) {
     return "symmetry_breaking_strain_cost";
   } else {
     return "isotropic_strain_cost";
@@ -577,6 +628,18 @@ const LatticeMap &LatticeMap::_next_mapping_better_than(double max_cost) const {
     m_deformation_gradient =
         m_reduced_child * inv_mat().cast<double>() *
         m_reduced_parent.inverse();  // -> _deformation_gradient
+
+    // Skip the polar decomposition if the isotropic strain cost cannot
+    // be less than max_cost
+    if (!m_fixed_axis.has_value() && !symmetrize_strain_cost()) {
+      double lower_bound =
+          mapping::isotropic_strain_cost_lower_bound(m_deformation_gradient);
+      if (!(lower_bound < (std::abs(max_cost) + std::abs(cost_tol())))) {
+        tcost = lower_bound;
+        continue;
+      }
+    }
+
     tcost = _calc_strain_cost(m_deformation_gradient);
     if (std::abs(tcost) < (std::abs(max_cost) + std::abs(cost_tol()))) {
       m_has_current_solution = true;
@@ -588,9 +651,7 @@ const LatticeMap &LatticeMap::_next_mapping_better_than(double max_cost) const {
       // m_transformation_matrix_to_reduced_child_inv depend on the lattice
       // reduction that was performed in the constructor, so we would need to
       // store "non-reduced" parent and child
-      m_N = m_transformation_matrix_to_reduced_parent *
-            inv_mat().cast<double>().inverse() *
-            m_transformation_matrix_to_reduced_child_inv;
+      m_N = _make_N();
       // std::cout << "N:\n" << m_N << "\n";
       //  We already have:
       //        m_deformation_gradient = m_reduced_child *
@@ -640,6 +701,131 @@ bool LatticeMap::_check_canonical() const {
   return true;
 }
 
+/// Returns N for the unreduced lattices, given the current inv_mat()
+LatticeMap::DMatType LatticeMap::_make_N() const {
+  return m_transformation_matrix_to_reduced_parent *
+         inv_mat().cast<double>().inverse() *
+         m_transformation_matrix_to_reduced_child_inv;
+}
+
+/// \brief Returns true if a transformation matrix preserves a lattice
+/// vector and the plane of the other two lattice vectors
+///
+/// \param M A transformation matrix, acting on fractional coordinates
+///     (i.e. a superlattice transformation matrix, T, a reorientation
+///     matrix, N, or a fractional point group operation matrix)
+/// \param fixed_axis Index (0, 1, or 2) of the fixed lattice vector
+/// \param tol Tolerance for checking elements
+///
+/// \returns True if `M(fixed_axis, fixed_axis) == +/-1` and all other
+///     elements in row and column `fixed_axis` are zero.
+bool is_slab_transformation(Eigen::Matrix3d const &M, Index fixed_axis,
+                            double tol) {
+  Index k = fixed_axis;
+  if (std::abs(std::abs(M(k, k)) - 1.0) > tol) {
+    return false;
+  }
+  for (Index i = 0; i < 3; ++i) {
+    if (i == k) {
+      continue;
+    }
+    if (std::abs(M(i, k)) > tol || std::abs(M(k, i)) > tol) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Returns the unimodular matrices used by LatticeMap as
+/// N.inverse() in slab mode
+///
+/// LatticeMap enumerates reorientations using unimodular matrices,
+/// `inv_mat`, with elements in `[-range, range]`, where
+///
+///     N = P * inv_mat.inverse() * Q,
+///
+/// with P = `transformation_matrix_to_reduced_parent` and
+/// Q = `transformation_matrix_to_reduced_child_inv`. This returns
+/// exactly those `inv_mat` for which N satisfies
+/// `is_slab_transformation`, without enumerating all unimodular
+/// matrices. Since `inv_mat = Q * X * P`, with X = N.inverse(), it
+/// enumerates X with the fixed row and column of the identity (up to
+/// sign) and an in-plane 2x2 block with determinant +/-1, with
+/// elements bounded using the range of `inv_mat`.
+///
+/// \param transformation_matrix_to_reduced_parent Integer matrix, P
+/// \param transformation_matrix_to_reduced_child_inv Integer matrix, Q
+/// \param range Maximum absolute value of elements of `inv_mat`
+/// \param fixed_axis Index (0, 1, or 2) of the fixed lattice vector
+///
+/// \returns The unimodular matrices, `inv_mat`, with determinant 1.
+std::vector<Eigen::Matrix3i> make_slab_unimodular_matrices(
+    Eigen::Matrix3d const &transformation_matrix_to_reduced_parent,
+    Eigen::Matrix3d const &transformation_matrix_to_reduced_child_inv,
+    int range, Index fixed_axis) {
+  Eigen::Matrix3d const &P = transformation_matrix_to_reduced_parent;
+  Eigen::Matrix3d const &Q = transformation_matrix_to_reduced_child_inv;
+
+  // |X(i,j)| <= range * (row i of |Q.inverse()|) * (column j of
+  // |P.inverse()|), since X = Q.inverse() * inv_mat * P.inverse()
+  double max_row_sum = Q.inverse().cwiseAbs().rowwise().sum().maxCoeff();
+  double max_col_sum = P.inverse().cwiseAbs().colwise().sum().maxCoeff();
+  int bound = std::lround(range * max_row_sum * max_col_sum);
+
+  Index k = fixed_axis;
+  Index i = (k + 1) % 3;
+  Index j = (k + 2) % 3;
+  std::vector<Eigen::Matrix3i> result;
+  Eigen::Matrix3d X = Eigen::Matrix3d::Zero();
+  for (int s = -1; s <= 1; s += 2) {
+    X(k, k) = s;
+    for (int a = -bound; a <= bound; ++a) {
+      for (int b = -bound; b <= bound; ++b) {
+        for (int c = -bound; c <= bound; ++c) {
+          for (int d = -bound; d <= bound; ++d) {
+            if (std::abs(a * d - b * c) != 1) {
+              continue;
+            }
+            X(i, i) = a;
+            X(i, j) = b;
+            X(j, i) = c;
+            X(j, j) = d;
+            Eigen::Matrix3i M = iround(Q * X * P);
+            if (M.cwiseAbs().maxCoeff() > range || M.determinant() != 1) {
+              continue;
+            }
+            result.push_back(M);
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/// \brief Returns the point group operations that preserve a lattice
+/// vector and the plane of the other two lattice vectors
+///
+/// \param lattice The lattice
+/// \param point_group Point group operations, in Cartesian coordinates
+/// \param fixed_axis Index (0, 1, or 2) of the fixed lattice vector
+///
+/// \returns The operations, op, for which the fractional operation matrix,
+///     `L.inv * op.matrix * L`, satisfies `is_slab_transformation`.
+xtal::SymOpVector make_slab_point_group(xtal::Lattice const &lattice,
+                                        xtal::SymOpVector const &point_group,
+                                        Index fixed_axis) {
+  xtal::SymOpVector result;
+  for (auto const &op : point_group) {
+    Eigen::Matrix3d M =
+        lattice.inv_lat_column_mat() * op.matrix * lattice.lat_column_mat();
+    if (is_slab_transformation(M, fixed_axis)) {
+      result.push_back(op);
+    }
+  }
+  return result;
+}
+
 /// \brief Returns the volume-normalized strain cost, calculated to be
 /// invariant to which structure is the child/parent.
 ///
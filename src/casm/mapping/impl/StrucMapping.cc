@@ -12,6 +12,7 @@
 #include "casm/external/Eigen/src/Core/PermutationMatrix.h"
 #include "casm/external/Eigen/src/Core/util/Constants.h"
 #include "casm/external/Eigen/src/Core/util/Meta.h"
+#include "casm/mapping/enumerate_superlattices.hh"
 #include "casm/mapping/impl/LatticeMap.hh"
 #include "casm/mapping/impl/StrucMapCalculatorInterface.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
@@ -1267,7 +1268,10 @@ StrucMapper::StrucMapper(StrucMapCalculatorInterface const &calculator,
       m_lattice_transformation_range(1),
       m_symmetrize_lattice_cost(false),
       m_symmetrize_atomic_cost(false),
-      m_filtered(false) {
+      m_vacuum_strain_weight(0.0),
+      m_ideal_lattice_bound(true),
+      m_filtered(false),
+      m_max_queue_size(0) {
   set_min_va_frac(_min_va_frac);
   set_max_va_frac(_max_va_frac);
 
@@ -1404,6 +1408,10 @@ std::set<MappingNode> StrucMapper::_seed_from_vol_range(
   // Ensure that you don't try to enumerate size zero supercells
   min_vol = std::max(min_vol, Index{1});
 
+  // Enumerate superlattices for the whole range at once, sharing work
+  // between volumes
+  _enumerate_superlattices(min_vol, max_vol);
+
   xtal::Lattice child_lat(unmapped_child.lat_column_mat, xtal_tol());
   std::set<MappingNode> mapping_seed;
   for (Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
@@ -1427,6 +1435,48 @@ std::set<MappingNode> StrucMapper::_seed_from_vol_range(
   return mapping_seed;
 }
 
+/// \brief Construct a partial mapping node (with uninitialized atomic_node)
+/// with zero lattice cost, if the child lattice is a superlattice of the
+/// parent lattice
+///
+/// Checks if \f$L_1 * T_1 = Q * L_2\f$, for some integer \f$T_1\f$, with
+/// \f$\det{T_1}\f$ in the range [min_vol, max_vol], and some parent
+/// structure point group operation \f$Q\f$, by checking if
+/// \f$L_1^{-1} * Q * L_2\f$ is integer. This is the case for unrelaxed
+/// child structures, such as enumerated configurations.
+///
+/// \returns A set containing the mapping node with the lattice mapping
+///     \f$F = Q^{-1}\f$, or an empty set if the child lattice is not a
+///     superlattice of the parent lattice in the volume range.
+std::set<MappingNode> StrucMapper::_seed_from_ideal_superlattice(
+    xtal::SimpleStructure const &unmapped_child, Index min_vol,
+    Index max_vol) const {
+  std::set<MappingNode> mapping_seed;
+  Eigen::Matrix3d const &L1 = parent().lat_column_mat;
+  Eigen::Matrix3d const &L2 = unmapped_child.lat_column_mat;
+  Eigen::Matrix3d L1_inv = L1.inverse();
+  for (xtal::SymOp const &op : calculator().point_group()) {
+    Eigen::Matrix3d T = L1_inv * op.matrix * L2;
+    if (!is_integer(T, xtal_tol())) {
+      continue;
+    }
+    Eigen::Matrix3l T_int = lround(T);
+    // the volume is the same for all Q, so there is no need to continue
+    Index vol = std::abs(T_int.determinant());
+    if (vol < min_vol || vol > max_vol) {
+      return mapping_seed;
+    }
+    LatticeNode lattice_node(
+        xtal::Lattice(L1, xtal_tol()),
+        xtal::Lattice(L1 * T_int.cast<double>(), xtal_tol()),
+        xtal::Lattice(L2, xtal_tol()), xtal::Lattice(L2, xtal_tol()),
+        _n_species(unmapped_child), 0. /*strain_cost is zero in ideal case*/);
+    mapping_seed.emplace(lattice_node, this->lattice_weight());
+    return mapping_seed;
+  }
+  return mapping_seed;
+}
+
 //*******************************************************************************************
 /*
  * Given a structure and a mapping node, find a perfect supercell of the prim
@@ -1619,6 +1669,14 @@ std::set<MappingNode> StrucMapper::map_deformed_struc(
 ///   and `soft_va_limit` have no effect.
 /// - Constraints set by `add_allowed_lattice` and `set_filter` are still in
 ///   effect, and all assignment is the same as in `map_deformed_struc`.
+/// - If `ideal_lattice_bound()` is true, and the child lattice is an exact
+///   superlattice of the parent lattice with volume in the range (as for
+///   unrelaxed child structures), the child is first mapped to that
+///   superlattice with zero lattice cost. The cost of the k-th best of
+///   those mappings is used as `max_cost` for the full search, so lattice
+///   mappings with a greater weighted lattice cost are skipped without
+///   atomic assignment. This is not done if allowed lattices or a lattice
+///   filter are set, or in slab mode.
 ///
 /// \param unmapped_child Input structure to be mapped onto parent structure
 /// \param min_vol,max_vol The inclusive range [min_vol, max_vol] of candidate
@@ -1639,13 +1697,39 @@ std::set<MappingNode> StrucMapper::map_deformed_struc_impose_lattice_vols(
     Index k /*=1*/, double max_cost /*=big_inf()*/, double min_cost /*=-TOL*/,
     bool keep_invalid /*=false*/,
     xtal::SymOpVector const &child_factor_group) const {
+  bool no_partition = !m_robust && k <= 1;
+  m_max_queue_size = 0;
+
+  // If the child lattice is an exact superlattice of the parent lattice,
+  // mapping to it first gives an upper bound on the cost of the k-best
+  // mappings, which prunes lattice mappings with
+  // lattice_weight * lattice_cost greater than the bound before any atomic
+  // assignment. This is skipped if the parent superlattices are constrained
+  // or filtered, or in slab mode, because the full search may not include
+  // the ideal superlattice.
+  if (m_ideal_lattice_bound && k > 0 && !lattices_constrained() &&
+      !m_filtered && !m_fixed_axis.has_value()) {
+    std::set<MappingNode> ideal_seed =
+        _seed_from_ideal_superlattice(unmapped_child, min_vol, max_vol);
+    if (!ideal_seed.empty()) {
+      k_best_maps_better_than(unmapped_child, ideal_seed, k, max_cost,
+                              min_cost, false, false, no_partition);
+      Index n_found = 0;
+      for (MappingNode const &node : ideal_seed) {
+        if (node.is_valid && node.cost > min_cost && ++n_found == k) {
+          max_cost = min(max_cost, node.cost);
+          break;
+        }
+      }
+    }
+  }
+
   int seed_k = 10 + 5 * k;
   std::set<MappingNode> mapping_seed = _seed_from_vol_range(
       unmapped_child, seed_k, min_vol, max_vol,
       max_cost / (this->lattice_weight()),
       max(min_cost / (this->lattice_weight()), cost_tol()), child_factor_group);
 
-  bool no_partition = !m_robust && k <= 1;
   k_best_maps_better_than(unmapped_child, mapping_seed, k, max_cost, min_cost,
                           keep_invalid, false, no_partition);
 
@@ -1761,23 +1845,70 @@ std::vector<xtal::Lattice> StrucMapper::_lattices_of_vol(Index prim_vol) const {
   if (it != m_superlat_map.end()) return it->second;
 
   // We don't have any lattices for the provided volume, enumerate them all!!!
-  std::vector<xtal::Lattice> &lat_vec = m_superlat_map[prim_vol];
-
-  auto pg = calculator().point_group();
-  xtal::SuperlatticeEnumerator enumerator(
-      pg.begin(), pg.end(), xtal::Lattice(parent().lat_column_mat, xtal_tol()),
-      xtal::ScelEnumProps(prim_vol, prim_vol + 1));
-
-  for (auto it = enumerator.begin(); it != enumerator.end(); ++it) {
-    xtal::Lattice canon_lat = *it;
-    if (xtal::canonical::check(canon_lat, calculator().point_group())) {
-      canon_lat =
-          xtal::canonical::equivalent(canon_lat, calculator().point_group());
+
+  // In slab mode, only enumerate superlattices in the plane of the other two
+  // lattice vectors, keeping the fixed lattice vector. Superlattices are not
+  // made canonical, which could change the fixed lattice vector.
+  if (m_fixed_axis.has_value()) {
+    std::vector<xtal::Lattice> &lat_vec = m_superlat_map[prim_vol];
+    xtal::Lattice parent_lat(parent().lat_column_mat, xtal_tol());
+    auto pg = calculator().point_group();
+    std::string dirs;
+    for (Index i = 0; i < 3; ++i) {
+      if (i != *m_fixed_axis) {
+        dirs.push_back("abc"[i]);
+      }
     }
-    lat_vec.push_back(canon_lat);
+    auto slab_pg = make_slab_point_group(parent_lat, pg, *m_fixed_axis);
+    xtal::SuperlatticeEnumerator enumerator(
+        slab_pg.begin(), slab_pg.end(), parent_lat,
+        xtal::ScelEnumProps(prim_vol, prim_vol + 1, dirs));
+    for (auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+      Eigen::Matrix3d T =
+          parent_lat.inv_lat_column_mat() * it->lat_column_mat();
+      if (is_slab_transformation(T, *m_fixed_axis)) {
+        lat_vec.push_back(*it);
+      }
+    }
+    return lat_vec;
   }
 
-  return lat_vec;
+  _enumerate_superlattices(prim_vol, prim_vol);
+  return m_superlat_map[prim_vol];
+}
+
+/// \brief Enumerate superlattices of the parent lattice, for all volumes
+///     in a range that are not already enumerated, and store them in
+///     m_superlat_map
+///
+/// Uses `mapping::SuperlatticeRangeEnumerator`, which shares the
+/// enumeration and symmetry analysis of superlattices with prime power
+/// volume between all volumes in the range. Does nothing if the
+/// allowed superlattices are constrained, or in slab mode, where
+/// superlattices are enumerated by `_lattices_of_vol`.
+void StrucMapper::_enumerate_superlattices(Index min_vol,
+                                           Index max_vol) const {
+  if (this->lattices_constrained() || m_fixed_axis.has_value()) {
+    return;
+  }
+  xtal::Lattice parent_lat(parent().lat_column_mat, xtal_tol());
+  auto const &pg = calculator().point_group();
+  mapping::SuperlatticeRangeEnumerator enumerator(
+      mapping::make_integer_point_group(parent_lat, pg));
+  for (Index vol = std::max(min_vol, Index{1}); vol <= max_vol; ++vol) {
+    if (m_superlat_map.count(vol)) {
+      continue;
+    }
+    std::vector<xtal::Lattice> &lat_vec = m_superlat_map[vol];
+    for (Eigen::Matrix3l const &H :
+         enumerator.distinct_hermite_normal_forms(vol)) {
+      xtal::Lattice canon_lat = xtal::make_superlattice(parent_lat, H);
+      if (xtal::canonical::check(canon_lat, pg)) {
+        canon_lat = xtal::canonical::equivalent(canon_lat, pg);
+      }
+      lat_vec.push_back(canon_lat);
+    }
+  }
 }
 
 /// Find k-best mappings
@@ -1844,6 +1975,7 @@ Index StrucMapper::k_best_maps_better_than(
   while (it != queue.end()) {
     bool erase = true;
     auto current = it;
+    m_max_queue_size = max(m_max_queue_size, Index(queue.size()));
 
     if (it->cost <= (max_cost + this->cost_tol())) {
       // If supercell volumes have already been determined incompatible, we do
@@ -1959,7 +2091,7 @@ std::set<MappingNode> StrucMapper::_seed_k_best_from_super_lats(
       LatticeMap lattice_map(p_lat, c_lat, this->lattice_transformation_range(),
                              calculator().point_group(), c_lat_factor_group,
                              max_lattice_cost, symmetrize_lattice_cost(),
-                             cost_tol());
+                             cost_tol(), m_fixed_axis, m_vacuum_strain_weight);
 
       // lattice_map is initialized to first mapping better than
       // 'max_lattice_cost', if such a mapping exists We will continue checking
@@ -3,8 +3,12 @@
 #include "casm/casm_io/container/json_io.hh"
 #include "casm/casm_io/json/jsonParser.hh"
 #include "casm/mapping/AtomMapping.hh"
+#include "casm/mapping/LatencyHistogram.hh"
 #include "casm/mapping/LatticeMapping.hh"
+#include "casm/mapping/LatticeMappingIndex.hh"
 #include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/map_structures_batch.hh"
+#include "casm/mapping/perf_counters.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 
 namespace CASM {
@@ -75,6 +79,73 @@ void from_json(mapping::LatticeMappingResults &results,
   from_json(results.data, json);
 }
 
+// LatticeMappingIndex
+
+/// \brief Write LatticeMappingIndex entries to JSON
+///
+/// Format:
+///
+///     {
+///       "lattice1": <parent lattice vectors, as rows>,
+///       "cost_method": <str>,
+///       "entries": [
+///         {
+///           "lattice2": <reduced child lattice vectors, as rows>,
+///           "lattice_mappings": <LatticeMappingResults>
+///         },
+///         ...
+///       ]
+///     }
+///
+/// The parent point group is not written.
+jsonParser &to_json(mapping::LatticeMappingIndex const &index,
+                    jsonParser &json) {
+  json.put_obj();
+  json["lattice1"] = index.lattice1().lat_column_mat().transpose();
+  json["cost_method"] = index.cost_method();
+  json["entries"].put_array();
+  for (auto const &entry : index.entries()) {
+    jsonParser tjson;
+    tjson["lattice2"] = entry.reduced_lattice2.lat_column_mat().transpose();
+    to_json(entry.lattice_mappings, tjson["lattice_mappings"]);
+    json["entries"].push_back(tjson);
+  }
+  return json;
+}
+
+/// \brief Insert LatticeMappingIndex entries from JSON
+///
+/// Entries are inserted into an existing index, which provides the
+/// parent point group. Throws if "lattice1" or "cost_method" do not
+/// match the index.
+void from_json(mapping::LatticeMappingIndex &index, jsonParser const &json) {
+  Eigen::Matrix3d lattice1_vectors;
+  std::string cost_method;
+  from_json(lattice1_vectors, json["lattice1"]);
+  from_json(cost_method, json["cost_method"]);
+  if (!almost_equal(lattice1_vectors.transpose(),
+                    index.lattice1().lat_column_mat(),
+                    index.lattice1().tol())) {
+    throw std::runtime_error(
+        "Error reading LatticeMappingIndex from JSON: lattice1 does not "
+        "match");
+  }
+  if (cost_method != index.cost_method()) {
+    throw std::runtime_error(
+        "Error reading LatticeMappingIndex from JSON: cost_method does not "
+        "match");
+  }
+  for (auto const &entry_json : json["entries"]) {
+    Eigen::Matrix3d lattice2_vectors;
+    mapping::LatticeMappingResults lattice_mappings;
+    from_json(lattice2_vectors, entry_json["lattice2"]);
+    from_json(lattice_mappings, entry_json["lattice_mappings"]);
+    index.insert(
+        xtal::Lattice(lattice2_vectors.transpose(), index.lattice1().tol()),
+        lattice_mappings);
+  }
+}
+
 // AtomMapping
 
 jsonParser &to_json(mapping::AtomMapping const &m, jsonParser &json) {
@@ -218,4 +289,139 @@ void from_json(mapping::StructureMappingResults &results,
   from_json(results.data, json, prim);
 }
 
+// PerfCounts
+
+/// \brief Write PerfCounts to JSON
+///
+/// Counters that are not available are written as null. Includes the
+/// derived value "ipc" (instructions per cycle).
+jsonParser &to_json(mapping::PerfCounts const &counts, jsonParser &json) {
+  auto write = [&](std::string key, std::optional<double> const &value) {
+    if (value.has_value()) {
+      json[key] = *value;
+    } else {
+      json[key].put_null();
+    }
+  };
+  json.put_obj();
+  json["seconds"] = counts.seconds;
+  write("cycles", counts.cycles);
+  write("instructions", counts.instructions);
+  write("l1d_read_misses", counts.l1d_read_misses);
+  write("llc_misses", counts.llc_misses);
+  write("branch_misses", counts.branch_misses);
+  write("ipc", counts.ipc());
+  return json;
+}
+
+// LatencyHistogram
+
+/// \brief Write LatencyHistogram to JSON
+///
+/// Includes summary values, in seconds, and the non-empty buckets as
+/// "buckets": [[lowest_ns, highest_ns, count], ...].
+jsonParser &to_json(mapping::LatencyHistogram const &histogram,
+                    jsonParser &json) {
+  json.put_obj();
+  json["significant_bits"] = histogram.significant_bits();
+  json["count"] = static_cast<Index>(histogram.count());
+  json["min"] = histogram.min();
+  json["mean"] = histogram.mean();
+  json["p50"] = histogram.value_at_percentile(50.0);
+  json["p90"] = histogram.value_at_percentile(90.0);
+  json["p99"] = histogram.value_at_percentile(99.0);
+  json["p999"] = histogram.value_at_percentile(99.9);
+  json["max"] = histogram.max();
+  json["buckets"].put_array();
+  for (Index i = 0; i < histogram.n_bucket(); ++i) {
+    if (histogram.bucket_count(i) == 0) {
+      continue;
+    }
+    auto range = histogram.bucket_range(i);
+    jsonParser bucket;
+    bucket.put_array();
+    bucket.push_back(static_cast<Index>(range.first));
+    bucket.push_back(static_cast<Index>(range.second));
+    bucket.push_back(static_cast<Index>(histogram.bucket_count(i)));
+    json["buckets"].push_back(bucket);
+  }
+  return json;
+}
+
+// MapStructuresParams
+
+/// \brief Write MapStructuresParams to JSON
+///
+/// Factor group operations are written as {"matrix", "tau",
+/// "time_reversal"}, matching `libcasm.xtal.SymOp.to_dict`.
+jsonParser &to_json(mapping::MapStructuresParams const &params,
+                    jsonParser &json) {
+  json.put_obj();
+  json["max_vol"] = params.max_vol;
+  json["prim_factor_group"].put_array();
+  for (xtal::SymOp const &op : params.prim_factor_group) {
+    jsonParser op_json;
+    op_json["matrix"] = op.matrix;
+    to_json(op.translation, op_json["tau"], jsonParser::as_array());
+    op_json["time_reversal"] = op.is_time_reversal_active;
+    json["prim_factor_group"].push_back(op_json);
+  }
+  json["min_vol"] = params.min_vol;
+  json["min_cost"] = params.min_cost;
+  json["max_cost"] = params.max_cost;
+  json["lattice_cost_weight"] = params.lattice_cost_weight;
+  json["lattice_cost_method"] = params.lattice_cost_method;
+  json["atom_cost_method"] = params.atom_cost_method;
+  json["k_best"] = params.k_best;
+  json["cost_tol"] = params.cost_tol;
+  if (params.fixed_axis.has_value()) {
+    json["fixed_axis"] = *params.fixed_axis;
+  } else {
+    json["fixed_axis"].put_null();
+  }
+  json["vacuum_strain_weight"] = params.vacuum_strain_weight;
+  return json;
+}
+
+void from_json(mapping::MapStructuresParams &params, jsonParser const &json) {
+  params = mapping::MapStructuresParams();
+  json.get_if(params.max_vol, "max_vol");
+  if (json.contains("prim_factor_group")) {
+    for (jsonParser const &op_json : json["prim_factor_group"]) {
+      Eigen::Matrix3d matrix;
+      Eigen::Vector3d translation;
+      CASM::from_json(matrix, op_json["matrix"]);
+      CASM::from_json(translation, op_json["tau"]);
+      params.prim_factor_group.emplace_back(
+          matrix, translation, op_json["time_reversal"].get<bool>());
+    }
+  }
+  json.get_if(params.min_vol, "min_vol");
+  json.get_if(params.min_cost, "min_cost");
+  json.get_if(params.max_cost, "max_cost");
+  json.get_if(params.lattice_cost_weight, "lattice_cost_weight");
+  json.get_if(params.lattice_cost_method, "lattice_cost_method");
+  json.get_if(params.atom_cost_method, "atom_cost_method");
+  json.get_if(params.k_best, "k_best");
+  json.get_if(params.cost_tol, "cost_tol");
+  if (json.contains("fixed_axis") && !json["fixed_axis"].is_null()) {
+    params.fixed_axis = json["fixed_axis"].get<Index>();
+  }
+  json.get_if(params.vacuum_strain_weight, "vacuum_strain_weight");
+}
+
+// MapStructuresBatchStatistics
+
+/// \brief Write MapStructuresBatchStatistics to JSON
+jsonParser &to_json(mapping::MapStructuresBatchStatistics const &statistics,
+                    jsonParser &json) {
+  json.put_obj();
+  json["n_structure"] = statistics.n_structure;
+  to_json(statistics.latency, json["latency"]);
+  json["max_queue_size"] = statistics.max_queue_size;
+  to_json(statistics.total, json["total"]);
+  json["slow_input_paths"] = statistics.slow_input_paths;
+  return json;
+}
+
 }  // namespace CASM
@@ -63,6 +63,36 @@ double isotropic_strain_cost(Eigen::Matrix3d const &deformation_gradient) {
          6.;
 }
 
+/// \brief Returns a lower bound on `isotropic_strain_cost`, which does
+/// not require a polar decomposition
+///
+/// With \f$u_i\f$ the eigenvalues of the volume-normalized right stretch
+/// tensor, \f$\tilde{U}\f$, and \f$\tilde{C} = \tilde{U}^{2} =
+/// \tilde{F}^{\mathsf{T}}\tilde{F}\f$, the Cauchy-Schwarz inequality,
+/// \f$\sum_i u_i \leq \sqrt{3 \sum_i u_i^2}\f$, gives:
+/// \f[
+///       \mathrm{tr}((\tilde{U} - I)^{2}) = \sum_i (u_i - 1)^2 \geq
+///           (\sqrt{\mathrm{tr}(\tilde{C})} - \sqrt{3})^2,
+/// \f]
+/// and similarly for \f$\tilde{U}^{-1}\f$, using
+/// \f$\mathrm{tr}(\tilde{C}^{-1})\f$. The bound is equal to the cost
+/// when \f$\tilde{U}\f$ is a multiple of the identity, and is used by
+/// LatticeMap to skip reorientations that cannot have a cost less than
+/// the current `max_cost`.
+///
+/// \param deformation_gradient The deformation gradient, \f$F or
+///     F_reverse\f$.
+///
+double isotropic_strain_cost_lower_bound(
+    Eigen::Matrix3d const &deformation_gradient) {
+  Eigen::Matrix3d const &F = deformation_gradient;
+  double vol_factor = std::pow(std::abs(F.determinant()), 2. / 3.);
+  Eigen::Matrix3d C_normalized = F.transpose() * F / vol_factor;
+  double a = std::sqrt(C_normalized.trace()) - std::sqrt(3.);
+  double b = std::sqrt(C_normalized.inverse().trace()) - std::sqrt(3.);
+  return (a * a + b * b) / 6.;
+}
+
 /// \brief Returns the symmetrized right stretch tensor
 ///
 /// \param deformation_gradient The deformation gradient.
@@ -163,5 +193,91 @@ double symmetry_breaking_strain_cost(
          6.;
 }
 
+/// \brief Returns the slab strain cost, with the in-plane and out-of-plane
+/// strain components weighted separately
+///
+/// For slabs and 2D materials, one lattice vector is not periodic (i.e.
+/// spans a vacuum region) or is fixed by construction, so the strain
+/// along it should not be compared in the same way as the in-plane
+/// strain. This calculates:
+///
+///     cost = in_plane_cost + vacuum_strain_weight * out_of_plane_cost
+///
+/// The in-plane cost is the area-normalized strain of the plane spanned
+/// by the in-plane parent lattice vectors, a and b, with unit normal
+/// \f$\hat{n} = (a \times b) / |a \times b|\f$. The fixed lattice vector
+/// is not used because it need not be perpendicular to the plane (i.e.
+/// monoclinic or hexagonal slabs). With
+/// \f$P = I - \hat{n} \hat{n}^{\top}\f$ and \f$C = F^{\top} F\f$, the
+/// in-plane stretch, \f$U_{p}\f$, is the
+/// square root of \f$P C P\f$ restricted to the plane, which gives the
+/// change in length of any in-plane vector. Then:
+///
+/// \f[
+///       \tilde{U}_{p} = \frac{1}{\det{U_{p}}^{1/2}} U_{p}
+///       \tilde{B}_{p} = \tilde{U}_{p} - I_{p}
+///       in\_plane\_cost = (1./2.)*(
+///           (1./2.)*\mathrm{tr}(\tilde{B}_{p}^{2}) +
+///           (1./2.)*\mathrm{tr}(\tilde{B}_{p,reverse}^{2}))
+/// \f]
+///
+/// where \f$\tilde{B}_{p,reverse} = \tilde{U}_{p}^{-1} - I_{p}\f$, so
+/// the in-plane cost is invariant to which structure is the child/parent
+/// and to the length of the vacuum direction. The out-of-plane cost uses
+/// the components of the Biot strain, \f$B = U - I\f$, that are not
+/// in-plane, \f$B_{out} = B - P B P\f$:
+///
+/// \f[
+///       out\_of\_plane\_cost = (1./2.)*(
+///           \mathrm{tr}(B_{out}^{2}) + \mathrm{tr}(B_{out,reverse}^{2}))
+/// \f]
+///
+/// where \f$B_{out,reverse}\f$ is calculated similarly from
+/// \f$B_{reverse} = U^{-1} - I\f$. The out-of-plane cost is not volume
+/// normalized.
+///
+/// \param deformation_gradient The parent-to-child deformation gradient,
+///     \f$F\f$.
+/// \param in_plane_vector_a The first in-plane (i.e. periodic) parent
+///     lattice vector, a, in the parent frame
+/// \param in_plane_vector_b The second in-plane parent lattice vector, b,
+///     in the parent frame
+/// \param vacuum_strain_weight Weight of the out-of-plane cost. If 0.0
+///     (default), strain along the fixed direction is ignored.
+///
+double slab_strain_cost(Eigen::Matrix3d const &deformation_gradient,
+                        Eigen::Vector3d const &in_plane_vector_a,
+                        Eigen::Vector3d const &in_plane_vector_b,
+                        double vacuum_strain_weight) {
+  Eigen::Matrix3d const &F = deformation_gradient;
+  Eigen::Vector3d n = in_plane_vector_a.cross(in_plane_vector_b).normalized();
+  Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d nnT = n * n.transpose();
+  Eigen::Matrix3d P = I - nnT;
+
+  // in-plane stretch, U_p + n * n^T
+  Eigen::Matrix3d C_p = P * F.transpose() * F * P + nnT;
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigen_solver(C_p);
+  Eigen::Matrix3d U_p = eigen_solver.operatorSqrt();
+  double area_factor = std::sqrt(std::abs(U_p.determinant()));
+  Eigen::Matrix3d U_p_normalized = (U_p - nnT) / area_factor + nnT;
+  Eigen::Matrix3d V_p_reverse_normalized = U_p_normalized.inverse();
+
+  // M.squaredNorm() = squared Frobenius norm of M = tr(M*M.transpose())
+  double in_plane_cost = ((U_p_normalized - I).squaredNorm() +
+                          (V_p_reverse_normalized - I).squaredNorm()) /
+                         4.;
+  if (vacuum_strain_weight == 0.0) {
+    return in_plane_cost;
+  }
+
+  Eigen::Matrix3d B = polar_decomposition(F) - I;
+  Eigen::Matrix3d B_reverse = (B + I).inverse() - I;
+  double out_of_plane_cost = ((B - P * B * P).squaredNorm() +
+                              (B_reverse - P * B_reverse * P).squaredNorm()) /
+                             2.;
+  return in_plane_cost + vacuum_strain_weight * out_of_plane_cost;
+}
+
 }  // namespace mapping
 }  // namespace CASM
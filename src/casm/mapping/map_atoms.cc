@@ -178,5 +178,29 @@ AtomMappingResults map_atoms(xtal::BasicStructure const &prim,
   return results;
 }
 
+/// \brief Find atom mappings, given a shared prim
+///
+/// This is equivalent to the overload taking `xtal::BasicStructure const &`,
+/// and is provided so that a prim held by `std::shared_ptr` can be used
+/// for `map_atoms` and `map_structures` alike without copying.
+///
+/// \param shared_prim The reference "parent" structure
+///
+/// See the other overload for the other parameters.
+AtomMappingResults map_atoms(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2,
+    LatticeMapping const &lattice_mapping,
+    std::vector<xtal::SymOp> prim_factor_group, double min_cost,
+    double max_cost, std::string atom_cost_method, int k_best,
+    double cost_tol) {
+  if (!shared_prim) {
+    throw std::runtime_error("Error in map_atoms: prim is null");
+  }
+  return map_atoms(*shared_prim, structure2, lattice_mapping,
+                   std::move(prim_factor_group), min_cost, max_cost,
+                   std::move(atom_cost_method), k_best, cost_tol);
+}
+
 }  // namespace mapping
 }  // namespace CASM
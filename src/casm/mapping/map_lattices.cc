@@ -3,8 +3,10 @@
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/SymType.hh"
 #include "casm/mapping/LatticeMapping.hh"
+#include "casm/mapping/LatticeMappingIndex.hh"
 #include "casm/mapping/impl/LatticeMap.hh"
 #include "casm/mapping/misc.hh"
+#include "casm/misc/CASM_Eigen_math.hh"
 
 namespace CASM {
 namespace mapping_impl {
@@ -29,60 +31,18 @@ struct LatticeMappingKey {
   }
 };
 
-}  // namespace mapping_impl
-
-namespace mapping {
-
-/// \brief Find lattice mappings
-///
-/// Find and rank lattice mappings (see `LatticeMapping`) by searching
-/// over equivalent lattices with different lattice vectors by varying
-/// the reorientation matrix, N.
-///
-/// This method is often used inside a loop over superlattice
-/// transformation matrices, T, to check mappings between distinct
-/// superlattices.
-///
-/// For strain cost definitions, see Python documentation.
-///
-/// For more details, see J.C. Thomas, A.R. Natarajan, and A.V. Van der Ven,
-/// npj Computational Materials (2021)7:164;
-/// https://doi.org/10.1038/s41524-021-00627-0
-///
-/// \param lattice1 The referece "parent" lattice
-/// \param lattice2 The "child" lattice
-/// \param T Mapping is performed for L1 * T * N <-> L2, where T is an
-///     approximately integer transformation matrix to a supercell of L1.
-///     The default value is the identity matrix.
-/// \param reorientation_range The absolute value of the maximum element in
-///     reorientation matrix, N. This determines how many equivalent lattice
-///     vector reorientations are checked. Usually 1 is sufficient.
-/// \param L1_point_group Used to skip reorientation matrices that result in
-///     symmetrically equivalent mappings. The default (empty), is
-///     equivalent to only including the identity operation.
-/// \param L2_point_group Used to skip reorientation matrices that
-///     result in symmetrically equivalent mappings. The default (empty), is
-///     equivalent to just including the identity operation.
-/// \param min_cost Keep results with cost >= min_cost
-/// \param max_cost Keep results with cost <= max_cost
-/// \param cost_method One of "isotropic_strain_cost" or
-///     "symmetry_breaking_strain_cost"
-/// \param k_best If k_best.has_value(), then only keep the k_best results
-///     satisfying the min_cost and max_cost constraints. If there are
-///     approximate ties, those will also be kept.
-/// \param cost_tol Tolerance for checking if lattice mapping costs are
-///     approximately equal
-///
-/// \returns A vector of {cost, lattice_mapping}, giving lattice
-///     mapping solutions and their costs, sorted by lattice mapping cost.
+/// \brief Find lattice mappings, and count the strain costs calculated
 ///
-LatticeMappingResults map_lattices(
+/// This is `map_lattices`, which also adds the number of lattice
+/// mapping strain costs calculated to `n_strain_cost`.
+mapping::LatticeMappingResults map_lattices(
     xtal::Lattice const &lattice1, xtal::Lattice const &lattice2,
     std::optional<Eigen::Matrix3d> T, int reorientation_range,
     std::vector<xtal::SymOp> lattice1_point_group,
     std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
     double max_cost, std::string cost_method, std::optional<int> k_best,
-    double cost_tol) {
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight, Index &n_strain_cost) {
   double init_better_than = 1e20;
   bool symmetrize_strain_cost;
   if (cost_method == "isotropic_strain_cost") {
@@ -106,32 +66,48 @@ LatticeMappingResults map_lattices(
   if (!T.has_value()) {
     T = Eigen::Matrix3d::Identity();
   }
+  if (fixed_axis.has_value()) {
+    if (*fixed_axis < 0 || *fixed_axis > 2) {
+      throw std::runtime_error(
+          "Error in map_lattices: fixed_axis must be 0, 1, or 2");
+    }
+    if (symmetrize_strain_cost) {
+      throw std::runtime_error(
+          "Error in map_lattices: fixed_axis is not supported with "
+          "\"symmetry_breaking_strain_cost\"");
+    }
+    if (!is_slab_transformation(T.value(), *fixed_axis)) {
+      throw std::runtime_error(
+          "Error in map_lattices: T does not preserve the fixed_axis");
+    }
+  }
   Eigen::Matrix3d L1 = lattice1.lat_column_mat();
   xtal::Lattice parent_superlattice(L1 * T.value(), lattice1.tol());
-  mapping_impl::LatticeMap latmap(
+  LatticeMap latmap(
       parent_superlattice, lattice2, reorientation_range, lattice1_point_group,
-      lattice2_point_group, init_better_than, symmetrize_strain_cost, cost_tol);
+      lattice2_point_group, init_better_than, symmetrize_strain_cost, cost_tol,
+      fixed_axis, vacuum_strain_weight);
 
   // the k-best results
-  std::multimap<mapping_impl::LatticeMappingKey, LatticeMapping> results;
+  std::multimap<LatticeMappingKey, mapping::LatticeMapping> results;
 
   // results that are approximately equal to last-place result
-  std::multimap<mapping_impl::LatticeMappingKey, LatticeMapping> overflow;
+  std::multimap<LatticeMappingKey, mapping::LatticeMapping> overflow;
 
   while (latmap) {
     double cost = latmap.strain_cost();
     if (cost > (min_cost - cost_tol) && cost < (max_cost + cost_tol)) {
       results.emplace(
-          mapping_impl::LatticeMappingKey(
+          LatticeMappingKey(
               cost, cost_tol, xtal::Lattice(L1 * T.value() * latmap.matrixN())),
-          LatticeMapping(latmap.deformation_gradient(), T.value(),
+          mapping::LatticeMapping(latmap.deformation_gradient(), T.value(),
                          latmap.matrixN()));
 
       // maintain results.size() <= *k_best, keep approximately equal results,
       // shrinks max_cost to results.rbegin() if results.size() == *k_best
-      maintain_k_best_results(
+      mapping::maintain_k_best_results(
           k_best, cost_tol, results, overflow,
-          [](mapping_impl::LatticeMappingKey const &key) { return key.cost; });
+          [](LatticeMappingKey const &key) { return key.cost; });
       if (k_best.has_value() && results.size() == *k_best) {
         max_cost = results.rbegin()->first.cost;
       }
@@ -145,12 +121,210 @@ LatticeMappingResults map_lattices(
   while (overflow.size()) {
     results.insert(overflow.extract(overflow.begin()));
   }
-  LatticeMappingResults final;
+  mapping::LatticeMappingResults final;
   for (auto const &pair : results) {
     final.data.emplace_back(pair.first.cost, pair.second);
   }
+  n_strain_cost += latmap.n_strain_cost();
   return final;
 }
 
+/// \brief Find the k-best lattice mappings, using an index of previously
+///     mapped lattices to bound the search, and count the strain costs
+///     calculated
+///
+/// This is `map_lattices_warm_start`, which also adds the number of
+/// lattice mapping strain costs calculated to `n_strain_cost`.
+mapping::LatticeMappingResults map_lattices_warm_start(
+    mapping::LatticeMappingIndex const &index, xtal::Lattice const &lattice2,
+    int k_best, std::optional<Eigen::Matrix3d> T, int reorientation_range,
+    std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
+    double max_cost, double cost_tol, Index k_nearest, double max_distance,
+    Index &n_strain_cost) {
+  if (k_best < 1) {
+    throw std::runtime_error(
+        "Error in map_lattices_warm_start: k_best < 1 is not allowed");
+  }
+  if (!T.has_value()) {
+    T = Eigen::Matrix3d::Identity();
+  }
+  Eigen::Matrix3d T_inv = T->inverse();
+
+  auto search = [&](double _max_cost) {
+    return map_lattices(index.lattice1(), lattice2, T, reorientation_range,
+                        index.lattice1_point_group(), lattice2_point_group,
+                        min_cost, _max_cost, index.cost_method(), k_best,
+                        cost_tol, std::nullopt, 0.0, n_strain_cost);
+  };
+
+  // the bound only skips strain costs for "isotropic_strain_cost"
+  if (index.cost_method() != "isotropic_strain_cost") {
+    return search(max_cost);
+  }
+
+  // count candidates with the same superlattice, up to reorientation
+  Index n_candidate = 0;
+  double bound = max_cost;
+  for (auto const &candidate :
+       index.make_candidates(lattice2, k_nearest, max_distance)) {
+    if (candidate.lattice_cost < min_cost - cost_tol ||
+        candidate.lattice_cost > max_cost + cost_tol) {
+      continue;
+    }
+    Eigen::Matrix3d N = T_inv * candidate.transformation_matrix_to_super *
+                        candidate.reorientation;
+    if (!is_integer(N, 1e-5) || !almost_equal(N.determinant(), 1.0)) {
+      continue;
+    }
+    if (++n_candidate == k_best) {
+      bound = candidate.lattice_cost;
+      break;
+    }
+  }
+
+  if (n_candidate == k_best) {
+    mapping::LatticeMappingResults results = search(bound);
+    if (results.size() >= k_best) {
+      return results;
+    }
+  }
+  return search(max_cost);
+}
+
+}  // namespace mapping_impl
+
+namespace mapping {
+
+/// \brief Find lattice mappings
+///
+/// Find and rank lattice mappings (see `LatticeMapping`) by searching
+/// over equivalent lattices with different lattice vectors by varying
+/// the reorientation matrix, N.
+///
+/// This method is often used inside a loop over superlattice
+/// transformation matrices, T, to check mappings between distinct
+/// superlattices.
+///
+/// For strain cost definitions, see Python documentation.
+///
+/// For more details, see J.C. Thomas, A.R. Natarajan, and A.V. Van der Ven,
+/// npj Computational Materials (2021)7:164;
+/// https://doi.org/10.1038/s41524-021-00627-0
+///
+/// \param lattice1 The referece "parent" lattice
+/// \param lattice2 The "child" lattice
+/// \param T Mapping is performed for L1 * T * N <-> L2, where T is an
+///     approximately integer transformation matrix to a supercell of L1.
+///     The default value is the identity matrix.
+/// \param reorientation_range The absolute value of the maximum element in
+///     reorientation matrix, N. This determines how many equivalent lattice
+///     vector reorientations are checked. Usually 1 is sufficient.
+/// \param L1_point_group Used to skip reorientation matrices that result in
+///     symmetrically equivalent mappings. The default (empty), is
+///     equivalent to only including the identity operation.
+/// \param L2_point_group Used to skip reorientation matrices that
+///     result in symmetrically equivalent mappings. The default (empty), is
+///     equivalent to just including the identity operation.
+/// \param min_cost Keep results with cost >= min_cost
+/// \param max_cost Keep results with cost <= max_cost
+/// \param cost_method One of "isotropic_strain_cost" or
+///     "symmetry_breaking_strain_cost"
+/// \param k_best If k_best.has_value(), then only keep the k_best results
+///     satisfying the min_cost and max_cost constraints. If there are
+///     approximate ties, those will also be kept.
+/// \param cost_tol Tolerance for checking if lattice mapping costs are
+///     approximately equal
+/// \param fixed_axis If has value, use slab mode: the index (0, 1, or 2)
+///     of the lattice vector of L1 * T and L2 that is fixed (i.e. the
+///     non-periodic, or vacuum, direction). Only reorientations that
+///     preserve the fixed lattice vector and the plane of the other two are
+///     considered, and lattice mappings are scored using `slab_strain_cost`
+///     instead of `cost_method`. T must also preserve the fixed lattice
+///     vector and plane.
+/// \param vacuum_strain_weight In slab mode, the weight of the
+///     out-of-plane strain in `slab_strain_cost`. If 0.0 (default), strain
+///     of the fixed lattice vector is ignored.
+///
+/// \returns A vector of {cost, lattice_mapping}, giving lattice
+///     mapping solutions and their costs, sorted by lattice mapping cost.
+///
+LatticeMappingResults map_lattices(
+    xtal::Lattice const &lattice1, xtal::Lattice const &lattice2,
+    std::optional<Eigen::Matrix3d> T, int reorientation_range,
+    std::vector<xtal::SymOp> lattice1_point_group,
+    std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
+    double max_cost, std::string cost_method, std::optional<int> k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight) {
+  Index n_strain_cost = 0;
+  return mapping_impl::map_lattices(
+      lattice1, lattice2, T, reorientation_range, lattice1_point_group,
+      lattice2_point_group, min_cost, max_cost, cost_method, k_best, cost_tol,
+      fixed_axis, vacuum_strain_weight, n_strain_cost);
+}
+
+/// \brief Find the k-best lattice mappings, using an index of previously
+///     mapped lattices to bound the search
+///
+/// This finds the same lattice mappings as:
+///
+///     map_lattices(index.lattice1(), lattice2, T, reorientation_range,
+///                  index.lattice1_point_group(), lattice2_point_group,
+///                  min_cost, max_cost, index.cost_method(), k_best,
+///                  cost_tol)
+///
+/// but first uses `index.make_candidates` to find candidate lattice
+/// mappings, adjusted from the lattice mappings of similar, previously
+/// mapped child lattices. Candidates with the same superlattice as
+/// L1 * T (up to a reorientation) are exact lattice mappings for this
+/// search, so if there are at least `k_best` of them, the cost of the
+/// k-th best is an upper bound on the cost of the k-th best result. The
+/// search is done with that bound as the initial `max_cost`.
+///
+/// Every reorientation is still enumerated. The bound saves work
+/// because reorientations whose `isotropic_strain_cost_lower_bound` is
+/// not less than the current `max_cost` are skipped without calculating
+/// their strain cost. This only applies to "isotropic_strain_cost", so
+/// for other cost methods the candidates are not used. If the bounded
+/// search finds fewer than `k_best` results (i.e. the candidate
+/// reorientations are not in the searched range), it is repeated
+/// without the bound, and costs more than `map_lattices`.
+///
+/// This is a standalone method: `map_structures` and `StrucMapper` do
+/// not use a LatticeMappingIndex. It is intended for mapping many
+/// similar child lattices to the same parent superlattice, inserting
+/// the results of each search into the index.
+///
+/// \param index Previously mapped child lattices. Provides lattice1,
+///     lattice1_point_group, and cost_method.
+/// \param lattice2 The "child" lattice
+/// \param k_best Number of results to keep. If there are approximate
+///     ties, those will also be kept.
+/// \param T Mapping is performed for L1 * T * N <-> L2. The default
+///     value is the identity matrix.
+/// \param reorientation_range See `map_lattices`
+/// \param lattice2_point_group See `map_lattices`
+/// \param min_cost Keep results with cost >= min_cost
+/// \param max_cost Keep results with cost <= max_cost
+/// \param cost_tol Tolerance for checking if lattice mapping costs are
+///     approximately equal
+/// \param k_nearest Number of nearest previously mapped child lattices
+///     used to make candidates
+/// \param max_distance Maximum lattice metric invariant distance of the
+///     previously mapped child lattices used to make candidates
+///
+/// \returns A vector of {cost, lattice_mapping}, giving lattice
+///     mapping solutions and their costs, sorted by lattice mapping cost.
+LatticeMappingResults map_lattices_warm_start(
+    LatticeMappingIndex const &index, xtal::Lattice const &lattice2, int k_best,
+    std::optional<Eigen::Matrix3d> T, int reorientation_range,
+    std::vector<xtal::SymOp> lattice2_point_group, double min_cost,
+    double max_cost, double cost_tol, Index k_nearest, double max_distance) {
+  Index n_strain_cost = 0;
+  return mapping_impl::map_lattices_warm_start(
+      index, lattice2, k_best, T, reorientation_range, lattice2_point_group,
+      min_cost, max_cost, cost_tol, k_nearest, max_distance, n_strain_cost);
+}
+
 }  // namespace mapping
 }  // namespace CASM
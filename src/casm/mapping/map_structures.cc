@@ -21,69 +21,18 @@ mapping::AtomMapping make_atom_mapping(
     Eigen::Matrix3d const &deformation_gradient,
     MappingNode const &mapping_node);
 
-}  // namespace mapping_impl
-
-namespace mapping {
-
-/// \brief Find structure mappings, given a range of parent superstructure
-/// volumes
-///
-/// This method finds mappings from a superstructure of a reference "parent"
-/// structure to a "child" structure. It works by finding lattice mappings
-/// (see `LatticeMapping`) for symmetrically unique superlattices of the
-/// "parent" lattice for a range of supercell volumes, and for each
-/// potential lattice mapping finding atom mappings (see `AtomMapping`).
-///
-/// The total structure mapping cost, total_cost, is a weighted mixture of
-/// the lattice mapping cost, lattice_cost, and the atom mapping cost,
-/// atom_cost:
-///
-///     total_cost = lattice_cost_weight*lattice_cost
-///                  + (1.0 - lattice_cost_weight)*atom_cost
-///
-/// where lattice_cost_weight is an input parameter.
-///
-/// For strain and atom cost definitions, see Python documentation.
-///
-/// For more details, see J.C. Thomas, A.R. Natarajan, and A.V. Van der Ven,
-/// npj Computational Materials (2021)7:164;
-/// https://doi.org/10.1038/s41524-021-00627-0
+/// \brief Construct the StrucMapper used by `mapping::map_structures`
 ///
 /// \param prim The reference "parent" structure
-/// \param structure2 The "child" structure
-/// \param max_vol The maximum parent superstructure volume to consider, as
-///     a multiple of the parent structure volume
-/// \param prim_factor_group Used to skip mappings that are
-///     symmetrically equivalent mappings. The default (empty), is
-///     equivalent to only including the identity operation.
-/// \param structure2_factor_group Used to skip mappings that are
-///     symmetrically equivalent mappings. The default (empty), is
-///     equivalent to only including the identity operation.
-/// \param min_vol The minimum parent superstructure volume to consider, as
-///     a multiple of the parent structure volume. Default=1.
-/// \param min_cost Keep results with total cost >= min_cost
-/// \param max_cost Keep results with total cost <= max_cost
-/// \param lattice_cost_weight The fraction of the total cost due to
-///     the lattice strain cost. The remaining fraction
-///     (1.-lattice_cost_weight) is due to the atom cost. Default=0.5.
-/// \param lattice_cost_method One of "isotropic_strain_cost" or
-///     "symmetry_breaking_strain_cost"
-/// \param atom_cost_method One of "isotropic_disp_cost" or
-///     "symmetry_breaking_disp_cost"
-/// \param k_best Keep the k_best results satisfying the min_cost and
-///     max_cost constraints. If there are approximate ties, those
-///     will also be kept.
-/// \param cost_tol Tolerance for checking if lattice mapping costs are
-///     approximately equal
-StructureMappingResults map_structures(
-    xtal::BasicStructure const &prim, xtal::SimpleStructure const &structure2,
-    Index max_vol, std::vector<xtal::SymOp> prim_factor_group,
-    std::vector<xtal::SymOp> structure2_factor_group, Index min_vol,
-    double min_cost, double max_cost, double lattice_cost_weight,
-    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
-    double cost_tol) {
-  auto shared_prim = std::make_shared<xtal::BasicStructure const>(prim);
-
+/// \param prim_factor_group The prim factor group. Must not be empty.
+///
+/// See `mapping::map_structures` for the other parameters.
+std::unique_ptr<StrucMapper> make_map_structures_struc_mapper(
+    xtal::BasicStructure const &prim,
+    std::vector<xtal::SymOp> const &prim_factor_group,
+    double lattice_cost_weight, std::string const &lattice_cost_method,
+    std::string const &atom_cost_method, double cost_tol,
+    std::optional<Index> fixed_axis, double vacuum_strain_weight) {
   bool symmetrize_lattice_cost;
   if (lattice_cost_method == "isotropic_strain_cost") {
     symmetrize_lattice_cost = false;
@@ -104,21 +53,16 @@ StructureMappingResults map_structures(
         "Error in map_structures: atom_cost_method not recognized");
   }
 
-  if (k_best < 1) {
-    throw std::runtime_error(
-        "Error in map_structures: k_best < 1 is not allowed");
-  }
-  if (prim_factor_group.empty()) {
-    prim_factor_group.push_back(xtal::SymOp::identity());
-  }
-  if (structure2_factor_group.empty()) {
-    structure2_factor_group.push_back(xtal::SymOp::identity());
-  }
-  if (min_vol < 1) {
-    throw std::runtime_error("Error in map_structures: min_vol < 1");
-  }
-  if (max_vol < min_vol) {
-    throw std::runtime_error("Error in map_structures: max_vol < min_vol");
+  if (fixed_axis.has_value()) {
+    if (*fixed_axis < 0 || *fixed_axis > 2) {
+      throw std::runtime_error(
+          "Error in map_structures: fixed_axis must be 0, 1, or 2");
+    }
+    if (symmetrize_lattice_cost) {
+      throw std::runtime_error(
+          "Error in map_structures: fixed_axis is not supported with "
+          "\"symmetry_breaking_strain_cost\"");
+    }
   }
 
   /// For the StrucMapper::map_deformed_struc_impose_lattice_vols method:
@@ -129,7 +73,7 @@ StructureMappingResults map_structures(
   ///   and `soft_va_limit` have no effect.
   /// - `robust` search is used anyway if k_best > 1
 
-  mapping_impl::SimpleStrucMapCalculator calculator(
+  SimpleStrucMapCalculator calculator(
       xtal::make_simple_structure(prim), prim_factor_group,
       CASM::xtal::SimpleStructure::SpeciesMode::ATOM,
       xtal::allowed_molecule_names(prim));
@@ -138,25 +82,35 @@ StructureMappingResults map_structures(
   bool _soft_va_limit = false;      // no effect
   double _min_va_frac = 0.;         // no effect
   double _max_va_frac = 1.;         // no effect
-  mapping_impl::StrucMapper strucmap(
+  auto strucmap = std::make_unique<StrucMapper>(
       calculator, lattice_cost_weight, _max_volume_change, _robust,
       _soft_va_limit, cost_tol, _min_va_frac, _max_va_frac);
 
   if (symmetrize_lattice_cost) {
-    strucmap.set_symmetrize_lattice_cost(true);
+    strucmap->set_symmetrize_lattice_cost(true);
+  }
+  if (fixed_axis.has_value()) {
+    strucmap->set_fixed_axis(fixed_axis, vacuum_strain_weight);
   }
   if (symmetrize_atom_cost) {
     auto prim_permute_group =
         xtal::make_permutation_representation(prim, prim_factor_group);
-    strucmap.set_symmetrize_atomic_cost(true, prim_factor_group,
-                                        prim_permute_group);
+    strucmap->set_symmetrize_atomic_cost(true, prim_factor_group,
+                                         prim_permute_group);
   }
+  return strucmap;
+}
 
-  bool keep_invalid = false;
-  std::set<mapping_impl::MappingNode> mappings =
-      strucmap.map_deformed_struc_impose_lattice_vols(
-          structure2, min_vol, max_vol, k_best, max_cost, min_cost,
-          keep_invalid, structure2_factor_group);
+/// \brief Convert StrucMapper results to the results of
+///     `mapping::map_structures`
+///
+/// Mappings with cost outside of the range (min_cost - cost_tol,
+/// max_cost + cost_tol) are not included.
+mapping::StructureMappingResults make_map_structures_results(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    std::set<MappingNode> const &mappings, double min_cost, double max_cost,
+    double cost_tol) {
+  using namespace mapping;
 
   // Convert mapping_impl::MappingNode results to StructureMapping results
   StructureMappingResults results;
@@ -168,10 +122,10 @@ StructureMappingResults map_structures(
 
     // Get LatticeMapping data
     LatticeMapping lattice_mapping =
-        mapping_impl::make_lattice_mapping(mapping_node.lattice_node);
+        make_lattice_mapping(mapping_node.lattice_node);
 
     // Get AtomMapping data
-    AtomMapping atom_mapping = mapping_impl::make_atom_mapping(
+    AtomMapping atom_mapping = make_atom_mapping(
         lattice_mapping.deformation_gradient, mapping_node);
 
     results.data.emplace_back(
@@ -183,5 +137,171 @@ StructureMappingResults map_structures(
   return results;
 }
 
+/// \brief Implements `mapping::map_structures`, also returning the
+///     largest mapping search queue size
+///
+/// \param max_queue_size Set to the largest number of MappingNode held in
+///     the StrucMapper search queue
+///
+/// See `mapping::map_structures` for the other parameters.
+mapping::StructureMappingResults map_structures_impl(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2, Index max_vol,
+    std::vector<xtal::SymOp> prim_factor_group,
+    std::vector<xtal::SymOp> structure2_factor_group, Index min_vol,
+    double min_cost, double max_cost, double lattice_cost_weight,
+    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight, Index &max_queue_size) {
+  if (!shared_prim) {
+    throw std::runtime_error("Error in map_structures: prim is null");
+  }
+  if (k_best < 1) {
+    throw std::runtime_error(
+        "Error in map_structures: k_best < 1 is not allowed");
+  }
+  if (prim_factor_group.empty()) {
+    prim_factor_group.push_back(xtal::SymOp::identity());
+  }
+  if (structure2_factor_group.empty()) {
+    structure2_factor_group.push_back(xtal::SymOp::identity());
+  }
+  if (min_vol < 1) {
+    throw std::runtime_error("Error in map_structures: min_vol < 1");
+  }
+  if (max_vol < min_vol) {
+    throw std::runtime_error("Error in map_structures: max_vol < min_vol");
+  }
+
+  std::unique_ptr<StrucMapper> strucmap = make_map_structures_struc_mapper(
+      *shared_prim, prim_factor_group, lattice_cost_weight,
+      lattice_cost_method, atom_cost_method, cost_tol, fixed_axis,
+      vacuum_strain_weight);
+
+  bool keep_invalid = false;
+  std::set<MappingNode> mappings =
+      strucmap->map_deformed_struc_impose_lattice_vols(
+          structure2, min_vol, max_vol, k_best, max_cost, min_cost,
+          keep_invalid, structure2_factor_group);
+  max_queue_size = strucmap->max_queue_size();
+
+  return make_map_structures_results(shared_prim, mappings, min_cost,
+                                     max_cost, cost_tol);
+}
+
+}  // namespace mapping_impl
+
+namespace mapping {
+
+/// \brief Find structure mappings, given a range of parent superstructure
+/// volumes
+///
+/// This method finds mappings from a superstructure of a reference "parent"
+/// structure to a "child" structure. It works by finding lattice mappings
+/// (see `LatticeMapping`) for symmetrically unique superlattices of the
+/// "parent" lattice for a range of supercell volumes, and for each
+/// potential lattice mapping finding atom mappings (see `AtomMapping`).
+///
+/// The total structure mapping cost, total_cost, is a weighted mixture of
+/// the lattice mapping cost, lattice_cost, and the atom mapping cost,
+/// atom_cost:
+///
+///     total_cost = lattice_cost_weight*lattice_cost
+///                  + (1.0 - lattice_cost_weight)*atom_cost
+///
+/// where lattice_cost_weight is an input parameter.
+///
+/// Since det(F) = child volume / parent superstructure volume, a mapping
+/// found at one volume is not repeated at multiples of that volume.
+///
+/// For strain and atom cost definitions, see Python documentation.
+///
+/// For more details, see J.C. Thomas, A.R. Natarajan, and A.V. Van der Ven,
+/// npj Computational Materials (2021)7:164;
+/// https://doi.org/10.1038/s41524-021-00627-0
+///
+/// \param prim The reference "parent" structure
+/// \param structure2 The "child" structure
+/// \param max_vol The maximum parent superstructure volume to consider, as
+///     a multiple of the parent structure volume
+/// \param prim_factor_group Used to skip mappings that are
+///     symmetrically equivalent mappings. The default (empty), is
+///     equivalent to only including the identity operation.
+/// \param structure2_factor_group Used to skip mappings that are
+///     symmetrically equivalent mappings. The default (empty), is
+///     equivalent to only including the identity operation.
+/// \param min_vol The minimum parent superstructure volume to consider, as
+///     a multiple of the parent structure volume. Default=1.
+/// \param min_cost Keep results with total cost >= min_cost
+/// \param max_cost Keep results with total cost <= max_cost
+/// \param lattice_cost_weight The fraction of the total cost due to
+///     the lattice strain cost. The remaining fraction
+///     (1.-lattice_cost_weight) is due to the atom cost. Default=0.5.
+/// \param lattice_cost_method One of "isotropic_strain_cost" or
+///     "symmetry_breaking_strain_cost"
+/// \param atom_cost_method One of "isotropic_disp_cost" or
+///     "symmetry_breaking_disp_cost"
+/// \param k_best Keep the k_best results satisfying the min_cost and
+///     max_cost constraints. If there are approximate ties, those
+///     will also be kept.
+/// \param cost_tol Tolerance for checking if lattice mapping costs are
+///     approximately equal
+/// \param fixed_axis If has value, use slab mode: the index (0, 1, or 2)
+///     of the prim and structure2 lattice vector that is fixed (i.e. the
+///     non-periodic, or vacuum, direction). Parent superlattices are only
+///     enumerated in the plane of the other two lattice vectors, so the
+///     number of superlattices of each volume grows like that of 2d
+///     superlattices. Only lattice reorientations that preserve the fixed
+///     lattice vector are considered, and lattice mappings are scored using
+///     `slab_strain_cost` instead of `lattice_cost_method`.
+/// \param vacuum_strain_weight In slab mode, the weight of the
+///     out-of-plane strain in `slab_strain_cost`. If 0.0 (default), strain
+///     of the fixed lattice vector is ignored.
+StructureMappingResults map_structures(
+    xtal::BasicStructure const &prim, xtal::SimpleStructure const &structure2,
+    Index max_vol, std::vector<xtal::SymOp> prim_factor_group,
+    std::vector<xtal::SymOp> structure2_factor_group, Index min_vol,
+    double min_cost, double max_cost, double lattice_cost_weight,
+    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight) {
+  return map_structures(
+      std::make_shared<xtal::BasicStructure const>(prim), structure2, max_vol,
+      std::move(prim_factor_group), std::move(structure2_factor_group),
+      min_vol, min_cost, max_cost, lattice_cost_weight,
+      std::move(lattice_cost_method), std::move(atom_cost_method), k_best,
+      cost_tol, fixed_axis, vacuum_strain_weight);
+}
+
+/// \brief Find structure mappings, given a range of parent superstructure
+/// volumes, sharing the prim with the results
+///
+/// This is equivalent to the overload taking `xtal::BasicStructure const &`,
+/// but the prim is not copied: every StructureMapping in the results holds
+/// `shared_prim`. When mapping many structures to the same prim, construct
+/// `shared_prim` once and use this overload so that the prim is not copied
+/// for each call and all results share one prim.
+///
+/// \param shared_prim The reference "parent" structure
+///
+/// See the other overload for the other parameters.
+StructureMappingResults map_structures(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2, Index max_vol,
+    std::vector<xtal::SymOp> prim_factor_group,
+    std::vector<xtal::SymOp> structure2_factor_group, Index min_vol,
+    double min_cost, double max_cost, double lattice_cost_weight,
+    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight) {
+  Index max_queue_size;
+  return mapping_impl::map_structures_impl(
+      shared_prim, structure2, max_vol, std::move(prim_factor_group),
+      std::move(structure2_factor_group), min_vol, min_cost, max_cost,
+      lattice_cost_weight, std::move(lattice_cost_method),
+      std::move(atom_cost_method), k_best, cost_tol, fixed_axis,
+      vacuum_strain_weight, max_queue_size);
+}
+
 }  // namespace mapping
 }  // namespace CASM
@@ -0,0 +1,208 @@
+#include "casm/mapping/map_structures_batch.hh"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "casm/casm_io/container/json_io.hh"
+#include "casm/casm_io/json/jsonParser.hh"
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/SimpleStructure.hh"
+#include "casm/crystallography/io/BasicStructureIO.hh"
+#include "casm/crystallography/io/SimpleStructureIO.hh"
+#include "casm/global/filesystem.hh"
+#include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/io/json_io.hh"
+
+namespace CASM {
+namespace mapping_impl {
+
+// Declarations of functions defined in map_structures.cc:
+
+mapping::StructureMappingResults map_structures_impl(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure2, Index max_vol,
+    std::vector<xtal::SymOp> prim_factor_group,
+    std::vector<xtal::SymOp> structure2_factor_group, Index min_vol,
+    double min_cost, double max_cost, double lattice_cost_weight,
+    std::string lattice_cost_method, std::string atom_cost_method, int k_best,
+    double cost_tol, std::optional<Index> fixed_axis,
+    double vacuum_strain_weight, Index &max_queue_size);
+
+}  // namespace mapping_impl
+
+namespace mapping {
+
+namespace {
+
+/// \brief Map one structure, recording latency and queue size
+StructureMappingResults map_and_record(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    xtal::SimpleStructure const &structure,
+    MapStructuresParams const &params,
+    MapStructuresBatchStatistics &statistics, PerfCounts &counts,
+    Index &max_queue_size) {
+  StructureMappingResults results;
+  {
+    ScopedPerfCounters scoped(counts);
+    // structure factor groups are not used: an empty structure2_factor_group
+    // is equivalent to the identity operation only
+    results = mapping_impl::map_structures_impl(
+        shared_prim, structure, params.max_vol, params.prim_factor_group,
+        std::vector<xtal::SymOp>{}, params.min_vol, params.min_cost,
+        params.max_cost, params.lattice_cost_weight,
+        params.lattice_cost_method, params.atom_cost_method, params.k_best,
+        params.cost_tol, params.fixed_axis, params.vacuum_strain_weight,
+        max_queue_size);
+  }
+  statistics.n_structure += 1;
+  statistics.latency.record(counts.seconds);
+  statistics.max_queue_size =
+      std::max(statistics.max_queue_size, max_queue_size);
+  statistics.total += counts;
+  return results;
+}
+
+}  // namespace
+
+/// \brief Find structure mappings for each of a batch of structures,
+///     recording per-structure latency and capturing slow structures
+///
+/// Each structure is mapped as by `map_structures`, and the time taken,
+/// hardware performance counts (see `PerfCounts`), and largest mapping
+/// search queue size are added to `statistics`. The structures' factor
+/// groups are not used: `structure2_factor_group` is the identity
+/// operation only, so mappings that are equivalent under a structure's
+/// symmetry are not skipped.
+///
+/// Structures that take at least `capture.min_seconds` to map, or for
+/// which the mapping search queue holds at least
+/// `capture.min_queue_size` mapping nodes, are written to
+/// `<capture.dir>/<capture.prefix>.<index>.json`, where `index` is
+/// `statistics.n_structure` before the structure was mapped. Each file
+/// includes:
+///
+/// - "prim": The name of the file, in the same directory, where the prim
+///   is written (`<capture.prefix>.prim.<first_index>.json`, written using
+///   the CASM prim JSON format the first time a structure is captured by
+///   this call, where `first_index` is `statistics.n_structure` at the
+///   start of the call, so that calls with different prims accumulating
+///   into the same `statistics` do not overwrite each other's prim file)
+/// - "structure": The structure, as written by `SimpleStructure` JSON IO
+/// - "params": The MapStructuresParams
+/// - "max_queue_size": The largest mapping search queue size
+/// - "perf_counts": The time taken and hardware performance counts
+///
+/// Captured structures can be mapped again, with the same parameters,
+/// using `replay_slow_input`. At most `capture.max_n_capture` structures
+/// are written by one call.
+///
+/// \param shared_prim The reference "parent" structure
+/// \param structures The "child" structures
+/// \param params Parameters of `map_structures` used for each structure
+/// \param statistics Per-structure latency and search statistics are
+///     added to this. Values are accumulated, so that one
+///     MapStructuresBatchStatistics may be used over multiple calls.
+/// \param capture Thresholds for writing slow structures. By default,
+///     no structures are written.
+///
+/// \returns results The mapping results for each structure, in the same
+///     order as `structures`
+std::vector<StructureMappingResults> map_structures_batch(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    std::vector<xtal::SimpleStructure> const &structures,
+    MapStructuresParams const &params,
+    MapStructuresBatchStatistics &statistics,
+    SlowInputCapture const &capture) {
+  if (!shared_prim) {
+    throw std::runtime_error("Error in map_structures_batch: prim is null");
+  }
+  fs::path dir(capture.dir);
+  std::string prim_filename = capture.prefix + ".prim." +
+                              std::to_string(statistics.n_structure) + ".json";
+  bool prim_written = false;
+  Index n_capture = 0;
+
+  std::vector<StructureMappingResults> results;
+  for (xtal::SimpleStructure const &structure : structures) {
+    Index index = statistics.n_structure;
+    PerfCounts counts;
+    Index max_queue_size = 0;
+    results.push_back(map_and_record(shared_prim, structure, params,
+                                     statistics, counts, max_queue_size));
+
+    bool is_slow =
+        (capture.min_seconds.has_value() &&
+         counts.seconds >= *capture.min_seconds) ||
+        (capture.min_queue_size.has_value() &&
+         max_queue_size >= *capture.min_queue_size);
+    if (!is_slow || n_capture >= capture.max_n_capture) {
+      continue;
+    }
+
+    if (!prim_written) {
+      fs::create_directories(dir);
+      jsonParser prim_json;
+      xtal::write_prim(*shared_prim, prim_json, FRAC);
+      prim_json.write(dir / prim_filename);
+      prim_written = true;
+    }
+
+    jsonParser json;
+    json["prim"] = prim_filename;
+    to_json(structure, json["structure"]);
+    to_json(params, json["params"]);
+    json["max_queue_size"] = max_queue_size;
+    to_json(counts, json["perf_counts"]);
+    fs::path path =
+        dir / (capture.prefix + "." + std::to_string(index) + ".json");
+    json.write(path);
+    statistics.slow_input_paths.push_back(path.string());
+    ++n_capture;
+  }
+  return results;
+}
+
+/// \brief Map a structure captured by `map_structures_batch` again
+///
+/// Reads the prim, structure, and parameters from a file written by
+/// `map_structures_batch` and maps the structure, recording latency and
+/// search statistics as `map_structures_batch` does. This makes it
+/// possible to profile or debug a slow structure in isolation.
+///
+/// \param path Path of a file written by `map_structures_batch`
+/// \param statistics Latency and search statistics are added to this
+///
+/// \returns results The mapping results
+StructureMappingResults replay_slow_input(
+    std::string const &path, MapStructuresBatchStatistics &statistics) {
+  fs::path input_path(path);
+  if (!fs::exists(input_path)) {
+    throw std::runtime_error("Error in replay_slow_input: file not found: " +
+                             path);
+  }
+  jsonParser json(input_path);
+
+  fs::path prim_path =
+      input_path.parent_path() / json["prim"].get<std::string>();
+  if (!fs::exists(prim_path)) {
+    throw std::runtime_error(
+        "Error in replay_slow_input: prim file not found: " +
+        prim_path.string());
+  }
+  jsonParser prim_json(prim_path);
+  auto shared_prim = std::make_shared<xtal::BasicStructure const>(
+      xtal::read_prim(prim_json, TOL));
+
+  xtal::SimpleStructure structure;
+  from_json(structure, json["structure"]);
+  MapStructuresParams params;
+  from_json(params, json["params"]);
+
+  PerfCounts counts;
+  Index max_queue_size = 0;
+  return map_and_record(shared_prim, structure, params, statistics, counts,
+                        max_queue_size);
+}
+
+}  // namespace mapping
+}  // namespace CASM
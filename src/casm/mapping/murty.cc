@@ -1,5 +1,9 @@
 #include "casm/mapping/murty.hh"
 
+#include <algorithm>
+#include <deque>
+#include <limits>
+
 namespace CASM {
 namespace mapping {
 namespace murty {
@@ -15,6 +19,186 @@ double make_forced_on_cost(Eigen::MatrixXd const &cost_matrix,
   return forced_on_cost;
 }
 
+/// \brief Returns the size of a maximum matching of a bipartite graph,
+///     using the Hopcroft-Karp algorithm
+///
+/// \param adjacency Size n_rows vector, where adjacency[i] holds the
+///     columns that row i may be matched to
+/// \param n_cols Number of columns
+///
+/// Runs in O(E * sqrt(V)), where E is the number of edges and V the
+/// number of rows and columns.
+Index hopcroft_karp_matching_size(
+    std::vector<std::vector<Index>> const &adjacency, Index n_cols) {
+  Index n_rows = adjacency.size();
+  Index const unmatched = -1;
+  Index const unreached = std::numeric_limits<Index>::max();
+  std::vector<Index> row_match(n_rows, unmatched);
+  std::vector<Index> col_match(n_cols, unmatched);
+  std::vector<Index> dist(n_rows);
+
+  // breadth-first search from the free rows, setting the layer of each
+  // row; returns true if an augmenting path exists
+  auto bfs = [&]() {
+    std::deque<Index> queue;
+    for (Index i = 0; i < n_rows; ++i) {
+      if (row_match[i] == unmatched) {
+        dist[i] = 0;
+        queue.push_back(i);
+      } else {
+        dist[i] = unreached;
+      }
+    }
+    bool found = false;
+    while (!queue.empty()) {
+      Index i = queue.front();
+      queue.pop_front();
+      for (Index j : adjacency[i]) {
+        Index next = col_match[j];
+        if (next == unmatched) {
+          found = true;
+        } else if (dist[next] == unreached) {
+          dist[next] = dist[i] + 1;
+          queue.push_back(next);
+        }
+      }
+    }
+    return found;
+  };
+
+  // depth-first search along the layers, augmenting the matching; uses an
+  // explicit stack of (row, position in adjacency[row]) on the current
+  // path, so the path length is not limited by the call stack
+  std::vector<std::pair<Index, Index>> path;
+  auto dfs = [&](Index root) {
+    path.clear();
+    path.emplace_back(root, 0);
+    while (!path.empty()) {
+      Index i = path.back().first;
+      Index pos = path.back().second;
+      if (pos == Index(adjacency[i].size())) {
+        // no augmenting path through row i
+        dist[i] = unreached;
+        path.pop_back();
+        if (!path.empty()) {
+          ++path.back().second;
+        }
+        continue;
+      }
+      Index next = col_match[adjacency[i][pos]];
+      if (next == unmatched) {
+        // augment along the path
+        for (auto const &step : path) {
+          Index j = adjacency[step.first][step.second];
+          row_match[step.first] = j;
+          col_match[j] = step.first;
+        }
+        return true;
+      }
+      if (dist[next] == dist[i] + 1) {
+        path.emplace_back(next, 0);
+      } else {
+        ++path.back().second;
+      }
+    }
+    return false;
+  };
+
+  Index matching_size = 0;
+  while (bfs()) {
+    for (Index i = 0; i < n_rows; ++i) {
+      if (row_match[i] == unmatched && dfs(i)) {
+        ++matching_size;
+      }
+    }
+  }
+  return matching_size;
+}
+
+/// \brief Checks if the sub-nodes made by `partition` are feasible
+///
+/// The node being partitioned has a sub_assignment which is a perfect
+/// matching of its unassigned rows and columns using only allowed
+/// assignments (cost less than infinity and not forced off). Sub-node m
+/// forces on x_0, ..., x_{m-1} and forces off x_m, where x_i are the
+/// sub_assignment pairs. Removing those from the matching leaves only
+/// row x_m.first and column x_m.second unmatched, so sub-node m is
+/// feasible if and only if there is an augmenting path from that row to
+/// that column. This is checked by a breadth-first search in O(E),
+/// updating the matching and remaining rows and columns incrementally
+/// from one sub-node to the next, instead of solving for the maximum
+/// matching from scratch.
+class PartitionFeasibility {
+ public:
+  PartitionFeasibility(Eigen::MatrixXd const &_cost_matrix, Node const &node,
+                       double _infinity)
+      : m_cost_matrix(_cost_matrix),
+        m_infinity(_infinity),
+        m_forced_off(node.forced_off.begin(), node.forced_off.end()),
+        m_row_active(_cost_matrix.rows(), false),
+        m_col_active(_cost_matrix.cols(), false),
+        m_col_match(_cost_matrix.cols(), -1),
+        m_visited(_cost_matrix.rows(), false) {
+    for (Index i : node.unassigned_rows) {
+      m_row_active[i] = true;
+    }
+    for (Index j : node.unassigned_cols) {
+      m_col_active[j] = true;
+    }
+    for (auto const &x : node.sub_assignment) {
+      m_col_match[x.second] = x.first;
+    }
+  }
+
+  /// \brief Returns true if the sub-node which forces off `x` (and
+  ///     forces on all previous sub_assignment pairs) is feasible
+  bool is_feasible(std::pair<Index, Index> const &x) {
+    std::fill(m_visited.begin(), m_visited.end(), false);
+    std::deque<Index> queue;
+    queue.push_back(x.first);
+    m_visited[x.first] = true;
+    while (!queue.empty()) {
+      Index i = queue.front();
+      queue.pop_front();
+      for (Index j = 0; j < m_cost_matrix.cols(); ++j) {
+        if (!m_col_active[j] || (i == x.first && j == x.second) ||
+            !_is_allowed(i, j)) {
+          continue;
+        }
+        if (j == x.second) {
+          return true;
+        }
+        Index next = m_col_match[j];
+        if (!m_visited[next]) {
+          m_visited[next] = true;
+          queue.push_back(next);
+        }
+      }
+    }
+    return false;
+  }
+
+  /// \brief Force on `x`, before checking the next sub-node
+  void force_on(std::pair<Index, Index> const &x) {
+    m_row_active[x.first] = false;
+    m_col_active[x.second] = false;
+  }
+
+ private:
+  bool _is_allowed(Index i, Index j) const {
+    return m_cost_matrix(i, j) < m_infinity &&
+           (m_forced_off.empty() || !m_forced_off.count({i, j}));
+  }
+
+  Eigen::MatrixXd const &m_cost_matrix;
+  double m_infinity;
+  std::set<std::pair<Index, Index>> m_forced_off;
+  std::vector<bool> m_row_active;
+  std::vector<bool> m_col_active;
+  std::vector<Index> m_col_match;
+  std::vector<bool> m_visited;
+};
+
 }  // namespace murty_impl
 
 /// \brief Find the k best solutions to the assignment problem
@@ -93,6 +277,11 @@ std::vector<std::pair<double, Assignment>> solve(
 
   // --- Find optimal assignment ---
   Node optimal_node = make_node(cost_matrix);
+  if (!is_feasible(cost_matrix, optimal_node.unassigned_rows,
+                   optimal_node.unassigned_cols, optimal_node.forced_off,
+                   infinity)) {
+    return results;
+  }
   std::tie(optimal_node.cost, optimal_node.sub_assignment) =
       make_sub_assignment(assign_f, cost_matrix, optimal_node.unassigned_rows,
                           optimal_node.unassigned_cols, optimal_node.forced_off,
@@ -184,17 +373,26 @@ Node make_node(Eigen::MatrixXd const &cost_matrix,
 /// the solution to a vector, under the assumption that
 /// all workers must be assigned.
 Assignment make_assignment(Node const &node) {
-  std::map<Index, Index> ordered = node.forced_on;
-  for (auto const &x : node.sub_assignment) {
-    ordered.emplace(x);
-  }
   Assignment assignment;
-  for (auto const &x : ordered) {
-    assignment.push_back(x.second);
-  }
+  make_assignment(node, assignment);
   return assignment;
 }
 
+/// \brief Write the full assignment to an existing vector
+///
+/// This gives the same result as `make_assignment(node)`, but reuses
+/// the storage of `assignment`, so that no allocation is needed if its
+/// capacity is sufficient.
+void make_assignment(Node const &node, Assignment &assignment) {
+  assignment.resize(node.forced_on.size() + node.sub_assignment.size());
+  for (auto const &x : node.forced_on) {
+    assignment[x.first] = x.second;
+  }
+  for (auto const &x : node.sub_assignment) {
+    assignment[x.first] = x.second;
+  }
+}
+
 /// \brief Return the cost for a particular assignment
 double make_cost(Eigen::MatrixXd const &cost_matrix,
                  Assignment const &assignment) {
@@ -217,6 +415,11 @@ double make_cost(Eigen::MatrixXd const &cost_matrix,
 ///     off
 /// \param tol Tolerance used for comparing costs
 ///
+/// Sub-nodes which have no solution with cost less than infinity are
+/// detected by a bipartite matching check (see
+/// `murty_impl::PartitionFeasibility`) and skipped without calling
+/// `assign_f`.
+///
 /// \returns A Node encoding the "next best" assignment
 void partition(std::multiset<Node> &node_set, AssignmentMethod assign_f,
                Eigen::MatrixXd const &cost_matrix, Node const &node,
@@ -236,24 +439,30 @@ void partition(std::multiset<Node> &node_set, AssignmentMethod assign_f,
   }
 
   Node subnode = node;
+  PartitionFeasibility feasibility(cost_matrix, node, infinity);
 
   // 'x' is a particular assignement {worker/row, task/column}
   for (auto const &x : node.sub_assignment) {
     subnode.forced_off.push_back(x);
 
-    double sub_assignment_cost;
-    std::tie(sub_assignment_cost, subnode.sub_assignment) = make_sub_assignment(
-        assign_f, cost_matrix, subnode.unassigned_rows, subnode.unassigned_cols,
-        subnode.forced_off, infinity, tol);
-
-    // handle failure to assign all "workers" (rows) by not saving the node
-    if (subnode.sub_assignment.size() + subnode.forced_on.size() ==
-        cost_matrix.rows()) {
-      subnode.cost =
-          sub_assignment_cost + make_forced_on_cost(cost_matrix, subnode);
-      node_set.insert(subnode);
+    // skip sub-nodes that have no finite cost solution
+    if (feasibility.is_feasible(x)) {
+      double sub_assignment_cost;
+      std::tie(sub_assignment_cost, subnode.sub_assignment) =
+          make_sub_assignment(assign_f, cost_matrix, subnode.unassigned_rows,
+                              subnode.unassigned_cols, subnode.forced_off,
+                              infinity, tol);
+
+      // handle failure to assign all "workers" (rows) by not saving the node
+      if (subnode.sub_assignment.size() + subnode.forced_on.size() ==
+          cost_matrix.rows()) {
+        subnode.cost =
+            sub_assignment_cost + make_forced_on_cost(cost_matrix, subnode);
+        node_set.insert(subnode);
+      }
     }
 
+    feasibility.force_on(x);
     subnode.forced_on.emplace(x);
     if (subnode.forced_on.size() == cost_matrix.rows()) {
       break;
@@ -264,6 +473,57 @@ void partition(std::multiset<Node> &node_set, AssignmentMethod assign_f,
   }
 }
 
+/// \brief Check if the assignment problem, given certain assignments
+///    forced on and certain assignments forced off, has a solution that
+///    only includes assignments with cost less than infinity
+///
+/// This checks if there is a perfect matching of the unassigned rows and
+/// columns using only assignments with cost less than infinity that are
+/// not forced off, using the Hopcroft-Karp algorithm, in O(E * sqrt(V))
+/// time. If not, `make_sub_assignment` would find a solution with cost
+/// greater than or equal to infinity, so it need not be called.
+///
+/// \param cost_matrix The cost of assigning "worker" i to "task" j is
+///     cost_matrix(i,j). This is the original, full, cost_matrix.
+/// \param unassigned_rows Indices of "workers" (rows) not currently
+///     forced into a particular assignment.
+/// \param unassigned_cols Indices of "tasks" (columns) not currently
+///     forced into a particular assignment.
+/// \param forced_off Pairs of "workers" and "tasks" {row, column}
+///     which are forced to be not be part of the assignment solution.
+/// \param infinity Cost used for "infinity". Assignments with cost
+///     greater than or equal to infinity are not allowed.
+///
+/// \returns True if there is a solution with all assignments allowed.
+bool is_feasible(Eigen::MatrixXd const &cost_matrix,
+                 std::set<Index> const &unassigned_rows,
+                 std::set<Index> const &unassigned_cols,
+                 std::vector<std::pair<Index, Index>> const &forced_off,
+                 double infinity) {
+  if (unassigned_rows.size() != unassigned_cols.size()) {
+    return false;
+  }
+  std::set<std::pair<Index, Index>> forced_off_set(forced_off.begin(),
+                                                   forced_off.end());
+  std::vector<std::vector<Index>> adjacency;
+  adjacency.reserve(unassigned_rows.size());
+  for (Index i : unassigned_rows) {
+    adjacency.emplace_back();
+    Index col = 0;
+    for (Index j : unassigned_cols) {
+      if (cost_matrix(i, j) < infinity && !forced_off_set.count({i, j})) {
+        adjacency.back().push_back(col);
+      }
+      ++col;
+    }
+    if (adjacency.back().empty()) {
+      return false;
+    }
+  }
+  return murty_impl::hopcroft_karp_matching_size(
+             adjacency, unassigned_cols.size()) == Index(adjacency.size());
+}
+
 /// \brief Solve the assignment problem given certain assignments
 ///    forced on and certain assignments forced off
 ///
@@ -0,0 +1,213 @@
+#include "casm/mapping/perf_counters.hh"
+
+#include <chrono>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+double now_seconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void add(std::optional<double> &lhs, std::optional<double> const &rhs) {
+  if (rhs.has_value()) {
+    lhs = lhs.value_or(0.0) + *rhs;
+  }
+}
+
+void divide(std::optional<double> &value, double n) {
+  if (value.has_value()) {
+    *value /= n;
+  }
+}
+
+#if defined(__linux__)
+
+/// \brief Open one counter, returning -1 if it is not available
+int open_counter(std::uint32_t type, std::uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  return static_cast<int>(fd);
+}
+
+/// \brief Read one counter, scaled for multiplexing
+std::optional<double> read_counter(int fd) {
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  std::uint64_t buf[3];
+  if (read(fd, buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) {
+    return std::nullopt;
+  }
+  return static_cast<double>(buf[0]) * static_cast<double>(buf[1]) /
+         static_cast<double>(buf[2]);
+}
+
+#endif
+
+}  // namespace
+
+/// \brief Instructions per cycle, if available
+std::optional<double> PerfCounts::ipc() const {
+  if (!cycles.has_value() || !instructions.has_value() || *cycles == 0.0) {
+    return std::nullopt;
+  }
+  return *instructions / *cycles;
+}
+
+/// \brief Add counts from another measurement
+///
+/// A count is available in the sum if it is available in either
+/// measurement.
+PerfCounts &PerfCounts::operator+=(PerfCounts const &other) {
+  seconds += other.seconds;
+  add(cycles, other.cycles);
+  add(instructions, other.instructions);
+  add(l1d_read_misses, other.l1d_read_misses);
+  add(llc_misses, other.llc_misses);
+  add(branch_misses, other.branch_misses);
+  return *this;
+}
+
+/// \brief Return per-element counts (i.e. per cost matrix element)
+///
+/// For example, `per_element(counts, N * N * n_cost_matrix)` gives the
+/// time, cycles, and cache misses per cost matrix element for a phase
+/// that constructs `n_cost_matrix` cost matrices of dimension N.
+///
+/// \param counts Total counts for a phase
+/// \param n_element Number of elements processed in the phase
+///
+/// \returns Counts divided by n_element. IPC is unchanged.
+PerfCounts per_element(PerfCounts const &counts, double n_element) {
+  PerfCounts result = counts;
+  if (n_element <= 0.0) {
+    return result;
+  }
+  result.seconds /= n_element;
+  divide(result.cycles, n_element);
+  divide(result.instructions, n_element);
+  divide(result.l1d_read_misses, n_element);
+  divide(result.llc_misses, n_element);
+  divide(result.branch_misses, n_element);
+  return result;
+}
+
+/// \class PerfCounters
+/// \brief Measures hardware performance counters for the calling
+///     thread (and threads it creates) using `perf_event_open`
+///
+/// Counts user-space cycles, instructions, L1 data cache read misses,
+/// last level cache misses, and branch mispredictions. Each counter is
+/// opened independently, so if some are not supported by the hardware
+/// the others are still measured. If `perf_event_open` is not available
+/// (non-Linux platforms, or restricted by `perf_event_paranoid` or a
+/// container seccomp profile), only the elapsed time is measured and
+/// `is_available()` returns false. Counts are scaled to account for
+/// counter multiplexing.
+
+/// \brief Constructor, opens the counters
+PerfCounters::PerfCounters() : m_begin(0.0) {
+  m_fd.fill(-1);
+#if defined(__linux__)
+  m_fd[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  m_fd[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+                                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  m_fd[2] = open_counter(PERF_TYPE_HW_CACHE, l1d_read_miss);
+  m_fd[3] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  m_fd[4] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+/// \brief Destructor, closes the counters
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+  for (int fd : m_fd) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+/// \brief True if any hardware counter is available
+bool PerfCounters::is_available() const {
+  for (int fd : m_fd) {
+    if (fd >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// \brief Reset and start counting
+void PerfCounters::start() {
+#if defined(__linux__)
+  for (int fd : m_fd) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+  m_begin = now_seconds();
+}
+
+/// \brief Stop counting and return the counts since `start`
+PerfCounts PerfCounters::stop() {
+  PerfCounts counts;
+  counts.seconds = now_seconds() - m_begin;
+#if defined(__linux__)
+  for (int fd : m_fd) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  counts.cycles = read_counter(m_fd[0]);
+  counts.instructions = read_counter(m_fd[1]);
+  counts.l1d_read_misses = read_counter(m_fd[2]);
+  counts.llc_misses = read_counter(m_fd[3]);
+  counts.branch_misses = read_counter(m_fd[4]);
+#endif
+  return counts;
+}
+
+/// \brief Constructor, starts counting
+///
+/// \param _counts Counts measured during the lifetime of this object
+///     are added to `_counts`, so the same PerfCounts can be used to
+///     accumulate repeated measurements of a phase.
+ScopedPerfCounters::ScopedPerfCounters(PerfCounts &_counts)
+    : m_counts(_counts) {
+  m_counters.start();
+}
+
+/// \brief Destructor, stops counting and adds to `counts`
+ScopedPerfCounters::~ScopedPerfCounters() { m_counts += m_counters.stop(); }
+
+}  // namespace mapping
+}  // namespace CASM
@@ -0,0 +1,242 @@
+#include "casm/mapping/synthetic_structure.hh"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/LinearIndexConverter.hh"
+#include "casm/crystallography/Molecule.hh"
+#include "casm/mapping/SearchData.hh"
+
+namespace CASM {
+namespace mapping {
+
+namespace {
+
+/// \brief Random numbers that are reproducible across platforms
+///
+/// The distributions provided by <random> are implementation defined,
+/// so uniform and normal variates are generated here directly from the
+/// bits of std::mt19937_64, which is fully specified.
+class SyntheticRandom {
+ public:
+  SyntheticRandom(std::uint64_t seed) : m_engine(seed) {}
+
+  /// \brief Uniform in [0, 1)
+  double uniform() { return (m_engine() >> 11) * (1.0 / 9007199254740992.0); }
+
+  /// \brief Uniform integer in [0, n)
+  Index index(Index n) {
+    Index i = static_cast<Index>(uniform() * n);
+    return (i < n) ? i : n - 1;
+  }
+
+  /// \brief Standard normal, using the Box-Muller transform
+  double normal() {
+    double u1 = 1.0 - uniform();
+    double u2 = uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+  }
+
+ private:
+  std::mt19937_64 m_engine;
+};
+
+}  // namespace
+
+/// \brief Generate a child structure with a known mapping to the prim
+///
+/// This generates structures for testing and for scaling studies of
+/// structure mapping methods, where the best mapping is known. The
+/// child structure is generated from a supercell of the prim by:
+///
+/// - Choosing site occupants. Each site is occupied by its first
+///   allowed atom type, except that, with probability
+///   `vacancy_fraction`, a site that allows vacancies is vacant, and
+///   with probability `antisite_fraction`, an occupied site with more
+///   than one allowed atom type is occupied by one of the others.
+///   Sites that only allow vacancies are always vacant.
+/// - Displacing occupied sites by random displacements, d, with
+///   normally distributed components. The mean displacement is
+///   removed, as in the displacements found by structure mapping.
+/// - Deforming the supercell by F = Q * U, where U = I + E, E is a
+///   random symmetric matrix with normally distributed elements, and Q
+///   is a uniformly random rotation (if `random_rotation`).
+/// - Applying a random rigid translation, t (if `random_translation`),
+///   and randomly shuffling the order of atoms (if `shuffle_atoms`).
+///
+/// The returned structure mapping satisfies:
+///
+///     F * (r1[i] + d[i]) = r2[perm[i]] + t,
+///
+/// modulo lattice translations, where r1 are the supercell site
+/// coordinates, ordered as by `xtal::UnitCellCoordIndexConverter`, and
+/// r2 are the child atom coordinates, which are placed within the child
+/// lattice, L2 = F * L1 * T. Vacant sites have permutation indices
+/// `perm[i] >= N_atom` and zero displacement.
+///
+/// The random number generation does not depend on the standard
+/// library implementation, so the same seed gives the same structure
+/// on every platform.
+///
+/// \param shared_prim The prim. Site occupants must be atomic.
+/// \param params Parameters controlling generation
+/// \param seed Random number generator seed
+///
+/// \returns The generated structure and its structure mapping
+SyntheticStructure make_synthetic_structure(
+    std::shared_ptr<xtal::BasicStructure const> const &shared_prim,
+    SyntheticStructureParams const &params, std::uint64_t seed) {
+  if (params.transformation_matrix_to_super.determinant() <= 0) {
+    throw std::runtime_error(
+        "Error in make_synthetic_structure: "
+        "transformation_matrix_to_super must have positive determinant");
+  }
+  if (params.vacancy_fraction < 0.0 || params.vacancy_fraction > 1.0 ||
+      params.antisite_fraction < 0.0 || params.antisite_fraction > 1.0) {
+    throw std::runtime_error(
+        "Error in make_synthetic_structure: "
+        "vacancy_fraction and antisite_fraction must be in [0, 1]");
+  }
+
+  bool enable_symmetry_breaking_atom_cost = false;
+  PrimSearchData prim_data(shared_prim, std::nullopt,
+                           enable_symmetry_breaking_atom_cost);
+  Eigen::Matrix3l const &T = params.transformation_matrix_to_super;
+  xtal::UnitCellCoordIndexConverter unitcellcoord_index_converter(
+      T, prim_data.N_prim_site);
+  Eigen::MatrixXd site_coordinate_cart =
+      mapping_impl::make_supercell_site_coordinate_cart(
+          unitcellcoord_index_converter, prim_data.prim_site_coordinate_cart,
+          prim_data.prim_lattice);
+  std::vector<std::vector<std::string>> allowed_atom_types =
+      mapping_impl::make_supercell_allowed_atom_types(
+          unitcellcoord_index_converter, prim_data.prim_allowed_atom_types);
+  Index N_site = site_coordinate_cart.cols();
+
+  SyntheticRandom random(seed);
+
+  // choose occupants
+  std::vector<std::string> occupant(N_site);
+  std::vector<bool> is_occupied(N_site, false);
+  Index N_atom = 0;
+  for (Index i = 0; i < N_site; ++i) {
+    std::vector<std::string> atom_types;
+    bool allows_vacancy = false;
+    for (auto const &name : allowed_atom_types[i]) {
+      if (xtal::is_vacancy(name)) {
+        allows_vacancy = true;
+      } else {
+        atom_types.push_back(name);
+      }
+    }
+    if (atom_types.empty() ||
+        (allows_vacancy && random.uniform() < params.vacancy_fraction)) {
+      continue;
+    }
+    occupant[i] = atom_types[0];
+    if (atom_types.size() > 1 && random.uniform() < params.antisite_fraction) {
+      occupant[i] = atom_types[1 + random.index(atom_types.size() - 1)];
+    }
+    is_occupied[i] = true;
+    ++N_atom;
+  }
+
+  // displacements, with the mean displacement removed
+  Eigen::MatrixXd displacement = Eigen::MatrixXd::Zero(3, N_site);
+  if (params.displacement_magnitude != 0.0 && N_atom > 0) {
+    Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+    for (Index i = 0; i < N_site; ++i) {
+      if (is_occupied[i]) {
+        for (Index k = 0; k < 3; ++k) {
+          displacement(k, i) = params.displacement_magnitude * random.normal();
+        }
+        mean += displacement.col(i);
+      }
+    }
+    mean /= N_atom;
+    for (Index i = 0; i < N_site; ++i) {
+      if (is_occupied[i]) {
+        displacement.col(i) -= mean;
+      }
+    }
+  }
+
+  // deformation gradient, F = Q * U
+  Eigen::Matrix3d U = Eigen::Matrix3d::Identity();
+  if (params.strain_magnitude != 0.0) {
+    for (Index i = 0; i < 3; ++i) {
+      for (Index j = i; j < 3; ++j) {
+        U(i, j) += params.strain_magnitude * random.normal();
+        U(j, i) = U(i, j);
+      }
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigen_solver(U);
+    if (eigen_solver.eigenvalues().minCoeff() <= 0.0) {
+      throw std::runtime_error(
+          "Error in make_synthetic_structure: "
+          "strain_magnitude is too large, U is not positive definite");
+    }
+  }
+  Eigen::Matrix3d Q = Eigen::Matrix3d::Identity();
+  if (params.random_rotation) {
+    // a normalized 4d normal vector is a uniformly random unit quaternion
+    Eigen::Quaterniond q(random.normal(), random.normal(), random.normal(),
+                         random.normal());
+    Q = q.normalized().toRotationMatrix();
+  }
+  Eigen::Matrix3d F = Q * U;
+  Eigen::Matrix3d N = Eigen::Matrix3d::Identity();
+  LatticeMapping lattice_mapping(F, T.cast<double>(), N);
+  Eigen::Matrix3d L2 = F * prim_data.prim_lattice.lat_column_mat() *
+                       T.cast<double>() * N;
+
+  Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+  if (params.random_translation) {
+    Eigen::Vector3d frac(random.uniform(), random.uniform(), random.uniform());
+    translation = L2 * frac;
+  }
+
+  // child atom order
+  std::vector<Index> atom_order(N_atom);
+  for (Index k = 0; k < N_atom; ++k) {
+    atom_order[k] = k;
+  }
+  if (params.shuffle_atoms) {
+    for (Index k = N_atom - 1; k > 0; --k) {
+      std::swap(atom_order[k], atom_order[random.index(k + 1)]);
+    }
+  }
+
+  // child structure, F * (r1[i] + d[i]) = r2[perm[i]] + t
+  xtal::SimpleStructure structure;
+  structure.lat_column_mat = L2;
+  structure.atom_info.resize(N_atom);
+  Eigen::Matrix3d L2_inv = L2.inverse();
+  std::vector<Index> permutation(N_site);
+  Index i_atom = 0;
+  Index i_vacancy = N_atom;
+  for (Index i = 0; i < N_site; ++i) {
+    if (!is_occupied[i]) {
+      permutation[i] = i_vacancy++;
+      continue;
+    }
+    Index j = atom_order[i_atom++];
+    permutation[i] = j;
+    Eigen::Vector3d r2 =
+        F * (site_coordinate_cart.col(i) + displacement.col(i)) - translation;
+    Eigen::Vector3d frac = L2_inv * r2;
+    frac = frac.array() - frac.array().floor();
+    structure.atom_info.coords.col(j) = L2 * frac;
+    structure.atom_info.names[j] = occupant[i];
+  }
+
+  AtomMapping atom_mapping(displacement, permutation, translation);
+  return SyntheticStructure(
+      structure,
+      StructureMapping(shared_prim, lattice_mapping, atom_mapping));
+}
+
+}  // namespace mapping
+}  // namespace CASM
@@ -1,27 +1,16 @@
 #ifndef CASM_mapping_unittest_SearchTestData
 #define CASM_mapping_unittest_SearchTestData
 
+#include <functional>
+
 #include "casm/crystallography/BasicStructure.hh"
 #include "casm/crystallography/BasicStructureTools.hh"
+#include "casm/mapping/MappingSearch.hh"
 #include "casm/mapping/SearchData.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 
 using namespace CASM;
 
-namespace CASM {
-namespace mapping {
-namespace mapping_impl {
-
-// Defined in SearchData.cc
-Eigen::MatrixXd make_supercell_site_coordinate_cart(
-    xtal::UnitCellCoordIndexConverter const &unitcellcoord_index_converter,
-    Eigen::MatrixXd const &prim_site_coordinate_cart,
-    xtal::Lattice const &prim_lattice);
-
-}  // namespace mapping_impl
-}  // namespace mapping
-}  // namespace CASM
-
 namespace test {
 
 /// \brief Modify r2 and atom_type (which correspond to F
@@ -222,6 +211,77 @@ make_search_prim_binary_conventional_BCC(double a) {
       std::make_shared<BasicStructure const>(prim));
 }
 
+/// \brief Small displacements, of the first `n_displaced` of `n_atom`
+///     atoms, as columns
+inline Eigen::MatrixXd make_small_displacements(Index n_atom,
+                                                Index n_displaced) {
+  Eigen::MatrixXd d(3, 7);
+  d.col(0) << 0.01, -0.01, 0.01;
+  d.col(1) << 0.00, 0.01, -0.01;
+  d.col(2) << 0.01, 0.00, -0.01;
+  d.col(3) << -0.01, 0.01, 0.0;
+  d.col(4) << -0.01, 0.00, 0.01;
+  d.col(5) << 0.0, 0.00, -0.01;
+  d.col(6) << 0.01, 0.00, 0.0;
+
+  Eigen::MatrixXd disp = Eigen::MatrixXd::Zero(3, n_atom);
+  disp.leftCols(n_displaced) = d.leftCols(n_displaced);
+  return disp;
+}
+
+/// \brief Make LatticeMappingSearchData for a strained and displaced
+///     superstructure of a prim
+///
+/// With F * L1 * T = L2, the structure has atoms of type "A" at
+/// F * (r1_supercell[i] + disp.col(i)), for the first disp.cols()
+/// supercell sites. If there are fewer atoms than supercell sites, the
+/// remaining sites are vacant.
+inline std::shared_ptr<mapping::LatticeMappingSearchData const>
+make_lattice_mapping_search_data(
+    std::shared_ptr<mapping::PrimSearchData const> prim_data,
+    Eigen::Matrix3d const &F, Eigen::Matrix3d const &T,
+    Eigen::MatrixXd const &disp) {
+  Eigen::Matrix3d N = Eigen::Matrix3d::Identity();
+  std::vector<Index> perm;
+  std::vector<std::string> structure1_supercell_atom_type;
+  for (Index i = 0; i < disp.cols(); ++i) {
+    perm.push_back(i);
+    structure1_supercell_atom_type.push_back("A");
+  }
+  Eigen::Vector3d trans(0., 0., 0.);
+
+  SearchTestData d(std::move(prim_data), F, T, N, disp,
+                   structure1_supercell_atom_type, perm, trans);
+  return std::make_shared<mapping::LatticeMappingSearchData const>(
+      d.prim_data, d.structure_data, d.lattice_mapping);
+}
+
+/// \brief Insert a MappingNode for each trial translation, then
+///     partition until the queue is empty, or `max_n_partition` times
+///
+/// \param before_partition If not empty, called before each partition
+///
+/// \returns The search results, combined with overflow
+inline mapping::StructureMappingResults run_mapping_search(
+    mapping::MappingSearch &search, double lattice_cost,
+    std::shared_ptr<mapping::LatticeMappingSearchData const> const
+        &lattice_mapping_data,
+    std::vector<Eigen::Vector3d> const &trial_translations,
+    Index max_n_partition = 100,
+    std::function<void(mapping::MappingSearch &)> before_partition = {}) {
+  for (auto const &trial_translation_cart : trial_translations) {
+    search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                        trial_translation_cart);
+  }
+  for (Index i = 0; i < max_n_partition && search.size(); ++i) {
+    if (before_partition) {
+      before_partition(search);
+    }
+    search.partition();
+  }
+  return mapping::combined_results(search);
+}
+
 }  // namespace test
 
 #endif
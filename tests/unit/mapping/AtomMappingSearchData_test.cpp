@@ -1,5 +1,6 @@
 #include "SearchTestData.hh"
 #include "casm/mapping/SearchData.hh"
+#include "casm/mapping/synthetic_structure.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 #include "gtest/gtest.h"
 #include "teststructures.hh"
@@ -111,3 +112,82 @@ TEST(AtomMappingSearchDataTest, Test2) {
   EXPECT_EQ(atom_mapping_data->cost_matrix.rows(), N_supercell_site);
   EXPECT_EQ(atom_mapping_data->cost_matrix.cols(), N_supercell_site);
 }
+
+// Test that the packed site data kernels give the same site
+// displacements and cost matrix as the reference kernels, using a
+// ZrO superstructure with vacancies and a non-diagonal supercell
+TEST(AtomMappingSearchDataTest, Test3) {
+  auto prim = std::make_shared<BasicStructure const>(test::ZrO_prim());
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super << 2, 1, 0,  //
+      0, 2, 1,                                       //
+      1, 0, 3;                                       //
+  params.strain_magnitude = 0.01;
+  params.displacement_magnitude = 0.1;
+  params.vacancy_fraction = 0.3;
+  SyntheticStructure synthetic = make_synthetic_structure(prim, params, 5);
+
+  auto prim_data = std::make_shared<PrimSearchData const>(prim);
+  auto structure_data = std::make_shared<StructureSearchData const>(
+      Lattice(synthetic.structure.lat_column_mat),
+      synthetic.structure.atom_info.coords,
+      synthetic.structure.atom_info.names);
+  auto lattice_mapping_data = std::make_shared<LatticeMappingSearchData const>(
+      prim_data, structure_data,
+      synthetic.structure_mapping.lattice_mapping);
+
+  SupercellSiteData const &site_data =
+      lattice_mapping_data->supercell_site_data;
+  Index N_site = lattice_mapping_data->N_supercell_site;
+  EXPECT_EQ(site_data.N_site, N_site);
+  ASSERT_EQ(site_data.sublattice.size(), N_site);
+  ASSERT_EQ(site_data.allowed_atom_type_mask.size(), N_site);
+  for (Index i = 0; i < N_site; ++i) {
+    EXPECT_EQ(site_data.sublattice[i],
+              lattice_mapping_data->unitcellcoord_index_converter(i)
+                  .sublattice());
+    auto const &allowed =
+        lattice_mapping_data->supercell_allowed_atom_types[i];
+    for (std::string name : {"Zr", "O", "Va", "X"}) {
+      bool is_allowed =
+          xtal::is_vacancy(name)
+              ? std::any_of(allowed.begin(), allowed.end(),
+                            [](std::string const &x) {
+                              return xtal::is_vacancy(x);
+                            })
+              : std::find(allowed.begin(), allowed.end(), name) !=
+                    allowed.end();
+      EXPECT_EQ((site_data.allowed_atom_type_mask[i] &
+                 site_data.atom_type_mask(name)) != 0,
+                is_allowed);
+    }
+  }
+
+  Eigen::Vector3d trial_translation =
+      -synthetic.structure_mapping.atom_mapping.translation;
+  auto expected_displacements = mapping_impl::make_site_displacements(
+      lattice_mapping_data->supercell_lattice,
+      lattice_mapping_data->supercell_site_coordinate_cart,
+      lattice_mapping_data->atom_coordinate_cart_in_supercell,
+      trial_translation);
+  auto expected_cost_matrix = mapping_impl::make_cost_matrix(
+      AtomToSiteCost(), expected_displacements, structure_data->atom_type,
+      lattice_mapping_data->supercell_allowed_atom_types, 1e20);
+
+  AtomMappingSearchData atom_mapping_data(lattice_mapping_data,
+                                          trial_translation);
+  ASSERT_EQ(atom_mapping_data.site_displacements.size(), N_site);
+  for (Index i = 0; i < N_site; ++i) {
+    for (Index j = 0; j < structure_data->N_atom; ++j) {
+      EXPECT_TRUE(almost_equal(atom_mapping_data.site_displacements[i][j],
+                               expected_displacements[i][j]));
+    }
+  }
+  EXPECT_TRUE(
+      almost_equal(atom_mapping_data.cost_matrix, expected_cost_matrix));
+
+  AtomMappingSearchData static_atom_mapping_data(
+      lattice_mapping_data, trial_translation, AtomToSiteCost(), 1e20);
+  EXPECT_TRUE(almost_equal(static_atom_mapping_data.cost_matrix,
+                           expected_cost_matrix));
+}
@@ -0,0 +1,90 @@
+#include "casm/mapping/BlockCompressedStream.hh"
+
+#include <cstdio>
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+/// \brief Compressible records of varying size, including binary data
+std::vector<std::string> make_records(Index n_record) {
+  std::mt19937 engine(12345);
+  std::uniform_int_distribution<int> size_dist(0, 300);
+  std::vector<std::string> records;
+  for (Index i = 0; i < n_record; ++i) {
+    std::string record = "{\"index\": " + std::to_string(i) +
+                         ", \"transformation_matrix_to_super\": [[2, 0, 0], "
+                         "[0, 2, 0], [0, 0, 1]]}";
+    record.append(size_dist(engine), char(i % 256));
+    records.push_back(record);
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(BlockCompressedStreamTest, Test1) {
+  // write and read back, in full and in ranges
+  std::string path = testing::TempDir() + "BlockCompressedStreamTest.blk";
+  std::vector<std::string> records = make_records(5000);
+  {
+    BlockCompressedWriter writer(path, 4096, 4);
+    for (auto const &record : records) {
+      writer.write(record);
+    }
+    writer.close();
+    EXPECT_EQ(writer.n_record(), records.size());
+  }
+
+  BlockCompressedReader reader(path, 3);
+  EXPECT_EQ(reader.n_record(), records.size());
+  EXPECT_GT(reader.index().size(), 10);
+  std::uint64_t n_bytes = 0;
+  for (auto const &entry : reader.index()) {
+    EXPECT_LT(entry.n_compressed_bytes, entry.n_bytes);
+    n_bytes += entry.n_bytes;
+  }
+  EXPECT_GT(n_bytes, 5000 * 80);
+
+  EXPECT_EQ(reader.read(0, records.size()), records);
+  for (auto range : std::vector<std::pair<Index, Index>>(
+           {{0, 1}, {17, 18}, {100, 2000}, {4999, 5000}, {2500, 2500}})) {
+    std::vector<std::string> expected(records.begin() + range.first,
+                                      records.begin() + range.second);
+    EXPECT_EQ(reader.read(range.first, range.second), expected);
+  }
+  EXPECT_THROW(reader.read(10, 5001), std::runtime_error);
+  EXPECT_THROW(reader.read(10, 9), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(BlockCompressedStreamTest, Test2) {
+  // empty stream, and closing in the destructor
+  std::string path = testing::TempDir() + "BlockCompressedStreamTest.blk";
+  { BlockCompressedWriter writer(path); }
+  {
+    BlockCompressedReader reader(path);
+    EXPECT_EQ(reader.n_record(), 0);
+    EXPECT_EQ(reader.index().size(), 0);
+    EXPECT_EQ(reader.read(0, 0).size(), 0);
+  }
+  {
+    BlockCompressedWriter writer(path, 1 << 20, 0, 9);
+    writer.write("a");
+    writer.write("");
+    writer.write("c\n");
+  }
+  BlockCompressedReader reader(path);
+  EXPECT_EQ(reader.read(0, 3), std::vector<std::string>({"a", "", "c\n"}));
+
+  // not a block-compressed stream
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  std::fputs("{\"not\": \"blocks\"}\n", file);
+  std::fclose(file);
+  EXPECT_THROW(BlockCompressedReader reader2(path), std::runtime_error);
+  std::remove(path.c_str());
+}
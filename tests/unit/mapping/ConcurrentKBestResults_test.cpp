@@ -0,0 +1,173 @@
+#include "casm/mapping/ConcurrentKBestResults.hh"
+
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+typedef std::pair<double, Index> Key;
+typedef std::multimap<Key, Index> ResultsMap;
+
+double get_cost(Key const &key) { return key.first; }
+
+/// \brief Serial k-best results, as by mapping_impl::insert, inserting in
+///     order of increasing key
+ResultsMap serial_k_best(std::vector<Key> keys, std::optional<int> k_best,
+                         double min_cost, double max_cost, double cost_tol) {
+  std::sort(keys.begin(), keys.end());
+  ResultsMap results;
+  ResultsMap overflow;
+  for (auto const &key : keys) {
+    if (key.first > (min_cost - cost_tol) && key.first < max_cost + cost_tol) {
+      results.emplace(key, key.second);
+      maintain_k_best_results(k_best, cost_tol, results, overflow, get_cost);
+      if (k_best.has_value() && results.size() == size_t(*k_best)) {
+        max_cost = results.rbegin()->first.first;
+      }
+    }
+  }
+  while (overflow.size()) {
+    results.insert(overflow.extract(overflow.begin()));
+  }
+  return results;
+}
+
+/// \brief Random costs, rounded so that there are many ties
+std::vector<Key> make_keys(Index n, unsigned seed) {
+  std::mt19937 engine(seed);
+  std::vector<Key> keys;
+  for (Index i = 0; i < n; ++i) {
+    double cost = (engine() % 1000) * 0.001;
+    keys.emplace_back(cost, i);
+  }
+  return keys;
+}
+
+void insert_concurrently(ConcurrentKBestResults<Key, Index> &collector,
+                         std::vector<Key> const &keys, Index n_thread) {
+  std::vector<std::thread> threads;
+  for (Index t = 0; t < n_thread; ++t) {
+    threads.emplace_back([&, t]() {
+      for (Index i = t; i < Index(keys.size()); i += n_thread) {
+        collector.insert(keys[i], keys[i].second);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+TEST(ConcurrentKBestResultsTest, Test1) {
+  // k-best with ties, single thread
+  std::vector<Key> keys({{0.3, 0}, {0.1, 1}, {0.2, 2}, {0.2, 3}, {0.5, 4}});
+  ConcurrentKBestResults<Key, Index> collector(2, 0.0, 1e20, 1e-5, get_cost,
+                                               1);
+  for (auto const &key : keys) {
+    collector.insert(key, key.second);
+  }
+  EXPECT_EQ(collector.max_cost(), 0.2);
+  EXPECT_FALSE(collector.insert({0.4, 5}, 5));
+
+  ResultsMap results = collector.results();
+  ASSERT_EQ(results.size(), 3);
+  auto it = results.begin();
+  EXPECT_EQ(it++->second, 1);
+  EXPECT_EQ(it++->second, 2);
+  EXPECT_EQ(it++->second, 3);
+}
+
+TEST(ConcurrentKBestResultsTest, Test2) {
+  // many threads, same results as serial insertion
+  std::vector<Key> keys = make_keys(20000, 1);
+  double min_cost = 0.01;
+  double max_cost = 0.9;
+  double cost_tol = 1e-5;
+  for (std::optional<int> k_best : std::vector<std::optional<int>>(
+           {std::nullopt, 1, 7, 100})) {
+    ResultsMap expected =
+        serial_k_best(keys, k_best, min_cost, max_cost, cost_tol);
+    for (Index n_shard : {1, 3, 8}) {
+      ConcurrentKBestResults<Key, Index> collector(
+          k_best, min_cost, max_cost, cost_tol, get_cost, n_shard);
+      insert_concurrently(collector, keys, 8);
+      ResultsMap results = collector.results();
+      EXPECT_EQ(results, expected)
+          << "k_best: " << k_best.value_or(-1) << " n_shard: " << n_shard;
+      if (k_best.has_value()) {
+        EXPECT_GE(collector.max_cost(), expected.rbegin()->first.first);
+        EXPECT_LE(collector.max_cost(), max_cost);
+      }
+    }
+  }
+}
+
+TEST(ConcurrentKBestResultsTest, Test3) {
+  // many threads, with equal keys ordered by value, results do not depend
+  // on the number of threads or shards
+  std::vector<Key> keys = make_keys(20000, 2);
+  for (auto &key : keys) {
+    key.second = 0;
+  }
+  double min_cost = 0.01;
+  double max_cost = 0.9;
+  double cost_tol = 1e-5;
+  for (std::optional<int> k_best : std::vector<std::optional<int>>(
+           {std::nullopt, 1, 7, 100})) {
+    // expected: serial insertion in order of increasing key and value
+    ResultsMap expected;
+    ResultsMap overflow;
+    double expected_max_cost = max_cost;
+    std::vector<Index> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](Index i, Index j) { return keys[i] < keys[j]; });
+    for (Index i : order) {
+      Key const &key = keys[i];
+      if (key.first > (min_cost - cost_tol) &&
+          key.first < expected_max_cost + cost_tol) {
+        expected.emplace(key, i);
+        maintain_k_best_results(k_best, cost_tol, expected, overflow,
+                                get_cost);
+        if (k_best.has_value() && expected.size() == size_t(*k_best)) {
+          expected_max_cost = expected.rbegin()->first.first;
+        }
+      }
+    }
+    while (overflow.size()) {
+      expected.insert(overflow.extract(overflow.begin()));
+    }
+
+    for (Index n_thread : {1, 3, 8}) {
+      for (Index n_shard : {1, 3, 8}) {
+        ConcurrentKBestResults<Key, Index> collector(
+            k_best, min_cost, max_cost, cost_tol, get_cost, n_shard);
+        collector.set_value_less(std::less<Index>());
+        std::vector<std::thread> threads;
+        for (Index t = 0; t < n_thread; ++t) {
+          threads.emplace_back([&, t]() {
+            for (Index i = t; i < Index(keys.size()); i += n_thread) {
+              collector.insert(keys[i], i);
+            }
+          });
+        }
+        for (auto &thread : threads) {
+          thread.join();
+        }
+        ResultsMap results = collector.results();
+        EXPECT_TRUE(std::equal(results.begin(), results.end(),
+                               expected.begin(), expected.end()))
+            << "k_best: " << k_best.value_or(-1) << " n_thread: " << n_thread
+            << " n_shard: " << n_shard;
+      }
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "casm/mapping/LatencyHistogram.hh"
+
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(LatencyHistogramTest, Test1) {
+  // buckets are contiguous and bounded in relative width
+  LatencyHistogram histogram(3);
+  std::uint64_t expected_lower = 0;
+  for (std::uint64_t v = 0; v < 100000; ++v) {
+    histogram.record_nanoseconds(v);
+  }
+  EXPECT_EQ(histogram.count(), 100000);
+  std::uint64_t total = 0;
+  for (Index i = 0; i < histogram.n_bucket(); ++i) {
+    auto range = histogram.bucket_range(i);
+    EXPECT_EQ(range.first, expected_lower);
+    EXPECT_GE(range.second, range.first);
+    EXPECT_LE(double(range.second - range.first), double(range.first) / 8.0);
+    expected_lower = range.second + 1;
+    total += histogram.bucket_count(i);
+  }
+  EXPECT_EQ(total, 100000);
+  EXPECT_GE(expected_lower, 100000);
+}
+
+TEST(LatencyHistogramTest, Test2) {
+  // statistics and percentiles
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.value_at_percentile(50.0), 0.0);
+
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.record(i * 1e-3);
+  }
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_NEAR(histogram.min(), 1e-3, 1e-12);
+  EXPECT_NEAR(histogram.max(), 1.0, 1e-12);
+  EXPECT_NEAR(histogram.mean(), 0.5005, 1e-9);
+  for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    double expected = p * 1e-2;
+    double value = histogram.value_at_percentile(p);
+    EXPECT_GE(value, expected - 1e-12);
+    EXPECT_LE(value, expected * (1.0 + 1.0 / 128.0));
+  }
+  EXPECT_NEAR(histogram.value_at_percentile(100.0), 1.0, 1e-12);
+  EXPECT_NEAR(histogram.value_at_percentile(0.0), 1e-3, 1e-3 / 128.0);
+  EXPECT_THROW(histogram.value_at_percentile(101.0), std::runtime_error);
+
+  // merge
+  LatencyHistogram other;
+  other.record(2.0);
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 1001);
+  EXPECT_NEAR(histogram.max(), 2.0, 1e-12);
+  EXPECT_NEAR(histogram.value_at_percentile(100.0), 2.0, 1e-12);
+  EXPECT_THROW(histogram.merge(LatencyHistogram(3)), std::runtime_error);
+  EXPECT_THROW(LatencyHistogram(0), std::runtime_error);
+}
@@ -3,6 +3,7 @@
 #include "autotools.hh"
 #include "casm/crystallography/Strain.hh"
 #include "casm/crystallography/SymTools.hh"
+#include "casm/mapping/lattice_cost.hh"
 #include "casm/misc/CASM_Eigen_math.hh"
 #include "gtest/gtest.h"
 
@@ -184,6 +185,25 @@ TEST_F(StrainCostTest, ShearTest) {
       << "hexagonal symmetry-breaking cost: " << cost;
 }
 
+TEST_F(StrainCostTest, LowerBoundTest) {
+  // isotropic_strain_cost_lower_bound does not exceed isotropic_strain_cost,
+  // and is equal for isotropic stretch
+  Eigen::Matrix3d R = Eigen::AngleAxisd(0.3, Eigen::Vector3d(1.0, 2.0, 3.0)
+                                                  .normalized())
+                          .toRotationMatrix();
+  for (Eigen::Matrix3d F :
+       {Eigen::Matrix3d(identity()), Eigen::Matrix3d(1.1 * identity()),
+        Eigen::Matrix3d(shear_stretch()), Eigen::Matrix3d(R * shear_stretch()),
+        Eigen::Matrix3d(R * (1.2 * shear_stretch()).inverse())}) {
+    double cost = mapping::isotropic_strain_cost(F);
+    double lower_bound = mapping::isotropic_strain_cost_lower_bound(F);
+    EXPECT_LE(lower_bound, cost + 1e-12);
+    EXPECT_GE(lower_bound, 0.0);
+  }
+  EXPECT_NEAR(mapping::isotropic_strain_cost_lower_bound(1.1 * identity()),
+              0.0, 1e-12);
+}
+
 TEST_F(StrainCostTest, ShearTest2) {
   // shear stretch
   Eigen::Matrix3d Vxy;
@@ -362,3 +382,100 @@ TEST_F(LatticeMapTest, Test2) {
   }
   ASSERT_EQ(N.size(), 15);
 }
+
+TEST(SlabLatticeMapTest, Test1) {
+  // in-plane isotropic expansion and any strain along the fixed direction
+  // have zero slab strain cost if vacuum_strain_weight == 0
+  Eigen::Vector3d a(1., 0., 0.);
+  Eigen::Vector3d b(0., 1., 0.);
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  F(0, 0) = 1.1;
+  F(1, 1) = 1.1;
+  F(2, 2) = 1.5;
+  F(0, 2) = 0.2;
+  EXPECT_TRUE(almost_equal(mapping::slab_strain_cost(F, a, b, 0.0), 0.0));
+  EXPECT_TRUE(mapping::slab_strain_cost(F, a, b, 1.0) > 0.01);
+
+  // invariant to rotation and to which structure is the child/parent
+  F = Eigen::Matrix3d::Identity();
+  F(0, 0) = 1.05;
+  Eigen::Matrix3d Q;
+  Q = Eigen::AngleAxis<double>(0.3, Eigen::Vector3d(1., 2., 3.).normalized());
+  double cost = mapping::slab_strain_cost(F, a, b, 0.0);
+  EXPECT_TRUE(cost > 0.0);
+  EXPECT_TRUE(almost_equal(mapping::slab_strain_cost(Q * F, a, b, 0.0), cost));
+  EXPECT_TRUE(
+      almost_equal(mapping::slab_strain_cost(F.inverse(), a, b, 0.0), cost));
+}
+
+TEST(SlabLatticeMapTest, Test2) {
+  // child is parent with a longer fixed lattice vector, c
+  xtal::Lattice L1_lattice(Eigen::Matrix3d::Identity());
+  Eigen::Matrix3d L2;
+  L2 << 1.0, 0.0, 0.0,  //
+      0.0, 1.0, 0.0,    //
+      0.0, 0.0, 1.2;    //
+  xtal::Lattice L2_lattice(L2);
+  xtal::SymOpVector identity_group({xtal::SymOp::identity()});
+  Index fixed_axis = 2;
+
+  double max_cost = 1e-10;
+  mapping_impl::LatticeMap lattice_map(L1_lattice, L2_lattice, 1,
+                                       identity_group, identity_group,
+                                       max_cost, false, 1e-5, fixed_axis);
+  EXPECT_EQ(lattice_map.cost_method(), "slab_strain_cost");
+
+  // only N that preserve the fixed axis; in-plane N must be one of the 8
+  // signed permutations for zero cost
+  Index count = 0;
+  while (lattice_map) {
+    Eigen::Matrix3d N = lattice_map.matrixN();
+    EXPECT_TRUE(mapping_impl::is_slab_transformation(N, fixed_axis));
+    EXPECT_TRUE(almost_equal(
+        lattice_map.child_matrix(),
+        lattice_map.deformation_gradient() * L1_lattice.lat_column_mat() * N));
+    EXPECT_TRUE(almost_equal(lattice_map.strain_cost(), 0.0));
+    ++count;
+    lattice_map.next_mapping_better_than(max_cost);
+  }
+  EXPECT_EQ(count, 8);
+}
+
+TEST(SlabLatticeMapTest, Test3) {
+  // hexagonal in-plane lattice with a fixed lattice vector, c, that is not
+  // perpendicular to the plane; the child only differs in c
+  Eigen::Matrix3d L1;
+  L1.col(0) << 1.0, 0.0, 0.0;
+  L1.col(1) << -0.5, std::sqrt(3.) / 2., 0.0;
+  L1.col(2) << 0.5, 0.3, 1.0;
+  Eigen::Matrix3d L2 = L1;
+  L2.col(2) << 0.2, 0.1, 1.5;
+
+  // zero in-plane cost, using the plane normal, not c
+  Eigen::Matrix3d F = L2 * L1.inverse();
+  EXPECT_TRUE(almost_equal(
+      mapping::slab_strain_cost(F, L1.col(0), L1.col(1), 0.0), 0.0));
+  EXPECT_TRUE(mapping::slab_strain_cost(F, L1.col(0), L1.col(1), 1.0) > 0.01);
+
+  xtal::Lattice L1_lattice(L1);
+  xtal::Lattice L2_lattice(L2);
+  xtal::SymOpVector identity_group({xtal::SymOp::identity()});
+  Index fixed_axis = 2;
+
+  double max_cost = 1e-10;
+  mapping_impl::LatticeMap lattice_map(L1_lattice, L2_lattice, 1,
+                                       identity_group, identity_group,
+                                       max_cost, false, 1e-5, fixed_axis);
+
+  // the 12 in-plane hexagonal lattice automorphisms, each with the sign
+  // of c giving det(N) == 1
+  Index count = 0;
+  while (lattice_map) {
+    Eigen::Matrix3d N = lattice_map.matrixN();
+    EXPECT_TRUE(mapping_impl::is_slab_transformation(N, fixed_axis));
+    EXPECT_TRUE(almost_equal(lattice_map.strain_cost(), 0.0));
+    ++count;
+    lattice_map.next_mapping_better_than(max_cost);
+  }
+  EXPECT_EQ(count, 12);
+}
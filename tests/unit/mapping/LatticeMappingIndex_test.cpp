@@ -0,0 +1,137 @@
+#include "casm/mapping/LatticeMappingIndex.hh"
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/mapping/LatticeMapping.hh"
+#include "casm/mapping/lattice_cost.hh"
+#include "casm/mapping/map_lattices.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+/// \brief FCC lattice, as columns
+Eigen::Matrix3d fcc_lattice_column_mat() {
+  Eigen::Matrix3d L1;
+  L1 << 0.0, 2.0, 2.0,  //
+      2.0, 0.0, 2.0,    //
+      2.0, 2.0, 0.0;    //
+  return L1;
+}
+
+/// \brief Small deformation gradient
+Eigen::Matrix3d make_F(double e) {
+  Eigen::Matrix3d F;
+  F << 1.0 + e, 0.2 * e, 0.0,  //
+      0.0, 1.0 - e, 0.3 * e,   //
+      0.0, 0.0, 1.0 + 2 * e;   //
+  return F;
+}
+
+}  // namespace
+
+TEST(LatticeMappingIndexTest, Test1) {
+  // nearest entries and candidate lattice mappings
+  Eigen::Matrix3d L1 = fcc_lattice_column_mat();
+  LatticeMappingIndex index{xtal::Lattice(L1)};
+  EXPECT_EQ(index.size(), 0);
+
+  for (Index i = 0; i < 10; ++i) {
+    xtal::Lattice lattice2(make_F(0.01 * i) * L1);
+    int k_best = 1;
+    index.insert(lattice2,
+                 map_lattices(xtal::Lattice(L1), lattice2, std::nullopt, 1,
+                              {}, {}, 0.0, 1e20, "isotropic_strain_cost",
+                              k_best));
+  }
+  EXPECT_EQ(index.size(), 10);
+
+  // query with different lattice vectors
+  Eigen::Matrix3d U;
+  U << 1, 1, 0,  //
+      0, 1, 0,   //
+      0, 0, 1;   //
+  Eigen::Matrix3d F = make_F(0.031);
+  xtal::Lattice lattice2(F * L1 * U);
+
+  auto nearest = index.nearest(lattice2, 2);
+  ASSERT_EQ(nearest.size(), 2);
+  EXPECT_EQ(nearest[0].second, 3);
+  EXPECT_LE(nearest[0].first, nearest[1].first);
+
+  LatticeMappingResults candidates = index.make_candidates(lattice2, 1);
+  ASSERT_GE(candidates.size(), 1);
+  auto const &best = candidates.data[0];
+  EXPECT_TRUE(almost_equal(best.deformation_gradient * L1 *
+                               best.transformation_matrix_to_super *
+                               best.reorientation,
+                           lattice2.lat_column_mat()));
+  EXPECT_NEAR(best.lattice_cost, isotropic_strain_cost(F), 1e-10);
+}
+
+TEST(LatticeMappingIndexTest, Test2) {
+  // map_lattices_warm_start gives the same results as map_lattices
+  Eigen::Matrix3d L1 = fcc_lattice_column_mat();
+  LatticeMappingIndex index{xtal::Lattice(L1)};
+  int k_best = 2;
+  for (Index i = 0; i < 5; ++i) {
+    xtal::Lattice lattice2(make_F(0.02 * i) * L1);
+    index.insert(lattice2,
+                 map_lattices(xtal::Lattice(L1), lattice2, std::nullopt, 1,
+                              {}, {}, 0.0, 1e20, "isotropic_strain_cost",
+                              k_best));
+  }
+
+  xtal::Lattice lattice2(make_F(0.045) * L1);
+  LatticeMappingResults expected =
+      map_lattices(xtal::Lattice(L1), lattice2, std::nullopt, 1, {}, {}, 0.0,
+                   1e20, "isotropic_strain_cost", k_best);
+  LatticeMappingResults results =
+      map_lattices_warm_start(index, lattice2, k_best);
+
+  ASSERT_EQ(results.size(), expected.size());
+  for (Index i = 0; i < results.size(); ++i) {
+    EXPECT_NEAR(results.data[i].lattice_cost, expected.data[i].lattice_cost,
+                1e-10);
+  }
+
+  // empty index: no bound, same results
+  LatticeMappingIndex empty_index{xtal::Lattice(L1)};
+  results = map_lattices_warm_start(empty_index, lattice2, k_best);
+  ASSERT_EQ(results.size(), expected.size());
+}
+
+TEST(LatticeMappingIndexTest, Test3) {
+  // map_lattices_warm_start calculates fewer strain costs than map_lattices
+  Eigen::Matrix3d L1 = fcc_lattice_column_mat();
+  LatticeMappingIndex index{xtal::Lattice(L1)};
+  int k_best = 2;
+  int reorientation_range = 2;
+  for (Index i = 0; i < 5; ++i) {
+    xtal::Lattice lattice2(make_F(0.02 * i) * L1);
+    index.insert(lattice2, map_lattices(xtal::Lattice(L1), lattice2,
+                                        std::nullopt, reorientation_range, {},
+                                        {}, 0.0, 1e20, "isotropic_strain_cost",
+                                        k_best));
+  }
+
+  xtal::Lattice lattice2(make_F(0.045) * L1);
+  Index n_cold = 0;
+  LatticeMappingResults expected = CASM::mapping_impl::map_lattices(
+      xtal::Lattice(L1), lattice2, std::nullopt, reorientation_range, {}, {},
+      0.0, 1e20, "isotropic_strain_cost", k_best, 1e-5, std::nullopt, 0.0,
+      n_cold);
+  Index n_warm = 0;
+  LatticeMappingResults results = CASM::mapping_impl::map_lattices_warm_start(
+      index, lattice2, k_best, std::nullopt, reorientation_range, {}, 0.0,
+      1e20, 1e-5, 1, 1e20, n_warm);
+
+  ASSERT_EQ(results.size(), expected.size());
+  for (Index i = 0; i < results.size(); ++i) {
+    EXPECT_NEAR(results.data[i].lattice_cost, expected.data[i].lattice_cost,
+                1e-10);
+  }
+  EXPECT_GT(n_warm, 0);
+  EXPECT_LT(n_warm, n_cold);
+}
@@ -1,5 +1,7 @@
 #include "casm/mapping/MappingSearch.hh"
 
+#include <unordered_set>
+
 #include "SearchTestData.hh"
 #include "casm/crystallography/SimpleStructure.hh"
 #include "casm/crystallography/StrainConverter.hh"
@@ -61,6 +63,21 @@ jsonParser &_to_json(murty::Node const &assignment_node, jsonParser &json) {
   return json;
 }
 
+/// \brief Expect exactly equal costs, permutations, and displacements
+void expect_same_results(StructureMappingResults const &results,
+                         StructureMappingResults const &expected) {
+  ASSERT_EQ(results.size(), expected.size());
+  auto it = results.begin();
+  auto expected_it = expected.begin();
+  for (; it != results.end(); ++it, ++expected_it) {
+    EXPECT_EQ(it->total_cost, expected_it->total_cost);
+    EXPECT_EQ(it->atom_mapping.permutation,
+              expected_it->atom_mapping.permutation);
+    EXPECT_EQ(it->atom_mapping.displacement,
+              expected_it->atom_mapping.displacement);
+  }
+}
+
 }  // namespace test
 
 // Test perfect BCC mapping to BCC
@@ -432,3 +449,663 @@ TEST(MappingSearchTest, Test4) {
     std::cout << json << std::endl;
   }
 }
+
+// Test MappingSearch with the built-in cost functors, which are called
+// directly, gives the same results as with wrapped cost functions
+TEST(MappingSearchTest, Test5) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T * N = L2
+  Eigen::Matrix3d Q;
+  Q = Eigen::AngleAxis<double>(M_PI / 8., Eigen::Vector3d::UnitZ());
+  Eigen::Matrix3d U;
+  U << 1.01, 0., 0.,  //
+      0., 1., 0.,     //
+      0., 0., 1.;     //
+  Eigen::Matrix3d F = Q * U;
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+  Eigen::Matrix3d N = Eigen::Matrix3d::Identity();
+
+  // F (r1_supercell[i] + disp) = r2[perm[i]] + trans
+  // structure1_supercell_atom_type[i] = structure2_atom_type[perm[i]]
+  Eigen::MatrixXd disp = Eigen::MatrixXd::Zero(3, 7);
+  disp.col(0) << 0.01, -0.01, 0.01;
+  disp.col(1) << 0.00, 0.01, -0.01;
+  disp.col(2) << 0.01, 0.00, -0.01;
+  disp.col(3) << -0.01, 0.01, 0.0;
+  disp.col(4) << -0.01, 0.00, 0.01;
+  disp.col(5) << 0.0, 0.00, -0.01;
+  disp.col(6) << 0.01, 0.00, 0.0;
+  std::vector<Index> perm;
+  std::vector<std::string> structure1_supercell_atom_type;
+  for (Index i = 0; i < 7; ++i) {
+    perm.push_back(i);
+    structure1_supercell_atom_type.push_back("A");
+  }
+  Eigen::Vector3d trans(0., 0., 0.);
+
+  test::SearchTestData d(test::make_search_prim_binary_vacancy_BCC(latparam_a),
+                         F, T, N, disp, structure1_supercell_atom_type, perm,
+                         trans);
+
+  auto lattice_mapping_data = std::make_shared<LatticeMappingSearchData const>(
+      d.prim_data, d.structure_data, d.lattice_mapping);
+
+  // MappingSearch parameters
+  double min_cost = 0.0;
+  double max_cost = 1e20;
+  int k_best = 10;
+  double lattice_cost_weight = 0.5;
+  bool enable_remove_mean_displacement = true;
+  double infinity = 1e20;
+  double cost_tol = 1e-5;
+
+  // wrapping the cost functions in lambdas disables calling them directly
+  AtomCostFunction wrapped_atom_cost_f =
+      [](LatticeMappingSearchData const &lattice_mapping_data,
+         AtomMappingSearchData const &atom_mapping_data,
+         AtomMapping const &atom_mapping) {
+        return IsotropicAtomCost()(lattice_mapping_data, atom_mapping_data,
+                                   atom_mapping);
+      };
+  TotalCostFunction wrapped_total_cost_f =
+      [=](double lattice_cost,
+          LatticeMappingSearchData const &lattice_mapping_data,
+          double atom_cost, AtomMappingSearchData const &atom_mapping_data,
+          AtomMapping const &atom_mapping) {
+        return WeightedTotalCost(lattice_cost_weight)(
+            lattice_cost, lattice_mapping_data, atom_cost, atom_mapping_data,
+            atom_mapping);
+      };
+  AtomToSiteCostFunction wrapped_atom_to_site_cost_f =
+      [](Eigen::Vector3d const &displacement, std::string const &atom_type,
+         std::vector<std::string> const &allowed_atom_types,
+         double infinity) {
+        return make_atom_to_site_cost(displacement, atom_type,
+                                      allowed_atom_types, infinity);
+      };
+  MappingSearch search(min_cost, max_cost, k_best, wrapped_atom_cost_f,
+                       wrapped_total_cost_f, wrapped_atom_to_site_cost_f,
+                       enable_remove_mean_displacement, infinity, cost_tol);
+  MappingSearch isotropic_search(
+      min_cost, max_cost, k_best, IsotropicAtomCost(),
+      WeightedTotalCost(lattice_cost_weight), AtomToSiteCost(),
+      enable_remove_mean_displacement, infinity, cost_tol);
+
+  double lattice_cost = isotropic_strain_cost(F);
+  Eigen::Vector3d trial_translation_cart(0., 0., 0.);
+  search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                      trial_translation_cart);
+  isotropic_search.make_and_insert_mapping_node(
+      lattice_cost, lattice_mapping_data, trial_translation_cart);
+
+  QueueConstraints queue_constraints(std::nullopt, std::nullopt, 100);
+  for (Index i = 0; i < 5; ++i) {
+    EXPECT_EQ(search.size(), isotropic_search.size());
+    if (!search.size()) {
+      break;
+    }
+    EXPECT_TRUE(almost_equal(search.front().total_cost,
+                             isotropic_search.front().total_cost));
+    search.partition();
+    isotropic_search.partition();
+    queue_constraints(search);
+    queue_constraints(isotropic_search);
+  }
+
+  auto results = combined_results(search);
+  auto isotropic_results = combined_results(isotropic_search);
+  ASSERT_EQ(results.size(), isotropic_results.size());
+  auto it = results.begin();
+  auto isotropic_it = isotropic_results.begin();
+  for (; it != results.end(); ++it, ++isotropic_it) {
+    EXPECT_TRUE(almost_equal(it->total_cost, isotropic_it->total_cost));
+    EXPECT_TRUE(almost_equal(it->atom_cost, isotropic_it->atom_cost));
+  }
+}
+
+// Test duplicate MappingNode elimination
+TEST(MappingSearchTest, Test6) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_BCC(latparam_a), F, T,
+      test::make_small_displacements(8, 2));
+
+  double lattice_cost = isotropic_strain_cost(F);
+  Eigen::Vector3d trial_translation_cart(0., 0., 0.);
+  // equivalent trial translation, by a supercell lattice vector
+  Eigen::Vector3d equiv_trial_translation_cart =
+      lattice_mapping_data->supercell_lattice.lat_column_mat().col(0);
+
+  for (bool enable_duplicate_elimination : {false, true}) {
+    MappingSearch search(0.0, 1e20, 1, IsotropicAtomCost(),
+                         WeightedTotalCost(0.5), make_atom_to_site_cost, false,
+                         1e20, 1e-5, enable_duplicate_elimination);
+    search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                        trial_translation_cart);
+    search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                        equiv_trial_translation_cart);
+    EXPECT_EQ(search.statistics.n_mapping_node, 2);
+    if (enable_duplicate_elimination) {
+      EXPECT_EQ(search.size(), 1);
+      EXPECT_EQ(search.statistics.n_duplicate_mapping_node, 1);
+      EXPECT_EQ(search.mapping_node_keys.size(), 1);
+    } else {
+      EXPECT_EQ(search.size(), 2);
+      EXPECT_EQ(search.statistics.n_duplicate_mapping_node, 0);
+      EXPECT_EQ(search.mapping_node_keys.size(), 0);
+    }
+  }
+}
+
+// Test atom cost from the displacement moment, and early rejection of
+// sub-assignments that exceed max_cost
+TEST(MappingSearchTest, Test7) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d Q;
+  Q = Eigen::AngleAxis<double>(M_PI / 8., Eigen::Vector3d::UnitZ());
+  Eigen::Matrix3d U;
+  U << 1.01, 0.01, 0.,  //
+      0.01, 1., 0.,     //
+      0., 0., 0.99;     //
+  Eigen::Matrix3d F = Q * U;
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_vacancy_BCC(latparam_a), F, T,
+      test::make_small_displacements(7, 7));
+  Eigen::Vector3d trial_translation_cart(0., 0., 0.);
+  AtomMappingSearchData atom_mapping_data(lattice_mapping_data,
+                                          trial_translation_cart);
+
+  // displacement moment and atom cost, for a non-optimal assignment
+  std::vector<Index> assignment({1, 0, 2, 3, 4, 5, 6, 7});
+  for (bool enable_remove_mean_displacement : {false, true}) {
+    AtomMapping atom_mapping = mapping_impl::make_atom_mapping_from_assignment(
+        assignment, atom_mapping_data.site_displacements,
+        atom_mapping_data.trial_translation_cart,
+        lattice_mapping_data->lattice_mapping.deformation_gradient,
+        enable_remove_mean_displacement);
+    auto moment = mapping_impl::make_displacement_moment_from_assignment(
+        assignment, atom_mapping_data.site_displacements,
+        enable_remove_mean_displacement);
+    Eigen::Matrix3d expected_moment =
+        atom_mapping.displacement * atom_mapping.displacement.transpose();
+    EXPECT_TRUE(almost_equal(moment.second, expected_moment, 1e-12));
+
+    Eigen::Matrix3d L1 =
+        lattice_mapping_data->prim_data->prim_lattice.lat_column_mat();
+    LatticeMapping const &lattice_mapping =
+        lattice_mapping_data->lattice_mapping;
+    Eigen::Matrix3d S1 = L1 * T;
+    Eigen::Matrix3d L2 = lattice_mapping.right_stretch * S1;
+    Eigen::MatrixXd d_reverse =
+        -lattice_mapping.right_stretch * atom_mapping.displacement;
+    double expected_atom_cost =
+        (make_geometric_atom_cost(S1, atom_mapping.displacement) +
+         make_geometric_atom_cost(L2, d_reverse)) /
+        2.;
+    EXPECT_TRUE(almost_equal(
+        make_isotropic_atom_cost(L1, lattice_mapping, moment.second,
+                                 assignment.size()),
+        expected_atom_cost, 1e-12));
+    EXPECT_TRUE(almost_equal(
+        make_isotropic_atom_cost(L1, lattice_mapping,
+                                 atom_mapping.displacement),
+        expected_atom_cost, 1e-12));
+  }
+
+  // sub-assignments exceeding max_cost are rejected without constructing
+  // MappingNode, with the same results as when they are constructed
+  double min_cost = 0.0;
+  double max_cost = 0.002;
+  int k_best = 10;
+  double lattice_cost_weight = 0.5;
+  bool enable_remove_mean_displacement = true;
+  double infinity = 1e20;
+  double cost_tol = 1e-5;
+
+  // wrapping the atom cost in a lambda disables early rejection
+  AtomCostFunction wrapped_atom_cost_f =
+      [](LatticeMappingSearchData const &lattice_mapping_data,
+         AtomMappingSearchData const &atom_mapping_data,
+         AtomMapping const &atom_mapping) {
+        return IsotropicAtomCost()(lattice_mapping_data, atom_mapping_data,
+                                   atom_mapping);
+      };
+  MappingSearch search(min_cost, max_cost, k_best, wrapped_atom_cost_f,
+                       WeightedTotalCost(lattice_cost_weight),
+                       make_atom_to_site_cost, enable_remove_mean_displacement,
+                       infinity, cost_tol);
+  MappingSearch isotropic_search(
+      min_cost, max_cost, k_best, IsotropicAtomCost(),
+      WeightedTotalCost(lattice_cost_weight), AtomToSiteCost(),
+      enable_remove_mean_displacement, infinity, cost_tol);
+
+  double lattice_cost = isotropic_strain_cost(F);
+  search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                      trial_translation_cart);
+  isotropic_search.make_and_insert_mapping_node(
+      lattice_cost, lattice_mapping_data, trial_translation_cart);
+  while (search.size() || isotropic_search.size()) {
+    search.partition();
+    isotropic_search.partition();
+  }
+  EXPECT_EQ(search.statistics.n_mapping_node,
+            isotropic_search.statistics.n_mapping_node);
+
+  auto results = combined_results(search);
+  auto isotropic_results = combined_results(isotropic_search);
+  ASSERT_EQ(results.size(), isotropic_results.size());
+  auto it = results.begin();
+  auto isotropic_it = isotropic_results.begin();
+  for (; it != results.end(); ++it, ++isotropic_it) {
+    EXPECT_TRUE(almost_equal(it->total_cost, isotropic_it->total_cost));
+    EXPECT_EQ(it->atom_mapping.permutation,
+              isotropic_it->atom_mapping.permutation);
+  }
+}
+
+// Test that spilling the queue to a temporary file gives the same search
+// as holding the queue in memory
+TEST(MappingSearchTest, Test8) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_vacancy_BCC(latparam_a), F, T,
+      test::make_small_displacements(7, 4));
+  double lattice_cost = isotropic_strain_cost(F);
+
+  auto run = [&](std::optional<Index> max_queue_memory_size,
+                 std::vector<double> &front_cost,
+                 MappingSearchStatistics &statistics) {
+    MappingSearch search(0.0, 1e20, 40, IsotropicAtomCost(),
+                         WeightedTotalCost(0.5), make_atom_to_site_cost);
+    if (max_queue_memory_size.has_value()) {
+      search.enable_queue_spill(*max_queue_memory_size);
+    }
+    QueueConstraints queue_constraints(std::nullopt, std::nullopt, 200);
+    auto results = test::run_mapping_search(
+        search, lattice_cost, lattice_mapping_data,
+        make_trial_translations(*lattice_mapping_data), 100,
+        [&](MappingSearch &search) {
+          queue_constraints(search);
+          front_cost.push_back(search.front().total_cost);
+          front_cost.push_back(search.back().total_cost);
+        });
+    statistics = search.statistics;
+    return results;
+  };
+
+  std::vector<double> expected_front_cost;
+  MappingSearchStatistics expected_statistics;
+  auto expected = run(std::nullopt, expected_front_cost, expected_statistics);
+  EXPECT_EQ(expected_statistics.queue_spill.n_spilled_mapping_node, 0);
+
+  for (Index max_queue_memory_size : {1, 10}) {
+    std::vector<double> front_cost;
+    MappingSearchStatistics statistics;
+    auto results = run(max_queue_memory_size, front_cost, statistics);
+    EXPECT_GT(statistics.queue_spill.n_spilled_mapping_node, 0);
+    EXPECT_GT(statistics.queue_spill.n_bytes_written, 0);
+    EXPECT_EQ(statistics.n_mapping_node, expected_statistics.n_mapping_node);
+    EXPECT_EQ(front_cost, expected_front_cost);
+    test::expect_same_results(results, expected);
+  }
+}
+
+TEST(MappingSearchTest, Test9) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_vacancy_BCC(latparam_a), F, T,
+      test::make_small_displacements(7, 4));
+  double lattice_cost = isotropic_strain_cost(F);
+  auto trial_translations = make_trial_translations(*lattice_mapping_data);
+
+  auto run = [&](std::optional<Index> max_n_bytes,
+                 std::optional<Index> max_queue_memory_size,
+                 MappingSearchStatistics &statistics) {
+    MappingSearch search(0.0, 1e20, 40, IsotropicAtomCost(),
+                         WeightedTotalCost(0.5), make_atom_to_site_cost);
+    if (max_n_bytes.has_value()) {
+      search.enable_atom_mapping_data_cache(*max_n_bytes);
+    }
+    if (max_queue_memory_size.has_value()) {
+      search.enable_queue_spill(*max_queue_memory_size);
+    }
+    auto results = test::run_mapping_search(
+        search, lattice_cost, lattice_mapping_data, trial_translations, 100,
+        [&](MappingSearch &search) {
+          if (max_n_bytes.has_value()) {
+            for (auto const &node : search.queue) {
+              EXPECT_TRUE(node.atom_mapping_data == nullptr);
+            }
+          }
+        });
+    statistics = search.statistics;
+    return results;
+  };
+
+  MappingSearchStatistics expected_statistics;
+  auto expected = run(std::nullopt, std::nullopt, expected_statistics);
+  EXPECT_EQ(expected_statistics.atom_mapping_data_cache.n_miss, 0);
+
+  // max_n_bytes=0 keeps only the most recently used data
+  for (Index max_n_bytes : {Index(0), Index(1) << 30}) {
+    for (std::optional<Index> max_queue_memory_size :
+         std::vector<std::optional<Index>>({std::nullopt, 5})) {
+      MappingSearchStatistics statistics;
+      auto results = run(max_n_bytes, max_queue_memory_size, statistics);
+      auto const &cache = statistics.atom_mapping_data_cache;
+      Index n_trial = trial_translations.size();
+      if (max_n_bytes == 0 && n_trial > 1) {
+        EXPECT_GT(cache.n_evicted, 0);
+        EXPECT_GT(cache.n_miss, n_trial);
+      } else {
+        EXPECT_EQ(cache.n_evicted, 0);
+        EXPECT_EQ(cache.n_miss, n_trial);
+      }
+      EXPECT_EQ(statistics.n_mapping_node, expected_statistics.n_mapping_node);
+      test::expect_same_results(results, expected);
+    }
+  }
+}
+
+// Test that batched atom-to-site and atom cost functions give the same
+// search as the per-element cost functions
+TEST(MappingSearchTest, Test10) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d Q;
+  Q = Eigen::AngleAxis<double>(M_PI / 8., Eigen::Vector3d::UnitZ());
+  Eigen::Matrix3d U;
+  U << 1.01, 0., 0.,  //
+      0., 1., 0.,     //
+      0., 0., 1.;     //
+  Eigen::Matrix3d F = Q * U;
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_vacancy_BCC(latparam_a), F, T,
+      test::make_small_displacements(7, 7));
+  double lattice_cost = isotropic_strain_cost(F);
+  Eigen::Vector3d trial_translation_cart(0., 0., 0.);
+
+  // equivalent to make_atom_to_site_cost, for all atoms and sites
+  Index n_cost_matrix_call = 0;
+  AtomToSiteCostMatrix atom_to_site_cost_f(
+      [&](AtomToSiteCostBatch const &batch, double infinity) {
+        n_cost_matrix_call += 1;
+        Eigen::MatrixXd cost(batch.N_site, batch.N_atom);
+        for (Index i = 0; i < batch.N_site; ++i) {
+          for (Index j = 0; j < batch.N_atom; ++j) {
+            int k = batch.atom_type_index(j);
+            if (xtal::is_vacancy(batch.atom_type_names[k])) {
+              bool vacancy_allowed = false;
+              for (Index l = 0; l < batch.atom_type_names.size(); ++l) {
+                if (batch.site_allowed(i, l) &&
+                    xtal::is_vacancy(batch.atom_type_names[l])) {
+                  vacancy_allowed = true;
+                }
+              }
+              cost(i, j) = vacancy_allowed ? 0.0 : infinity;
+            } else if (!batch.site_allowed(i, k)) {
+              cost(i, j) = infinity;
+            } else {
+              cost(i, j) =
+                  batch.displacement.col(i * batch.N_atom + j).squaredNorm();
+            }
+          }
+        }
+        return cost;
+      });
+
+  Index n_atom_cost_call = 0;
+  Index n_atom_cost = 0;
+  BatchAtomCost atom_cost_f(
+      [&](LatticeMappingSearchData const &lattice_mapping_data,
+          AtomMappingSearchData const &atom_mapping_data,
+          std::vector<AtomMapping> const &atom_mappings) {
+        n_atom_cost_call += 1;
+        n_atom_cost += atom_mappings.size();
+        Eigen::VectorXd atom_cost(atom_mappings.size());
+        for (Index i = 0; i < atom_mappings.size(); ++i) {
+          atom_cost(i) = IsotropicAtomCost()(
+              lattice_mapping_data, atom_mapping_data, atom_mappings[i]);
+        }
+        return atom_cost;
+      });
+
+  AtomMappingSearchData atom_mapping_data(
+      lattice_mapping_data, trial_translation_cart, make_atom_to_site_cost,
+      1e20);
+  AtomMappingSearchData batch_atom_mapping_data(
+      lattice_mapping_data, trial_translation_cart, atom_to_site_cost_f,
+      1e20);
+  EXPECT_EQ(n_cost_matrix_call, 1);
+  EXPECT_TRUE(almost_equal(batch_atom_mapping_data.cost_matrix,
+                           atom_mapping_data.cost_matrix));
+
+  MappingSearch search(0.0, 1e20, 10, IsotropicAtomCost(),
+                       WeightedTotalCost(0.5), make_atom_to_site_cost);
+  MappingSearch batch_search(0.0, 1e20, 10, atom_cost_f,
+                             WeightedTotalCost(0.5), atom_to_site_cost_f);
+  search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                      trial_translation_cart);
+  batch_search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                            trial_translation_cart);
+  EXPECT_EQ(n_cost_matrix_call, 2);
+  EXPECT_EQ(n_atom_cost_call, 1);
+
+  Index n_partition = 0;
+  for (Index i = 0; i < 5 && search.size(); ++i) {
+    EXPECT_EQ(search.size(), batch_search.size());
+    auto sub_nodes = search.partition();
+    auto batch_sub_nodes = batch_search.partition();
+    EXPECT_EQ(sub_nodes.size(), batch_sub_nodes.size());
+    if (batch_sub_nodes.size()) {
+      n_partition += 1;
+    }
+  }
+  EXPECT_EQ(n_atom_cost_call, 1 + n_partition);
+  EXPECT_EQ(n_atom_cost, batch_search.statistics.n_mapping_node);
+
+  auto results = combined_results(search);
+  auto batch_results = combined_results(batch_search);
+  ASSERT_EQ(results.size(), batch_results.size());
+  auto it = results.begin();
+  auto batch_it = batch_results.begin();
+  for (; it != results.end(); ++it, ++batch_it) {
+    EXPECT_TRUE(almost_equal(it->total_cost, batch_it->total_cost));
+    EXPECT_EQ(it->atom_mapping.permutation,
+              batch_it->atom_mapping.permutation);
+  }
+}
+
+// Test that, with duplicate elimination, MappingSearch results contain no
+// duplicates, and only keys of MappingNode inserted in results are kept
+// once the queue is empty
+TEST(MappingSearchTest, Test11) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_BCC(latparam_a), F, T,
+      test::make_small_displacements(8, 2));
+
+  double lattice_cost = isotropic_strain_cost(F);
+  Eigen::Vector3d trial_translation_cart(0., 0., 0.);
+  // equivalent trial translation, by a supercell lattice vector
+  Eigen::Vector3d equiv_trial_translation_cart =
+      lattice_mapping_data->supercell_lattice.lat_column_mat().col(0);
+
+  EXPECT_FALSE(MappingSearch().enable_duplicate_elimination);
+  MappingSearch search(0.0, 1e20, 20, IsotropicAtomCost(),
+                       WeightedTotalCost(0.5), make_atom_to_site_cost, true,
+                       1e20, 1e-5, true);
+  search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                      trial_translation_cart);
+  search.make_and_insert_mapping_node(lattice_cost, lattice_mapping_data,
+                                      equiv_trial_translation_cart);
+  while (search.size()) {
+    search.partition();
+  }
+  EXPECT_GE(search.statistics.n_duplicate_mapping_node, 1);
+  for (auto const &pair : search.mapping_node_keys) {
+    EXPECT_TRUE(pair.second);
+  }
+  EXPECT_LT(search.mapping_node_keys.size(),
+            search.statistics.n_mapping_node);
+
+  auto results = combined_results(search);
+  EXPECT_GE(results.size(), 20);
+  std::unordered_set<MappingNodeKey, MappingNodeKeyHash> keys;
+  for (auto const &result : results) {
+    EXPECT_TRUE(keys
+                    .insert(make_mapping_node_key(
+                        *lattice_mapping_data, result.atom_mapping.permutation,
+                        result.atom_mapping.translation))
+                    .second);
+  }
+}
+
+TEST(MappingSearchTest, Test12) {
+  // MappingQueueSpill re-uses the space of removed MappingNode and reads
+  // several MappingNode in order of increasing total cost
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity() * 2;
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      test::make_search_prim_binary_BCC(latparam_a), F, T,
+      test::make_small_displacements(8, 0));
+
+  murty::Node assignment_node = murty::make_node(Eigen::MatrixXd::Zero(8, 8));
+  for (Index i = 0; i < 8; ++i) {
+    assignment_node.sub_assignment.emplace(i, i);
+  }
+  auto make_spilled = [&](double total_cost) {
+    return SpilledMappingNode{0.0,
+                              lattice_mapping_data,
+                              total_cost,
+                              Eigen::Vector3d::Zero(),
+                              assignment_node,
+                              total_cost};
+  };
+
+  MappingQueueSpill queue_spill;
+  for (double total_cost : {3.0, 1.0, 2.0, 0.0}) {
+    queue_spill.push_back(make_spilled(total_cost));
+  }
+  Index n_bytes_file = queue_spill.statistics.max_n_bytes_file;
+  EXPECT_EQ(n_bytes_file, queue_spill.statistics.n_bytes_written);
+  EXPECT_EQ(queue_spill.back().total_cost, 3.0);
+
+  std::vector<SpilledMappingNode> nodes = queue_spill.pop_front(2);
+  ASSERT_EQ(nodes.size(), 2);
+  EXPECT_EQ(nodes[0].total_cost, 0.0);
+  EXPECT_EQ(nodes[1].total_cost, 1.0);
+  EXPECT_EQ(nodes[1].assignment_node.sub_assignment,
+            assignment_node.sub_assignment);
+  EXPECT_EQ(nodes[1].assignment_node.unassigned_rows.size(), 8);
+
+  // records of equal size fit in the freed space
+  for (double total_cost : {5.0, 4.0}) {
+    queue_spill.push_back(make_spilled(total_cost));
+  }
+  EXPECT_EQ(queue_spill.statistics.max_n_bytes_file, n_bytes_file);
+
+  nodes = queue_spill.pop_front(10);
+  ASSERT_EQ(nodes.size(), 4);
+  for (Index i = 0; i < 4; ++i) {
+    EXPECT_EQ(nodes[i].total_cost, 2.0 + i);
+  }
+  EXPECT_EQ(queue_spill.size(), 0);
+  EXPECT_EQ(queue_spill.statistics.n_reloaded_mapping_node, 6);
+}
+
+// Test that structure symmetry reduction skips trial translations without
+// changing the costs found
+TEST(MappingSearchTest, Test13) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity();
+
+  // prim without symmetry, so only the structure's internal
+  // translations can be used to skip translations
+  auto prim_data = std::make_shared<PrimSearchData const>(
+      test::make_search_prim_binary_conventional_BCC(latparam_a)->prim,
+      std::vector<SymOp>({SymOp::identity()}));
+
+  auto lattice_mapping_data = test::make_lattice_mapping_search_data(
+      prim_data, F, T, test::make_small_displacements(2, 0));
+  double lattice_cost = isotropic_strain_cost(F);
+
+  auto run = [&](bool enable_structure_symmetry_reduction,
+                 MappingSearchStatistics &statistics) {
+    MappingSearch search(0.0, 1e20, 10, IsotropicAtomCost(),
+                         WeightedTotalCost(0.5), make_atom_to_site_cost, true,
+                         1e20, 1e-5, false,
+                         enable_structure_symmetry_reduction);
+    EXPECT_EQ(search.enable_structure_symmetry_reduction,
+              enable_structure_symmetry_reduction);
+    search.make_and_insert_mapping_nodes(lattice_cost, lattice_mapping_data);
+    while (search.size()) {
+      search.partition();
+    }
+    statistics = search.statistics;
+    return combined_results(search);
+  };
+
+  // distinct costs, in increasing order
+  auto distinct_costs = [](StructureMappingResults const &results) {
+    std::vector<double> costs;
+    for (auto const &result : results) {
+      if (costs.empty() || result.total_cost > costs.back() + 1e-5) {
+        costs.push_back(result.total_cost);
+      }
+    }
+    return costs;
+  };
+
+  MappingSearchStatistics expected_statistics;
+  auto expected = run(false, expected_statistics);
+  EXPECT_EQ(expected.size(), 4);
+
+  MappingSearchStatistics statistics;
+  auto results = run(true, statistics);
+  EXPECT_EQ(results.size(), 2);
+  EXPECT_LT(statistics.n_mapping_node, expected_statistics.n_mapping_node);
+
+  std::vector<double> expected_costs = distinct_costs(expected);
+  std::vector<double> costs = distinct_costs(results);
+  ASSERT_EQ(costs.size(), expected_costs.size());
+  EXPECT_NEAR(costs[0], 0.0, 1e-10);
+  for (Index i = 0; i < costs.size(); ++i) {
+    EXPECT_NEAR(costs[i], expected_costs[i], 1e-10);
+  }
+}
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "casm/crystallography/BasicStructureTools.hh"
 #include "casm/crystallography/SimpleStructureTools.hh"
 #include "casm/mapping/SearchData.hh"
@@ -128,3 +130,71 @@ TEST(PrimSearchDataTest, Test3) {
     EXPECT_TRUE(almost_equal(modes[0], expected));
   }
 }
+
+TEST(PrimSearchDataTest, Test4) {
+  // symmetry-invariant displacement modes are generated once, on first
+  // access
+  auto s =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  auto prim_data = std::make_shared<PrimSearchData const>(s);
+  EXPECT_EQ(prim_data->prim_sym_invariant_displacement_modes.has_value(), true);
+
+  std::vector<std::vector<Eigen::MatrixXd> const *> results(4, nullptr);
+  std::vector<std::thread> threads;
+  for (Index i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      results[i] = &*prim_data->prim_sym_invariant_displacement_modes;
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  for (auto const *result : results) {
+    EXPECT_EQ(result, &*prim_data->prim_sym_invariant_displacement_modes);
+  }
+  EXPECT_EQ(prim_data->prim_sym_invariant_displacement_modes->size(), 0);
+}
+
+TEST(PrimSearchDataTest, Test5) {
+  // override_prim_factor_group and disabled symmetry-breaking atom cost
+  auto s =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  std::vector<xtal::SymOp> override_prim_factor_group(
+      {xtal::SymOp::identity()});
+  bool enable_symmetry_breaking_atom_cost = false;
+  auto prim_data = std::make_shared<PrimSearchData const>(
+      s, override_prim_factor_group, enable_symmetry_breaking_atom_cost);
+
+  EXPECT_EQ(prim_data->prim_factor_group.size(), 1);
+  EXPECT_EQ(prim_data->prim_crystal_point_group.size(), 1);
+  EXPECT_EQ(prim_data->prim_sym_invariant_displacement_modes.has_value(),
+            false);
+  EXPECT_THROW(prim_data->prim_sym_invariant_displacement_modes.value(),
+               std::bad_optional_access);
+
+  EXPECT_THROW(PrimSearchData(s, std::vector<xtal::SymOp>{}),
+               std::runtime_error);
+}
+
+TEST(PrimSearchDataTest, Test6) {
+  // copies remain valid after the original is destroyed, whether or not
+  // the symmetry-invariant displacement modes were generated before copying
+  auto s =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  auto prim_data = std::make_unique<PrimSearchData>(s);
+  PrimSearchData copy_before(*prim_data);
+  auto const &modes = *prim_data->prim_sym_invariant_displacement_modes;
+  PrimSearchData copy_after(*prim_data);
+  std::vector<Eigen::MatrixXd> expected = modes;
+  prim_data.reset();
+
+  EXPECT_EQ(copy_before.prim_factor_group.size(), 48);
+  EXPECT_EQ(copy_before.prim_sym_invariant_displacement_modes.has_value(),
+            true);
+  EXPECT_EQ(copy_before.prim_sym_invariant_displacement_modes->size(),
+            expected.size());
+  EXPECT_EQ(copy_after.prim_sym_invariant_displacement_modes->size(),
+            expected.size());
+  EXPECT_NE(&*copy_before.prim_sym_invariant_displacement_modes,
+            &*copy_after.prim_sym_invariant_displacement_modes);
+}
@@ -336,6 +336,75 @@ TEST_F(StrucMapperTest, MapIdealStruc0) {
   assert_mapping_relations(mappings, mapper, child);
 }
 
+TEST_F(StrucMapperTest, MapDeformedStrucImposeLatticeVols1) {
+  // The child lattice is an exact superlattice of the parent lattice, so the
+  // k-best mapping cost is bounded by mapping to it first. Check that the
+  // results are the same as without the bound.
+  mapping_impl::StrucMapper mapper(calculator, lattice_weight,
+                                   max_volume_change, robust, soft_va_limit,
+                                   cost_tol, min_va_frac, max_va_frac);
+  EXPECT_TRUE(mapper.ideal_lattice_bound());
+
+  Index min_vol = 1;
+  Index max_vol = 4;
+  Index k = 6;
+  std::set<mapping_impl::MappingNode> mappings =
+      mapper.map_deformed_struc_impose_lattice_vols(
+          child, min_vol, max_vol, k, max_cost, min_cost, keep_invalid,
+          child_factor_group);
+
+  mapper.set_ideal_lattice_bound(false);
+  std::set<mapping_impl::MappingNode> expected =
+      mapper.map_deformed_struc_impose_lattice_vols(
+          child, min_vol, max_vol, k, max_cost, min_cost, keep_invalid,
+          child_factor_group);
+
+  ASSERT_EQ(mappings.size(), expected.size());
+  auto it = mappings.begin();
+  for (auto const &expected_node : expected) {
+    EXPECT_NEAR(it->cost, expected_node.cost, cost_tol);
+    EXPECT_NEAR(it->lattice_node.cost, expected_node.lattice_node.cost,
+                cost_tol);
+    ++it;
+  }
+  assert_mapping_relations(mappings, mapper, child);
+}
+
+TEST_F(StrucMapperTest, MapDeformedStrucImposeLatticeVols2) {
+  // The child is an ideal superstructure, so the best mapping to the ideal
+  // superlattice has zero cost. Check that mappings to other lattices that
+  // are tied with it are still found, as without the bound.
+  mapping_impl::StrucMapper mapper(calculator, lattice_weight,
+                                   max_volume_change, robust, soft_va_limit,
+                                   cost_tol, min_va_frac, max_va_frac);
+
+  Index min_vol = 1;
+  Index max_vol = 4;
+  Index k = 1;
+  std::set<mapping_impl::MappingNode> mappings =
+      mapper.map_deformed_struc_impose_lattice_vols(
+          child, min_vol, max_vol, k, max_cost, min_cost, keep_invalid,
+          child_factor_group);
+
+  mapper.set_ideal_lattice_bound(false);
+  std::set<mapping_impl::MappingNode> expected =
+      mapper.map_deformed_struc_impose_lattice_vols(
+          child, min_vol, max_vol, k, max_cost, min_cost, keep_invalid,
+          child_factor_group);
+
+  ASSERT_FALSE(mappings.empty());
+  EXPECT_NEAR(mappings.begin()->cost, 0.0, cost_tol);
+  ASSERT_EQ(mappings.size(), expected.size());
+  auto it = mappings.begin();
+  for (auto const &expected_node : expected) {
+    EXPECT_NEAR(it->cost, expected_node.cost, cost_tol);
+    EXPECT_NEAR(it->lattice_node.cost, expected_node.lattice_node.cost,
+                cost_tol);
+    ++it;
+  }
+  assert_mapping_relations(mappings, mapper, child);
+}
+
 // \brief Confirm that the MappingNode maps the unmapped child to the mapped
 // child constructed by `mapper.resolve_setting` as expected
 void assert_mapping_relations(
@@ -0,0 +1,107 @@
+#include "casm/mapping/StructureSimilarityMatrix.hh"
+
+#include <cmath>
+#include <limits>
+
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/SimpleStructureTools.hh"
+#include "casm/mapping/StructureMapping.hh"
+#include "casm/mapping/map_structures.hh"
+#include "gtest/gtest.h"
+#include "teststructures.hh"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+/// \brief Tetragonal structure, with n_site sites along c, each occupied
+///     by `atom_name` only
+std::shared_ptr<xtal::BasicStructure const> make_tetragonal(
+    double a, double c, Index n_site, std::string atom_name) {
+  using namespace xtal;
+  Lattice lattice(Eigen::Vector3d(a, 0.0, 0.0), Eigen::Vector3d(0.0, a, 0.0),
+                  Eigen::Vector3d(0.0, 0.0, c * n_site));
+  BasicStructure struc(lattice);
+  std::vector<Molecule> occupants = {Molecule::make_atom(atom_name)};
+  for (Index i = 0; i < n_site; ++i) {
+    Eigen::Vector3d frac(0.0, 0.0, double(i) / n_site);
+    struc.push_back(Site(Coordinate(frac, struc.lattice(), FRAC), occupants));
+  }
+  return std::make_shared<BasicStructure const>(struc);
+}
+
+/// \brief Check StructureSimilarityMatrix costs against independent
+///     map_structures calls
+void check_costs(
+    StructureSimilarityMatrix const &matrix,
+    std::vector<std::shared_ptr<xtal::BasicStructure const>> const
+        &structures) {
+  StructureSimilarityParams const &params = matrix.params();
+  for (Index i = 0; i < matrix.size(); ++i) {
+    for (Index j = 0; j < matrix.size(); ++j) {
+      if (i == j) {
+        EXPECT_EQ(matrix.cost()(i, j), 0.0);
+        continue;
+      }
+      xtal::SimpleStructure child = xtal::make_simple_structure(*structures[j]);
+      Index n_parent = structures[i]->basis().size();
+      Index n_child = child.atom_info.names.size();
+      double expected = std::numeric_limits<double>::infinity();
+      if (n_child % n_parent == 0 && n_child / n_parent <= params.max_vol) {
+        Index vol = n_child / n_parent;
+        StructureMappingResults results = map_structures(
+            structures[i], child, vol, {}, {}, vol, 0.0, params.max_cost,
+            params.lattice_cost_weight, params.lattice_cost_method,
+            params.atom_cost_method, 1, params.cost_tol);
+        if (results.size()) {
+          expected = results.data[0].total_cost;
+        }
+      }
+      if (std::isinf(expected)) {
+        EXPECT_TRUE(std::isinf(matrix.cost()(i, j))) << i << " " << j;
+      } else {
+        EXPECT_NEAR(matrix.cost()(i, j), expected, 1e-10) << i << " " << j;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(StructureSimilarityMatrixTest, Test1) {
+  // ordered structures: pairs with equal numbers of sites are mapped in one
+  // direction only
+  std::vector<std::shared_ptr<xtal::BasicStructure const>> structures = {
+      make_tetragonal(1.0, 1.0, 1, "A"), make_tetragonal(1.0, 1.05, 1, "A"),
+      make_tetragonal(1.0, 1.0, 1, "B"), make_tetragonal(1.0, 1.02, 2, "A")};
+  StructureSimilarityParams params;
+  params.max_vol = 2;
+  StructureSimilarityMatrix matrix(structures, {}, params, 2);
+
+  ASSERT_EQ(matrix.size(), 4);
+  check_costs(matrix, structures);
+  for (Index i = 0; i < 3; ++i) {
+    for (Index j = 0; j < 3; ++j) {
+      EXPECT_EQ(matrix.cost()(i, j), matrix.cost()(j, i));
+    }
+  }
+  StructureSimilarityStatistics const &stats = matrix.statistics();
+  EXPECT_EQ(stats.n_mirrored, 3);
+  EXPECT_EQ(stats.n_skipped_volume, 3);
+  EXPECT_EQ(stats.n_skipped_composition, 3);
+  EXPECT_EQ(stats.n_mapped, 3);
+}
+
+TEST(StructureSimilarityMatrixTest, Test2) {
+  // disordered structures: pairs are mapped in both directions
+  std::vector<std::shared_ptr<xtal::BasicStructure const>> structures = {
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim()),
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim())};
+  StructureSimilarityParams params;
+  StructureSimilarityMatrix matrix(structures, {}, params, 1);
+
+  check_costs(matrix, structures);
+  EXPECT_EQ(matrix.statistics().n_mirrored, 0);
+  EXPECT_EQ(matrix.statistics().n_mapped, 2);
+}
@@ -0,0 +1,52 @@
+#include "casm/mapping/assignment.hh"
+
+#include "casm/mapping/murty.hh"
+#include "casm/misc/CASM_math.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(AssignmentTest, SolveTest) {
+  EXPECT_EQ(assignment::to_string(assignment::SolverType::hungarian),
+            "hungarian");
+  EXPECT_EQ(assignment::to_string(assignment::SolverType::augmenting_path),
+            "augmenting_path");
+
+  Eigen::MatrixXd C(3, 3);
+  C << 0., 1., 3.,  //
+      2., 1., 0.,   //
+      4., 0., 2.;   //
+  for (auto solver_type : {assignment::SolverType::hungarian,
+                           assignment::SolverType::augmenting_path}) {
+    auto result = assignment::solve(solver_type, C);
+    EXPECT_TRUE(almost_equal(result.first, 0.0));
+    EXPECT_EQ(result.second, assignment::Assignment({0, 2, 1}));
+  }
+}
+
+TEST(AssignmentTest, SolverMethodTest) {
+  // Murty's algorithm solves sub-problems of decreasing size
+  Eigen::MatrixXd D(5, 5);
+  D << 0.1, 0.5, 0.9, 0.3, 0.7,  //
+      0.6, 0.2, 0.8, 0.4, 0.1,   //
+      0.9, 0.3, 0.2, 0.8, 0.5,   //
+      0.4, 0.7, 0.6, 0.1, 0.9,   //
+      0.8, 0.9, 0.4, 0.6, 0.3;   //
+
+  assignment::SolverMethod default_assign_f;
+  EXPECT_EQ(default_assign_f.solver_type, assignment::SolverType::hungarian);
+  auto default_results = murty::solve(default_assign_f, D, 3);
+  EXPECT_EQ(default_results.size(), 3);
+  EXPECT_TRUE(*default_assign_f.n_solved > 0);
+
+  // same costs with augmenting_path::solve; copies share the count
+  assignment::SolverMethod assign_f(assignment::SolverType::augmenting_path);
+  assignment::SolverMethod assign_f_copy(assign_f);
+  auto results = murty::solve(assign_f_copy, D, 3);
+  ASSERT_EQ(results.size(), default_results.size());
+  for (Index i = 0; i < results.size(); ++i) {
+    EXPECT_TRUE(almost_equal(results[i].first, default_results[i].first));
+  }
+  EXPECT_EQ(*assign_f.n_solved, *default_assign_f.n_solved);
+}
@@ -0,0 +1,75 @@
+#include "casm/mapping/augmenting_path.hh"
+
+#include <random>
+
+#include "casm/mapping/hungarian.hh"
+#include "casm/misc/CASM_math.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(AugmentingPathTest, Test1) {
+  Eigen::MatrixXd C(3, 3);
+  C << 0., 1., 3.,  //
+      2., 1., 0.,   //
+      4., 0., 2.;   //
+
+  double cost;
+  augmenting_path::Assignment assignment;
+  std::tie(cost, assignment) = augmenting_path::solve(C);
+
+  EXPECT_TRUE(almost_equal(cost, 0.0));
+  EXPECT_EQ(assignment, augmenting_path::Assignment({0, 2, 1}));
+}
+
+TEST(AugmentingPathTest, Test2) {
+  Eigen::MatrixXd C(3, 3);
+  C << 1., 1., 2.,  //
+      2., 1., 1.,   //
+      4., 0., 2.;   //
+
+  double cost;
+  augmenting_path::Assignment assignment;
+  std::tie(cost, assignment) = augmenting_path::solve(C);
+
+  EXPECT_TRUE(almost_equal(cost, 2.0));
+  EXPECT_EQ(assignment, augmenting_path::Assignment({0, 2, 1}));
+}
+
+// Entries >= infinity are not allowed
+TEST(AugmentingPathTest, Test3) {
+  double inf = 1e20;
+  Eigen::MatrixXd C(3, 3);
+  C << inf, 1., 2.,  //
+      inf, 1., 1.,   //
+      4., inf, 2.;   //
+
+  double cost;
+  augmenting_path::Assignment assignment;
+  std::tie(cost, assignment) = augmenting_path::solve(C, inf);
+
+  EXPECT_TRUE(almost_equal(cost, 6.0));
+  EXPECT_EQ(assignment, augmenting_path::Assignment({1, 2, 0}));
+
+  // no solution without an infinity cost assignment
+  C(2, 0) = inf;
+  std::tie(cost, assignment) = augmenting_path::solve(C, inf);
+  EXPECT_EQ(cost, inf);
+  EXPECT_EQ(assignment.size(), 0);
+}
+
+// Compare optimal costs with hungarian::solve
+TEST(AugmentingPathTest, Test4) {
+  std::mt19937_64 engine(0);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  for (Index dim = 1; dim < 20; ++dim) {
+    Eigen::MatrixXd C =
+        Eigen::MatrixXd::NullaryExpr(dim, dim, [&]() { return dist(engine); });
+    double augmenting_path_cost = augmenting_path::solve(C).first;
+    double hungarian_cost = hungarian::solve(C).first;
+    EXPECT_TRUE(almost_equal(augmenting_path_cost, hungarian_cost, 1e-8))
+        << "dim=" << dim << " augmenting_path_cost=" << augmenting_path_cost
+        << " hungarian_cost=" << hungarian_cost;
+  }
+}
@@ -0,0 +1,131 @@
+#include "casm/mapping/enumerate_superlattices.hh"
+
+#include <set>
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/SymType.hh"
+#include "casm/mapping/estimate_search_cost.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+/// \brief The 48 signed permutation matrices, the point group of a
+///     simple cubic lattice
+std::vector<Eigen::Matrix3l> make_cubic_point_group() {
+  std::vector<Eigen::Matrix3l> point_group;
+  std::vector<int> perm({0, 1, 2});
+  do {
+    for (int signs = 0; signs < 8; ++signs) {
+      Eigen::Matrix3l R = Eigen::Matrix3l::Zero();
+      for (int i = 0; i < 3; ++i) {
+        R(i, perm[i]) = ((signs >> i) & 1) ? -1 : 1;
+      }
+      point_group.push_back(R);
+    }
+  } while (std::next_permutation(perm.begin(), perm.end()));
+  return point_group;
+}
+
+/// \brief Minimum (a, c, f, b, d, e) over the images of H, used to
+///     identify orbits by brute force
+std::vector<long> orbit_key(std::vector<Eigen::Matrix3l> const &point_group,
+                            Eigen::Matrix3l const &H) {
+  std::vector<long> key;
+  for (Eigen::Matrix3l const &R : point_group) {
+    Eigen::Matrix3l H_image = make_hermite_normal_form(R * H);
+    std::vector<long> image_key({H_image(0, 0), H_image(1, 1), H_image(2, 2),
+                                 H_image(0, 1), H_image(0, 2), H_image(1, 2)});
+    if (key.empty() || image_key < key) {
+      key = image_key;
+    }
+  }
+  return key;
+}
+
+}  // namespace
+
+TEST(EnumerateSuperlatticesTest, Test1) {
+  // Hermite normal form
+  Eigen::Matrix<long, 3, Eigen::Dynamic> M(3, 3);
+  M << 2, 1, 0, 0, 3, 5, 1, 0, 2;
+  Eigen::Matrix3l H = make_hermite_normal_form(M);
+  EXPECT_EQ(H(1, 0), 0);
+  EXPECT_EQ(H(2, 0), 0);
+  EXPECT_EQ(H(2, 1), 0);
+  EXPECT_EQ(H.determinant(), std::abs(M.leftCols(3).determinant()));
+  Eigen::Matrix3l U;
+  U << 1, 1, 0, 0, 1, 0, 0, -2, 1;
+  Eigen::Matrix<long, 3, Eigen::Dynamic> M_U = M * U;
+  EXPECT_EQ(make_hermite_normal_form(M_U), H);
+
+  // all Hermite normal forms, with no symmetry
+  SuperlatticeRangeEnumerator enumerator({});
+  for (Index vol = 1; vol <= 32; ++vol) {
+    auto const &hnf = enumerator.distinct_hermite_normal_forms(vol);
+    EXPECT_EQ(hnf.size(), count_superlattices(vol));
+    EXPECT_EQ(enumerator.n_superlattice(vol), count_superlattices(vol));
+    std::set<std::vector<long>> unique;
+    for (Eigen::Matrix3l const &H : hnf) {
+      EXPECT_EQ(H.determinant(), vol);
+      EXPECT_EQ(make_hermite_normal_form(H), H);
+      unique.insert(std::vector<long>(H.data(), H.data() + 9));
+    }
+    EXPECT_EQ(unique.size(), hnf.size());
+  }
+}
+
+TEST(EnumerateSuperlatticesTest, Test2) {
+  // simple cubic, compared with per-volume brute force
+  std::vector<Eigen::Matrix3l> point_group = make_cubic_point_group();
+  SuperlatticeRangeEnumerator enumerator(point_group);
+
+  std::vector<Index> expected_size({1, 3, 3, 9, 5, 13, 7, 24});
+  for (Index vol = 1; vol <= 12; ++vol) {
+    std::set<std::vector<long>> expected;
+    for (Eigen::Matrix3l const &H : make_hermite_normal_forms(vol)) {
+      expected.insert(orbit_key(point_group, H));
+    }
+    std::set<std::vector<long>> found;
+    auto const &hnf = enumerator.distinct_hermite_normal_forms(vol);
+    for (Eigen::Matrix3l const &H : hnf) {
+      found.insert(orbit_key(point_group, H));
+    }
+    EXPECT_EQ(hnf.size(), expected.size());
+    EXPECT_EQ(found, expected);
+    if (vol <= Index(expected_size.size())) {
+      EXPECT_EQ(hnf.size(), expected_size[vol - 1]);
+    }
+  }
+}
+
+TEST(EnumerateSuperlatticesTest, Test3) {
+  // FCC, using Cartesian point group operations
+  Eigen::Matrix3d L;
+  L << 0.0, 2.0, 2.0, 2.0, 0.0, 2.0, 2.0, 2.0, 0.0;
+  xtal::Lattice lattice(L);
+  std::vector<xtal::SymOp> point_group;
+  for (Eigen::Matrix3l const &R : make_cubic_point_group()) {
+    point_group.emplace_back(R.cast<double>(), Eigen::Vector3d::Zero(),
+                             false);
+  }
+
+  auto superlattices = enumerate_superlattices(lattice, point_group, 2, 8);
+  EXPECT_EQ(superlattices.size(), 7);
+  EXPECT_EQ(superlattices.count(1), 0);
+  std::vector<Index> expected_size({1, 2, 3, 7, 5, 10, 7, 20});
+  for (auto const &pair : superlattices) {
+    EXPECT_EQ(pair.second.size(), expected_size[pair.first - 1]);
+    for (xtal::Lattice const &superlattice : pair.second) {
+      EXPECT_NEAR(superlattice.volume(), pair.first * lattice.volume(),
+                  1e-8);
+    }
+  }
+
+  EXPECT_THROW(enumerate_superlattices(lattice, point_group, 0, 8),
+               std::runtime_error);
+  EXPECT_THROW(enumerate_superlattices(lattice, point_group, 3, 2),
+               std::runtime_error);
+}
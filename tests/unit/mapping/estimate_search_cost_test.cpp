@@ -0,0 +1,100 @@
+#include "casm/mapping/estimate_search_cost.hh"
+
+#include "SearchTestData.hh"
+#include "casm/crystallography/Lattice.hh"
+#include "casm/mapping/SearchData.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(EstimateSearchCostTest, Test1) {
+  EXPECT_EQ(count_superlattices(0), 0);
+  EXPECT_EQ(count_superlattices(1), 1);
+  EXPECT_EQ(count_superlattices(2), 7);
+  EXPECT_EQ(count_superlattices(3), 13);
+  EXPECT_EQ(count_superlattices(4), 35);
+
+  EXPECT_EQ(count_reorientations(1), 3480);
+  EXPECT_EQ(count_reorientations(2), 67704);
+  EXPECT_EQ(count_reorientations(3), 640824);
+  EXPECT_EQ(count_reorientations(4), 2597208);
+  EXPECT_THROW(count_reorientations(0), std::runtime_error);
+  EXPECT_THROW(count_reorientations(5), std::runtime_error);
+}
+
+TEST(EstimateSearchCostTest, Test2) {
+  // B2 ordering, in the conventional cubic cell, mapped to binary BCC
+  // with vacancies
+  double a = 4.0;
+  auto prim_data = test::make_search_prim_binary_vacancy_BCC(a);
+
+  Eigen::MatrixXd coordinate_cart(3, 2);
+  coordinate_cart.col(0) << 0.0, 0.0, 0.0;
+  coordinate_cart.col(1) << a / 2., a / 2., a / 2.;
+  StructureSearchData structure_data(
+      xtal::Lattice(a * Eigen::Matrix3d::Identity()), coordinate_cart,
+      {"A", "B"});
+
+  SearchCostParams params;
+  params.min_vol = 1;
+  params.max_vol = 4;
+  params.k_best = 2;
+  SearchCostEstimate estimate =
+      estimate_search_cost(*prim_data, structure_data, params);
+
+  EXPECT_EQ(estimate.n_reorientation, 3480);
+  ASSERT_EQ(estimate.volumes.size(), 4);
+
+  // vol=1: not enough sites for the structure atoms
+  EXPECT_FALSE(estimate.volumes[0].is_compatible);
+  EXPECT_EQ(estimate.volumes[0].n_assignment_problem, 0.0);
+  EXPECT_EQ(estimate.volumes[0].total_seconds, 0.0);
+
+  double total_seconds = 0.0;
+  for (Index i = 1; i < estimate.volumes.size(); ++i) {
+    auto const &v = estimate.volumes[i];
+    EXPECT_TRUE(v.is_compatible);
+    EXPECT_EQ(v.n_supercell_site, v.vol);
+    EXPECT_EQ(v.n_superlattice, count_superlattices(v.vol));
+    EXPECT_EQ(v.n_trial_translation, 1);
+    EXPECT_GT(v.n_assignment_problem, 0.0);
+    EXPECT_GT(v.total_seconds, estimate.volumes[i - 1].total_seconds);
+    total_seconds += v.total_seconds;
+  }
+  EXPECT_NEAR(estimate.total_seconds, total_seconds, 1e-12);
+
+  // without vacancies, only vol=2 is compatible
+  auto prim_data_no_va = test::make_search_prim_binary_BCC(a);
+  estimate = estimate_search_cost(*prim_data_no_va, structure_data, params);
+  ASSERT_EQ(estimate.volumes.size(), 4);
+  EXPECT_FALSE(estimate.volumes[0].is_compatible);
+  EXPECT_TRUE(estimate.volumes[1].is_compatible);
+  EXPECT_FALSE(estimate.volumes[2].is_compatible);
+  EXPECT_FALSE(estimate.volumes[3].is_compatible);
+}
+
+TEST(EstimateSearchCostTest, Test3) {
+  // atom type not allowed by the prim
+  double a = 4.0;
+  auto prim_data = test::make_search_prim_binary_BCC(a);
+
+  Eigen::MatrixXd coordinate_cart(3, 1);
+  coordinate_cart.col(0) << 0.0, 0.0, 0.0;
+  StructureSearchData structure_data(xtal::Lattice(prim_data->prim_lattice),
+                                     coordinate_cart, {"C"});
+
+  SearchCostParams params;
+  params.max_vol = 2;
+  SearchCostEstimate estimate =
+      estimate_search_cost(*prim_data, structure_data, params);
+
+  ASSERT_EQ(estimate.volumes.size(), 2);
+  EXPECT_FALSE(estimate.volumes[0].is_compatible);
+  EXPECT_FALSE(estimate.volumes[1].is_compatible);
+  EXPECT_EQ(estimate.total_seconds, 0.0);
+
+  params.max_vol = 0;
+  EXPECT_THROW(estimate_search_cost(*prim_data, structure_data, params),
+               std::runtime_error);
+}
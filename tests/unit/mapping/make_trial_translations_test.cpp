@@ -87,3 +87,46 @@ TEST(MakeTrialTranslationsTest, Test2) {
   EXPECT_EQ(trial_translations.size(), 1);
   EXPECT_TRUE(almost_equal(trial_translations[0], Eigen::Vector3d(0., 0., 0.)));
 }
+
+// Test make_trial_translations with structure symmetry reduction, for a
+// structure generated from the conventional BCC unit cell
+TEST(MakeTrialTranslationsTest, Test3) {
+  double latparam_a = 4.0;
+
+  // F * L1 * T * N = L2
+  Eigen::Matrix3d F = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d T = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d N = Eigen::Matrix3d::Identity();
+
+  // F (r1_supercell[i] + disp) = r2[perm[i]] + trans
+  // structure1_supercell_atom_type[i] = structure2_atom_type[perm[i]]
+  Eigen::MatrixXd disp = Eigen::MatrixXd::Zero(3, 2);
+  std::vector<std::string> structure1_supercell_atom_type({"A", "A"});
+  std::vector<Index> perm({0, 1});
+  Eigen::Vector3d trans(0., 0., 0.);
+
+  // prim without symmetry, so only the structure's internal
+  // translations can be used to skip translations
+  auto prim_data = std::make_shared<PrimSearchData const>(
+      test::make_search_prim_binary_conventional_BCC(latparam_a)->prim,
+      std::vector<SymOp>({SymOp::identity()}));
+
+  test::SearchTestData d(prim_data, F, T, N, disp,
+                         structure1_supercell_atom_type, perm, trans);
+
+  auto lattice_mapping_data = std::make_shared<LatticeMappingSearchData const>(
+      d.prim_data, d.structure_data, d.lattice_mapping);
+
+  EXPECT_EQ(d.prim_data->prim_factor_group.size(), 1);
+  EXPECT_EQ(d.structure_data->structure_factor_group.size(), 48 * 2);
+
+  // there are 2 atom -> site translations (0., 0., 0.) and (2., 2., 2.)
+  std::vector<Eigen::Vector3d> trial_translations =
+      make_trial_translations(*lattice_mapping_data);
+  EXPECT_EQ(trial_translations.size(), 2);
+
+  // but they are equivalent under the structure's internal translation
+  trial_translations = make_trial_translations(*lattice_mapping_data, true);
+  EXPECT_EQ(trial_translations.size(), 1);
+  EXPECT_TRUE(almost_equal(trial_translations[0], Eigen::Vector3d(0., 0., 0.)));
+}
@@ -0,0 +1,40 @@
+#include "casm/mapping/map_structures.hh"
+
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/mapping/map_atoms.hh"
+#include "casm/mapping/synthetic_structure.hh"
+#include "gtest/gtest.h"
+#include "teststructures.hh"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(MapStructuresTest, Test1) {
+  // map_structures and map_atoms with a shared prim do not copy it
+  auto prim =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super = Eigen::Matrix3l::Identity() * 2;
+  params.displacement_magnitude = 0.02;
+
+  SyntheticStructure synthetic = make_synthetic_structure(prim, params, 4);
+  StructureMappingResults results =
+      map_structures(prim, synthetic.structure, 8, {}, {}, 8);
+  StructureMappingResults expected =
+      map_structures(*prim, synthetic.structure, 8, {}, {}, 8);
+  ASSERT_EQ(results.size(), expected.size());
+  ASSERT_GT(results.size(), 0);
+  for (Index i = 0; i < Index(results.size()); ++i) {
+    EXPECT_EQ(results.data[i].shared_prim, prim);
+    EXPECT_NE(expected.data[i].shared_prim, prim);
+    EXPECT_NEAR(results.data[i].total_cost, expected.data[i].total_cost,
+                1e-10);
+  }
+
+  AtomMappingResults atom_results =
+      map_atoms(prim, synthetic.structure,
+                synthetic.structure_mapping.lattice_mapping);
+  ASSERT_EQ(atom_results.size(), 1);
+  EXPECT_EQ(atom_results.data[0].permutation,
+            synthetic.structure_mapping.atom_mapping.permutation);
+}
@@ -1,5 +1,8 @@
 #include "casm/mapping/murty.hh"
 
+#include <numeric>
+#include <random>
+
 #include "casm/casm_io/container/stream_io.hh"
 #include "casm/global/eigen.hh"
 #include "casm/mapping/hungarian.hh"
@@ -121,3 +124,77 @@ TEST(MurtyTest, Test4) {
   EXPECT_TRUE(almost_equal(assignments[4], {0., {1, 0, 2, }}));
   // clang-format on
 }
+
+TEST(MurtyTest, Test5) {
+  // test cost matrix with assignments that are not allowed, compared with
+  // all solutions found by brute force
+
+  double infinity = 1e20;
+  Index n = 6;
+  std::mt19937 engine(1);
+  for (Index trial = 0; trial < 20; ++trial) {
+    Eigen::MatrixXd C(n, n);
+    for (Index i = 0; i < n; ++i) {
+      for (Index j = 0; j < n; ++j) {
+        C(i, j) = (engine() % 3 == 0) ? infinity : (engine() % 100) * 0.01;
+      }
+    }
+
+    std::vector<double> expected_costs;
+    murty::Assignment assignment(n);
+    std::iota(assignment.begin(), assignment.end(), 0);
+    do {
+      double cost = murty::make_cost(C, assignment);
+      if (cost < infinity) {
+        expected_costs.push_back(cost);
+      }
+    } while (std::next_permutation(assignment.begin(), assignment.end()));
+    std::sort(expected_costs.begin(), expected_costs.end());
+
+    int k_best = 1000;
+    auto assignments = murty::solve(hungarian::solve, C, k_best);
+    ASSERT_EQ(assignments.size(), expected_costs.size());
+    for (Index i = 0; i < Index(assignments.size()); ++i) {
+      EXPECT_NEAR(assignments[i].first, expected_costs[i], 1e-5);
+      EXPECT_NEAR(murty::make_cost(C, assignments[i].second),
+                  assignments[i].first, 1e-5);
+    }
+  }
+}
+
+TEST(MurtyTest, Test6) {
+  // test is_feasible
+
+  double infinity = 1e20;
+  Eigen::MatrixXd C(3, 3);
+  C << 0., infinity, infinity,  //
+      1., infinity, infinity,   //
+      2., 1., 0.;               //
+
+  std::set<Index> all({0, 1, 2});
+  EXPECT_FALSE(murty::is_feasible(C, all, all, {}, infinity));
+  EXPECT_TRUE(murty::is_feasible(C, {1, 2}, {0, 1}, {}, infinity));
+  EXPECT_FALSE(murty::is_feasible(C, {1, 2}, {0, 1}, {{1, 0}}, infinity));
+  EXPECT_FALSE(murty::is_feasible(C, {1, 2}, {0, 1, 2}, {}, infinity));
+
+  C(1, 2) = 3.;
+  EXPECT_TRUE(murty::is_feasible(C, all, all, {}, infinity));
+  EXPECT_FALSE(murty::is_feasible(C, all, all, {{1, 2}}, infinity));
+  auto assignments = murty::solve(hungarian::solve, C, 10, std::nullopt,
+                                  std::nullopt, infinity);
+  ASSERT_EQ(assignments.size(), 1);
+  EXPECT_TRUE(almost_equal(assignments[0], {4., {0, 2, 1}}));
+}
+
+TEST(MurtyTest, Test7) {
+  // test make_assignment with reused storage
+
+  murty::Node node;
+  node.forced_on = {{1, 3}};
+  node.sub_assignment = {{0, 2}, {2, 0}, {3, 1}};
+
+  murty::Assignment assignment(10, -1);
+  murty::make_assignment(node, assignment);
+  EXPECT_EQ(assignment, murty::Assignment({2, 3, 0, 1}));
+  EXPECT_EQ(assignment, murty::make_assignment(node));
+}
@@ -0,0 +1,44 @@
+#include "casm/mapping/perf_counters.hh"
+
+#include "casm/mapping/SearchData.hh"
+#include "gtest/gtest.h"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+TEST(PerfCountersTest, Test1) {
+  // counters may not be available (i.e. in containers), but measuring
+  // must always succeed and give the elapsed time
+  Index dim = 64;
+  Index n_cost_matrix = 10;
+  Eigen::MatrixXd cost_matrix(dim, dim);
+  double sum = 0.0;
+
+  PerfCounts counts;
+  for (Index n = 0; n < n_cost_matrix; ++n) {
+    ScopedPerfCounters scoped(counts);
+    for (Index i = 0; i < dim; ++i) {
+      for (Index j = 0; j < dim; ++j) {
+        cost_matrix(i, j) = make_atom_to_site_cost(
+            Eigen::Vector3d(i, j, n), "A", {"A", "B"}, 1e20);
+      }
+    }
+    sum += cost_matrix.sum();
+  }
+  EXPECT_GT(sum, 0.0);
+  EXPECT_GT(counts.seconds, 0.0);
+
+  PerfCounters counters;
+  if (counters.is_available()) {
+    ASSERT_TRUE(counts.instructions.has_value());
+    EXPECT_GT(*counts.instructions, 0.0);
+  }
+  if (counts.ipc().has_value()) {
+    EXPECT_GT(*counts.ipc(), 0.0);
+  }
+
+  PerfCounts per = per_element(counts, dim * dim * n_cost_matrix);
+  EXPECT_NEAR(per.seconds * dim * dim * n_cost_matrix, counts.seconds,
+              1e-12);
+  EXPECT_EQ(per.cycles.has_value(), counts.cycles.has_value());
+}
@@ -0,0 +1,134 @@
+#include "casm/mapping/synthetic_structure.hh"
+
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/LinearIndexConverter.hh"
+#include "casm/mapping/SearchData.hh"
+#include "casm/mapping/map_atoms.hh"
+#include "casm/misc/CASM_Eigen_math.hh"
+#include "gtest/gtest.h"
+#include "teststructures.hh"
+
+using namespace CASM;
+using namespace CASM::mapping;
+
+namespace {
+
+/// \brief Check F * (r1[i] + d[i]) = r2[perm[i]] + t, modulo lattice
+///     translations, and that vacancies have zero displacement
+void check_structure_mapping(SyntheticStructure const &synthetic) {
+  StructureMapping const &mapping = synthetic.structure_mapping;
+  xtal::BasicStructure const &prim = *mapping.shared_prim;
+  Eigen::Matrix3d const &F = mapping.lattice_mapping.deformation_gradient;
+  Eigen::Matrix3l T =
+      lround(mapping.lattice_mapping.transformation_matrix_to_super);
+  xtal::UnitCellCoordIndexConverter converter(T, prim.basis().size());
+  Eigen::MatrixXd prim_site_coordinate_cart(3, prim.basis().size());
+  for (Index b = 0; b < prim.basis().size(); ++b) {
+    prim_site_coordinate_cart.col(b) = prim.basis()[b].const_cart();
+  }
+  Eigen::MatrixXd r1 = mapping_impl::make_supercell_site_coordinate_cart(
+      converter, prim_site_coordinate_cart, prim.lattice());
+
+  Eigen::MatrixXd const &r2 = synthetic.structure.atom_info.coords;
+  Eigen::Matrix3d L2_inv = synthetic.structure.lat_column_mat.inverse();
+  AtomMapping const &atom_mapping = mapping.atom_mapping;
+  Index N_atom = r2.cols();
+  ASSERT_EQ(atom_mapping.permutation.size(), r1.cols());
+  for (Index i = 0; i < r1.cols(); ++i) {
+    Index j = atom_mapping.permutation[i];
+    if (j >= N_atom) {
+      EXPECT_TRUE(almost_zero(atom_mapping.displacement.col(i)));
+      continue;
+    }
+    Eigen::Vector3d diff =
+        F * (r1.col(i) + atom_mapping.displacement.col(i)) - r2.col(j) -
+        atom_mapping.translation;
+    Eigen::Vector3d frac = L2_inv * diff;
+    frac = frac.array() - frac.array().round();
+    EXPECT_TRUE(almost_zero(frac, 1e-8));
+  }
+}
+
+}  // namespace
+
+TEST(SyntheticStructureTest, Test1) {
+  // FCC binary, no vacancies allowed
+  auto prim =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super = Eigen::Matrix3l::Identity() * 4;
+  params.strain_magnitude = 0.01;
+  params.displacement_magnitude = 0.05;
+  params.vacancy_fraction = 0.5;
+  params.antisite_fraction = 0.25;
+  params.random_rotation = true;
+
+  SyntheticStructure synthetic = make_synthetic_structure(prim, params, 1);
+  EXPECT_EQ(synthetic.structure.atom_info.names.size(), 64);
+  Index n_B = std::count(synthetic.structure.atom_info.names.begin(),
+                         synthetic.structure.atom_info.names.end(), "B");
+  EXPECT_GT(n_B, 0);
+  EXPECT_LT(n_B, 64);
+  check_structure_mapping(synthetic);
+
+  // mean displacement is removed
+  EXPECT_TRUE(almost_zero(
+      Eigen::Vector3d(synthetic.structure_mapping.atom_mapping.displacement
+                          .rowwise()
+                          .sum())));
+
+  // same seed, same structure
+  SyntheticStructure same = make_synthetic_structure(prim, params, 1);
+  EXPECT_EQ(same.structure.atom_info.names,
+            synthetic.structure.atom_info.names);
+  EXPECT_EQ(same.structure.atom_info.coords,
+            synthetic.structure.atom_info.coords);
+  EXPECT_EQ(same.structure_mapping.atom_mapping.permutation,
+            synthetic.structure_mapping.atom_mapping.permutation);
+
+  // different seed, different structure
+  SyntheticStructure other = make_synthetic_structure(prim, params, 2);
+  EXPECT_FALSE(almost_equal(other.structure.atom_info.coords,
+                            synthetic.structure.atom_info.coords));
+}
+
+TEST(SyntheticStructureTest, Test2) {
+  // ZrO, vacancies allowed on O sites
+  auto prim = std::make_shared<xtal::BasicStructure const>(test::ZrO_prim());
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super = Eigen::Matrix3l::Identity() * 3;
+  params.displacement_magnitude = 0.02;
+  params.vacancy_fraction = 0.5;
+
+  SyntheticStructure synthetic = make_synthetic_structure(prim, params, 10);
+  Index N_site = 4 * 27;
+  Index N_atom = synthetic.structure.atom_info.names.size();
+  Index n_Zr = std::count(synthetic.structure.atom_info.names.begin(),
+                          synthetic.structure.atom_info.names.end(), "Zr");
+  EXPECT_EQ(n_Zr, 2 * 27);
+  EXPECT_GT(N_atom, n_Zr);
+  EXPECT_LT(N_atom, N_site);
+  check_structure_mapping(synthetic);
+}
+
+TEST(SyntheticStructureTest, Test3) {
+  // the known atom mapping is found by map_atoms
+  auto prim =
+      std::make_shared<xtal::BasicStructure const>(test::FCC_binary_prim());
+  SyntheticStructureParams params;
+  params.transformation_matrix_to_super = Eigen::Matrix3l::Identity() * 2;
+  params.displacement_magnitude = 0.02;
+  params.antisite_fraction = 0.5;
+
+  SyntheticStructure synthetic = make_synthetic_structure(prim, params, 3);
+  AtomMappingResults results =
+      map_atoms(*prim, synthetic.structure,
+                synthetic.structure_mapping.lattice_mapping);
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results.data[0].permutation,
+            synthetic.structure_mapping.atom_mapping.permutation);
+  EXPECT_TRUE(
+      almost_equal(results.data[0].displacement,
+                   synthetic.structure_mapping.atom_mapping.displacement,
+                   1e-8));
+}